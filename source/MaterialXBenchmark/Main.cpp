@@ -0,0 +1,201 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXRender/CpuEvaluator.h>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+namespace mx = MaterialX;
+
+const std::string options =
+" Options: \n"
+"    --category [NAME]              Specify a node category to measure, e.g. 'noise3d'.  May be given multiple times (defaults to all categories)\n"
+"    --size [INTEGER]               Specify the number of components of node ports (defaults to 3)\n"
+"    --time [FLOAT]                 Specify the time in seconds spent measuring each kernel (defaults to 0.2)\n"
+"    --help                         Display the complete list of command-line options\n";
+
+const mx::StringVec DEFAULT_CATEGORIES =
+{
+    // Math
+    "add", "multiply", "divide", "modulo", "min", "clamp", "mix", "smoothstep", "remap",
+    "power", "sin", "sqrt",
+
+    // Geometric
+    "dotproduct", "normalize", "crossproduct", "rotate2d",
+
+    // Conditional and compositing
+    "ifgreater", "switch", "overlay", "burn", "over", "disjointover", "premult",
+
+    // Color
+    "luminance", "rgbtohsv", "hsvtorgb", "srgb_texture_to_linear", "gamma22_to_linear",
+
+    // Texture and procedural
+    "image", "ramplr", "noise2d", "noise3d", "fractal3d", "cellnoise2d", "cellnoise3d"
+};
+
+// Return the throughput of a kernel in samples per second, measured over
+// the given duration.
+double measureKernel(mx::CpuKernel kernel, const mx::CpuKernelArgs& args, double duration)
+{
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+    size_t samples = 0;
+    double elapsed = 0.0;
+    while (elapsed < duration)
+    {
+        for (int i = 0; i < 64; i++)
+        {
+            kernel(args);
+        }
+        samples += 64 * args.count;
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    }
+    return (double) samples / elapsed;
+}
+
+int main(int argc, char* const argv[])
+{
+    std::vector<std::string> tokens;
+    for (int i = 1; i < argc; i++)
+    {
+        tokens.emplace_back(argv[i]);
+    }
+
+    mx::StringVec categories;
+    size_t size = 3;
+    double duration = 0.2;
+    for (size_t i = 0; i < tokens.size(); i++)
+    {
+        const std::string& token = tokens[i];
+        const std::string& nextToken = i + 1 < tokens.size() ? tokens[i + 1] : mx::EMPTY_STRING;
+        if (token == "--category")
+        {
+            categories.push_back(nextToken);
+        }
+        else if (token == "--size")
+        {
+            size = (size_t) std::max(1, std::min(4, std::stoi(nextToken)));
+        }
+        else if (token == "--time")
+        {
+            duration = std::stod(nextToken);
+        }
+        else if (token == "--help")
+        {
+            std::cout << " MaterialXBenchmark version " << mx::getVersionString() << std::endl;
+            std::cout << options << std::endl;
+            return 0;
+        }
+        else
+        {
+            std::cout << "Unrecognized command-line option: " << token << std::endl;
+            std::cout << "Launch the benchmark with '--help' for a complete list of supported options." << std::endl;
+            continue;
+        }
+
+        if (nextToken.empty())
+        {
+            std::cout << "Expected another token following command-line option: " << token << std::endl;
+        }
+        else
+        {
+            i++;
+        }
+    }
+    if (categories.empty())
+    {
+        categories = DEFAULT_CATEGORIES;
+    }
+
+    std::vector<mx::CpuInstructionSet> instructionSets;
+    for (mx::CpuInstructionSet instructionSet : { mx::CpuInstructionSet::SCALAR, mx::CpuInstructionSet::SSE4,
+                                                  mx::CpuInstructionSet::AVX2, mx::CpuInstructionSet::AVX512 })
+    {
+        if (mx::isCpuInstructionSetSupported(instructionSet))
+        {
+            instructionSets.push_back(instructionSet);
+        }
+    }
+
+    // Inputs take random values in the unit interval, and image nodes sample
+    // an 8-bit texture with linear filtering.
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+    const size_t stride = mx::CpuEvaluator::BATCH_SIZE;
+
+    mx::CpuKernelParams params;
+    params.channels = { 2, 1, 0, 3 };
+    params.image = mx::Image::create(1024, 1024, 4, mx::Image::BaseType::UINT8);
+    params.image->createResourceBuffer();
+    for (unsigned int y = 0; y < params.image->getHeight(); y++)
+    {
+        for (unsigned int x = 0; x < params.image->getWidth(); x++)
+        {
+            params.image->setTexelColor(x, y, mx::Color4(distribution(generator), distribution(generator),
+                                                         distribution(generator), 1.0f));
+        }
+    }
+
+    std::cout << "Throughput of CPU kernels in millions of samples per second, with " << size << " components per port" << std::endl;
+    std::cout << std::left << std::setw(24) << "category";
+    for (mx::CpuInstructionSet instructionSet : instructionSets)
+    {
+        std::cout << std::right << std::setw(10) << mx::getCpuInstructionSetName(instructionSet);
+    }
+    std::cout << std::right << std::setw(10) << "speedup" << std::endl;
+
+    for (const std::string& category : categories)
+    {
+        const mx::CpuKernelDef* scalarDef = mx::getCpuKernelDef(category, mx::CpuInstructionSet::SCALAR);
+        if (!scalarDef)
+        {
+            std::cout << "No CPU kernel for category: " << category << std::endl;
+            continue;
+        }
+
+        std::vector<std::vector<float>> inputs;
+        for (const std::string& name : scalarDef->inputs)
+        {
+            std::vector<float> input(4 * stride);
+            for (float& value : input)
+            {
+                value = name == "octaves" ? 3.0f : name == "lacunarity" ? 2.0f : distribution(generator) * 4.0f;
+            }
+            inputs.push_back(input);
+        }
+        std::vector<float> output(4 * stride);
+
+        mx::CpuKernelArgs args;
+        args.count = stride;
+        args.stride = stride;
+        args.params = &params;
+        for (const std::vector<float>& input : inputs)
+        {
+            args.inputs.push_back(input.data());
+            args.inputSizes.push_back(size);
+        }
+        args.outputs.push_back(output.data());
+        args.outputSizes.push_back(size);
+
+        std::cout << std::left << std::setw(24) << category << std::right << std::fixed << std::setprecision(1);
+        double scalarRate = 0.0;
+        double rate = 0.0;
+        for (mx::CpuInstructionSet instructionSet : instructionSets)
+        {
+            rate = measureKernel(mx::getCpuKernelDef(category, instructionSet)->kernel, args, duration);
+            if (instructionSet == mx::CpuInstructionSet::SCALAR)
+            {
+                scalarRate = rate;
+            }
+            std::cout << std::setw(10) << rate * 1e-6;
+        }
+        std::cout << std::setw(9) << rate / scalarRate << "x" << std::endl;
+    }
+
+    return 0;
+}
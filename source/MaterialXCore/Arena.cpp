@@ -0,0 +1,282 @@
+//
+// TM & (c) 2021 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXCore/Arena.h>
+
+namespace MaterialX
+{
+
+const size_t ElementArena::DEFAULT_BLOCK_SIZE = 1 << 20;
+const size_t ElementArena::SIZE_CLASS_GRANULARITY = 16;
+const size_t ElementArena::MAX_SIZE_CLASS = 1024;
+
+namespace {
+
+// The number of arenas whose free lists are cached by each thread.
+const size_t THREAD_CACHE_SLOTS = 4;
+
+// The number of free allocations of a size class held by a thread before
+// half of them are returned to the arena.
+const size_t THREAD_CACHE_CAPACITY = 64;
+
+// The number of bytes moved to a thread by each batch from the arena.
+const size_t BATCH_BYTES = 4096;
+
+std::atomic<uint64_t> nextArenaId(1);
+
+size_t getSizeClass(size_t size)
+{
+    return std::max<size_t>((size + ElementArena::SIZE_CLASS_GRANULARITY - 1) / ElementArena::SIZE_CLASS_GRANULARITY, 1);
+}
+
+// Live arenas by identifier, through which thread caches return memory to
+// arenas that may have been destroyed since it was cached.
+std::mutex& getRegistryMutex()
+{
+    static std::mutex registryMutex;
+    return registryMutex;
+}
+
+std::unordered_map<uint64_t, ElementArena*>& getRegistry()
+{
+    static std::unordered_map<uint64_t, ElementArena*> registry;
+    return registry;
+}
+
+} // anonymous namespace
+
+//
+// ElementArena::ThreadCache methods
+//
+
+class ElementArena::ThreadCache
+{
+  public:
+    struct FreeList
+    {
+        FreeNode* head = nullptr;
+        size_t count = 0;
+    };
+
+    struct Slot
+    {
+        uint64_t arenaId = 0;
+        vector<FreeList> lists;
+    };
+
+    ThreadCache() :
+        _nextSlot(0)
+    {
+    }
+
+    ~ThreadCache()
+    {
+        for (Slot& slot : _slots)
+        {
+            release(slot);
+        }
+    }
+
+    // Return the free list of the given arena and size class, replacing the
+    // oldest cached arena if needed.
+    FreeList& getFreeList(const ElementArena& arena, size_t sizeClass)
+    {
+        for (Slot& slot : _slots)
+        {
+            if (slot.arenaId == arena._id)
+            {
+                return slot.lists[sizeClass];
+            }
+        }
+        Slot& slot = _slots[_nextSlot];
+        _nextSlot = (_nextSlot + 1) % THREAD_CACHE_SLOTS;
+        release(slot);
+        slot.arenaId = arena._id;
+        slot.lists.resize(arena._freeLists.size());
+        return slot.lists[sizeClass];
+    }
+
+  private:
+    // Return the free lists of a slot to their arena.  The lists of arenas
+    // that have since been destroyed are discarded without being read.
+    static void release(Slot& slot)
+    {
+        if (!slot.arenaId)
+        {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> guard(getRegistryMutex());
+            auto it = getRegistry().find(slot.arenaId);
+            if (it != getRegistry().end())
+            {
+                for (size_t sizeClass = 0; sizeClass < slot.lists.size(); sizeClass++)
+                {
+                    const FreeList& list = slot.lists[sizeClass];
+                    it->second->releaseBatch(sizeClass, list.head, list.count);
+                }
+            }
+        }
+        slot.arenaId = 0;
+        slot.lists.assign(slot.lists.size(), FreeList());
+    }
+
+  private:
+    Slot _slots[THREAD_CACHE_SLOTS];
+    size_t _nextSlot;
+};
+
+//
+// ElementArena methods
+//
+
+ElementArena::ElementArena(size_t blockSize) :
+    _id(nextArenaId.fetch_add(1)),
+    _blockSize(std::max(blockSize, MAX_SIZE_CLASS)),
+    _blockOffset(0),
+    _freeLists(getSizeClass(MAX_SIZE_CLASS) + 1, nullptr),
+    _allocatedBytes(0)
+{
+    std::lock_guard<std::mutex> guard(getRegistryMutex());
+    getRegistry()[_id] = this;
+}
+
+ElementArena::~ElementArena()
+{
+    {
+        std::lock_guard<std::mutex> guard(getRegistryMutex());
+        getRegistry().erase(_id);
+    }
+    for (char* block : _blocks)
+    {
+        delete[] block;
+    }
+}
+
+void* ElementArena::allocate(size_t size)
+{
+    if (size > MAX_SIZE_CLASS)
+    {
+        return ::operator new(size);
+    }
+
+    size_t sizeClass = getSizeClass(size);
+    _allocatedBytes.fetch_add(sizeClass * SIZE_CLASS_GRANULARITY, std::memory_order_relaxed);
+
+    ThreadCache::FreeList& list = getThreadCache().getFreeList(*this, sizeClass);
+    if (!list.head)
+    {
+        acquireBatch(sizeClass, list.head, list.count);
+    }
+    FreeNode* node = list.head;
+    list.head = node->next;
+    list.count--;
+    return node;
+}
+
+void ElementArena::deallocate(void* ptr, size_t size)
+{
+    if (!ptr)
+    {
+        return;
+    }
+    if (size > MAX_SIZE_CLASS)
+    {
+        ::operator delete(ptr);
+        return;
+    }
+
+    size_t sizeClass = getSizeClass(size);
+    _allocatedBytes.fetch_sub(sizeClass * SIZE_CLASS_GRANULARITY, std::memory_order_relaxed);
+
+    ThreadCache::FreeList& list = getThreadCache().getFreeList(*this, sizeClass);
+    FreeNode* node = static_cast<FreeNode*>(ptr);
+    node->next = list.head;
+    list.head = node;
+    list.count++;
+
+    // Return the older half of a full list to the arena.
+    if (list.count >= THREAD_CACHE_CAPACITY)
+    {
+        FreeNode* last = list.head;
+        for (size_t i = 1; i < THREAD_CACHE_CAPACITY / 2; i++)
+        {
+            last = last->next;
+        }
+        releaseBatch(sizeClass, last->next, list.count - THREAD_CACHE_CAPACITY / 2);
+        last->next = nullptr;
+        list.count = THREAD_CACHE_CAPACITY / 2;
+    }
+}
+
+size_t ElementArena::getBlockCount() const
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _blocks.size();
+}
+
+size_t ElementArena::getAllocatedBytes() const
+{
+    return _allocatedBytes.load(std::memory_order_relaxed);
+}
+
+ElementArena::ThreadCache& ElementArena::getThreadCache()
+{
+    static thread_local ThreadCache threadCache;
+    return threadCache;
+}
+
+void ElementArena::acquireBatch(size_t sizeClass, FreeNode*& head, size_t& count)
+{
+    const size_t classBytes = sizeClass * SIZE_CLASS_GRANULARITY;
+    const size_t batchCount = std::max<size_t>(std::min(BATCH_BYTES / classBytes, THREAD_CACHE_CAPACITY / 2), 1);
+
+    std::lock_guard<std::mutex> guard(_mutex);
+
+    // Recycle previously released allocations of the same size class.
+    while (count < batchCount && _freeLists[sizeClass])
+    {
+        FreeNode* node = _freeLists[sizeClass];
+        _freeLists[sizeClass] = node->next;
+        node->next = head;
+        head = node;
+        count++;
+    }
+
+    // Carve the remainder from the current block, reserving a new block
+    // when the current one is exhausted.
+    while (count < batchCount)
+    {
+        if (_blocks.empty() || _blockOffset + classBytes > _blockSize)
+        {
+            _blocks.push_back(new char[_blockSize]);
+            _blockOffset = 0;
+        }
+        FreeNode* node = reinterpret_cast<FreeNode*>(_blocks.back() + _blockOffset);
+        _blockOffset += classBytes;
+        node->next = head;
+        head = node;
+        count++;
+    }
+}
+
+void ElementArena::releaseBatch(size_t sizeClass, FreeNode* head, size_t count)
+{
+    if (!head)
+    {
+        return;
+    }
+    FreeNode* last = head;
+    for (size_t i = 1; i < count; i++)
+    {
+        last = last->next;
+    }
+
+    std::lock_guard<std::mutex> guard(_mutex);
+    last->next = _freeLists[sizeClass];
+    _freeLists[sizeClass] = head;
+}
+
+} // namespace MaterialX
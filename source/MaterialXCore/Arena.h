@@ -0,0 +1,166 @@
+//
+// TM & (c) 2021 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_ARENA_H
+#define MATERIALX_ARENA_H
+
+/// @file
+/// Arena allocation for element trees
+
+#include <MaterialXCore/Export.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+namespace MaterialX
+{
+
+class ElementArena;
+
+/// A shared pointer to an ElementArena
+using ElementArenaPtr = shared_ptr<ElementArena>;
+
+/// @class ElementArena
+/// A memory arena for the elements of a document.
+///
+/// Memory is reserved from the system in large blocks, and small requests
+/// are served from these blocks in fixed size classes, with released memory
+/// recycled through per-class free lists.  All blocks are returned to the
+/// system together when the arena is destroyed, which occurs once the owning
+/// document and all elements allocated from the arena have been released.
+///
+/// Allocation and deallocation may be called from multiple threads.  Each
+/// thread keeps its own free lists for the arenas it has recently used, and
+/// only exchanges batches of memory with the shared lists of the arena, so
+/// most requests take no lock.
+class MX_CORE_API ElementArena
+{
+  public:
+    explicit ElementArena(size_t blockSize = DEFAULT_BLOCK_SIZE);
+    ~ElementArena();
+    ElementArena(const ElementArena&) = delete;
+    ElementArena& operator=(const ElementArena&) = delete;
+
+    /// Create a new arena with the given block size in bytes.
+    static ElementArenaPtr create(size_t blockSize = DEFAULT_BLOCK_SIZE)
+    {
+        return std::make_shared<ElementArena>(blockSize);
+    }
+
+    /// Allocate memory of the given size from the arena.  Requests larger
+    /// than the maximum size class are forwarded to the system allocator.
+    void* allocate(size_t size);
+
+    /// Return memory of the given size to the arena.
+    void deallocate(void* ptr, size_t size);
+
+    /// Return the number of blocks reserved from the system.
+    size_t getBlockCount() const;
+
+    /// Return the number of bytes presently allocated from the arena.
+    size_t getAllocatedBytes() const;
+
+  public:
+    static const size_t DEFAULT_BLOCK_SIZE;
+    static const size_t SIZE_CLASS_GRANULARITY;
+    static const size_t MAX_SIZE_CLASS;
+
+  private:
+    struct FreeNode
+    {
+        FreeNode* next;
+    };
+
+    class ThreadCache;
+
+    // Return the free lists of the calling thread.
+    static ThreadCache& getThreadCache();
+
+    // Move a batch of free allocations of the given size class from the
+    // shared lists to the given list, carving new allocations as needed.
+    void acquireBatch(size_t sizeClass, FreeNode*& head, size_t& count);
+
+    // Return a list of free allocations of the given size class to the
+    // shared lists.
+    void releaseBatch(size_t sizeClass, FreeNode* head, size_t count);
+
+    const uint64_t _id;
+    size_t _blockSize;
+    vector<char*> _blocks;
+    size_t _blockOffset;
+    vector<FreeNode*> _freeLists;
+    std::atomic<size_t> _allocatedBytes;
+    mutable std::mutex _mutex;
+};
+
+/// @class ArenaAllocator
+/// A standard allocator that draws memory from a shared ElementArena.
+/// Each copy of the allocator retains a reference to the arena, keeping it
+/// alive for as long as any memory allocated from it remains in use.  An
+/// allocator without an arena draws memory from the system.
+///
+/// Containers exchange allocators when they are moved or swapped, and keep
+/// their own allocator when they are copied.
+template <class T> class ArenaAllocator
+{
+  public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    ArenaAllocator()
+    {
+    }
+    explicit ArenaAllocator(ElementArenaPtr arena) :
+        _arena(arena)
+    {
+    }
+    template <class U> ArenaAllocator(const ArenaAllocator<U>& other) :
+        _arena(other.getArena())
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        if (!_arena)
+        {
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+        return static_cast<T*>(_arena->allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, size_t n)
+    {
+        if (!_arena)
+        {
+            ::operator delete(ptr);
+            return;
+        }
+        _arena->deallocate(ptr, n * sizeof(T));
+    }
+
+    /// Return the arena from which this allocator draws memory.
+    const ElementArenaPtr& getArena() const
+    {
+        return _arena;
+    }
+
+    template <class U> bool operator==(const ArenaAllocator<U>& rhs) const
+    {
+        return _arena == rhs.getArena();
+    }
+    template <class U> bool operator!=(const ArenaAllocator<U>& rhs) const
+    {
+        return _arena != rhs.getArena();
+    }
+
+  private:
+    ElementArenaPtr _arena;
+};
+
+} // namespace MaterialX
+
+#endif
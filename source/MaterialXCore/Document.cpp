@@ -7,7 +7,11 @@
 
 #include <MaterialXCore/Util.h>
 
+#include <atomic>
+#include <chrono>
+#include <exception>
 #include <mutex>
+#include <thread>
 
 namespace MaterialX
 {
@@ -46,6 +50,36 @@ NodeDefPtr getShaderNodeDef(ElementPtr shaderRef)
     return NodeDefPtr();
 }
 
+// The state of a call to Document::validate with options, which is visible
+// to the validation of the document's children on the calling thread.
+struct ValidationState
+{
+    const Document* doc;
+    const ValidationOptions* options;
+    ValidationTimeMap* categoryTimes;
+};
+
+thread_local const ValidationState* activeValidationState = nullptr;
+
+// Publish the given validation state on the calling thread for the lifetime
+// of this object.
+class ScopedValidationState
+{
+  public:
+    explicit ScopedValidationState(const ValidationState* state) :
+        _prevState(activeValidationState)
+    {
+        activeValidationState = state;
+    }
+    ~ScopedValidationState()
+    {
+        activeValidationState = _prevState;
+    }
+
+  private:
+    const ValidationState* _prevState;
+};
+
 } // anonymous namespace
 
 //
@@ -65,17 +99,25 @@ class Document::Cache
 {
   public:
     Cache() :
-        valid(false)
+        valid(false),
+        connectionRevision(0)
     {
     }
     ~Cache() { }
 
     void refresh()
     {
+        // Once the cache has been published, concurrent readers may access
+        // it without locking, as the document is not modified while shared.
+        if (valid.load(std::memory_order_acquire))
+        {
+            return;
+        }
+
         // Thread synchronization for multiple concurrent readers of a single document.
         std::lock_guard<std::mutex> guard(mutex);
 
-        if (!valid)
+        if (!valid.load(std::memory_order_relaxed))
         {
             // Clear the existing cache.
             portElementMap.clear();
@@ -83,51 +125,170 @@ class Document::Cache
             implementationMap.clear();
 
             // Traverse the document to build a new cache.
-            for (ElementPtr elem : doc.lock()->traverseTree())
+            for (const Element& elem : doc.lock()->traverseTreeConst())
             {
-                const string& nodeName = elem->getAttribute(PortElement::NODE_NAME_ATTRIBUTE);
-                const string& nodeString = elem->getAttribute(NodeDef::NODE_ATTRIBUTE);
-                const string& nodeDefString = elem->getAttribute(InterfaceElement::NODE_DEF_ATTRIBUTE);
+                addEntries(elem);
+            }
 
-                if (!nodeName.empty())
-                {
-                    PortElementPtr portElem = elem->asA<PortElement>();
-                    if (portElem)
-                    {
-                        portElementMap.emplace(portElem->getQualifiedName(nodeName), portElem);
-                    }
-                }
-                if (!nodeString.empty())
-                {
-                    NodeDefPtr nodeDef = elem->asA<NodeDef>();
-                    if (nodeDef)
-                    {
-                        nodeDefMap.emplace(nodeDef->getQualifiedName(nodeString), nodeDef);
-                    }
-                }
-                if (!nodeDefString.empty())
-                {
-                    InterfaceElementPtr interface = elem->asA<InterfaceElement>();
-                    if (interface && (interface->isA<Implementation>() || interface->isA<NodeGraph>()))
-                    {
-                        implementationMap.emplace(interface->getQualifiedName(nodeDefString), interface);
-                    }
-                }
+            valid.store(true, std::memory_order_release);
+        }
+    }
+
+    // Add the given element and its descendants to a valid cache.
+    void addTree(ElementPtr root)
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+
+        if (valid && isConnected(root))
+        {
+            for (const Element& elem : root->traverseTreeConst())
+            {
+                addEntries(elem);
+            }
+        }
+    }
+
+    // Remove the given element and its descendants from a valid cache.
+    void removeTree(ElementPtr root)
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+
+        if (valid && isConnected(root))
+        {
+            for (const Element& elem : root->traverseTreeConst())
+            {
+                removeEntries(elem);
             }
+        }
+    }
+
+    // Add the given element, excluding its descendants, to a valid cache.
+    void addElement(ElementPtr elem)
+    {
+        std::lock_guard<std::mutex> guard(mutex);
 
-            valid = true;
+        if (valid && isConnected(elem))
+        {
+            addEntries(*elem);
         }
     }
 
+    // Remove the given element, excluding its descendants, from a valid cache.
+    void removeElement(ElementPtr elem)
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+
+        if (valid && isConnected(elem))
+        {
+            removeEntries(*elem);
+        }
+    }
+
+    // Return true if the given attribute contributes to the cache.
+    static bool isCachedAttribute(const string& attrib)
+    {
+        return attrib == PortElement::NODE_NAME_ATTRIBUTE ||
+               attrib == NodeDef::NODE_ATTRIBUTE ||
+               attrib == InterfaceElement::NODE_DEF_ATTRIBUTE;
+    }
+
+  private:
+    // Return true if the given element is reachable from the root of the
+    // document.  Elements that have been removed from the tree retain their
+    // parent pointers, so each link is verified against the parent's children.
+    bool isConnected(ConstElementPtr elem) const
+    {
+        for (ConstElementPtr parent = elem->getParent(); parent; parent = parent->getParent())
+        {
+            if (parent->getChild(elem->getName()) != elem)
+            {
+                return false;
+            }
+            elem = parent;
+        }
+        return elem == doc.lock();
+    }
+
+    // Add cache entries for the given element.  Shared pointers are only
+    // acquired for elements that contribute to the cache.
+    void addEntries(const Element& elem)
+    {
+        const string& nodeName = elem.getAttribute(PortElement::NODE_NAME_ATTRIBUTE);
+        const string& nodeString = elem.getAttribute(NodeDef::NODE_ATTRIBUTE);
+        const string& nodeDefString = elem.getAttribute(InterfaceElement::NODE_DEF_ATTRIBUTE);
+
+        if (!nodeName.empty() && elem.isA<PortElement>())
+        {
+            portElementMap.emplace(elem.getQualifiedName(nodeName), getMutableElement(elem)->asA<PortElement>());
+        }
+        if (!nodeString.empty() && elem.isA<NodeDef>())
+        {
+            nodeDefMap.emplace(elem.getQualifiedName(nodeString), getMutableElement(elem)->asA<NodeDef>());
+        }
+        if (!nodeDefString.empty() && (elem.isA<Implementation>() || elem.isA<NodeGraph>()))
+        {
+            implementationMap.emplace(elem.getQualifiedName(nodeDefString), getMutableElement(elem)->asA<InterfaceElement>());
+        }
+    }
+
+    void removeEntries(const Element& elem)
+    {
+        const string& nodeName = elem.getAttribute(PortElement::NODE_NAME_ATTRIBUTE);
+        const string& nodeString = elem.getAttribute(NodeDef::NODE_ATTRIBUTE);
+        const string& nodeDefString = elem.getAttribute(InterfaceElement::NODE_DEF_ATTRIBUTE);
+
+        if (!nodeName.empty())
+        {
+            eraseEntry(portElementMap, elem.getQualifiedName(nodeName), elem);
+        }
+        if (!nodeString.empty())
+        {
+            eraseEntry(nodeDefMap, elem.getQualifiedName(nodeString), elem);
+        }
+        if (!nodeDefString.empty())
+        {
+            eraseEntry(implementationMap, elem.getQualifiedName(nodeDefString), elem);
+        }
+    }
+
+    template <class T> static void eraseEntry(std::unordered_multimap<string, T>& map, const string& key, const Element& elem)
+    {
+        auto keyRange = map.equal_range(key);
+        for (auto it = keyRange.first; it != keyRange.second; ++it)
+        {
+            if (it->second.get() == &elem)
+            {
+                map.erase(it);
+                return;
+            }
+        }
+    }
+
+    // The cache holds mutable pointers to the elements of its document.
+    static ElementPtr getMutableElement(const Element& elem)
+    {
+        return std::const_pointer_cast<Element>(elem.getSelf());
+    }
+
   public:
     weak_ptr<Document> doc;
     std::mutex mutex;
-    bool valid;
+    std::atomic<bool> valid;
+    std::atomic<size_t> connectionRevision;
     std::unordered_multimap<string, PortElementPtr> portElementMap;
     std::unordered_multimap<string, NodeDefPtr> nodeDefMap;
     std::unordered_multimap<string, InterfaceElementPtr> implementationMap;
 };
 
+//
+// ValidationOptions methods
+//
+
+ValidationOptions::ValidationOptions() :
+    threadCount(1)
+{
+}
+
 //
 // Document methods
 //
@@ -148,6 +309,7 @@ void Document::initialize()
     _cache->doc = getDocument();
 
     clearContent();
+    clearDataLibraries();
     setVersionIntegers(MATERIALX_MAJOR_VERSION, MATERIALX_MINOR_VERSION);
 }
 
@@ -246,14 +408,87 @@ void Document::importLibrary(const ConstDocumentPtr& library)
     }
 }
 
+void Document::addDataLibrary(ConstDocumentPtr library)
+{
+    if (!library)
+    {
+        return;
+    }
+    if (library == getSelf())
+    {
+        throw Exception("A document cannot reference itself as a data library");
+    }
+
+    // Reject libraries that reference this document in turn, which would
+    // make lookups through the library chain recurse without end.
+    vector<ConstDocumentPtr> pending = library->getDataLibraries();
+    std::set<ConstDocumentPtr> visited;
+    while (!pending.empty())
+    {
+        ConstDocumentPtr reference = pending.back();
+        pending.pop_back();
+        if (reference == getSelf())
+        {
+            throw Exception("Data library references this document through its own data libraries");
+        }
+        if (visited.insert(reference).second)
+        {
+            pending.insert(pending.end(), reference->getDataLibraries().begin(), reference->getDataLibraries().end());
+        }
+    }
+    if (std::find(_dataLibraries.begin(), _dataLibraries.end(), library) == _dataLibraries.end())
+    {
+        _dataLibraries.push_back(library);
+        onConnectionChange();
+    }
+}
+
+void Document::clearDataLibraries()
+{
+    _dataLibraries.clear();
+    onConnectionChange();
+}
+
+ElementPtr Document::getDataLibraryChild(const string& name, ElementPredicate predicate) const
+{
+    for (ConstDocumentPtr library : _dataLibraries)
+    {
+        ElementPtr child = library->getChild(name);
+        if (child && (!predicate || predicate(child)))
+        {
+            return child;
+        }
+        child = library->getDataLibraryChild(name, predicate);
+        if (child)
+        {
+            return child;
+        }
+    }
+    return ElementPtr();
+}
+
+void Document::setElementArena(ElementArenaPtr arena)
+{
+    // Move the containers of the document to the new allocator, from which
+    // the containers of its new children are drawn in turn.
+    ElementVec::allocator_type allocator(arena);
+    _childOrder = ElementVec(_childOrder.begin(), _childOrder.end(), allocator);
+    _attributes = AttributeVec(_attributes.begin(), _attributes.end(), allocator);
+    if (_childMap)
+    {
+        _childMap.reset(new ChildMap(_childMap->begin(), _childMap->end(), _childMap->bucket_count(),
+                                     std::hash<string>(), std::equal_to<string>(), allocator));
+    }
+}
+
 StringSet Document::getReferencedSourceUris() const
 {
     StringSet sourceUris;
-    for (ElementPtr elem : traverseTree())
+    for (const Element& elem : traverseTreeConst())
     {
-        if (elem->hasSourceUri())
+        if (elem.hasSourceUri())
         {
-            sourceUris.insert(elem->getSourceUri());
+            sourceUris.insert(elem.getSourceUri());
         }
     }
     return sourceUris;
@@ -316,6 +551,13 @@ vector<NodeDefPtr> Document::getMatchingNodeDefs(const string& nodeName) const
         nodeDefs.push_back(it->second);
     }
 
+    // Append matches from referenced data libraries.
+    for (ConstDocumentPtr library : _dataLibraries)
+    {
+        vector<NodeDefPtr> libraryNodeDefs = library->getMatchingNodeDefs(nodeName);
+        nodeDefs.insert(nodeDefs.end(), libraryNodeDefs.begin(), libraryNodeDefs.end());
+    }
+
     // Return the matches.
     return nodeDefs;
 }
@@ -333,6 +575,13 @@ vector<InterfaceElementPtr> Document::getMatchingImplementations(const string& n
         implementations.push_back(it->second);
     }
 
+    // Append matches from referenced data libraries.
+    for (ConstDocumentPtr library : _dataLibraries)
+    {
+        vector<InterfaceElementPtr> libraryImplementations = library->getMatchingImplementations(nodeDef);
+        implementations.insert(implementations.end(), libraryImplementations.begin(), libraryImplementations.end());
+    }
+
     // Return the matches.
     return implementations;
 }
@@ -344,6 +593,96 @@ bool Document::validate(string* message) const
     return GraphElement::validate(message) && res;
 }
 
+bool Document::validate(string* message, const ValidationOptions& options, ValidationTimeMap* categoryTimes) const
+{
+    ValidationState state { this, &options, categoryTimes };
+    ScopedValidationState scopedState(&state);
+    return validate(message);
+}
+
+bool Document::validateChildren(string* message) const
+{
+    const ValidationState* state = activeValidationState;
+    if (!state || state->doc != this)
+    {
+        return GraphElement::validateChildren(message);
+    }
+
+    const ElementVec& children = getChildren();
+    size_t threadCount = state->options->threadCount;
+    if (threadCount == 0)
+    {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    threadCount = std::min(threadCount, children.size());
+
+    // Validate each top-level element into its own message string.
+    vector<string> childMessages(children.size());
+    vector<char> childResults(children.size(), 1);
+    vector<double> childTimes(children.size(), 0.0);
+    vector<std::exception_ptr> childErrors(children.size());
+    auto validateChild = [&](size_t index)
+    {
+        try
+        {
+            auto startTime = std::chrono::steady_clock::now();
+            childResults[index] = children[index]->validate(message ? &childMessages[index] : nullptr);
+            childTimes[index] = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        }
+        catch (...)
+        {
+            childErrors[index] = std::current_exception();
+        }
+    };
+
+    if (threadCount <= 1)
+    {
+        for (size_t i = 0; i < children.size(); i++)
+        {
+            validateChild(i);
+        }
+    }
+    else
+    {
+        std::atomic<size_t> nextChild(0);
+        vector<std::thread> threads;
+        for (size_t i = 0; i < threadCount; i++)
+        {
+            threads.emplace_back([&]()
+            {
+                for (size_t index = nextChild++; index < children.size(); index = nextChild++)
+                {
+                    validateChild(index);
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    // Merge the results in document order.
+    bool res = true;
+    for (size_t i = 0; i < children.size(); i++)
+    {
+        if (childErrors[i])
+        {
+            std::rethrow_exception(childErrors[i]);
+        }
+        res = childResults[i] && res;
+        if (message)
+        {
+            *message += childMessages[i];
+        }
+        if (state->categoryTimes)
+        {
+            (*state->categoryTimes)[children[i]->getCategory()] += childTimes[i];
+        }
+    }
+    return res;
+}
+
 void Document::upgradeVersion()
 {
     std::pair<int, int> versions = getVersionIntegers();
@@ -423,7 +762,7 @@ void Document::upgradeVersion()
         // Upgrade elements in place.
         for (ElementPtr elem : traverseTree())
         {
-            vector<ElementPtr> origChildren = elem->getChildren();
+            ElementVec origChildren = elem->getChildren();
             for (ElementPtr child : origChildren)
             {
                 if (child->getCategory() == "opgraph")
@@ -614,7 +953,7 @@ void Document::upgradeVersion()
                 elem->setAttribute(ValueElement::VALUE_ATTRIBUTE, replaceSubstrings(elem->getAttribute(ValueElement::VALUE_ATTRIBUTE), stringMap));
             }
 
-            vector<ElementPtr> origChildren = elem->getChildren();
+            ElementVec origChildren = elem->getChildren();
             for (ElementPtr child : origChildren)
             {
                 if (elem->getCategory() == "material" && child->getCategory() == "override")
@@ -1348,7 +1687,74 @@ void Document::upgradeVersion()
 
 void Document::invalidateCache()
 {
-    _cache->valid = false;
+    _cache->valid.store(false, std::memory_order_release);
+    onConnectionChange();
+}
+
+void Document::onAddElement(ElementPtr elem)
+{
+    _cache->addTree(elem);
+    onConnectionChange(elem);
+}
+
+void Document::onRemoveElement(ElementPtr elem)
+{
+    _cache->removeTree(elem);
+    onConnectionChange(elem);
+}
+
+void Document::onBeginAttributeChange(ElementPtr elem)
+{
+    _cache->removeElement(elem);
+    onConnectionChange(elem);
+}
+
+void Document::onEndAttributeChange(ElementPtr elem)
+{
+    _cache->addElement(elem);
+}
+
+void Document::onConnectionChange(ConstElementPtr elem)
+{
+    _cache->connectionRevision.fetch_add(1, std::memory_order_acq_rel);
+    if (!elem)
+    {
+        return;
+    }
+
+    // Notify the graph that contains the element, along with the element
+    // itself if it is a graph whose children may have changed.
+    GraphElementPtr graph = std::const_pointer_cast<GraphElement>(elem->asA<GraphElement>());
+    if (graph)
+    {
+        graph->onGraphConnectionChange();
+    }
+    for (ConstElementPtr parent = elem->getParent(); parent; parent = parent->getParent())
+    {
+        graph = std::const_pointer_cast<GraphElement>(parent->asA<GraphElement>());
+        if (graph)
+        {
+            graph->onGraphConnectionChange();
+            break;
+        }
+    }
+}
+
+bool Document::isCachedAttribute(const string& attrib)
+{
+    return Cache::isCachedAttribute(attrib);
+}
+
+bool Document::isConnectionAttribute(const string& attrib)
+{
+    return attrib == PortElement::OUTPUT_ATTRIBUTE ||
+           attrib == PortElement::NODE_GRAPH_ATTRIBUTE ||
+           attrib == ValueElement::INTERFACE_NAME_ATTRIBUTE;
+}
+
+size_t Document::getConnectionRevision() const
+{
+    return _cache->connectionRevision.load(std::memory_order_acquire);
 }
 
 } // namespace MaterialX
@@ -24,6 +24,25 @@ using DocumentPtr = shared_ptr<Document>;
 /// A shared pointer to a const Document
 using ConstDocumentPtr = shared_ptr<const Document>;
 
+/// A map from element categories to validation times in seconds
+using ValidationTimeMap = std::unordered_map<string, double>;
+
+/// @class ValidationOptions
+/// A set of options for controlling the behavior of document validation.
+class MX_CORE_API ValidationOptions
+{
+  public:
+    ValidationOptions();
+    ~ValidationOptions() { }
+
+    /// The number of threads used to validate the top-level elements of a
+    /// document concurrently.  The document must not be modified during
+    /// validation, and error descriptions are appended in document order
+    /// regardless of the thread count.  A value of zero selects the number
+    /// of hardware threads.  Defaults to one, which validates serially.
+    unsigned int threadCount;
+};
+
 /// @class Document
 /// A MaterialX document, which represents the top-level element in the
 /// MaterialX ownership hierarchy.
@@ -50,7 +69,12 @@ class MX_CORE_API Document : public GraphElement
     virtual DocumentPtr copy() const
     {
         DocumentPtr doc = createDocument<Document>();
+        if (getElementArena())
+        {
+            doc->setElementArena(ElementArena::create());
+        }
         doc->copyContentFrom(getSelf());
+        doc->_dataLibraries = _dataLibraries;
         return doc;
     }
 
@@ -63,6 +87,63 @@ class MX_CORE_API Document : public GraphElement
     /// Get a list of source URI's referenced by the document
     StringSet getReferencedSourceUris() const;
 
+    /// @name Data Libraries
+    /// @{
+
+    /// Add a reference to a data library within this document.
+    ///
+    /// In contrast to importLibrary, the contents of the library are not
+    /// copied.  Lookups of definition elements such as NodeDefs,
+    /// Implementations and TypeDefs fall through to referenced libraries,
+    /// in the order they were added, when no match is found in this document.
+    /// A single library may be shared by any number of documents, and must
+    /// not be modified while it is referenced.
+    /// @param library The data library document to be referenced.
+    /// @throws Exception if the given library is this document, or
+    ///    references this document through its own data libraries.
+    void addDataLibrary(ConstDocumentPtr library);
+
+    /// Return true if this document references any data libraries.
+    bool hasDataLibraries() const
+    {
+        return !_dataLibraries.empty();
+    }
+
+    /// Return the vector of data libraries referenced by this document.
+    const vector<ConstDocumentPtr>& getDataLibraries() const
+    {
+        return _dataLibraries;
+    }
+
+    /// Remove all data library references from this document.
+    void clearDataLibraries();
+
+    /// Return the first element at the root scope of the referenced data
+    /// libraries with the given name, optionally filtered by the given
+    /// predicate.  Libraries are searched in order, including the libraries
+    /// they reference in turn.
+    ElementPtr getDataLibraryChild(const string& name, ElementPredicate predicate = nullptr) const;
+
+    /// @}
+    /// @name Memory
+    /// @{
+
+    /// Set the arena from which new elements in this document, along with
+    /// their child and attribute containers, are allocated.  An arena
+    /// replaces the individual heap allocations of elements with a small
+    /// number of bulk allocations, reducing the cost of loading and releasing
+    /// large documents.  Elements created before the arena is set, and their
+    /// new children, retain the original allocator.
+    void setElementArena(ElementArenaPtr arena);
+
+    /// Return the arena, if any, from which new elements in this document
+    /// are allocated.
+    ElementArenaPtr getElementArena() const
+    {
+        return Element::getElementArena();
+    }
+
+    /// @}
     /// @name NodeGraph Elements
     /// @{
 
@@ -97,6 +178,8 @@ class MX_CORE_API Document : public GraphElement
     /// Return a vector of all port elements that match the given node name.
     /// Port elements support spatially-varying upstream connections to
     /// nodes, and include both Input and Output elements.
+    /// This method may be called concurrently from multiple threads, provided
+    /// that the document is not modified while it is shared.
     vector<PortElementPtr> getMatchingPorts(const string& nodeName) const;
 
     /// @}
@@ -155,7 +238,7 @@ class MX_CORE_API Document : public GraphElement
     /// Return the GeomPropDef, if any, with the given name.
     GeomPropDefPtr getGeomPropDef(const string& name) const
     {
-        return getChildOfType<GeomPropDef>(name);
+        return getDefinitionOfType<GeomPropDef>(name);
     }
 
     /// Return a vector of all GeomPropDef elements in the document.
@@ -283,7 +366,7 @@ class MX_CORE_API Document : public GraphElement
     /// Return the TypeDef, if any, with the given name.
     TypeDefPtr getTypeDef(const string& name) const
     {
-        return getChildOfType<TypeDef>(name);
+        return getDefinitionOfType<TypeDef>(name);
     }
 
     /// Return a vector of all TypeDef elements in the document.
@@ -340,10 +423,11 @@ class MX_CORE_API Document : public GraphElement
     NodeDefPtr addNodeDefFromGraph(const NodeGraphPtr nodeGraph, const string& nodeDefName, const string& node, const string& version,
                                    bool isDefaultVersion, const string& nodeGroup, string& newGraphName);
 
-    /// Return the NodeDef, if any, with the given name.
+    /// Return the NodeDef, if any, with the given name, searching referenced
+    /// data libraries if no match is found in this document.
     NodeDefPtr getNodeDef(const string& name) const
     {
-        return getChildOfType<NodeDef>(name);
+        return getDefinitionOfType<NodeDef>(name);
     }
 
     /// Return a vector of all NodeDef elements in the document.
@@ -358,7 +442,10 @@ class MX_CORE_API Document : public GraphElement
         removeChildOfType<NodeDef>(name);
     }
 
-    /// Return a vector of all NodeDef elements that match the given node name.
+    /// Return a vector of all NodeDef elements that match the given node name,
+    /// including matches within referenced data libraries.
+    /// This method may be called concurrently from multiple threads, provided
+    /// that the document is not modified while it is shared.
     vector<NodeDefPtr> getMatchingNodeDefs(const string& nodeName) const;
 
     /// @}
@@ -378,7 +465,7 @@ class MX_CORE_API Document : public GraphElement
     /// Return the AttributeDef, if any, with the given name.
     AttributeDefPtr getAttributeDef(const string& name) const
     {
-        return getChildOfType<AttributeDef>(name);
+        return getDefinitionOfType<AttributeDef>(name);
     }
 
     /// Return a vector of all AttributeDef elements in the document.
@@ -410,7 +497,7 @@ class MX_CORE_API Document : public GraphElement
     /// Return the AttributeDef, if any, with the given name.
     TargetDefPtr getTargetDef(const string& name) const
     {
-        return getChildOfType<TargetDef>(name);
+        return getDefinitionOfType<TargetDef>(name);
     }
 
     /// Return a vector of all TargetDef elements in the document.
@@ -503,10 +590,11 @@ class MX_CORE_API Document : public GraphElement
         return addChild<Implementation>(name);
     }
 
-    /// Return the Implementation, if any, with the given name.
+    /// Return the Implementation, if any, with the given name, searching
+    /// referenced data libraries if no match is found in this document.
     ImplementationPtr getImplementation(const string& name) const
     {
-        return getChildOfType<Implementation>(name);
+        return getDefinitionOfType<Implementation>(name);
     }
 
     /// Return a vector of all Implementation elements in the document.
@@ -523,7 +611,10 @@ class MX_CORE_API Document : public GraphElement
 
     /// Return a vector of all node implementations that match the given
     /// NodeDef string.  Note that a node implementation may be either an
-    /// Implementation element or NodeGraph element.
+    /// Implementation element or NodeGraph element.  Matches within referenced
+    /// data libraries are included.
+    /// This method may be called concurrently from multiple threads, provided
+    /// that the document is not modified while it is shared.
     vector<InterfaceElementPtr> getMatchingImplementations(const string& nodeDef) const;
 
     /// @}
@@ -542,7 +633,7 @@ class MX_CORE_API Document : public GraphElement
     /// Return the UnitDef, if any, with the given name.
     UnitDefPtr getUnitDef(const string& name) const
     {
-        return getChildOfType<UnitDef>(name);
+        return getDefinitionOfType<UnitDef>(name);
     }
 
     /// Return a vector of all Member elements in the TypeDef.
@@ -573,7 +664,7 @@ class MX_CORE_API Document : public GraphElement
     /// Return the UnitTypeDef, if any, with the given name.
     UnitTypeDefPtr getUnitTypeDef(const string& name) const
     {
-        return getChildOfType<UnitTypeDef>(name);
+        return getDefinitionOfType<UnitTypeDef>(name);
     }
 
     /// Return a vector of all UnitTypeDef elements in the document.
@@ -654,15 +745,78 @@ class MX_CORE_API Document : public GraphElement
     /// @return True if the document passes all tests, false otherwise.
     bool validate(string* message = nullptr) const override;
 
+    /// Validate that the given document is consistent with the MaterialX
+    /// specification, using the given options.
+    /// @param message An optional output string, to which a description of
+    ///    each error will be appended.
+    /// @param options Options controlling the validation, such as the number
+    ///    of threads used.
+    /// @param categoryTimes An optional output map, to which the time in
+    ///    seconds spent validating top-level elements, including their
+    ///    descendants, will be added for each element category.
+    /// @return True if the document passes all tests, false otherwise.
+    bool validate(string* message, const ValidationOptions& options, ValidationTimeMap* categoryTimes = nullptr) const;
+
     /// @}
     /// @name Utility
     /// @{
 
     /// Invalidate cached data for optimized lookups within the given document.
+    /// The cache will be rebuilt from a full traversal of the document on the
+    /// next lookup.
     void invalidateCache();
 
     /// @}
 
+  protected:
+    friend class Element;
+    friend class GraphElement;
+
+    // Notifications from the element tree, allowing a valid cache to be
+    // updated incrementally rather than rebuilt.  Each notification is
+    // ignored if the cache is already invalid or if the given element is
+    // not connected to this document.
+    void onAddElement(ElementPtr elem);
+    void onRemoveElement(ElementPtr elem);
+    void onBeginAttributeChange(ElementPtr elem);
+    void onEndAttributeChange(ElementPtr elem);
+
+    // Notification of a change that may affect connections between elements,
+    // such as a renamed element or an edited connection attribute.  If the
+    // changed element is given, then the graph elements whose own connections
+    // it may affect are notified as well.
+    void onConnectionChange(ConstElementPtr elem = nullptr);
+
+    // Return true if the given attribute contributes to cached lookups.
+    static bool isCachedAttribute(const string& attrib);
+
+    // Return true if the given attribute affects connections between
+    // elements, without contributing to cached lookups.
+    static bool isConnectionAttribute(const string& attrib);
+
+    // Validate the top-level elements of this document, distributing them
+    // across threads when validating with options.
+    bool validateChildren(string* message) const override;
+
+    // Return a revision number for the connections within this document,
+    // which is incremented by every change that may affect them.  Connections
+    // that graph elements resolve across graphs are discarded when this
+    // number changes.
+    size_t getConnectionRevision() const;
+
+    // Return the child element, if any, with the given name and subclass,
+    // searching referenced data libraries if no match is found.
+    template<class T> shared_ptr<T> getDefinitionOfType(const string& name) const
+    {
+        shared_ptr<T> child = getChildOfType<T>(name);
+        if (!child && !_dataLibraries.empty())
+        {
+            ElementPtr libraryChild = getDataLibraryChild(name, [](ConstElementPtr elem) { return elem->isA<T>(); });
+            child = libraryChild ? libraryChild->asA<T>() : shared_ptr<T>();
+        }
+        return child;
+    }
+
   public:
     static const string CATEGORY;
     static const string CMS_ATTRIBUTE;
@@ -671,6 +825,7 @@ class MX_CORE_API Document : public GraphElement
   private:
     class Cache;
     std::unique_ptr<Cache> _cache;
+    vector<ConstDocumentPtr> _dataLibraries;
 };
 
 /// Create a new Document.
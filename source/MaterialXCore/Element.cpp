@@ -9,7 +9,10 @@
 #include <MaterialXCore/Node.h>
 #include <MaterialXCore/Util.h>
 
+#include <deque>
 #include <iterator>
+#include <mutex>
+#include <unordered_map>
 
 namespace MaterialX
 {
@@ -42,6 +45,13 @@ const string ValueElement::UNIFORM_ATTRIBUTE = "uniform";
 
 Element::CreatorMap Element::_creatorMap;
 
+namespace {
+
+// The number of children beyond which an element maintains a name index.
+const size_t CHILD_MAP_THRESHOLD = 16;
+
+} // anonymous namespace
+
 //
 // Element methods
 //
@@ -54,18 +64,14 @@ bool Element::operator==(const Element& rhs) const
         return false;
     }
 
-    // Compare attributes.
-    if (getAttributeNames() != rhs.getAttributeNames())
+    // Compare attributes.  Since attribute names are interned, their
+    // pointers may be compared directly.
+    if (_attributes != rhs._attributes)
         return false;
-    for (const string& attr : rhs.getAttributeNames())
-    {
-        if (getAttribute(attr) != rhs.getAttribute(attr))
-            return false;
-    }
 
     // Compare children.
-    const vector<ElementPtr>& c1 = getChildren();
-    const vector<ElementPtr>& c2 = rhs.getChildren();
+    const ElementVec& c1 = getChildren();
+    const ElementVec& c2 = rhs.getChildren();
     if (c1.size() != c2.size())
         return false;
     for (size_t i = 0; i < c1.size(); i++)
@@ -84,19 +90,25 @@ bool Element::operator!=(const Element& rhs) const
 void Element::setName(const string& name)
 {
     ElementPtr parent = getParent();
-    if (parent && parent->_childMap.count(name) && name != getName())
+    if (parent && parent->getChild(name) && name != getName())
     {
         throw Exception("Element name is not unique at the given scope: " + name);
     }
 
-    getDocument()->invalidateCache();
-
-    if (parent)
+    if (parent && parent->_childMap)
     {
-        parent->_childMap.erase(getName());
-        parent->_childMap[name] = getSelf();
+        parent->_childMap->erase(getName());
+        (*parent->_childMap)[name] = getSelf();
     }
     _name = name;
+
+    // Connections are resolved by name, so a rename may affect them.
+    ElementPtr root = _root.lock();
+    DocumentPtr doc = root ? root->asA<Document>() : nullptr;
+    if (doc)
+    {
+        doc->onConnectionChange(getSelf());
+    }
 }
 
 string Element::getNamePath(ConstElementPtr relativeTo) const
@@ -133,19 +145,132 @@ ElementPtr Element::getDescendant(const string& namePath) const
     return elem;
 }
 
-void Element::registerChildElement(ElementPtr child)
+namespace
 {
-    getDocument()->invalidateCache();
 
-    _childMap[child->getName()] = child;
+// Set while an element validates its descendants with a single traversal,
+// so that each descendant validates only itself.
+thread_local bool validatingDescendants = false;
+
+class ScopedDescendantValidation
+{
+  public:
+    ScopedDescendantValidation()
+    {
+        validatingDescendants = true;
+    }
+    ~ScopedDescendantValidation()
+    {
+        validatingDescendants = false;
+    }
+};
+
+// Interned names are never released, so their addresses remain stable
+// for the lifetime of the process.  The well-known attribute constants
+// are registered as their own interned copies, so lookups that pass these
+// constants match stored names by pointer alone.
+class InternTable
+{
+  public:
+    InternTable()
+    {
+        const string* wellKnownNames[] =
+        {
+            &Element::NAME_ATTRIBUTE, &Element::FILE_PREFIX_ATTRIBUTE, &Element::GEOM_PREFIX_ATTRIBUTE,
+            &Element::COLOR_SPACE_ATTRIBUTE, &Element::INHERIT_ATTRIBUTE, &Element::NAMESPACE_ATTRIBUTE,
+            &Element::DOC_ATTRIBUTE, &TypedElement::TYPE_ATTRIBUTE, &ValueElement::VALUE_ATTRIBUTE,
+            &ValueElement::INTERFACE_NAME_ATTRIBUTE, &ValueElement::ENUM_ATTRIBUTE,
+            &ValueElement::IMPLEMENTATION_NAME_ATTRIBUTE, &ValueElement::IMPLEMENTATION_TYPE_ATTRIBUTE,
+            &ValueElement::ENUM_VALUES_ATTRIBUTE, &ValueElement::UI_NAME_ATTRIBUTE,
+            &ValueElement::UI_FOLDER_ATTRIBUTE, &ValueElement::UI_MIN_ATTRIBUTE, &ValueElement::UI_MAX_ATTRIBUTE,
+            &ValueElement::UI_SOFT_MIN_ATTRIBUTE, &ValueElement::UI_SOFT_MAX_ATTRIBUTE,
+            &ValueElement::UI_STEP_ATTRIBUTE, &ValueElement::UI_ADVANCED_ATTRIBUTE,
+            &ValueElement::UNIT_ATTRIBUTE, &ValueElement::UNITTYPE_ATTRIBUTE, &ValueElement::UNIFORM_ATTRIBUTE,
+            &NodeDef::NODE_ATTRIBUTE, &NodeDef::NODE_GROUP_ATTRIBUTE, &Implementation::FILE_ATTRIBUTE,
+            &Implementation::FUNCTION_ATTRIBUTE, &Document::CMS_ATTRIBUTE, &Document::CMS_CONFIG_ATTRIBUTE,
+            &GeomElement::GEOM_ATTRIBUTE, &GeomElement::COLLECTION_ATTRIBUTE,
+            &PortElement::NODE_NAME_ATTRIBUTE, &PortElement::NODE_GRAPH_ATTRIBUTE,
+            &PortElement::OUTPUT_ATTRIBUTE, &PortElement::CHANNELS_ATTRIBUTE,
+            &InterfaceElement::NODE_DEF_ATTRIBUTE, &InterfaceElement::TARGET_ATTRIBUTE,
+            &InterfaceElement::VERSION_ATTRIBUTE, &InterfaceElement::DEFAULT_VERSION_ATTRIBUTE,
+            &Input::DEFAULT_GEOM_PROP_ATTRIBUTE, &Output::DEFAULT_INPUT_ATTRIBUTE,
+            &MaterialAssign::MATERIAL_ATTRIBUTE, &Visibility::VIEWER_GEOM_ATTRIBUTE,
+            &Visibility::VISIBLE_ATTRIBUTE, &Backdrop::CONTAINS_ATTRIBUTE,
+            &Backdrop::WIDTH_ATTRIBUTE, &Backdrop::HEIGHT_ATTRIBUTE
+        };
+        for (const string* name : wellKnownNames)
+        {
+            _names.emplace(*name, name);
+        }
+    }
+
+    const string* intern(const string& attrib)
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        auto it = _names.find(attrib);
+        if (it != _names.end())
+        {
+            return it->second;
+        }
+        _storage.push_back(attrib);
+        const string* name = &_storage.back();
+        _names.emplace(attrib, name);
+        return name;
+    }
+
+  private:
+    std::mutex _mutex;
+    std::unordered_map<string, const string*> _names;
+    std::deque<string> _storage;
+};
+
+} // anonymous namespace
+
+const string* Element::internAttributeName(const string& attrib)
+{
+    static InternTable internTable;
+    return internTable.intern(attrib);
+}
+
+ElementPtr Element::resolveDataLibraryReference(const string& name, ElementPredicate predicate) const
+{
+    ConstDocumentPtr doc = getDocument();
+    if (!doc || !doc->hasDataLibraries())
+    {
+        return ElementPtr();
+    }
+
+    ElementPtr child = doc->getDataLibraryChild(getQualifiedName(name), predicate);
+    return child ? child : doc->getDataLibraryChild(name, predicate);
+}
+
+void Element::registerChildElement(ElementPtr child)
+{
     _childOrder.push_back(child);
+    if (_childMap)
+    {
+        (*_childMap)[child->getName()] = child;
+    }
+    else if (_childOrder.size() > CHILD_MAP_THRESHOLD)
+    {
+        _childMap.reset(new ChildMap(0, std::hash<string>(), std::equal_to<string>(), _childOrder.get_allocator()));
+        for (const ElementPtr& elem : _childOrder)
+        {
+            (*_childMap)[elem->getName()] = elem;
+        }
+    }
+
+    getDocument()->onAddElement(child);
 }
 
 void Element::unregisterChildElement(ElementPtr child)
 {
-    getDocument()->invalidateCache();
+    getDocument()->onRemoveElement(child);
 
-    _childMap.erase(child->getName());
+    if (_childMap)
+    {
+        _childMap->erase(child->getName());
+    }
     _childOrder.erase(
         std::find(_childOrder.begin(), _childOrder.end(), child));
 }
@@ -153,7 +278,7 @@ void Element::unregisterChildElement(ElementPtr child)
 int Element::getChildIndex(const string& name) const
 {
     ElementPtr child = getChild(name);
-    vector<ElementPtr>::const_iterator it = std::find(_childOrder.begin(), _childOrder.end(), child);
+    ElementVec::const_iterator it = std::find(_childOrder.begin(), _childOrder.end(), child);
     if (it == _childOrder.end())
     {
         return -1;
@@ -164,7 +289,7 @@ int Element::getChildIndex(const string& name) const
 void Element::setChildIndex(const string& name, int index)
 {
     ElementPtr child = getChild(name);
-    vector<ElementPtr>::iterator it = std::find(_childOrder.begin(), _childOrder.end(), child);
+    ElementVec::iterator it = std::find(_childOrder.begin(), _childOrder.end(), child);
     if (it == _childOrder.end())
     {
         return;
@@ -181,36 +306,79 @@ void Element::setChildIndex(const string& name, int index)
 
 void Element::removeChild(const string& name)
 {
-    ElementMap::iterator it = _childMap.find(name);
-    if (it == _childMap.end())
+    ElementPtr child = getChild(name);
+    if (!child)
     {
         return;
     }
 
-    unregisterChildElement(it->second);
+    unregisterChildElement(child);
 }
 
 void Element::setAttribute(const string& attrib, const string& value)
 {
-    getDocument()->invalidateCache();
+    // Namespaces affect the qualified names of all descendants, so a change
+    // invalidates the document cache, while changes to cached attributes
+    // are applied to the cache incrementally.
+    DocumentPtr doc;
+    if (attrib == NAMESPACE_ATTRIBUTE)
+    {
+        getDocument()->invalidateCache();
+    }
+    else if (Document::isCachedAttribute(attrib))
+    {
+        doc = getDocument();
+        doc->onBeginAttributeChange(getSelf());
+    }
+    else if (Document::isConnectionAttribute(attrib))
+    {
+        getDocument()->onConnectionChange(getSelf());
+    }
 
-    if (!_attributeMap.count(attrib))
+    AttributeVec::const_iterator it = findAttribute(attrib);
+    if (it != _attributes.end())
+    {
+        _attributes[it - _attributes.begin()].second = value;
+    }
+    else
     {
-        _attributeOrder.push_back(attrib);
+        _attributes.emplace_back(internAttributeName(attrib), value);
+    }
+    onAttributeChange(attrib);
+
+    if (doc)
+    {
+        doc->onEndAttributeChange(getSelf());
     }
-    _attributeMap[attrib] = value;
 }
 
 void Element::removeAttribute(const string& attrib)
 {
-    StringMap::iterator it = _attributeMap.find(attrib);
-    if (it != _attributeMap.end())
+    AttributeVec::const_iterator it = findAttribute(attrib);
+    if (it != _attributes.end())
     {
-        getDocument()->invalidateCache();
+        DocumentPtr doc;
+        if (attrib == NAMESPACE_ATTRIBUTE)
+        {
+            getDocument()->invalidateCache();
+        }
+        else if (Document::isCachedAttribute(attrib))
+        {
+            doc = getDocument();
+            doc->onBeginAttributeChange(getSelf());
+        }
+        else if (Document::isConnectionAttribute(attrib))
+        {
+            getDocument()->onConnectionChange(getSelf());
+        }
 
-        _attributeMap.erase(it);
-        _attributeOrder.erase(
-            std::find(_attributeOrder.begin(), _attributeOrder.end(), attrib));
+        _attributes.erase(it);
+        onAttributeChange(attrib);
+
+        if (doc)
+        {
+            doc->onEndAttributeChange(getSelf());
+        }
     }
 }
 
@@ -230,7 +398,7 @@ ElementPtr Element::addChildOfCategory(const string& category, string name)
     {
         name = createValidChildName(category + "1");
     }
-    if (_childMap.count(name))
+    if (getChild(name))
     {
         throw Exception("Child name is not unique: " + name);
     }
@@ -339,6 +507,11 @@ TreeIterator Element::traverseTree() const
     return TreeIterator(getSelfNonConst());
 }
 
+ConstTreeIterator Element::traverseTreeConst() const
+{
+    return ConstTreeIterator(this);
+}
+
 GraphIterator Element::traverseGraph() const
 {
     return GraphIterator(getSelfNonConst());
@@ -361,11 +534,26 @@ InheritanceIterator Element::traverseInheritance() const
 
 void Element::copyContentFrom(const ConstElementPtr& source)
 {
-    getDocument()->invalidateCache();
+    DocumentPtr doc = getDocument();
+    bool namespaceChange = hasNamespace() || source->hasNamespace();
+    if (namespaceChange)
+    {
+        doc->invalidateCache();
+        doc->onConnectionChange(getSelf());
+    }
+    else
+    {
+        doc->onBeginAttributeChange(getSelf());
+    }
 
     _sourceUri = source->_sourceUri;
-    _attributeMap = source->_attributeMap;
-    _attributeOrder = source->_attributeOrder;
+    _attributes = source->_attributes;
+    onAttributeChange(EMPTY_STRING);
+
+    if (!namespaceChange)
+    {
+        doc->onEndAttributeChange(getSelf());
+    }
 
     for (auto child : source->getChildren())
     {
@@ -387,11 +575,12 @@ void Element::copyContentFrom(const ConstElementPtr& source)
 void Element::clearContent()
 {
     getDocument()->invalidateCache();
+    getDocument()->onConnectionChange(getSelf());
 
     _sourceUri.clear();
-    _attributeMap.clear();
-    _attributeOrder.clear();
-    _childMap.clear();
+    _attributes.clear();
+    onAttributeChange(EMPTY_STRING);
+    _childMap.reset();
     _childOrder.clear();
 }
 
@@ -404,11 +593,26 @@ bool Element::validate(string* message) const
         bool validInherit = getInheritsFrom() && getInheritsFrom()->getCategory() == getCategory();
         validateRequire(validInherit, res, message, "Invalid element inheritance");
     }
-    for (auto child : getChildren())
+    res = validateChildren(message) && res;
+    validateRequire(!hasInheritanceCycle(), res, message, "Cycle in element inheritance chain");
+    return res;
+}
+
+bool Element::validateChildren(string* message) const
+{
+    // Descendants are validated by the traversal of an ancestor.
+    if (validatingDescendants)
     {
-        res = child->validate(message) && res;
+        return true;
+    }
+
+    bool res = true;
+    ScopedDescendantValidation scopedValidation;
+    ConstTreeIterator it = traverseTreeConst();
+    for (++it; it != ConstTreeIterator::end(); ++it)
+    {
+        res = (*it).validate(message) && res;
     }
-    validateRequire(!hasInheritanceCycle(), res, message, "Cycle in element inheritance chain");
     return res;
 }
 
@@ -492,6 +696,28 @@ string ValueElement::getResolvedValueString(StringResolverPtr resolver) const
     return resolver->resolve(getValueString(), getType());
 }
 
+ValuePtr ValueElement::getValue() const
+{
+    // The cache may be read by concurrent callers, so it is accessed with
+    // atomic operations.  Callers receive a copy of the cached value, so that
+    // edits to the returned value do not affect the element.
+    ValuePtr value = std::atomic_load(&_cachedValue);
+    if (!value)
+    {
+        if (!hasValue())
+        {
+            return ValuePtr();
+        }
+        value = Value::createValueFromStrings(getValueString(), getType());
+        if (!value)
+        {
+            return ValuePtr();
+        }
+        std::atomic_store(&_cachedValue, value);
+    }
+    return value->copy();
+}
+
 ValuePtr ValueElement::getDefaultValue() const
 {
     ConstElementPtr parent = getParent();
@@ -531,6 +757,14 @@ const string& ValueElement::getActiveUnit() const
     return EMPTY_STRING;
 }
 
+void ValueElement::onAttributeChange(const string& attrib)
+{
+    if (attrib.empty() || attrib == VALUE_ATTRIBUTE || attrib == TYPE_ATTRIBUTE)
+    {
+        std::atomic_store(&_cachedValue, ValuePtr());
+    }
+}
+
 bool ValueElement::validate(string* message) const
 {
     bool res = true;
@@ -618,7 +852,7 @@ bool targetStringsMatch(const string& target1, const string& target2)
 string prettyPrint(ConstElementPtr elem)
 {
     string text;
-    for (TreeIterator it = elem->traverseTree().begin(); it != TreeIterator::end(); ++it)
+    for (ConstTreeIterator it = elem->traverseTreeConst().begin(); it != ConstTreeIterator::end(); ++it)
     {
         string indent(it.getElementDepth() * 2, ' ');
         text += indent + it.getElement()->asString() + "\n";
@@ -11,6 +11,7 @@
 
 #include <MaterialXCore/Export.h>
 
+#include <MaterialXCore/Arena.h>
 #include <MaterialXCore/Traversal.h>
 #include <MaterialXCore/Util.h>
 #include <MaterialXCore/Value.h>
@@ -63,6 +64,10 @@ using StringResolverPtr = shared_ptr<StringResolver>;
 /// A hash map from strings to elements
 using ElementMap = std::unordered_map<string, ElementPtr>;
 
+/// A vector of elements, drawing memory from the element arena of the
+/// owning document if one is present
+using ElementVec = vector<ElementPtr, ArenaAllocator<ElementPtr>>;
+
 /// A standard function taking an ElementPtr and returning a boolean.
 using ElementPredicate = std::function<bool(ConstElementPtr)>;
 
@@ -77,6 +82,8 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     Element(ElementPtr parent, const string& category, const string& name) :
         _category(category),
         _name(name),
+        _childOrder(parent ? parent->_childOrder.get_allocator() : ElementVec::allocator_type()),
+        _attributes(_childOrder.get_allocator()),
         _parent(parent),
         _root(parent ? parent->getRoot() : nullptr)
     {
@@ -374,7 +381,8 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     /// matches are required.
     template<class T> bool isA(const string& category = EMPTY_STRING) const
     {
-        if (!asA<T>())
+        const T* typed = dynamic_cast<const T*>(this);
+        if (!typed)
             return false;
         if (!category.empty() && getCategory() != category)
             return false;
@@ -422,8 +430,19 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     /// Return the child element, if any, with the given name.
     ElementPtr getChild(const string& name) const
     {
-        ElementMap::const_iterator it = _childMap.find(name);
-        return (it != _childMap.end()) ? it->second : ElementPtr();
+        if (_childMap)
+        {
+            ChildMap::const_iterator it = _childMap->find(name);
+            return (it != _childMap->end()) ? it->second : ElementPtr();
+        }
+        for (const ElementPtr& child : _childOrder)
+        {
+            if (child->getName() == name)
+            {
+                return child;
+            }
+        }
+        return ElementPtr();
     }
 
     /// Return the child element, if any, with the given name and subclass.
@@ -437,7 +456,7 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
 
     /// Return a constant vector of all child elements.
     /// The returned vector maintains the order in which children were added.
-    const vector<ElementPtr>& getChildren() const
+    const ElementVec& getChildren() const
     {
         return _childOrder;
     }
@@ -490,21 +509,27 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     /// Return true if the given attribute is present.
     bool hasAttribute(const string& attrib) const
     {
-        return _attributeMap.count(attrib) != 0;
+        return findAttribute(attrib) != _attributes.end();
     }
 
     /// Return the value string of the given attribute.  If the given attribute
     /// is not present, then an empty string is returned.
     const string& getAttribute(const string& attrib) const
     {
-        StringMap::const_iterator it = _attributeMap.find(attrib);
-        return (it != _attributeMap.end()) ? it->second : EMPTY_STRING;
+        AttributeVec::const_iterator it = findAttribute(attrib);
+        return (it != _attributes.end()) ? it->second : EMPTY_STRING;
     }
 
     /// Return a vector of stored attribute names, in the order they were set.
-    const StringVec& getAttributeNames() const
+    StringVec getAttributeNames() const
     {
-        return _attributeOrder;
+        StringVec names;
+        names.reserve(_attributes.size());
+        for (const Attribute& attr : _attributes)
+        {
+            names.push_back(*attr.first);
+        }
+        return names;
     }
 
     /// Set the value of an implicitly typed attribute.  Since an attribute
@@ -615,6 +640,21 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     /// @endcode
     TreeIterator traverseTree() const;
 
+    /// Traverse the tree from the given element to each of its descendants in
+    /// depth-first order, visiting each element by const reference.  This is
+    /// the preferred method for read-only traversals of large documents, as
+    /// no shared pointers are copied as the traversal proceeds.  The tree must
+    /// not be modified during the traversal.
+    /// @return A ConstTreeIterator object.
+    /// @details Example usage with an implicit iterator:
+    /// @code
+    /// for (const Element& elem : inputElem->traverseTreeConst())
+    /// {
+    ///     cout << elem.asString() << endl;
+    /// }
+    /// @endcode
+    ConstTreeIterator traverseTreeConst() const;
+
     /// Traverse the dataflow graph from the given element to each of its
     /// upstream sources in depth-first order, using pre-order visitation.
     /// @throws ExceptionFoundCycle if a cycle is encountered.
@@ -752,7 +792,7 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     string createValidChildName(string name) const
     {
         name = createValidName(name);
-        while (_childMap.count(name))
+        while (getChild(name))
         {
             name = incrementName(name);
         }
@@ -775,11 +815,22 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
 
     /// Resolve a reference to a named element at the root scope of this document,
     /// taking the namespace at the scope of this element into account.
+    /// If no match is found in the document itself, then the data libraries
+    /// referenced by the document are searched in order.
     template<class T> shared_ptr<T> resolveRootNameReference(const string& name) const
     {
         ConstElementPtr root = getRoot();
         shared_ptr<T> child = root->getChildOfType<T>(getQualifiedName(name));
-        return child ? child : root->getChildOfType<T>(name);
+        if (!child)
+        {
+            child = root->getChildOfType<T>(name);
+        }
+        if (!child)
+        {
+            ElementPtr libraryChild = resolveDataLibraryReference(name, [](ConstElementPtr elem) { return elem->isA<T>(); });
+            child = libraryChild ? libraryChild->asA<T>() : shared_ptr<T>();
+        }
+        return child;
     }
 
     /// @}
@@ -789,6 +840,15 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     // state and optional output text if the requirement is not met.
     void validateRequire(bool expression, bool& res, string* message, string errorDesc) const;
 
+    // Validate each descendant of this element in a single read-only
+    // traversal, appending a description of any errors to the optional
+    // output text.
+    virtual bool validateChildren(string* message) const;
+
+    // Notify this element that the given attribute has been set or removed.
+    // An empty attribute name indicates that any attribute may have changed.
+    virtual void onAttributeChange(const string&) { }
+
   public:
     static const string NAME_ATTRIBUTE;
     static const string FILE_PREFIX_ATTRIBUTE;
@@ -799,6 +859,10 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     static const string DOC_ATTRIBUTE;
 
   protected:
+    // Resolve a reference to a named element within the data libraries of
+    // the root document, returning the first element matching the predicate.
+    ElementPtr resolveDataLibraryReference(const string& name, ElementPredicate predicate) const;
+
     virtual void registerChildElement(ElementPtr child);
     virtual void unregisterChildElement(ElementPtr child);
 
@@ -814,18 +878,58 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     string _name;
     string _sourceUri;
 
-    ElementMap _childMap;
-    vector<ElementPtr> _childOrder;
+    // Children are stored in the order they were added, with a name index
+    // that is only constructed once the child count exceeds a threshold.
+    // Both draw memory from the element arena of the parent, if any.
+    using ChildMap = std::unordered_map<string, ElementPtr, std::hash<string>, std::equal_to<string>,
+                                        ArenaAllocator<std::pair<const string, ElementPtr>>>;
+    ElementVec _childOrder;
+    std::unique_ptr<ChildMap> _childMap;
 
-    StringMap _attributeMap;
-    StringVec _attributeOrder;
+    // Attributes are stored as a flat vector of name and value pairs in the
+    // order they were set, with names interned in a global table.
+    using Attribute = std::pair<const string*, string>;
+    using AttributeVec = vector<Attribute, ArenaAllocator<Attribute>>;
+    AttributeVec _attributes;
 
     weak_ptr<Element> _parent;
     weak_ptr<Element> _root;
 
+    // Return the element arena, if any, from which the children and
+    // attributes of this element are allocated.
+    ElementArenaPtr getElementArena() const
+    {
+        return _childOrder.get_allocator().getArena();
+    }
+
+    // Return an iterator to the stored attribute with the given name.  Names
+    // passed as the well-known attribute constants match by pointer, while
+    // other names fall back to a string compare against the few entries.
+    AttributeVec::const_iterator findAttribute(const string& attrib) const
+    {
+        return std::find_if(_attributes.begin(), _attributes.end(),
+                            [&attrib](const Attribute& attr) { return attr.first == &attrib || *attr.first == attrib; });
+    }
+
+    // Return the interned copy of the given attribute name, adding it to the
+    // global table if needed.
+    static const string* internAttributeName(const string& attrib);
+
   private:
     template <class T> static ElementPtr createElement(ElementPtr parent, const string& name)
     {
+        return allocateElement<T>(parent, name);
+    }
+
+    // Allocate a new element of the given subclass, drawing memory from the
+    // arena of its parent if one is present.
+    template <class T> static shared_ptr<T> allocateElement(ElementPtr parent, const string& name)
+    {
+        ElementArenaPtr arena = parent ? parent->getElementArena() : nullptr;
+        if (arena)
+        {
+            return std::allocate_shared<T>(ArenaAllocator<T>(arena), parent, name);
+        }
         return std::make_shared<T>(parent, name);
     }
 
@@ -1003,14 +1107,13 @@ class MX_CORE_API ValueElement : public TypedElement
     /// Return the typed value of an element as a generic value object, which
     /// may be queried to access its data.
     ///
+    /// The parsed value is cached by the element, and each caller receives
+    /// its own copy of the cached value.  The cache is cleared when the value
+    /// or type attribute changes.
+    ///
     /// @return A shared pointer to the typed value of this element, or an
     ///    empty shared pointer if no value is present.
-    ValuePtr getValue() const
-    {
-        if (!hasValue())
-            return ValuePtr();
-        return Value::createValueFromStrings(getValueString(), getType());
-    }
+    ValuePtr getValue() const;
 
     /// Return the resolved value of an element as a generic value object, which
     /// may be queried to access its data.
@@ -1122,6 +1225,14 @@ class MX_CORE_API ValueElement : public TypedElement
     static const string UNIT_ATTRIBUTE;
     static const string UNITTYPE_ATTRIBUTE;
     static const string UNIFORM_ATTRIBUTE;
+
+  protected:
+    void onAttributeChange(const string& attrib) override;
+
+  private:
+    // The parsed value of this element, which is built on first access and
+    // cleared when the value or type attribute changes.
+    mutable ValuePtr _cachedValue;
 };
 
 /// @class Token
@@ -1315,10 +1426,10 @@ template<class T> shared_ptr<T> Element::addChild(const string& name)
         childName = createValidChildName(T::CATEGORY + "1");
     }
 
-    if (_childMap.count(childName))
+    if (getChild(childName))
         throw Exception("Child name is not unique: " + childName);
 
-    shared_ptr<T> child = std::make_shared<T>(getSelf(), childName);
+    shared_ptr<T> child = allocateElement<T>(getSelf(), childName);
     registerChildElement(child);
 
     return child;
@@ -372,7 +372,7 @@ Edge Output::getUpstreamEdge(size_t index) const
 {
     if (index < getUpstreamEdgeCount())
     {
-        return Edge(getSelfNonConst(), nullptr, getConnectedNode());
+        return Edge(getSelfNonConst(), nullptr, GraphElement::getIndexedConnectedNode(*this));
     }
 
     return NULL_EDGE;
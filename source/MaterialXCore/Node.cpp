@@ -7,8 +7,13 @@
 
 #include <MaterialXCore/Document.h>
 #include <MaterialXCore/Material.h>
+#include <MaterialXCore/Util.h>
 
 #include <deque>
+#include <iterator>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace MaterialX
 {
@@ -17,6 +22,540 @@ const string Backdrop::CONTAINS_ATTRIBUTE = "contains";
 const string Backdrop::WIDTH_ATTRIBUTE = "width";
 const string Backdrop::HEIGHT_ATTRIBUTE = "height";
 
+namespace {
+
+// Return all downstream ports that connect to the given node, ordered by
+// the names of the port elements.
+vector<PortElementPtr> findDownstreamPorts(const Node& node)
+{
+    vector<PortElementPtr> downstreamPorts;
+    for (PortElementPtr port : node.getDocument()->getMatchingPorts(node.getName()))
+    {
+        if (port->getConnectedNode().get() == &node)
+        {
+            downstreamPorts.push_back(port);
+        }
+    }
+    std::sort(downstreamPorts.begin(), downstreamPorts.end(), [](const ConstElementPtr& a, const ConstElementPtr& b)
+    {
+        return a->getName() > b->getName();
+    });
+    return downstreamPorts;
+}
+
+// Return true if the connection of the given port is resolved within the
+// graph that contains it, depending only on the elements of that graph.
+// Connections through nodegraph references, named outputs, the inputs of
+// node graphs, and connected interface inputs reach into other graphs.
+bool isLocalConnection(const PortElement& port)
+{
+    if (port.hasNodeGraphString() || port.hasOutputString())
+    {
+        return false;
+    }
+    const Input* input = dynamic_cast<const Input*>(&port);
+    if (input)
+    {
+        ConstElementPtr parent = input->getParent();
+        if (!parent || parent->isA<NodeGraph>())
+        {
+            return false;
+        }
+        InputPtr interfaceInput = input->getInterfaceInput();
+        if (interfaceInput && (interfaceInput->hasNodeName() || interfaceInput->hasNodeGraphString()))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Computes structural hashes of nodes, caching the hash of each node so that
+// shared upstream nodes are only visited once.
+class StructuralHasher
+{
+  public:
+    // Return the structural hash of the given node and its upstream graph.
+    uint64_t hashNode(ConstNodePtr root)
+    {
+        // Visit upstream nodes depth-first without recursion, as graphs may
+        // be arbitrarily deep.
+        vector<std::pair<ConstNodePtr, bool>> stack;
+        stack.emplace_back(root, false);
+        while (!stack.empty())
+        {
+            ConstNodePtr node = stack.back().first;
+            if (_hashMap.count(node.get()))
+            {
+                stack.pop_back();
+                continue;
+            }
+            if (!stack.back().second)
+            {
+                stack.back().second = true;
+                _visiting.insert(node.get());
+                for (const ElementPtr& child : node->getChildren())
+                {
+                    ConstNodePtr upstreamNode = getUpstream(child).first;
+                    if (upstreamNode && !_hashMap.count(upstreamNode.get()))
+                    {
+                        if (_visiting.count(upstreamNode.get()))
+                        {
+                            throw ExceptionFoundCycle("Encountered a cycle at node: " + upstreamNode->getNamePath());
+                        }
+                        stack.emplace_back(upstreamNode, false);
+                    }
+                }
+                continue;
+            }
+
+            FnvHash digest;
+            addElement(digest, *node);
+            _hashMap[node.get()] = digest.get();
+            _visiting.erase(node.get());
+            stack.pop_back();
+        }
+        return _hashMap[root.get()];
+    }
+
+    // Return the structural hash of the given graph, combining its interface
+    // inputs, its outputs, and the nodes that have no downstream ports.
+    uint64_t hashGraph(const GraphElement& graph)
+    {
+        vector<uint64_t> terminalHashes;
+        for (const NodePtr& node : graph.getNodes())
+        {
+            if (node->getDownstreamPorts().empty())
+            {
+                terminalHashes.push_back(hashNode(node));
+            }
+        }
+        std::sort(terminalHashes.begin(), terminalHashes.end());
+
+        FnvHash digest;
+        digest.add(graph.getCategory());
+        addAttributes(digest, graph);
+        for (const ElementPtr& port : getSortedChildren(graph))
+        {
+            if (port->isA<Input>() || port->isA<Output>())
+            {
+                hashUpstream(port);
+                addChild(digest, port);
+            }
+        }
+        digest.add((uint64_t) terminalHashes.size());
+        for (uint64_t hash : terminalHashes)
+        {
+            digest.add(hash);
+        }
+        return digest.get();
+    }
+
+    // Return true if the given nodes and their upstream graphs are
+    // structurally identical, confirming that matching hashes are not the
+    // result of a collision.
+    bool isEqual(ConstNodePtr first, ConstNodePtr second)
+    {
+        NodePairVec stack;
+        stack.emplace_back(first, second);
+        std::set<std::pair<const Node*, const Node*>> visited;
+        while (!stack.empty())
+        {
+            NodePair pair = stack.back();
+            stack.pop_back();
+            if (pair.first == pair.second || !visited.emplace(pair.first.get(), pair.second.get()).second)
+            {
+                continue;
+            }
+            if (hashNode(pair.first) != hashNode(pair.second) ||
+                !isElementEqual(*pair.first, *pair.second, stack))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+  private:
+    using NodePair = std::pair<ConstNodePtr, ConstNodePtr>;
+    using NodePairVec = vector<NodePair>;
+    using AttributeVec = vector<std::pair<string, string>>;
+
+    // Return the upstream node, if any, and the name of its output to which
+    // the given port element is connected.
+    std::pair<ConstNodePtr, string> getUpstream(const ConstElementPtr& elem) const
+    {
+        ConstInputPtr input = elem->asA<Input>();
+        if (input)
+        {
+            InputPtr interfaceInput = input->getInterfaceInput();
+            if (interfaceInput && (interfaceInput->hasNodeName() || interfaceInput->hasNodeGraphString()))
+            {
+                return getUpstream(interfaceInput);
+            }
+            if (input->hasNodeGraphString() || (!input->hasNodeName() && input->hasOutputString()))
+            {
+                OutputPtr output = input->getConnectedOutput();
+                if (output)
+                {
+                    return std::make_pair(output->getConnectedNode(), output->getOutputString());
+                }
+                return std::make_pair(ConstNodePtr(), EMPTY_STRING);
+            }
+        }
+        ConstPortElementPtr port = elem->asA<PortElement>();
+        if (port && port->hasNodeName())
+        {
+            return std::make_pair(port->getConnectedNode(), port->getOutputString());
+        }
+        return std::make_pair(ConstNodePtr(), EMPTY_STRING);
+    }
+
+    // Compute the hashes of the upstream node of the given element.
+    void hashUpstream(const ConstElementPtr& elem)
+    {
+        ConstNodePtr upstreamNode = getUpstream(elem).first;
+        if (upstreamNode)
+        {
+            hashNode(upstreamNode);
+        }
+    }
+
+    // Add the category, attributes and children of the given element to the
+    // digest.  The hashes of all upstream nodes must already be computed.
+    void addElement(FnvHash& digest, const Element& elem)
+    {
+        digest.add(elem.getCategory());
+        addAttributes(digest, elem);
+        for (const ElementPtr& child : getSortedChildren(elem))
+        {
+            addChild(digest, child);
+        }
+    }
+
+    // Add a child element, which is identified by its name, along with the
+    // hash of any upstream node to which it is connected.
+    void addChild(FnvHash& digest, const ConstElementPtr& child)
+    {
+        digest.add(child->getName());
+        addElement(digest, *child);
+
+        std::pair<ConstNodePtr, string> upstream = getUpstream(child);
+        ConstPortElementPtr port = child->asA<PortElement>();
+        if (upstream.first)
+        {
+            digest.add((uint64_t) 1);
+            digest.add(_hashMap.at(upstream.first.get()));
+            digest.add(upstream.second);
+        }
+        else if (port && (port->hasNodeName() || port->hasNodeGraphString()))
+        {
+            // Unresolved connections fall back to the referenced names.
+            digest.add((uint64_t) 2);
+            digest.add(port->getNodeName());
+            digest.add(port->getNodeGraphString());
+            digest.add(port->getOutputString());
+        }
+    }
+
+    // Add the attributes of the given element in sorted order, skipping
+    // connection attributes, which are replaced by the hashes of upstream
+    // nodes, and attributes that do not affect the meaning of the element.
+    static void addAttributes(FnvHash& digest, const Element& elem)
+    {
+        for (const auto& attr : getSortedAttributes(elem))
+        {
+            digest.add(attr.first);
+            digest.add(attr.second);
+        }
+        digest.add(EMPTY_STRING);
+    }
+
+    // Return true if the given elements have the same category, attributes
+    // and children, adding the pairs of upstream nodes to which their
+    // children are connected to the given stack for comparison.
+    bool isElementEqual(const Element& first, const Element& second, NodePairVec& stack) const
+    {
+        if (first.getCategory() != second.getCategory() ||
+            getSortedAttributes(first) != getSortedAttributes(second))
+        {
+            return false;
+        }
+
+        vector<ElementPtr> firstChildren = getSortedChildren(first);
+        vector<ElementPtr> secondChildren = getSortedChildren(second);
+        if (firstChildren.size() != secondChildren.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < firstChildren.size(); i++)
+        {
+            const ElementPtr& firstChild = firstChildren[i];
+            const ElementPtr& secondChild = secondChildren[i];
+            if (firstChild->getName() != secondChild->getName() ||
+                !isElementEqual(*firstChild, *secondChild, stack))
+            {
+                return false;
+            }
+
+            std::pair<ConstNodePtr, string> firstUpstream = getUpstream(firstChild);
+            std::pair<ConstNodePtr, string> secondUpstream = getUpstream(secondChild);
+            if (!firstUpstream.first != !secondUpstream.first ||
+                firstUpstream.second != secondUpstream.second)
+            {
+                return false;
+            }
+            if (firstUpstream.first)
+            {
+                stack.emplace_back(firstUpstream.first, secondUpstream.first);
+                continue;
+            }
+
+            // Unresolved connections are compared by the referenced names.
+            ConstPortElementPtr firstPort = firstChild->asA<PortElement>();
+            ConstPortElementPtr secondPort = secondChild->asA<PortElement>();
+            if (firstPort && secondPort &&
+                (firstPort->getNodeName() != secondPort->getNodeName() ||
+                 firstPort->getNodeGraphString() != secondPort->getNodeGraphString() ||
+                 firstPort->getOutputString() != secondPort->getOutputString()))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Return the attributes of the given element sorted by name, skipping
+    // connection attributes, which are replaced by the hashes of upstream
+    // nodes, and attributes that do not affect the meaning of the element.
+    static AttributeVec getSortedAttributes(const Element& elem)
+    {
+        static const std::set<string> IGNORED_ATTRIBUTES =
+        {
+            PortElement::NODE_NAME_ATTRIBUTE,
+            PortElement::NODE_GRAPH_ATTRIBUTE,
+            PortElement::OUTPUT_ATTRIBUTE,
+            Element::DOC_ATTRIBUTE,
+            ValueElement::UI_NAME_ATTRIBUTE,
+            ValueElement::UI_FOLDER_ATTRIBUTE,
+            "xpos",
+            "ypos"
+        };
+
+        AttributeVec attributes;
+        for (const string& attrName : elem.getAttributeNames())
+        {
+            if (!IGNORED_ATTRIBUTES.count(attrName))
+            {
+                attributes.emplace_back(attrName, elem.getAttribute(attrName));
+            }
+        }
+        std::sort(attributes.begin(), attributes.end());
+        return attributes;
+    }
+
+    // Return the children of the given element, excluding nodes and
+    // backdrops, sorted by name.
+    static vector<ElementPtr> getSortedChildren(const Element& elem)
+    {
+        vector<ElementPtr> children;
+        for (const ElementPtr& child : elem.getChildren())
+        {
+            if (!child->isA<Node>() && !child->isA<Backdrop>())
+            {
+                children.push_back(child);
+            }
+        }
+        std::sort(children.begin(), children.end(), [](const ElementPtr& a, const ElementPtr& b)
+        {
+            return a->getName() < b->getName();
+        });
+        return children;
+    }
+
+  private:
+    std::unordered_map<const Node*, uint64_t> _hashMap;
+    std::unordered_set<const Node*> _visiting;
+};
+
+} // anonymous namespace
+
+//
+// GraphElement::ConnectionIndex methods
+//
+
+class GraphElement::ConnectionIndex
+{
+  public:
+    ConnectionIndex(const GraphElement& graph, size_t graphRevision, size_t documentRevision) :
+        graphRevision(graphRevision),
+        documentRevision(documentRevision),
+        _graph(graph),
+        _localDownstreamValid(false)
+    {
+    }
+
+    // Discard the connections that reach into other graphs, which may have
+    // changed with the given document revision.
+    void clearCrossGraphConnections(size_t revision)
+    {
+        documentRevision = revision;
+        for (auto it = _upstreamMap.begin(); it != _upstreamMap.end();)
+        {
+            it = it->second.local ? std::next(it) : _upstreamMap.erase(it);
+        }
+        _downstreamPortMap.clear();
+    }
+
+    // Return the node connected upstream of the given port of this graph.
+    NodePtr getUpstreamNode(const PortElement& port)
+    {
+        return getUpstreamEntry(port).node;
+    }
+
+    // Return the number of connected upstream edges of the given child element.
+    size_t getUpstreamConnectionCount(const Element& elem)
+    {
+        size_t connectionCount = 0;
+        const Node* node = dynamic_cast<const Node*>(&elem);
+        const Output* output = dynamic_cast<const Output*>(&elem);
+        if (node)
+        {
+            for (const InputPtr& input : node->getInputs())
+            {
+                if (getUpstreamEntry(*input).node)
+                {
+                    connectionCount++;
+                }
+            }
+        }
+        else if (output)
+        {
+            if (getUpstreamEntry(*output).node)
+            {
+                connectionCount++;
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < elem.getUpstreamEdgeCount(); ++i)
+            {
+                if (elem.getUpstreamEdge(i))
+                {
+                    connectionCount++;
+                }
+            }
+        }
+        return connectionCount;
+    }
+
+    // Return the downstream ports of the given child node, combining the
+    // ports whose connections are resolved within this graph with the
+    // matching ports whose connections reach across graphs.
+    const vector<PortElementPtr>& getDownstreamPorts(const Node& node)
+    {
+        auto it = _downstreamPortMap.find(&node);
+        if (it != _downstreamPortMap.end())
+        {
+            return it->second;
+        }
+
+        if (!_localDownstreamValid)
+        {
+            buildLocalDownstreamPorts();
+        }
+        vector<PortElementPtr> downstreamPorts;
+        auto localIt = _localDownstreamMap.find(&node);
+        if (localIt != _localDownstreamMap.end())
+        {
+            downstreamPorts = localIt->second;
+        }
+        for (PortElementPtr port : node.getDocument()->getMatchingPorts(node.getName()))
+        {
+            if (port->getAncestorOfType<GraphElement>().get() == &_graph)
+            {
+                const UpstreamEntry& entry = getUpstreamEntry(*port);
+                if (!entry.local && entry.node.get() == &node)
+                {
+                    downstreamPorts.push_back(port);
+                }
+            }
+            else if (port->getConnectedNode().get() == &node)
+            {
+                downstreamPorts.push_back(port);
+            }
+        }
+        std::sort(downstreamPorts.begin(), downstreamPorts.end(), [](const ConstElementPtr& a, const ConstElementPtr& b)
+        {
+            return a->getName() > b->getName();
+        });
+        return _downstreamPortMap.emplace(&node, std::move(downstreamPorts)).first->second;
+    }
+
+  private:
+    struct UpstreamEntry
+    {
+        NodePtr node;
+        bool local;
+    };
+
+    const UpstreamEntry& getUpstreamEntry(const PortElement& port)
+    {
+        auto it = _upstreamMap.find(&port);
+        if (it == _upstreamMap.end())
+        {
+            UpstreamEntry entry = { port.getConnectedNode(), isLocalConnection(port) };
+            it = _upstreamMap.emplace(&port, std::move(entry)).first;
+        }
+        return it->second;
+    }
+
+    // Record the ports of this graph and of its nodes whose connections are
+    // resolved within this graph, under the nodes they connect to.
+    void buildLocalDownstreamPorts()
+    {
+        auto addPort = [this](const PortElementPtr& port)
+        {
+            const UpstreamEntry& entry = getUpstreamEntry(*port);
+            if (entry.local && entry.node && port->getNodeName() == entry.node->getName())
+            {
+                _localDownstreamMap[entry.node.get()].push_back(port);
+            }
+        };
+        for (const ElementPtr& child : _graph.getChildren())
+        {
+            PortElementPtr port = child->asA<PortElement>();
+            if (port)
+            {
+                addPort(port);
+            }
+            else if (child->isA<Node>())
+            {
+                for (const ElementPtr& grandchild : child->getChildren())
+                {
+                    port = grandchild->asA<PortElement>();
+                    if (port)
+                    {
+                        addPort(port);
+                    }
+                }
+            }
+        }
+        _localDownstreamValid = true;
+    }
+
+  public:
+    size_t graphRevision;
+    size_t documentRevision;
+
+  private:
+    const GraphElement& _graph;
+    std::unordered_map<const PortElement*, UpstreamEntry> _upstreamMap;
+    std::unordered_map<const Node*, vector<PortElementPtr>> _localDownstreamMap;
+    bool _localDownstreamValid;
+    std::unordered_map<const Node*, vector<PortElementPtr>> _downstreamPortMap;
+};
+
 //
 // Node methods
 //
@@ -42,7 +581,7 @@ NodePtr Node::getConnectedNode(const string& inputName) const
     {
         return NodePtr();
     }
-    return input->getConnectedNode();    
+    return GraphElement::getIndexedConnectedNode(*input);
 }
 
 void Node::setConnectedNodeName(const string& inputName, const string& nodeName)
@@ -115,7 +654,7 @@ Edge Node::getUpstreamEdge(size_t index) const
     if (index < getUpstreamEdgeCount())
     {
         InputPtr input = getInputs()[index];
-        ElementPtr upstreamNode = input->getConnectedNode();
+        ElementPtr upstreamNode = GraphElement::getIndexedConnectedNode(*input);
         if (upstreamNode)
         {
             return Edge(getSelfNonConst(), input, upstreamNode);
@@ -179,19 +718,21 @@ OutputPtr Node::getNodeDefOutput(ElementPtr connectingElement)
 
 vector<PortElementPtr> Node::getDownstreamPorts() const
 {
-    vector<PortElementPtr> downstreamPorts;
-    for (PortElementPtr port : getDocument()->getMatchingPorts(getName()))
+    // Consult the connection index of the parent graph when available.
+    ConstElementPtr parent = getParent();
+    ConstGraphElementPtr graph = parent ? parent->asA<GraphElement>() : nullptr;
+    if (graph)
     {
-        if (port->getConnectedNode() == getSelf())
-        {
-            downstreamPorts.push_back(port);
-        }
+        std::lock_guard<std::mutex> guard(graph->_connectionMutex);
+        return graph->getConnectionIndex().getDownstreamPorts(*this);
     }
-    std::sort(downstreamPorts.begin(), downstreamPorts.end(), [](const ConstElementPtr& a, const ConstElementPtr& b)
-    {
-        return a->getName() > b->getName();
-    });
-    return downstreamPorts;
+    return findDownstreamPorts(*this);
+}
+
+uint64_t Node::getStructuralHash() const
+{
+    StructuralHasher hasher;
+    return hasher.hashNode(getSelf()->asA<Node>());
 }
 
 bool Node::validate(string* message) const
@@ -353,6 +894,108 @@ void GraphElement::flattenSubgraphs(const string& target, NodePredicate filter)
     }
 }
 
+GraphElement::GraphElement(ElementPtr parent, const string& category, const string& name) :
+    InterfaceElement(parent, category, name),
+    _connectionRevision(0)
+{
+}
+
+GraphElement::~GraphElement()
+{
+}
+
+GraphElement::ConnectionIndex& GraphElement::getConnectionIndex() const
+{
+    size_t graphRevision = _connectionRevision.load(std::memory_order_acquire);
+    size_t documentRevision = getDocument()->getConnectionRevision();
+    if (!_connectionIndex || _connectionIndex->graphRevision != graphRevision)
+    {
+        _connectionIndex.reset(new ConnectionIndex(*this, graphRevision, documentRevision));
+    }
+    else if (_connectionIndex->documentRevision != documentRevision)
+    {
+        _connectionIndex->clearCrossGraphConnections(documentRevision);
+    }
+    return *_connectionIndex;
+}
+
+NodePtr GraphElement::getIndexedConnectedNode(const PortElement& port)
+{
+    ConstGraphElementPtr graph = port.getAncestorOfType<GraphElement>();
+    if (!graph)
+    {
+        return port.getConnectedNode();
+    }
+    std::lock_guard<std::mutex> guard(graph->_connectionMutex);
+    return graph->getConnectionIndex().getUpstreamNode(port);
+}
+
+uint64_t GraphElement::getStructuralHash() const
+{
+    StructuralHasher hasher;
+    return hasher.hashGraph(*this);
+}
+
+size_t GraphElement::mergeDuplicateNodes()
+{
+    size_t mergeCount = 0;
+    DocumentPtr doc = asA<Document>();
+    if (doc)
+    {
+        for (NodeGraphPtr nodeGraph : doc->getNodeGraphs())
+        {
+            mergeCount += nodeGraph->mergeDuplicateNodes();
+        }
+    }
+
+    // Hashes are independent of node names, so they remain valid for the
+    // retained nodes as duplicates are rewired and removed.  Nodes with
+    // matching hashes are compared in full before they are merged.  Nodes
+    // are visited from upstream to downstream, so that upstream duplicates
+    // are merged while they still have downstream ports, independent of the
+    // order in which nodes are declared.
+    StructuralHasher hasher;
+    std::unordered_map<uint64_t, vector<NodePtr>> retainedNodes;
+    for (ElementPtr elem : topologicalSort())
+    {
+        NodePtr node = elem->asA<Node>();
+        if (!node)
+        {
+            continue;
+        }
+        vector<PortElementPtr> downstreamPorts = node->getDownstreamPorts();
+        if (downstreamPorts.empty())
+        {
+            continue;
+        }
+
+        vector<NodePtr>& candidates = retainedNodes[hasher.hashNode(node)];
+        NodePtr retainedNode;
+        for (NodePtr candidate : candidates)
+        {
+            if (hasher.isEqual(candidate, node))
+            {
+                retainedNode = candidate;
+                break;
+            }
+        }
+        if (!retainedNode)
+        {
+            candidates.push_back(node);
+            continue;
+        }
+
+        for (PortElementPtr port : downstreamPorts)
+        {
+            port->setNodeName(retainedNode->getName());
+        }
+        removeNode(node->getName());
+        mergeCount++;
+    }
+
+    return mergeCount;
+}
+
 vector<ElementPtr> GraphElement::topologicalSort() const
 {
     // Calculate a topological order of the children, using Kahn's algorithm
@@ -360,23 +1003,19 @@ vector<ElementPtr> GraphElement::topologicalSort() const
     //
     // Running time: O(numNodes + numEdges).
 
-    const vector<ElementPtr>& children = getChildren();
+    const ElementVec& children = getChildren();
+
+    // Resolve connections through the connection index.
+    std::lock_guard<std::mutex> guard(_connectionMutex);
+    ConnectionIndex& index = getConnectionIndex();
 
     // Calculate in-degrees for all children.
-    std::unordered_map<ElementPtr, size_t> inDegree(children.size());
+    std::unordered_map<const Element*, size_t> inDegree(children.size());
     std::deque<ElementPtr> childQueue;
-    for (ElementPtr child : children)
+    for (const ElementPtr& child : children)
     {
-        size_t connectionCount = 0;
-        for (size_t i = 0; i < child->getUpstreamEdgeCount(); ++i)
-        {
-            if (child->getUpstreamEdge(i))
-            {
-                connectionCount++;
-            }
-        }
-
-        inDegree[child] = connectionCount;
+        size_t connectionCount = index.getUpstreamConnectionCount(*child);
+        inDegree[child.get()] = connectionCount;
 
         // Enqueue children with in-degree 0.
         if (connectionCount == 0)
@@ -397,18 +1036,20 @@ vector<ElementPtr> GraphElement::topologicalSort() const
 
         // Find connected nodes and decrease their in-degree, 
         // adding node to the queue if in-degrees becomes 0.
-        if (child->isA<Node>())
+        const Node* node = dynamic_cast<const Node*>(child.get());
+        if (node)
         {
-            for (PortElementPtr port : child->asA<Node>()->getDownstreamPorts())
+            for (const PortElementPtr& port : index.getDownstreamPorts(*node))
             {
                 const ElementPtr downstreamElem = port->isA<Output>() ? port : port->getParent();
-                if (inDegree[downstreamElem] > 1)
+                size_t& degree = inDegree[downstreamElem.get()];
+                if (degree > 1)
                 {
-                    inDegree[downstreamElem]--;
+                    degree--;
                 }
                 else
                 {
-                    inDegree[downstreamElem] = 0;
+                    degree = 0;
                     childQueue.push_back(downstreamElem);
                 }
             }
@@ -13,6 +13,9 @@
 
 #include <MaterialXCore/Definition.h>
 
+#include <atomic>
+#include <mutex>
+
 namespace MaterialX
 {
 
@@ -157,6 +160,16 @@ class MX_CORE_API Node : public InterfaceElement
     /// If the input already exists on the node it will just be returned.
     InputPtr addInputFromNodeDef(const string& name);
 
+    /// Return a structural hash of this node and its upstream graph.
+    ///
+    /// The hash covers the categories, types, attributes and values of the
+    /// node and each upstream node, along with the connections between them,
+    /// but ignores the names of nodes and graphs, so that graphs that differ
+    /// only in naming produce the same hash.  The hash is stable across
+    /// platforms and sessions, and may be used as a persistent cache key.
+    /// @throws ExceptionFoundCycle if a cycle is encountered.
+    uint64_t getStructuralHash() const;
+
     /// @}
     /// @name Validation
     /// @{
@@ -176,12 +189,9 @@ class MX_CORE_API Node : public InterfaceElement
 class MX_CORE_API GraphElement : public InterfaceElement
 {
   protected:
-    GraphElement(ElementPtr parent, const string& category, const string& name) :
-        InterfaceElement(parent, category, name)
-    {
-    }
+    GraphElement(ElementPtr parent, const string& category, const string& name);
   public:
-    virtual ~GraphElement() { }
+    virtual ~GraphElement();
 
     /// @name Node Elements
     /// @{
@@ -299,6 +309,26 @@ class MX_CORE_API GraphElement : public InterfaceElement
     /// @throws ExceptionFoundCycle if a cycle is encountered.
     vector<ElementPtr> topologicalSort() const;
 
+    /// Return a structural hash of this graph, combining its attributes, its
+    /// input and output elements, and the structural hashes of the graphs
+    /// upstream of its outputs and of its nodes without downstream ports.
+    /// As with Node::getStructuralHash, the names of nodes are ignored.
+    /// @throws ExceptionFoundCycle if a cycle is encountered.
+    uint64_t getStructuralHash() const;
+
+    /// Merge structurally identical nodes within this graph, connecting the
+    /// downstream ports of each duplicate node to a single retained node and
+    /// removing the duplicate.  Nodes with matching structural hashes are
+    /// compared along with their upstream graphs, so identical upstream graphs
+    /// collapse to a single copy.
+    ///
+    /// Nodes without downstream ports are left in place, as they may be
+    /// referenced by name from other elements such as material assignments.
+    /// If this graph is a document, then its node graphs are processed as well.
+    /// @return The number of nodes that were merged and removed.
+    /// @throws ExceptionFoundCycle if a cycle is encountered.
+    size_t mergeDuplicateNodes();
+
     /// Convert this graph to a string in the DOT language syntax.  This can be
     /// used to visualise the graph using GraphViz (http://www.graphviz.org).
     ///
@@ -308,6 +338,37 @@ class MX_CORE_API GraphElement : public InterfaceElement
     string asStringDot() const;
 
     /// @}
+
+  protected:
+    friend class Document;
+    friend class Node;
+    friend class Output;
+
+    class ConnectionIndex;
+
+    // Return the connection index of this graph, which caches the resolved
+    // upstream node of each port and the downstream ports of each node.
+    // Connections resolved within this graph are discarded only when this
+    // graph changes, while connections that reach into other graphs are
+    // discarded whenever the connections of the owning document may have
+    // changed.  The caller must hold the connection mutex.
+    ConnectionIndex& getConnectionIndex() const;
+
+    // Return the node connected upstream of the given port, resolved through
+    // the connection index of the graph that contains the port.
+    static NodePtr getIndexedConnectedNode(const PortElement& port);
+
+    // Notification of a change to this graph that may affect the connections
+    // resolved within it.
+    void onGraphConnectionChange()
+    {
+        _connectionRevision.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+  private:
+    std::atomic<size_t> _connectionRevision;
+    mutable std::mutex _connectionMutex;
+    mutable std::unique_ptr<ConnectionIndex> _connectionIndex;
 };
 
 /// @class NodeGraph
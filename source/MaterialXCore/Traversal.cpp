@@ -13,6 +13,7 @@ namespace MaterialX
 const Edge NULL_EDGE(nullptr, nullptr, nullptr);
 
 const TreeIterator NULL_TREE_ITERATOR(nullptr);
+const ConstTreeIterator NULL_CONST_TREE_ITERATOR(nullptr);
 const GraphIterator NULL_GRAPH_ITERATOR(nullptr);
 const InheritanceIterator NULL_INHERITANCE_ITERATOR(nullptr);
 
@@ -67,7 +68,7 @@ TreeIterator& TreeIterator::operator++()
 
         // Traverse to our siblings.
         StackFrame& parentFrame = _stack.back();
-        const vector<ElementPtr>& siblings = parentFrame.first->getChildren();
+        const ElementVec& siblings = parentFrame.first->getChildren();
         if (parentFrame.second + 1 < siblings.size())
         {
             _elem = siblings[++parentFrame.second];
@@ -79,6 +80,49 @@ TreeIterator& TreeIterator::operator++()
     }
 }
 
+//
+// ConstTreeIterator methods
+//
+
+const ConstTreeIterator& ConstTreeIterator::end()
+{
+    return NULL_CONST_TREE_ITERATOR;
+}
+
+ConstTreeIterator& ConstTreeIterator::operator++()
+{
+    if (!_prune && _elem && !_elem->getChildren().empty())
+    {
+        // Traverse to the first child of this element.
+        _stack.emplace_back(_elem, 0);
+        _elem = _elem->getChildren()[0].get();
+        return *this;
+    }
+    _prune = false;
+
+    while (true)
+    {
+        if (_stack.empty())
+        {
+            // Traversal is complete.
+            _elem = nullptr;
+            return *this;
+        }
+
+        // Traverse to our siblings.
+        StackFrame& parentFrame = _stack.back();
+        const ElementVec& siblings = parentFrame.first->getChildren();
+        if (parentFrame.second + 1 < siblings.size())
+        {
+            _elem = siblings[++parentFrame.second].get();
+            return *this;
+        }
+
+        // Traverse to our parent's siblings.
+        _stack.pop_back();
+    }
+}
+
 //
 // GraphIterator methods
 //
@@ -185,6 +185,110 @@ class MX_CORE_API TreeIterator
     size_t _holdCount;
 };
 
+/// @class ConstTreeIterator
+/// An iterator object representing the state of a read-only tree traversal.
+///
+/// Unlike TreeIterator, this iterator visits elements by const reference and
+/// holds no shared pointers, so a traversal performs no reference counting.
+/// The tree must not be modified while the traversal is in progress.
+///
+/// @sa Element::traverseTreeConst
+class MX_CORE_API ConstTreeIterator
+{
+  public:
+    explicit ConstTreeIterator(const Element* elem):
+        _elem(elem),
+        _prune(false)
+    {
+    }
+    ~ConstTreeIterator() { }
+
+  private:
+    using StackFrame = std::pair<const Element*, size_t>;
+
+  public:
+    bool operator==(const ConstTreeIterator& rhs) const
+    {
+        return _elem == rhs._elem &&
+               _stack == rhs._stack &&
+               _prune == rhs._prune;
+    }
+    bool operator!=(const ConstTreeIterator& rhs) const
+    {
+        return !(*this == rhs);
+    }
+
+    /// Dereference this iterator, returning the current element in the
+    /// traversal.
+    const Element& operator*() const
+    {
+        return *_elem;
+    }
+
+    /// Iterate to the next element in the traversal.
+    ConstTreeIterator& operator++();
+
+    /// @name Elements
+    /// @{
+
+    /// Return the current element in the traversal.
+    const Element* getElement() const
+    {
+        return _elem;
+    }
+
+    /// @}
+    /// @name Depth
+    /// @{
+
+    /// Return the element depth of the current traversal, where the starting
+    /// element represents a depth of zero.
+    size_t getElementDepth() const
+    {
+        return _stack.size();
+    }
+
+    /// @}
+    /// @name Pruning
+    /// @{
+
+    /// Set the prune subtree flag, which controls whether the current subtree
+    /// is pruned from traversal.
+    /// @param prune If set to true, then the current subtree will be pruned.
+    void setPruneSubtree(bool prune)
+    {
+        _prune = prune;
+    }
+
+    /// Return the prune subtree flag, which controls whether the current
+    /// subtree is pruned from traversal.
+    bool getPruneSubtree() const
+    {
+        return _prune;
+    }
+
+    /// @}
+    /// @name Range Methods
+    /// @{
+
+    /// Interpret this object as an iteration range, and return its begin
+    /// iterator.
+    ConstTreeIterator& begin()
+    {
+        return *this;
+    }
+
+    /// Return the sentinel end iterator for this class.
+    static const ConstTreeIterator& end();
+
+    /// @}
+
+  private:
+    const Element* _elem;
+    vector<StackFrame> _stack;
+    bool _prune;
+};
+
 /// @class GraphIterator
 /// An iterator object representing the state of an upstream graph traversal.
 ///
@@ -394,6 +498,7 @@ class MX_CORE_API ExceptionFoundCycle : public Exception
 extern MX_CORE_API const Edge NULL_EDGE;
 
 extern MX_CORE_API const TreeIterator NULL_TREE_ITERATOR;
+extern MX_CORE_API const ConstTreeIterator NULL_CONST_TREE_ITERATOR;
 extern MX_CORE_API const GraphIterator NULL_GRAPH_ITERATOR;
 extern MX_CORE_API const InheritanceIterator NULL_INHERITANCE_ITERATOR;
 
@@ -11,6 +11,8 @@
 
 #include <MaterialXCore/Export.h>
 
+#include <cstdint>
+
 namespace MaterialX
 {
 
@@ -54,6 +56,61 @@ template<typename T> void hashCombine(size_t& seed, const T& value)
     seed ^= std::hash<T>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
 } 
 
+/// @class FnvHash
+/// A 64-bit FNV-1a hash, whose values are stable across platforms and
+/// processes.  Integers are hashed as eight little-endian bytes, and strings
+/// are hashed along with their length.
+class MX_CORE_API FnvHash
+{
+  public:
+    explicit FnvHash(uint64_t offsetBasis = OFFSET_BASIS) :
+        _value(offsetBasis)
+    {
+    }
+
+    /// Add an integer to the hash.
+    void add(uint64_t value)
+    {
+        for (int i = 0; i < 8; i++)
+        {
+            addByte((unsigned char) (value >> (i * 8)));
+        }
+    }
+
+    /// Add a string to the hash.
+    void add(const string& str)
+    {
+        add((uint64_t) str.size());
+        for (char c : str)
+        {
+            addByte((unsigned char) c);
+        }
+    }
+
+    /// Return the current value of the hash.
+    uint64_t get() const
+    {
+        return _value;
+    }
+
+  public:
+    /// The standard offset basis of 64-bit FNV-1a.
+    static const uint64_t OFFSET_BASIS = 14695981039346656037ull;
+
+    /// The prime of 64-bit FNV-1a.
+    static const uint64_t PRIME = 1099511628211ull;
+
+  private:
+    void addByte(unsigned char byte)
+    {
+        _value ^= byte;
+        _value *= PRIME;
+    }
+
+  private:
+    uint64_t _value;
+};
+
 /// Split a name path into string vector
 MX_CORE_API StringVec splitNamePath(const string& namePath);
 
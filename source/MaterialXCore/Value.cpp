@@ -5,7 +5,12 @@
 
 #include <MaterialXCore/Value.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <iomanip>
+#include <limits>
 #include <sstream>
 #include <type_traits>
 
@@ -13,11 +18,12 @@ namespace MaterialX
 {
 
 Value::CreatorMap Value::_creatorMap;
-Value::FloatFormat Value::_floatFormat = Value::FloatFormatDefault;
-int Value::_floatPrecision = 6;
 
 namespace {
 
+thread_local Value::FloatFormat floatFormat = Value::FloatFormatDefault;
+thread_local int floatPrecision = 6;
+
 template <class T> using enable_if_mx_vector_t =
     typename std::enable_if<std::is_base_of<VectorBase, T>::value, T>::type;
 template <class T> using enable_if_mx_matrix_t =
@@ -37,6 +43,211 @@ template <class T> void stringToData(const string& str, T& data)
     }
 }
 
+// Parse a decimal integer string of the form [+-]digits, returning false if
+// the string has any other form or the value is out of range.
+template <class T> bool parseInteger(const string& str, T& data)
+{
+    const char* ptr = str.c_str();
+    const char* end = ptr + str.size();
+    bool negative = (ptr != end && *ptr == '-');
+    if (ptr != end && (*ptr == '-' || *ptr == '+'))
+    {
+        ptr++;
+    }
+    if (ptr == end)
+    {
+        return false;
+    }
+
+    using Unsigned = typename std::make_unsigned<T>::type;
+    const Unsigned limit = negative ? Unsigned(std::numeric_limits<T>::max()) + 1 :
+                                      Unsigned(std::numeric_limits<T>::max());
+    Unsigned value = 0;
+    for (; ptr != end; ptr++)
+    {
+        if (*ptr < '0' || *ptr > '9')
+        {
+            return false;
+        }
+        Unsigned digit = Unsigned(*ptr - '0');
+        if (value > (limit - digit) / 10)
+        {
+            return false;
+        }
+        value = value * 10 + digit;
+    }
+    data = negative ? T(Unsigned(0) - value) : T(value);
+    return true;
+}
+
+// Parse a decimal floating-point string of the form
+// [+-]digits[.digits][(e|E)[+-]digits], returning false if the string has
+// any other form or cannot be converted exactly by this method.
+//
+// The significant digits and the decimal exponent are accumulated as
+// integers, and the value is computed with a single multiplication or
+// division in double precision.  When both operands are exactly
+// representable in the target type, this yields the correctly rounded
+// result, so it matches the result of stream extraction.
+template <class T> bool parseFloat(const string& str, T& data)
+{
+    const uint64_t maxMantissa = uint64_t(1) << std::numeric_limits<T>::digits;
+    const int maxExponent = std::is_same<T, float>::value ? 10 : 22;
+    static const double POWERS_OF_TEN[] =
+    {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    const char* ptr = str.c_str();
+    const char* end = ptr + str.size();
+    bool negative = (ptr != end && *ptr == '-');
+    if (ptr != end && (*ptr == '-' || *ptr == '+'))
+    {
+        ptr++;
+    }
+
+    // Accumulate significant digits, deferring runs of zeros so that
+    // leading and trailing zeros do not count against the mantissa limit.
+    uint64_t mantissa = 0;
+    int exponent = 0;
+    int pendingZeros = 0;
+    bool hasDigits = false;
+    bool fraction = false;
+    for (; ptr != end; ptr++)
+    {
+        if (*ptr == '.' && !fraction)
+        {
+            fraction = true;
+            continue;
+        }
+        if (*ptr < '0' || *ptr > '9')
+        {
+            break;
+        }
+        hasDigits = true;
+        if (fraction)
+        {
+            exponent--;
+        }
+        if (*ptr == '0')
+        {
+            if (mantissa)
+            {
+                pendingZeros++;
+            }
+            continue;
+        }
+        for (; pendingZeros > 0; pendingZeros--)
+        {
+            mantissa *= 10;
+            if (mantissa >= maxMantissa)
+            {
+                return false;
+            }
+        }
+        mantissa = mantissa * 10 + uint64_t(*ptr - '0');
+        if (mantissa >= maxMantissa)
+        {
+            return false;
+        }
+    }
+    if (!hasDigits)
+    {
+        return false;
+    }
+    exponent += pendingZeros;
+
+    // Parse an optional exponent.
+    if (ptr != end && (*ptr == 'e' || *ptr == 'E'))
+    {
+        ptr++;
+        bool negativeExponent = (ptr != end && *ptr == '-');
+        if (ptr != end && (*ptr == '-' || *ptr == '+'))
+        {
+            ptr++;
+        }
+        if (ptr == end)
+        {
+            return false;
+        }
+        int explicitExponent = 0;
+        for (; ptr != end; ptr++)
+        {
+            if (*ptr < '0' || *ptr > '9' || explicitExponent > 1000)
+            {
+                return false;
+            }
+            explicitExponent = explicitExponent * 10 + (*ptr - '0');
+        }
+        exponent += negativeExponent ? -explicitExponent : explicitExponent;
+    }
+    if (ptr != end)
+    {
+        return false;
+    }
+
+    double value = (double) mantissa;
+    if (mantissa)
+    {
+        if (exponent > maxExponent || exponent < -maxExponent)
+        {
+            return false;
+        }
+        value = (exponent >= 0) ? value * POWERS_OF_TEN[exponent] : value / POWERS_OF_TEN[-exponent];
+    }
+    data = (T) (negative ? -value : value);
+    return true;
+}
+
+template <> void stringToData(const string& str, int& data)
+{
+    if (!parseInteger(str, data))
+    {
+        std::stringstream ss(str);
+        if (!(ss >> data))
+        {
+            throw ExceptionTypeError("Type mismatch in integer stringToData: " + str);
+        }
+    }
+}
+
+template <> void stringToData(const string& str, long& data)
+{
+    if (!parseInteger(str, data))
+    {
+        std::stringstream ss(str);
+        if (!(ss >> data))
+        {
+            throw ExceptionTypeError("Type mismatch in integer stringToData: " + str);
+        }
+    }
+}
+
+template <> void stringToData(const string& str, float& data)
+{
+    if (!parseFloat(str, data))
+    {
+        std::stringstream ss(str);
+        if (!(ss >> data))
+        {
+            throw ExceptionTypeError("Type mismatch in float stringToData: " + str);
+        }
+    }
+}
+
+template <> void stringToData(const string& str, double& data)
+{
+    if (!parseFloat(str, data))
+    {
+        std::stringstream ss(str);
+        if (!(ss >> data))
+        {
+            throw ExceptionTypeError("Type mismatch in float stringToData: " + str);
+        }
+    }
+}
+
 template <> void stringToData(const string& str, bool& data)
 {
     if (str == VALUE_STRING_TRUE)
@@ -107,6 +318,333 @@ template <class T> void dataToString(const T& data, string& str)
     str = ss.str();
 }
 
+// An unsigned integer of fixed capacity, holding the scaled numerators and
+// denominators of exact decimal conversions of doubles.
+class DecimalBigInt
+{
+  public:
+    // The largest operands, from subnormal doubles, stay below 1100 bits.
+    static const size_t CAPACITY = 40;
+
+    explicit DecimalBigInt(uint64_t value = 0) :
+        _size(0)
+    {
+        while (value)
+        {
+            _limbs[_size++] = (uint32_t) value;
+            value >>= 32;
+        }
+    }
+
+    bool isZero() const
+    {
+        return _size == 0;
+    }
+
+    void multiply(uint32_t factor)
+    {
+        uint64_t carry = 0;
+        for (size_t i = 0; i < _size; i++)
+        {
+            uint64_t product = (uint64_t) _limbs[i] * factor + carry;
+            _limbs[i] = (uint32_t) product;
+            carry = product >> 32;
+        }
+        if (carry)
+        {
+            _limbs[_size++] = (uint32_t) carry;
+        }
+    }
+
+    void multiplyPow10(int exponent)
+    {
+        for (; exponent >= 9; exponent -= 9)
+        {
+            multiply(1000000000u);
+        }
+        static const uint32_t POW10[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000 };
+        if (exponent > 0)
+        {
+            multiply(POW10[exponent]);
+        }
+    }
+
+    void shiftLeft(int bits)
+    {
+        if (isZero() || bits <= 0)
+        {
+            return;
+        }
+        const size_t limbShift = (size_t) bits / 32;
+        const int bitShift = bits % 32;
+        if (bitShift)
+        {
+            uint32_t carry = 0;
+            for (size_t i = 0; i < _size; i++)
+            {
+                uint32_t limb = _limbs[i];
+                _limbs[i] = (limb << bitShift) | carry;
+                carry = limb >> (32 - bitShift);
+            }
+            if (carry)
+            {
+                _limbs[_size++] = carry;
+            }
+        }
+        if (limbShift)
+        {
+            for (size_t i = _size; i-- > 0;)
+            {
+                _limbs[i + limbShift] = _limbs[i];
+            }
+            std::fill(_limbs, _limbs + limbShift, 0u);
+            _size += limbShift;
+        }
+    }
+
+    int compare(const DecimalBigInt& rhs) const
+    {
+        if (_size != rhs._size)
+        {
+            return _size < rhs._size ? -1 : 1;
+        }
+        for (size_t i = _size; i-- > 0;)
+        {
+            if (_limbs[i] != rhs._limbs[i])
+            {
+                return _limbs[i] < rhs._limbs[i] ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+
+    // Subtract a value no greater than this one.
+    void subtract(const DecimalBigInt& rhs)
+    {
+        uint64_t borrow = 0;
+        for (size_t i = 0; i < _size; i++)
+        {
+            uint64_t difference = (uint64_t) _limbs[i] - (i < rhs._size ? rhs._limbs[i] : 0) - borrow;
+            _limbs[i] = (uint32_t) difference;
+            borrow = (difference >> 32) & 1;
+        }
+        while (_size && !_limbs[_size - 1])
+        {
+            _size--;
+        }
+    }
+
+  private:
+    uint32_t _limbs[CAPACITY];
+    size_t _size;
+};
+
+// Format a double as with the %g conversion of printf in the classic locale,
+// with the given number of significant digits.  The digits are generated
+// from the exact binary value with integer arithmetic and rounded to nearest,
+// with ties to even, so the text matches printf for any precision.
+void formatGeneral(double data, int precision, string& str)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &data, sizeof(bits));
+    const bool negative = (bits >> 63) != 0;
+    const int biasedExponent = (int) ((bits >> 52) & 0x7ff);
+    uint64_t mantissa = bits & ((uint64_t(1) << 52) - 1);
+
+    str = negative ? "-" : "";
+    if (biasedExponent == 0x7ff)
+    {
+        str += mantissa ? "nan" : "inf";
+        return;
+    }
+    if (!biasedExponent && !mantissa)
+    {
+        str += "0";
+        return;
+    }
+
+    // The value is mantissa * 2^exponent.
+    int exponent = -1074;
+    if (biasedExponent)
+    {
+        mantissa |= uint64_t(1) << 52;
+        exponent = biasedExponent - 1075;
+    }
+    int bitLength = 0;
+    for (uint64_t m = mantissa; m; m >>= 1)
+    {
+        bitLength++;
+    }
+
+    // Estimate the decimal exponent from the binary exponent, and scale the
+    // value to the ratio numerator / denominator in [1, 10).
+    const int64_t scaledLog = (int64_t) (exponent + bitLength - 1) * 78913;
+    int decimalExponent = (int) (scaledLog >= 0 ? scaledLog >> 18 : -((-scaledLog + (1 << 18) - 1) >> 18));
+    DecimalBigInt numerator(mantissa);
+    DecimalBigInt denominator(1);
+    numerator.shiftLeft(exponent);
+    denominator.shiftLeft(-exponent);
+    numerator.multiplyPow10(-decimalExponent);
+    denominator.multiplyPow10(decimalExponent);
+    DecimalBigInt limit = denominator;
+    limit.multiply(10);
+    while (numerator.compare(limit) >= 0)
+    {
+        denominator.multiply(10);
+        limit.multiply(10);
+        decimalExponent++;
+    }
+    while (numerator.compare(denominator) < 0)
+    {
+        numerator.multiply(10);
+        decimalExponent--;
+    }
+
+    // Generate the significant digits, stopping early once the remainder
+    // is exhausted.
+    const size_t digitCount = (size_t) (precision < 0 ? 6 : std::max(precision, 1));
+    DecimalBigInt denominator2 = denominator;
+    denominator2.shiftLeft(1);
+    DecimalBigInt denominator4 = denominator;
+    denominator4.shiftLeft(2);
+    DecimalBigInt denominator8 = denominator;
+    denominator8.shiftLeft(3);
+    string digits;
+    while (digits.size() < digitCount && !numerator.isZero())
+    {
+        int digit = 0;
+        if (numerator.compare(denominator8) >= 0) { numerator.subtract(denominator8); digit += 8; }
+        if (numerator.compare(denominator4) >= 0) { numerator.subtract(denominator4); digit += 4; }
+        if (numerator.compare(denominator2) >= 0) { numerator.subtract(denominator2); digit += 2; }
+        if (numerator.compare(denominator) >= 0) { numerator.subtract(denominator); digit += 1; }
+        digits += (char) ('0' + digit);
+        numerator.multiply(10);
+    }
+
+    // Round the remainder, which has been scaled by ten.
+    if (!numerator.isZero())
+    {
+        DecimalBigInt half = denominator;
+        half.multiply(5);
+        const int order = numerator.compare(half);
+        if (order > 0 || (order == 0 && ((digits.back() - '0') & 1)))
+        {
+            size_t i = digits.size();
+            while (i > 0 && digits[i - 1] == '9')
+            {
+                digits[--i] = '0';
+            }
+            if (i == 0)
+            {
+                digits.insert(digits.begin(), '1');
+                digits.pop_back();
+                decimalExponent++;
+            }
+            else
+            {
+                digits[i - 1]++;
+            }
+        }
+    }
+    while (digits.size() > 1 && digits.back() == '0')
+    {
+        digits.pop_back();
+    }
+
+    // Choose between fixed and scientific notation as %g does.
+    if (decimalExponent < -4 || decimalExponent >= (int) digitCount)
+    {
+        str += digits[0];
+        if (digits.size() > 1)
+        {
+            str += '.';
+            str.append(digits, 1, string::npos);
+        }
+        const int absExponent = std::abs(decimalExponent);
+        str += decimalExponent < 0 ? "e-" : "e+";
+        if (absExponent < 10)
+        {
+            str += '0';
+        }
+        str += std::to_string(absExponent);
+    }
+    else if (decimalExponent < 0)
+    {
+        str += "0.";
+        str.append((size_t) (-decimalExponent - 1), '0');
+        str += digits;
+    }
+    else
+    {
+        const size_t integerDigits = (size_t) decimalExponent + 1;
+        if (digits.size() <= integerDigits)
+        {
+            str += digits;
+            str.append(integerDigits - digits.size(), '0');
+        }
+        else
+        {
+            str.append(digits, 0, integerDigits);
+            str += '.';
+            str.append(digits, integerDigits, string::npos);
+        }
+    }
+}
+
+// A string stream that formats values in the classic locale.
+class ClassicStringStream : public std::ostringstream
+{
+  public:
+    ClassicStringStream()
+    {
+        imbue(std::locale::classic());
+    }
+};
+
+// Format a floating-point value with the current float format and
+// precision in the classic locale, independent of the global locale.  The
+// default format is generated directly, while the fixed and scientific
+// formats reuse a single stream for each thread.
+template <class T> void floatToString(T data, string& str)
+{
+    const Value::FloatFormat fmt = Value::getFloatFormat();
+    if (fmt != Value::FloatFormatFixed && fmt != Value::FloatFormatScientific)
+    {
+        formatGeneral((double) data, Value::getFloatPrecision(), str);
+        return;
+    }
+
+    thread_local ClassicStringStream ss;
+    ss.str(EMPTY_STRING);
+    ss.clear();
+    ss.setf(fmt == Value::FloatFormatFixed ? std::ios_base::fixed : std::ios_base::scientific,
+            std::ios_base::floatfield);
+    ss.precision(Value::getFloatPrecision());
+
+    ss << data;
+    str = ss.str();
+}
+
+template <> void dataToString(const int& data, string& str)
+{
+    str = std::to_string(data);
+}
+
+template <> void dataToString(const long& data, string& str)
+{
+    str = std::to_string(data);
+}
+
+template <> void dataToString(const float& data, string& str)
+{
+    floatToString(data, str);
+}
+
+template <> void dataToString(const double& data, string& str)
+{
+    floatToString(data, str);
+}
+
 template <> void dataToString(const bool& data, string& str)
 {
     str = data ? VALUE_STRING_TRUE : VALUE_STRING_FALSE;
@@ -219,19 +757,42 @@ ValuePtr Value::createValueFromStrings(const string& value, const string& type)
 
 template<class T> bool Value::isA() const
 {
-    return dynamic_cast<const TypedValue<T>*>(this) != nullptr;
+    return _typeTag == TypedValue<T>::TAG;
 }
 
 template<class T> const T& Value::asA() const
 {
-    const TypedValue<T>* typedVal = dynamic_cast<const TypedValue<T>*>(this);
-    if (!typedVal)
+    if (_typeTag != TypedValue<T>::TAG)
     {
         throw ExceptionTypeError("Incorrect type specified for value");
     }
-    return typedVal->getData();
+    return static_cast<const TypedValue<T>*>(this)->getData();
 }
 
+void Value::setFloatFormat(FloatFormat format)
+{
+    floatFormat = format;
+}
+
+void Value::setFloatPrecision(int precision)
+{
+    floatPrecision = precision;
+}
+
+Value::FloatFormat Value::getFloatFormat()
+{
+    return floatFormat;
+}
+
+int Value::getFloatPrecision()
+{
+    return floatPrecision;
+}
+
+//
+// ScopedFloatFormatting methods
+//
+
 ScopedFloatFormatting::ScopedFloatFormatting(Value::FloatFormat format, int precision) :
     _format(Value::getFloatFormat()),
     _precision(Value::getFloatPrecision())
@@ -267,8 +828,9 @@ template <class T> class ValueRegistry
 // Template instantiations
 //
 
-#define INSTANTIATE_TYPE(T, name)                                                               \
+#define INSTANTIATE_TYPE(T, name, tag)                                                          \
 template <> const string TypedValue<T>::TYPE = name;                                            \
+template <> const Value::TypeTag TypedValue<T>::TAG = Value::tag;                               \
 template <> const string& TypedValue<T>::getTypeString() const { return TYPE; }                 \
 template <> string TypedValue<T>::getValueString() const { return toValueString<T>(_data); }    \
 template MX_CORE_API bool Value::isA<T>() const;                                                \
@@ -279,26 +841,26 @@ template MX_CORE_API T fromValueString(const string& value);
 ValueRegistry<T> registry##T;
 
 // Base types
-INSTANTIATE_TYPE(int, "integer")
-INSTANTIATE_TYPE(bool, "boolean")
-INSTANTIATE_TYPE(float, "float")
-INSTANTIATE_TYPE(Color3, "color3")
-INSTANTIATE_TYPE(Color4, "color4")
-INSTANTIATE_TYPE(Vector2, "vector2")
-INSTANTIATE_TYPE(Vector3, "vector3")
-INSTANTIATE_TYPE(Vector4, "vector4")
-INSTANTIATE_TYPE(Matrix33, "matrix33")
-INSTANTIATE_TYPE(Matrix44, "matrix44")
-INSTANTIATE_TYPE(string, "string")
+INSTANTIATE_TYPE(int, "integer", TypeTagInteger)
+INSTANTIATE_TYPE(bool, "boolean", TypeTagBoolean)
+INSTANTIATE_TYPE(float, "float", TypeTagFloat)
+INSTANTIATE_TYPE(Color3, "color3", TypeTagColor3)
+INSTANTIATE_TYPE(Color4, "color4", TypeTagColor4)
+INSTANTIATE_TYPE(Vector2, "vector2", TypeTagVector2)
+INSTANTIATE_TYPE(Vector3, "vector3", TypeTagVector3)
+INSTANTIATE_TYPE(Vector4, "vector4", TypeTagVector4)
+INSTANTIATE_TYPE(Matrix33, "matrix33", TypeTagMatrix33)
+INSTANTIATE_TYPE(Matrix44, "matrix44", TypeTagMatrix44)
+INSTANTIATE_TYPE(string, "string", TypeTagString)
 
 // Array types
-INSTANTIATE_TYPE(IntVec, "integerarray")
-INSTANTIATE_TYPE(BoolVec, "booleanarray")
-INSTANTIATE_TYPE(FloatVec, "floatarray")
-INSTANTIATE_TYPE(StringVec, "stringarray")
+INSTANTIATE_TYPE(IntVec, "integerarray", TypeTagIntegerArray)
+INSTANTIATE_TYPE(BoolVec, "booleanarray", TypeTagBooleanArray)
+INSTANTIATE_TYPE(FloatVec, "floatarray", TypeTagFloatArray)
+INSTANTIATE_TYPE(StringVec, "stringarray", TypeTagStringArray)
 
 // Alias types
-INSTANTIATE_TYPE(long, "integer")
-INSTANTIATE_TYPE(double, "float")
+INSTANTIATE_TYPE(long, "integer", TypeTagLong)
+INSTANTIATE_TYPE(double, "float", TypeTagDouble)
 
 } // namespace MaterialX
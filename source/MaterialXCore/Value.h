@@ -53,10 +53,36 @@ class MX_CORE_API Value
         FloatFormatScientific = 2
     };
 
-  public:
-    Value()
+    /// Tags identifying the data type of a value, with one tag for each
+    /// instantiated TypedValue class.
+    enum TypeTag
+    {
+        TypeTagInteger = 0,
+        TypeTagBoolean,
+        TypeTagFloat,
+        TypeTagColor3,
+        TypeTagColor4,
+        TypeTagVector2,
+        TypeTagVector3,
+        TypeTagVector4,
+        TypeTagMatrix33,
+        TypeTagMatrix44,
+        TypeTagString,
+        TypeTagIntegerArray,
+        TypeTagBooleanArray,
+        TypeTagFloatArray,
+        TypeTagStringArray,
+        TypeTagLong,
+        TypeTagDouble
+    };
+
+  protected:
+    explicit Value(TypeTag typeTag) :
+        _typeTag(typeTag)
     {
     }
+
+  public:
     virtual ~Value() { }
 
     /// Create a new value from an object of any valid MaterialX type.
@@ -90,6 +116,12 @@ class MX_CORE_API Value
     /// exception is thrown.
     template<class T> const T& asA() const;
 
+    /// Return the type tag for this value.
+    TypeTag getTypeTag() const
+    {
+        return _typeTag;
+    }
+
     /// Return the type string for this value.
     virtual const string& getTypeString() const = 0;
 
@@ -99,28 +131,19 @@ class MX_CORE_API Value
     /// Set float formatting for converting values to strings.
     /// Formats to use are FloatFormatFixed, FloatFormatScientific 
     /// or FloatFormatDefault to set default format.
-    static void setFloatFormat(FloatFormat format)
-    {
-        _floatFormat = format;
-    }
+    /// Float formatting is stored per thread, so this call affects only
+    /// the calling thread.
+    static void setFloatFormat(FloatFormat format);
 
     /// Set float precision for converting values to strings.
-    static void setFloatPrecision(int precision)
-    {
-        _floatPrecision = precision;
-    }
+    /// Float precision is stored per thread.
+    static void setFloatPrecision(int precision);
 
-    /// Return the current float format.
-    static FloatFormat getFloatFormat()
-    {
-        return _floatFormat;
-    }
+    /// Return the current float format for the calling thread.
+    static FloatFormat getFloatFormat();
 
-    /// Return the current float precision.
-    static int getFloatPrecision()
-    {
-        return _floatPrecision;
-    }
+    /// Return the current float precision for the calling thread.
+    static int getFloatPrecision();
 
   protected:
     template <class T> friend class ValueRegistry;
@@ -129,9 +152,9 @@ class MX_CORE_API Value
     using CreatorMap = std::unordered_map<string, CreatorFunction>;
 
   private:
+    TypeTag _typeTag;
+
     static CreatorMap _creatorMap;
-    static FloatFormat _floatFormat;
-    static int _floatPrecision;
 };
 
 /// The class template for typed subclasses of Value
@@ -139,10 +162,12 @@ template <class T> class MX_CORE_API TypedValue : public Value
 {
   public:
     TypedValue() :
+        Value(TAG),
         _data{}
     {
     }
     explicit TypedValue(const T& value) :
+        Value(TAG),
         _data(value)
     {
     }
@@ -189,6 +214,7 @@ template <class T> class MX_CORE_API TypedValue : public Value
 
   public:
     static const string TYPE;
+    static const TypeTag TAG;
 
   private:
     T _data;
@@ -0,0 +1,305 @@
+//
+// TM & (c) 2021 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXFormat/BinaryIo.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+
+namespace MaterialX
+{
+
+const string MTLXB_EXTENSION = "mtlxb";
+
+namespace {
+
+const char BINARY_MAGIC[] = { 'M', 'T', 'L', 'X', 'B', 'I', 'N', '\0' };
+const uint32_t BINARY_VERSION = 1;
+
+// The minimum encoded size of an element: category, name, source URI,
+// attribute count and child count.
+const size_t MIN_ELEMENT_SIZE = 5 * sizeof(uint32_t);
+
+// The maximum depth of the element tree, guarding against stack exhaustion
+// when reading corrupt or malicious data.
+const size_t MAX_ELEMENT_DEPTH = 1024;
+
+class BinaryWriter
+{
+  public:
+    void writeElement(ConstElementPtr elem)
+    {
+        writeString(elem->getCategory());
+        writeString(elem->getName());
+        writeString(elem->getSourceUri());
+
+        StringVec attrNames = elem->getAttributeNames();
+        writeUInt(_body, (uint32_t) attrNames.size());
+        for (const string& attrName : attrNames)
+        {
+            writeString(attrName);
+            writeString(elem->getAttribute(attrName));
+        }
+
+        const ElementVec& children = elem->getChildren();
+        writeUInt(_body, (uint32_t) children.size());
+        for (ConstElementPtr child : children)
+        {
+            writeElement(child);
+        }
+    }
+
+    void writeTo(std::ostream& stream) const
+    {
+        string header(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+        writeUInt(header, BINARY_VERSION);
+        writeUInt(header, (uint32_t) _strings.size());
+        for (const string* str : _strings)
+        {
+            writeUInt(header, (uint32_t) str->size());
+            header += *str;
+        }
+        stream.write(header.data(), header.size());
+        stream.write(_body.data(), _body.size());
+    }
+
+  private:
+    void writeString(const string& str)
+    {
+        auto it = _stringIndices.find(str);
+        if (it == _stringIndices.end())
+        {
+            it = _stringIndices.emplace(str, (uint32_t) _strings.size()).first;
+            _strings.push_back(&it->first);
+        }
+        writeUInt(_body, it->second);
+    }
+
+    static void writeUInt(string& dest, uint32_t value)
+    {
+        // Values are stored in little-endian order on all platforms.
+        char bytes[4] = { (char) (value & 0xff),
+                          (char) ((value >> 8) & 0xff),
+                          (char) ((value >> 16) & 0xff),
+                          (char) ((value >> 24) & 0xff) };
+        dest.append(bytes, sizeof(bytes));
+    }
+
+  private:
+    std::unordered_map<string, uint32_t> _stringIndices;
+    vector<const string*> _strings;
+    string _body;
+};
+
+class BinaryReader
+{
+  public:
+    BinaryReader(const char* buffer, size_t size) :
+        _ptr(buffer),
+        _end(buffer + size)
+    {
+    }
+
+    void readDocument(DocumentPtr doc)
+    {
+        // Validate the header.
+        if (remaining() < sizeof(BINARY_MAGIC) ||
+            std::memcmp(_ptr, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0)
+        {
+            throw ExceptionParseError("Binary parse error (invalid header)");
+        }
+        _ptr += sizeof(BINARY_MAGIC);
+        uint32_t version = readUInt();
+        if (version != BINARY_VERSION)
+        {
+            throw ExceptionParseError("Binary parse error (unsupported version " + std::to_string(version) + ")");
+        }
+
+        // Read the string table.
+        uint32_t stringCount = readUInt();
+        checkCount(stringCount, sizeof(uint32_t));
+        _strings.reserve(stringCount);
+        for (uint32_t i = 0; i < stringCount; i++)
+        {
+            uint32_t length = readUInt();
+            checkCount(length, 1);
+            _strings.emplace_back(_ptr, length);
+            _ptr += length;
+        }
+
+        // Read the element tree, whose root is the document itself.
+        readString();
+        readString();
+        const string& sourceUri = readString();
+        if (!sourceUri.empty())
+        {
+            doc->setSourceUri(sourceUri);
+        }
+        readContent(doc, 0);
+
+        if (_ptr != _end)
+        {
+            throw ExceptionParseError("Binary parse error (unexpected trailing data)");
+        }
+    }
+
+  private:
+    void readContent(ElementPtr elem, size_t depth)
+    {
+        if (depth > MAX_ELEMENT_DEPTH)
+        {
+            throw ExceptionParseError("Binary parse error (maximum element depth exceeded)");
+        }
+
+        uint32_t attrCount = readUInt();
+        checkCount(attrCount, 2 * sizeof(uint32_t));
+        for (uint32_t i = 0; i < attrCount; i++)
+        {
+            const string& attrName = readString();
+            const string& attrValue = readString();
+            elem->setAttribute(attrName, attrValue);
+        }
+
+        uint32_t childCount = readUInt();
+        checkCount(childCount, MIN_ELEMENT_SIZE);
+        for (uint32_t i = 0; i < childCount; i++)
+        {
+            const string& category = readString();
+            const string& name = readString();
+            const string& sourceUri = readString();
+            ElementPtr child = elem->addChildOfCategory(category, name);
+            if (!sourceUri.empty())
+            {
+                child->setSourceUri(sourceUri);
+            }
+            readContent(child, depth + 1);
+        }
+    }
+
+    uint32_t readUInt()
+    {
+        if (remaining() < sizeof(uint32_t))
+        {
+            throw ExceptionParseError("Binary parse error (unexpected end of data)");
+        }
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(_ptr);
+        _ptr += sizeof(uint32_t);
+        return (uint32_t) bytes[0] |
+               ((uint32_t) bytes[1] << 8) |
+               ((uint32_t) bytes[2] << 16) |
+               ((uint32_t) bytes[3] << 24);
+    }
+
+    const string& readString()
+    {
+        uint32_t index = readUInt();
+        if (index >= _strings.size())
+        {
+            throw ExceptionParseError("Binary parse error (invalid string index)");
+        }
+        return _strings[index];
+    }
+
+    // Guard against corrupt counts before reserving or iterating.
+    void checkCount(uint32_t count, size_t minItemSize) const
+    {
+        if (count > remaining() / minItemSize)
+        {
+            throw ExceptionParseError("Binary parse error (unexpected end of data)");
+        }
+    }
+
+    size_t remaining() const
+    {
+        return (size_t) (_end - _ptr);
+    }
+
+  private:
+    const char* _ptr;
+    const char* _end;
+    StringVec _strings;
+};
+
+} // anonymous namespace
+
+//
+// Reading
+//
+
+void readFromBinaryBuffer(DocumentPtr doc, const char* buffer, size_t size)
+{
+    BinaryReader reader(buffer, size);
+    reader.readDocument(doc);
+}
+
+void readFromBinaryFile(DocumentPtr doc, FilePath filename, FileSearchPath searchPath)
+{
+    searchPath.append(getEnvironmentPath());
+    filename = searchPath.find(filename);
+
+    // Read directly from a memory mapping of the file when possible.
+    MappedFile mappedFile;
+    if (mappedFile.open(filename))
+    {
+        readFromBinaryBuffer(doc, mappedFile.getData(), mappedFile.getSize());
+        doc->setSourceUri(filename);
+        return;
+    }
+
+    // Otherwise read the complete file with a single request.
+    std::ifstream ifs(filename.asString(), std::ios::binary | std::ios::ate);
+    if (!ifs)
+    {
+        throw ExceptionFileMissing("Failed to open file for reading: " + filename.asString());
+    }
+    std::streamoff size = ifs.tellg();
+    string buffer(size > 0 ? (size_t) size : 0, '\0');
+    ifs.seekg(0);
+    if (!ifs.read(&buffer[0], buffer.size()))
+    {
+        throw ExceptionFileMissing("Failed to read file: " + filename.asString());
+    }
+
+    readFromBinaryBuffer(doc, buffer.data(), buffer.size());
+    doc->setSourceUri(filename);
+}
+
+void readFromBinaryString(DocumentPtr doc, const string& str)
+{
+    readFromBinaryBuffer(doc, str.data(), str.size());
+}
+
+//
+// Writing
+//
+
+void writeToBinaryStream(ConstDocumentPtr doc, std::ostream& stream)
+{
+    BinaryWriter writer;
+    writer.writeElement(doc);
+    writer.writeTo(stream);
+}
+
+void writeToBinaryFile(ConstDocumentPtr doc, const FilePath& filename)
+{
+    std::ofstream ofs(filename.asString(), std::ios::binary);
+    if (!ofs)
+    {
+        throw ExceptionFileMissing("Failed to open file for writing: " + filename.asString());
+    }
+    writeToBinaryStream(doc, ofs);
+}
+
+string writeToBinaryString(ConstDocumentPtr doc)
+{
+    std::ostringstream stream;
+    writeToBinaryStream(doc, stream);
+    return stream.str();
+}
+
+} // namespace MaterialX
@@ -0,0 +1,81 @@
+//
+// TM & (c) 2021 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_BINARYIO_H
+#define MATERIALX_BINARYIO_H
+
+/// @file
+/// Support for a compact binary serialization of documents
+
+#include <MaterialXFormat/XmlIo.h>
+
+namespace MaterialX
+{
+
+extern MX_FORMAT_API const string MTLXB_EXTENSION;
+
+/// @name Binary Read Functions
+/// @{
+
+/// Read a Document in binary format from the given character buffer.
+///
+/// The binary format stores a table of unique strings, followed by the
+/// element tree in document order, with each category, name, source URI,
+/// attribute name and attribute value encoded as an index into the table.
+/// Reading a binary document reproduces the element tree exactly as it was
+/// written, including the source URIs of imported library elements, and
+/// involves no XML parsing.
+///
+/// @param doc The Document into which data is read.
+/// @param buffer The character buffer from which data is read.
+/// @param size The size of the buffer in bytes.
+/// @throws ExceptionParseError if the buffer is not a valid binary document,
+///    or if its element tree exceeds the maximum supported depth.
+MX_FORMAT_API void readFromBinaryBuffer(DocumentPtr doc, const char* buffer, size_t size);
+
+/// Read a Document in binary format from the given filename.
+/// @param doc The Document into which data is read.
+/// @param filename The filename from which data is read.  This argument can
+///    be supplied either as a FilePath or a standard string.
+/// @param searchPath An optional sequence of file paths that will be applied
+///    in order when searching for the given file.
+/// @throws ExceptionParseError if the file is not a valid binary document.
+/// @throws ExceptionFileMissing if the file cannot be opened.
+MX_FORMAT_API void readFromBinaryFile(DocumentPtr doc,
+                                      FilePath filename,
+                                      FileSearchPath searchPath = FileSearchPath());
+
+/// Read a Document in binary format from the given string.
+/// @param doc The Document into which data is read.
+/// @param str The string from which data is read.
+/// @throws ExceptionParseError if the string is not a valid binary document.
+MX_FORMAT_API void readFromBinaryString(DocumentPtr doc, const string& str);
+
+/// @}
+/// @name Binary Write Functions
+/// @{
+
+/// Write a Document in binary format to the given output stream.
+/// @param doc The Document to be written.
+/// @param stream The output stream to which data is written.
+MX_FORMAT_API void writeToBinaryStream(ConstDocumentPtr doc, std::ostream& stream);
+
+/// Write a Document in binary format to the given filename.
+/// @param doc The Document to be written.
+/// @param filename The filename to which data is written.  This argument can
+///    be supplied either as a FilePath or a standard string.
+/// @throws ExceptionFileMissing if the file cannot be opened for writing.
+MX_FORMAT_API void writeToBinaryFile(ConstDocumentPtr doc, const FilePath& filename);
+
+/// Write a Document in binary format to a new string, returned by value.
+/// @param doc The Document to be written.
+/// @return The output string, returned by value
+MX_FORMAT_API string writeToBinaryString(ConstDocumentPtr doc);
+
+/// @}
+
+} // namespace MaterialX
+
+#endif
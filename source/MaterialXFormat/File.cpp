@@ -15,6 +15,8 @@
 #include <direct.h>
 #else
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <dirent.h>
 #endif
@@ -337,6 +339,82 @@ FilePath FilePath::getModulePath()
 #endif
 }
 
+//
+// MappedFile methods
+//
+
+bool MappedFile::open(const FilePath& path)
+{
+    close();
+
+#if defined(_WIN32)
+    HANDLE file = CreateFile(path.asString().c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                             OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMapping(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    CloseHandle(file);
+    if (!mapping)
+    {
+        return false;
+    }
+    void* data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!data)
+    {
+        return false;
+    }
+    _data = static_cast<char*>(data);
+    _size = (size_t) fileSize.QuadPart;
+#else
+    int fd = ::open(path.asString().c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        return false;
+    }
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size <= 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    void* data = mmap(nullptr, (size_t) fileStat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+    _data = static_cast<char*>(data);
+    _size = (size_t) fileStat.st_size;
+#endif
+
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (!_data)
+    {
+        return;
+    }
+
+#if defined(_WIN32)
+    UnmapViewOfFile(_data);
+#else
+    munmap(_data, _size);
+#endif
+    _data = nullptr;
+    _size = 0;
+}
+
 FileSearchPath getEnvironmentPath(const string& sep)
 {
     string searchPathEnv = getEnviron(MATERIALX_SEARCH_PATH_ENV_VAR);
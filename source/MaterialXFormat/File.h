@@ -342,6 +342,58 @@ class MX_FORMAT_API FileSearchPath
     FilePathVec _paths;
 };
 
+/// @class MappedFile
+/// A private, copy-on-write memory mapping of the contents of a file.
+///
+/// The mapped contents may be modified in place, for example by an in-situ
+/// parser, without these modifications being written back to the file.
+/// Pages of the file are loaded on demand by the operating system, and
+/// only pages that are modified consume private memory.
+class MX_FORMAT_API MappedFile
+{
+  public:
+    MappedFile() :
+        _data(nullptr),
+        _size(0)
+    {
+    }
+    ~MappedFile()
+    {
+        close();
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /// Map the contents of the given file into memory, returning true if
+    /// the mapping succeeded.  Empty files cannot be mapped.
+    bool open(const FilePath& path);
+
+    /// Release the current mapping, if any.
+    void close();
+
+    /// Return true if a file is currently mapped.
+    bool isOpen() const
+    {
+        return _data != nullptr;
+    }
+
+    /// Return a pointer to the mapped contents.
+    char* getData() const
+    {
+        return _data;
+    }
+
+    /// Return the size of the mapped contents in bytes.
+    size_t getSize() const
+    {
+        return _size;
+    }
+
+  private:
+    char* _data;
+    size_t _size;
+};
+
 /// Return a FileSearchPath object from search path environment variable.
 MX_FORMAT_API FileSearchPath getEnvironmentPath(const string& sep = PATH_LIST_SEPARATOR);
 
@@ -5,9 +5,12 @@
 
 #include <MaterialXFormat/Util.h>
 
+#include <atomic>
+#include <exception>
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <thread>
 
 namespace MaterialX
 {
@@ -91,7 +94,8 @@ StringSet loadLibraries(const FilePathVec& libraryFolders,
     FileSearchPath librarySearchPath = searchPath;
     librarySearchPath.append(getEnvironmentPath());
 
-    StringSet loadedLibraries;
+    // Gather the library folders to be scanned.
+    FilePathVec libraryPaths;
     if (libraryFolders.empty())
     {
         // No libraries specified so scan in all search paths
@@ -99,18 +103,7 @@ StringSet loadLibraries(const FilePathVec& libraryFolders,
         {
             for (const FilePath& path : libraryPath.getSubDirectories())
             {
-                for (const FilePath& filename : path.getFilesInDirectory(MTLX_EXTENSION))
-                {
-                    if (!excludeFiles.count(filename))
-                    {
-                        const FilePath& file = path / filename;
-                        if (loadedLibraries.count(file) == 0)
-                        {
-                            loadLibrary(file, doc, searchPath, readOptions);
-                            loadedLibraries.insert(file.asString());
-                        }
-                    }
-                }
+                libraryPaths.push_back(path);
             }
         }
     }
@@ -122,29 +115,101 @@ StringSet loadLibraries(const FilePathVec& libraryFolders,
             FilePath libraryPath = librarySearchPath.find(libraryName);
             for (const FilePath& path : libraryPath.getSubDirectories())
             {
-                for (const FilePath& filename : path.getFilesInDirectory(MTLX_EXTENSION))
+                libraryPaths.push_back(path);
+            }
+        }
+    }
+
+    // Gather the library files to be loaded, in order.
+    StringSet loadedLibraries;
+    FilePathVec libraryFiles;
+    for (const FilePath& path : libraryPaths)
+    {
+        for (const FilePath& filename : path.getFilesInDirectory(MTLX_EXTENSION))
+        {
+            if (!excludeFiles.count(filename))
+            {
+                const FilePath& file = path / filename;
+                if (loadedLibraries.count(file) == 0)
                 {
-                    if (!excludeFiles.count(filename))
-                    {
-                        const FilePath& file = path / filename;
-                        if (loadedLibraries.count(file) == 0)
-                        {
-                            loadLibrary(file, doc, searchPath, readOptions);
-                            loadedLibraries.insert(file.asString());
-                        }
-                    }
+                    libraryFiles.push_back(file);
+                    loadedLibraries.insert(file.asString());
                 }
             }
         }
     }
+
+    size_t threadCount = readOptions ? readOptions->readThreadCount : 1;
+    if (threadCount == 0)
+    {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    threadCount = std::min(threadCount, libraryFiles.size());
+
+    if (threadCount <= 1)
+    {
+        for (const FilePath& file : libraryFiles)
+        {
+            loadLibrary(file, doc, searchPath, readOptions);
+        }
+        return loadedLibraries;
+    }
+
+    // Parse library files concurrently into separate documents.
+    vector<DocumentPtr> libraryDocs(libraryFiles.size());
+    vector<std::exception_ptr> libraryErrors(libraryFiles.size());
+    std::atomic<size_t> nextFile(0);
+    vector<std::thread> threads;
+    for (size_t i = 0; i < threadCount; i++)
+    {
+        threads.emplace_back([&]()
+        {
+            for (size_t index = nextFile++; index < libraryFiles.size(); index = nextFile++)
+            {
+                try
+                {
+                    DocumentPtr libDoc = createDocument();
+                    readFromXmlFile(libDoc, libraryFiles[index], searchPath, readOptions);
+                    libraryDocs[index] = libDoc;
+                }
+                catch (...)
+                {
+                    libraryErrors[index] = std::current_exception();
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    // Merge the parsed documents in their original order.
+    for (size_t i = 0; i < libraryFiles.size(); i++)
+    {
+        if (libraryErrors[i])
+        {
+            std::rethrow_exception(libraryErrors[i]);
+        }
+        doc->importLibrary(libraryDocs[i]);
+    }
     return loadedLibraries;
 }
 
 void flattenFilenames(DocumentPtr doc, const FileSearchPath& searchPath, StringResolverPtr customResolver)
 {
-    for (ElementPtr elem : doc->traverseTree())
+    // Resolve filenames and find file prefixes with a read-only traversal,
+    // then apply the edits once the traversal is complete.
+    vector<std::pair<const ValueElement*, string>> resolvedValues;
+    vector<const Element*> prefixedElements;
+    for (const Element& elem : doc->traverseTreeConst())
     {
-        ValueElementPtr valueElem = elem->asA<ValueElement>();
+        if (elem.hasFilePrefix())
+        {
+            prefixedElements.push_back(&elem);
+        }
+
+        const ValueElement* valueElem = dynamic_cast<const ValueElement*>(&elem);
         if (!valueElem || valueElem->getType() != FILENAME_TYPE_STRING)
         {
             continue;
@@ -155,7 +220,7 @@ void flattenFilenames(DocumentPtr doc, const FileSearchPath& searchPath, StringR
         {
             continue;
         }
-        StringResolverPtr elementResolver = elem->createStringResolver();
+        StringResolverPtr elementResolver = elem.createStringResolver();
         // If the path is already absolute then don't allow an additional prefix
         // as this would make the path invalid.
         if (unresolvedValue.isAbsolute())
@@ -188,16 +253,20 @@ void flattenFilenames(DocumentPtr doc, const FileSearchPath& searchPath, StringR
             resolvedString = customResolver->resolve(resolvedString, FILENAME_TYPE_STRING);
         }
 
-        valueElem->setValueString(resolvedString);
+        resolvedValues.emplace_back(valueElem, resolvedString);
+    }
+
+    // The elements belong to the given mutable document, so their constness
+    // may be cast away once the traversal is complete.
+    for (const auto& resolvedValue : resolvedValues)
+    {
+        const_cast<ValueElement*>(resolvedValue.first)->setValueString(resolvedValue.second);
     }
 
     // Remove any file prefix attributes
-    for (ElementPtr elem : doc->traverseTree())
+    for (const Element* elem : prefixedElements)
     {
-        if (elem->hasFilePrefix())
-        {
-            elem->removeAttribute(Element::FILE_PREFIX_ATTRIBUTE);
-        }
+        const_cast<Element*>(elem)->removeAttribute(Element::FILE_PREFIX_ATTRIBUTE);
     }
 }
 
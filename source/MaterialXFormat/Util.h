@@ -45,6 +45,8 @@ MX_FORMAT_API void loadLibrary(const FilePath& file,
 
 /// Load all MaterialX files within the given library folders into a document,
 /// using the given search path to locate the folders on the file system.
+/// If the given read options request multiple threads, then the library files
+/// are parsed concurrently and merged into the document in a deterministic order.
 MX_FORMAT_API StringSet loadLibraries(const FilePathVec& libraryFolders,
                         const FileSearchPath& searchPath,
                         DocumentPtr doc,
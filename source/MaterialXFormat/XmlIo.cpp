@@ -9,8 +9,10 @@
 
 #include <MaterialXCore/Types.h>
 
+#include <algorithm>
 #include <cstring>
 #include <fstream>
+#include <iterator>
 #include <sstream>
 
 using namespace pugi;
@@ -26,9 +28,8 @@ const string XINCLUDE_TAG = "xi:include";
 const string XINCLUDE_NAMESPACE = "xmlns:xi";
 const string XINCLUDE_URL = "http://www.w3.org/2001/XInclude";
 
-void elementFromXml(const xml_node& xmlNode, ElementPtr elem, const XmlReadOptions* readOptions)
+void attributesFromXml(const xml_node& xmlNode, ElementPtr elem)
 {
-    // Store attributes in element.
     for (const xml_attribute& xmlAttr : xmlNode.attributes())
     {
         if (xmlAttr.name() != Element::NAME_ATTRIBUTE)
@@ -36,6 +37,11 @@ void elementFromXml(const xml_node& xmlNode, ElementPtr elem, const XmlReadOptio
             elem->setAttribute(xmlAttr.name(), xmlAttr.value());
         }
     }
+}
+
+void childrenFromXml(const xml_node& xmlNode, ElementPtr elem, const XmlReadOptions* readOptions)
+{
+    ElementPredicate elementPredicate = readOptions ? readOptions->elementPredicate : nullptr;
 
     // Create child elements and recurse.
     for (const xml_node& xmlChild : xmlNode.children())
@@ -60,7 +66,7 @@ void elementFromXml(const xml_node& xmlNode, ElementPtr elem, const XmlReadOptio
 
         // Create the new element.
         ElementPtr child = elem->addChildOfCategory(category, name);
-        elementFromXml(xmlChild, child, readOptions);
+        attributesFromXml(xmlChild, child);
 
         // Handle the interpretation of XML comments.
         if (readOptions && readOptions->readComments && category.empty())
@@ -68,6 +74,15 @@ void elementFromXml(const xml_node& xmlNode, ElementPtr elem, const XmlReadOptio
             child = elem->changeChildCategory(child, CommentElement::CATEGORY);
             child->setDocString(xmlChild.value());
         }
+
+        // Skip excluded elements along with their descendants.
+        if (elementPredicate && !elementPredicate(child))
+        {
+            elem->removeChild(child->getName());
+            continue;
+        }
+
+        childrenFromXml(xmlChild, child, readOptions);
     }
 }
 
@@ -137,6 +152,55 @@ void elementToXml(ConstElementPtr elem, xml_node& xmlNode, const XmlWriteOptions
     }
 }
 
+void readXInclude(DocumentPtr doc,
+                  const string& filename,
+                  const FileSearchPath& searchPath,
+                  FileSearchPath& includeSearchPath,
+                  XmlReadFunction readXIncludeFunction,
+                  const XmlReadOptions* readOptions)
+{
+    // Check for XInclude cycles.
+    if (readOptions)
+    {
+        const StringVec& parents = readOptions->parentXIncludes;
+        if (std::find(parents.begin(), parents.end(), filename) != parents.end())
+        {
+            throw ExceptionParseError("XInclude cycle detected.");
+        }
+    }
+
+    // Read the included file into a library document.
+    DocumentPtr library = createDocument();
+    XmlReadOptions xiReadOptions = readOptions ? *readOptions : XmlReadOptions();
+    xiReadOptions.parentXIncludes.push_back(filename);
+
+    // Prepend the directory of the parent to accommodate
+    // includes relative to the parent file location.
+    if (includeSearchPath.isEmpty())
+    {
+        string parentUri = doc->getSourceUri();
+        if (!parentUri.empty())
+        {
+            FilePath filePath = searchPath.find(parentUri);
+            if (!filePath.isEmpty())
+            {
+                // Remove the file name from the path as we want the path to the containing folder.
+                includeSearchPath = searchPath;
+                includeSearchPath.prepend(filePath.getParentPath());
+            }
+        }
+        // Set default search path if no parent path found
+        if (includeSearchPath.isEmpty())
+        {
+            includeSearchPath = searchPath;
+        }
+    }
+    readXIncludeFunction(library, filename, includeSearchPath, &xiReadOptions);
+
+    // Import the library document.
+    doc->importLibrary(library);
+}
+
 void processXIncludes(DocumentPtr doc, xml_node& xmlNode, const FileSearchPath& searchPath, const XmlReadOptions* readOptions)
 {
     // Search path for includes. Set empty and then evaluated once in the iteration through xml includes.
@@ -152,47 +216,7 @@ void processXIncludes(DocumentPtr doc, xml_node& xmlNode, const FileSearchPath&
             if (readXIncludeFunction)
             {
                 string filename = xmlChild.attribute("href").value();
-
-                // Check for XInclude cycles.
-                if (readOptions)
-                {
-                    const StringVec& parents = readOptions->parentXIncludes;
-                    if (std::find(parents.begin(), parents.end(), filename) != parents.end())
-                    {
-                        throw ExceptionParseError("XInclude cycle detected.");
-                    }
-                }
-
-                // Read the included file into a library document.
-                DocumentPtr library = createDocument();
-                XmlReadOptions xiReadOptions = readOptions ? *readOptions : XmlReadOptions();
-                xiReadOptions.parentXIncludes.push_back(filename);
-
-                // Prepend the directory of the parent to accommodate
-                // includes relative to the parent file location.
-                if (includeSearchPath.isEmpty())
-                {
-                    string parentUri = doc->getSourceUri();
-                    if (!parentUri.empty())
-                    {
-                        FilePath filePath = searchPath.find(parentUri);
-                        if (!filePath.isEmpty())
-                        {
-                            // Remove the file name from the path as we want the path to the containing folder.
-                            includeSearchPath = searchPath;
-                            includeSearchPath.prepend(filePath.getParentPath());
-                        }
-                    }
-                    // Set default search path if no parent path found
-                    if (includeSearchPath.isEmpty())
-                    {
-                        includeSearchPath = searchPath;
-                    }
-                }
-                readXIncludeFunction(library, filename, includeSearchPath, &xiReadOptions);
-
-                // Import the library document.
-                doc->importLibrary(library);
+                readXInclude(doc, filename, searchPath, includeSearchPath, readXIncludeFunction, readOptions);
             }
 
             // Remove include directive.
@@ -216,12 +240,24 @@ void documentFromXml(DocumentPtr doc,
     if (xmlRoot)
     {
         processXIncludes(doc, xmlRoot, searchPath, readOptions);
-        elementFromXml(xmlRoot, doc, readOptions);
+        attributesFromXml(xmlRoot, doc);
+        childrenFromXml(xmlRoot, doc, readOptions);
     }
 
     doc->upgradeVersion();
 }
 
+string getParseErrorMessage(const string& desc, size_t offset, const FilePath& filename)
+{
+    string message = "XML parse error";
+    if (!filename.isEmpty())
+    {
+        message += " in " + filename.asString();
+    }
+    message += " (" + desc + " at character " + std::to_string(offset) + ")";
+    return message;
+}
+
 void validateParseResult(xml_parse_result& result, const FilePath& filename = FilePath())
 {
     if (result)
@@ -236,16 +272,7 @@ void validateParseResult(xml_parse_result& result, const FilePath& filename = Fi
         throw ExceptionFileMissing("Failed to open file for reading: " + filename.asString());
     }
 
-    string desc = result.description();
-    string offset = std::to_string(result.offset);
-    string message = "XML parse error";
-    if (!filename.isEmpty())
-    {
-        message += " in " + filename.asString();
-    }
-    message += " (" + desc + " at character " + offset + ")";
-
-    throw ExceptionParseError(message);
+    throw ExceptionParseError(getParseErrorMessage(result.description(), (size_t) result.offset, filename));
 }
 
 unsigned int getParseOptions(const XmlReadOptions* readOptions)
@@ -258,6 +285,541 @@ unsigned int getParseOptions(const XmlReadOptions* readOptions)
     return parseOptions;
 }
 
+// The type of the default XInclude read function.
+using XmlReadFilePtr = void (*)(DocumentPtr, FilePath, FileSearchPath, const XmlReadOptions*);
+
+// A streaming XML reader, which builds the element tree of a document
+// directly from parse events without constructing an XML tree.  Elements
+// that are duplicates or that are rejected by the element predicate of the
+// read options are skipped along with their descendants.
+class XmlStreamReader
+{
+  public:
+    XmlStreamReader(const char* buffer, size_t size, const FilePath& filename) :
+        _begin(buffer),
+        _ptr(buffer),
+        _end(buffer + size),
+        _filename(filename)
+    {
+    }
+
+    void read(DocumentPtr doc, const FileSearchPath& searchPath, const XmlReadOptions* readOptions)
+    {
+        XmlReadFunction readXIncludeFunction = getXIncludeFunction(readOptions);
+        ElementPredicate elementPredicate = readOptions ? readOptions->elementPredicate : nullptr;
+        bool readComments = readOptions && readOptions->readComments;
+        FileSearchPath includeSearchPath;
+        bool foundRoot = false;
+
+        // The stack of open elements, where skipped elements are represented
+        // by null pointers.
+        vector<ElementPtr> elemStack;
+        StringVec tagStack;
+        string tag;
+
+        // Skip a UTF-8 byte order mark.
+        if (startsWith("\xEF\xBB\xBF"))
+        {
+            _ptr += 3;
+        }
+
+        // As in the standard reader, XInclude references are read before
+        // the other children of the document, so that included elements
+        // take precedence over duplicates in the document itself.
+        StringVec includes;
+        if (readXIncludeFunction && std::search(_ptr, _end, XINCLUDE_TAG.begin(), XINCLUDE_TAG.end()) != _end)
+        {
+            scanXIncludes(includes);
+        }
+
+        while (_ptr < _end)
+        {
+            // Skip character data.
+            if (*_ptr != '<')
+            {
+                const char* next = static_cast<const char*>(std::memchr(_ptr, '<', _end - _ptr));
+                _ptr = next ? next : _end;
+                continue;
+            }
+
+            if (startsWith("<!--"))
+            {
+                const char* valueBegin = _ptr + 4;
+                skipPast("-->", "Comment is not terminated");
+                if (readComments && !elemStack.empty() && elemStack.back())
+                {
+                    ElementPtr parent = elemStack.back();
+                    ElementPtr comment = parent->addChildOfCategory(EMPTY_STRING, EMPTY_STRING);
+                    comment = parent->changeChildCategory(comment, CommentElement::CATEGORY);
+                    comment->setDocString(normalizeEol(valueBegin, _ptr - 3));
+                    if (elementPredicate && !elementPredicate(comment))
+                    {
+                        parent->removeChild(comment->getName());
+                    }
+                }
+            }
+            else if (startsWith("<![CDATA["))
+            {
+                skipPast("]]>", "CDATA section is not terminated");
+            }
+            else if (startsWith("<!"))
+            {
+                skipDeclaration();
+            }
+            else if (startsWith("<?"))
+            {
+                skipPast("?>", "Processing instruction is not terminated");
+            }
+            else if (startsWith("</"))
+            {
+                size_t offset = getOffset();
+                _ptr += 2;
+                readName(tag);
+                skipWhitespace();
+                expect('>');
+                if (tagStack.empty() || tag != tagStack.back())
+                {
+                    throwError("End element mismatch", offset);
+                }
+                elemStack.pop_back();
+                tagStack.pop_back();
+            }
+            else
+            {
+                _ptr++;
+                readName(tag);
+                bool selfClosing = readAttributes();
+
+                ElementPtr elem;
+                if (elemStack.empty())
+                {
+                    // Only the first document element is read.
+                    if (!foundRoot && tag == Document::CATEGORY)
+                    {
+                        foundRoot = true;
+                        elem = doc;
+                        for (const string& filename : includes)
+                        {
+                            readXInclude(doc, filename, searchPath, includeSearchPath, readXIncludeFunction, readOptions);
+                        }
+                        setAttributes(elem);
+                    }
+                }
+                else if (elemStack.back())
+                {
+                    ElementPtr parent = elemStack.back();
+                    if (parent == doc && tag == XINCLUDE_TAG)
+                    {
+                        // XInclude references have already been read.
+                    }
+                    else
+                    {
+                        const string& name = getAttribute(Element::NAME_ATTRIBUTE);
+                        if (!parent->getChild(name))
+                        {
+                            elem = parent->addChildOfCategory(tag, name);
+                            setAttributes(elem);
+
+                            // Skip excluded elements along with their descendants.
+                            if (elementPredicate && !elementPredicate(elem))
+                            {
+                                parent->removeChild(elem->getName());
+                                elem = nullptr;
+                            }
+                        }
+                    }
+                }
+
+                if (!selfClosing)
+                {
+                    elemStack.push_back(elem);
+                    tagStack.push_back(tag);
+                }
+            }
+        }
+
+        if (!tagStack.empty())
+        {
+            throwError("Start-end tags mismatch", getOffset());
+        }
+        if (!foundRoot)
+        {
+            throwError("No document element found", getOffset());
+        }
+    }
+
+  private:
+    // Return the function used to read XInclude references, where the
+    // default function of the read options is replaced by the streaming
+    // reader, whether or not read options are given.
+    static XmlReadFunction getXIncludeFunction(const XmlReadOptions* readOptions)
+    {
+        if (!readOptions)
+        {
+            return readFromXmlFileStreaming;
+        }
+        const XmlReadFunction& function = readOptions->readXIncludeFunction;
+        const XmlReadFilePtr* target = function.target<XmlReadFilePtr>();
+        if (target && *target == readFromXmlFile)
+        {
+            return readFromXmlFileStreaming;
+        }
+        return function;
+    }
+
+    // Collect the XInclude references that are children of the document
+    // element, leaving the read position unchanged.
+    void scanXIncludes(StringVec& includes)
+    {
+        const char* start = _ptr;
+        string tag;
+        bool inRoot = false;
+        size_t depth = 0;
+        while (_ptr < _end)
+        {
+            if (*_ptr != '<')
+            {
+                const char* next = static_cast<const char*>(std::memchr(_ptr, '<', _end - _ptr));
+                _ptr = next ? next : _end;
+            }
+            else if (startsWith("<!--"))
+            {
+                skipPast("-->", "Comment is not terminated");
+            }
+            else if (startsWith("<![CDATA["))
+            {
+                skipPast("]]>", "CDATA section is not terminated");
+            }
+            else if (startsWith("<!"))
+            {
+                skipDeclaration();
+            }
+            else if (startsWith("<?"))
+            {
+                skipPast("?>", "Processing instruction is not terminated");
+            }
+            else if (startsWith("</"))
+            {
+                _ptr += 2;
+                readName(tag);
+                if (depth > 0 && --depth == 0 && inRoot)
+                {
+                    break;
+                }
+            }
+            else
+            {
+                _ptr++;
+                readName(tag);
+                bool selfClosing = readAttributes();
+                if (depth == 0 && tag == Document::CATEGORY)
+                {
+                    if (selfClosing)
+                    {
+                        break;
+                    }
+                    inRoot = true;
+                }
+                else if (inRoot && depth == 1 && tag == XINCLUDE_TAG)
+                {
+                    includes.push_back(getAttribute("href"));
+                }
+                if (!selfClosing)
+                {
+                    depth++;
+                }
+            }
+        }
+        _ptr = start;
+    }
+
+    bool startsWith(const char* token) const
+    {
+        size_t length = std::strlen(token);
+        return (size_t) (_end - _ptr) >= length && std::memcmp(_ptr, token, length) == 0;
+    }
+
+    void skipPast(const char* token, const char* error)
+    {
+        size_t offset = getOffset();
+        const char* found = std::search(_ptr, _end, token, token + std::strlen(token));
+        if (found == _end)
+        {
+            throwError(error, offset);
+        }
+        _ptr = found + std::strlen(token);
+    }
+
+    void skipDeclaration()
+    {
+        // Skip a document type declaration, including any internal subset.
+        size_t offset = getOffset();
+        int depth = 0;
+        for (_ptr += 2; _ptr < _end; _ptr++)
+        {
+            if (*_ptr == '[')
+            {
+                depth++;
+            }
+            else if (*_ptr == ']')
+            {
+                depth--;
+            }
+            else if (*_ptr == '>' && depth <= 0)
+            {
+                _ptr++;
+                return;
+            }
+        }
+        throwError("Declaration is not terminated", offset);
+    }
+
+    void skipWhitespace()
+    {
+        while (_ptr < _end && isWhitespace(*_ptr))
+        {
+            _ptr++;
+        }
+    }
+
+    void expect(char c)
+    {
+        if (_ptr >= _end || *_ptr != c)
+        {
+            throwError(string("Expected '") + c + "'", getOffset());
+        }
+        _ptr++;
+    }
+
+    void readName(string& name)
+    {
+        const char* nameBegin = _ptr;
+        while (_ptr < _end && !isWhitespace(*_ptr) && *_ptr != '=' && *_ptr != '>' && *_ptr != '/')
+        {
+            _ptr++;
+        }
+        if (_ptr == nameBegin)
+        {
+            throwError("Error parsing name", getOffset());
+        }
+        name.assign(nameBegin, _ptr);
+    }
+
+    // Read the attributes of a start tag, returning true if the tag is
+    // self-closing.  Attribute strings are recycled between tags.
+    bool readAttributes()
+    {
+        _attrCount = 0;
+        while (true)
+        {
+            skipWhitespace();
+            if (_ptr >= _end)
+            {
+                throwError("Start tag is not terminated", getOffset());
+            }
+            if (*_ptr == '>')
+            {
+                _ptr++;
+                return false;
+            }
+            if (*_ptr == '/')
+            {
+                _ptr++;
+                expect('>');
+                return true;
+            }
+
+            if (_attrCount == _attrs.size())
+            {
+                _attrs.emplace_back();
+            }
+            std::pair<string, string>& attr = _attrs[_attrCount++];
+            readName(attr.first);
+            skipWhitespace();
+            expect('=');
+            skipWhitespace();
+            if (_ptr >= _end || (*_ptr != '"' && *_ptr != '\''))
+            {
+                throwError("Error parsing attribute value", getOffset());
+            }
+            char quote = *_ptr++;
+            const char* valueEnd = static_cast<const char*>(std::memchr(_ptr, quote, _end - _ptr));
+            if (!valueEnd)
+            {
+                throwError("Attribute value is not terminated", getOffset());
+            }
+            decodeAttributeValue(_ptr, valueEnd, attr.second);
+            _ptr = valueEnd + 1;
+        }
+    }
+
+    const string& getAttribute(const string& name) const
+    {
+        for (size_t i = 0; i < _attrCount; i++)
+        {
+            if (_attrs[i].first == name)
+            {
+                return _attrs[i].second;
+            }
+        }
+        return EMPTY_STRING;
+    }
+
+    void setAttributes(ElementPtr elem) const
+    {
+        for (size_t i = 0; i < _attrCount; i++)
+        {
+            if (_attrs[i].first != Element::NAME_ATTRIBUTE)
+            {
+                elem->setAttribute(_attrs[i].first, _attrs[i].second);
+            }
+        }
+    }
+
+    // Decode an attribute value, expanding character references and
+    // normalizing whitespace characters to spaces.
+    void decodeAttributeValue(const char* begin, const char* end, string& value) const
+    {
+        value.clear();
+        for (const char* c = begin; c < end; c++)
+        {
+            if (*c == '&')
+            {
+                const char* semicolon = std::find(c, end, ';');
+                if (semicolon != end && decodeReference(c + 1, semicolon, value, (size_t) (c - _begin)))
+                {
+                    c = semicolon;
+                    continue;
+                }
+                value += *c;
+            }
+            else if (*c == '\r')
+            {
+                if (c + 1 < end && c[1] == '\n')
+                {
+                    c++;
+                }
+                value += ' ';
+            }
+            else if (*c == '\n' || *c == '\t')
+            {
+                value += ' ';
+            }
+            else
+            {
+                value += *c;
+            }
+        }
+    }
+
+    bool decodeReference(const char* begin, const char* end, string& value, size_t offset) const
+    {
+        string ref(begin, end);
+        if (ref == "lt")
+            value += '<';
+        else if (ref == "gt")
+            value += '>';
+        else if (ref == "amp")
+            value += '&';
+        else if (ref == "quot")
+            value += '"';
+        else if (ref == "apos")
+            value += '\'';
+        else if (ref.size() > 1 && ref[0] == '#')
+        {
+            bool hex = ref[1] == 'x';
+            string digits = ref.substr(hex ? 2 : 1);
+            if (digits.empty() || digits.size() > 8 || digits.find_first_not_of(hex ? "0123456789abcdefABCDEF" : "0123456789") != string::npos)
+            {
+                return false;
+            }
+            unsigned long code = std::stoul(digits, nullptr, hex ? 16 : 10);
+            if (code == 0 || (code >= 0xD800 && code <= 0xDFFF) || code > 0x10FFFF)
+            {
+                throwError("Invalid character reference", offset);
+            }
+            appendUtf8(code, value);
+        }
+        else
+        {
+            return false;
+        }
+        return true;
+    }
+
+    static void appendUtf8(unsigned long code, string& value)
+    {
+        if (code < 0x80)
+        {
+            value += (char) code;
+        }
+        else if (code < 0x800)
+        {
+            value += (char) (0xC0 | (code >> 6));
+            value += (char) (0x80 | (code & 0x3F));
+        }
+        else if (code < 0x10000)
+        {
+            value += (char) (0xE0 | (code >> 12));
+            value += (char) (0x80 | ((code >> 6) & 0x3F));
+            value += (char) (0x80 | (code & 0x3F));
+        }
+        else
+        {
+            value += (char) (0xF0 | ((code >> 18) & 0x07));
+            value += (char) (0x80 | ((code >> 12) & 0x3F));
+            value += (char) (0x80 | ((code >> 6) & 0x3F));
+            value += (char) (0x80 | (code & 0x3F));
+        }
+    }
+
+    static string normalizeEol(const char* begin, const char* end)
+    {
+        string str;
+        str.reserve(end - begin);
+        for (const char* c = begin; c < end; c++)
+        {
+            if (*c == '\r')
+            {
+                if (c + 1 < end && c[1] == '\n')
+                {
+                    c++;
+                }
+                str += '\n';
+            }
+            else
+            {
+                str += *c;
+            }
+        }
+        return str;
+    }
+
+    static bool isWhitespace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    size_t getOffset() const
+    {
+        return (size_t) (_ptr - _begin);
+    }
+
+    void throwError(const string& desc, size_t offset) const
+    {
+        throw ExceptionParseError(getParseErrorMessage(desc, offset, _filename));
+    }
+
+  private:
+    const char* _begin;
+    const char* _ptr;
+    const char* _end;
+    FilePath _filename;
+
+    vector<std::pair<string, string>> _attrs;
+    size_t _attrCount = 0;
+};
+
 } // anonymous namespace
 
 //
@@ -266,7 +828,8 @@ unsigned int getParseOptions(const XmlReadOptions* readOptions)
 
 XmlReadOptions::XmlReadOptions() :
     readXIncludeFunction(readFromXmlFile),
-    readComments(false)
+    readComments(false),
+    readThreadCount(1)
 {
 }
 
@@ -303,12 +866,17 @@ void readFromXmlStream(DocumentPtr doc, std::istream& stream, const XmlReadOptio
 
 void readFromXmlFile(DocumentPtr doc, FilePath filename, FileSearchPath searchPath, const XmlReadOptions* readOptions)
 {
-    xml_document xmlDoc;
-
     searchPath.append(getEnvironmentPath());
     filename = searchPath.find(filename);
 
-    xml_parse_result result = xmlDoc.load_file(filename.asString().c_str(), getParseOptions(readOptions));
+    // Parse the file in place from a private memory mapping, so that the XML
+    // tree refers directly to the mapped contents, falling back to a buffered
+    // read when the file cannot be mapped.  The mapping must outlive the tree.
+    MappedFile mappedFile;
+    xml_document xmlDoc;
+    xml_parse_result result = mappedFile.open(filename) ?
+        xmlDoc.load_buffer_inplace(mappedFile.getData(), mappedFile.getSize(), getParseOptions(readOptions)) :
+        xmlDoc.load_file(filename.asString().c_str(), getParseOptions(readOptions));
     validateParseResult(result, filename);
 
     // This must be done before parsing the XML as the source URI
@@ -330,6 +898,56 @@ void readFromXmlString(DocumentPtr doc, const string& str, const XmlReadOptions*
     readFromXmlStream(doc, stream, readOptions);
 }
 
+void readFromXmlBufferStreaming(DocumentPtr doc, const char* buffer, size_t size, const XmlReadOptions* readOptions)
+{
+    XmlStreamReader reader(buffer, size, FilePath());
+    reader.read(doc, FileSearchPath(), readOptions);
+    doc->upgradeVersion();
+}
+
+void readFromXmlFileStreaming(DocumentPtr doc, FilePath filename, FileSearchPath searchPath, const XmlReadOptions* readOptions)
+{
+    searchPath.append(getEnvironmentPath());
+    filename = searchPath.find(filename);
+
+    // Read from a memory mapping of the file when possible, so that only
+    // the pages currently being parsed need to be resident.
+    MappedFile mappedFile;
+    string contents;
+    const char* buffer = nullptr;
+    size_t size = 0;
+    if (mappedFile.open(filename))
+    {
+        buffer = mappedFile.getData();
+        size = mappedFile.getSize();
+    }
+    else
+    {
+        std::ifstream ifs(filename.asString(), std::ios::binary);
+        if (!ifs)
+        {
+            throw ExceptionFileMissing("Failed to open file for reading: " + filename.asString());
+        }
+        contents.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+        buffer = contents.data();
+        size = contents.size();
+    }
+
+    // The source URI is used for searching for include files.
+    if (readOptions && !readOptions->parentXIncludes.empty())
+    {
+        doc->setSourceUri(readOptions->parentXIncludes[0]);
+    }
+    else
+    {
+        doc->setSourceUri(filename);
+    }
+
+    XmlStreamReader reader(buffer, size, filename);
+    reader.read(doc, searchPath, readOptions);
+    doc->upgradeVersion();
+}
+
 //
 // Writing
 //
@@ -46,6 +46,20 @@ class MX_FORMAT_API XmlReadOptions
     /// The vector of parent XIncludes at the scope of the current document.
     /// Defaults to an empty vector.
     StringVec parentXIncludes;
+
+    /// The number of threads used to read files concurrently, when multiple
+    /// files are loaded through functions such as loadLibraries.  Files are
+    /// parsed into separate documents in parallel, and then merged in the
+    /// same order as a serial load.  A value of zero selects the number of
+    /// hardware threads.  Defaults to one, which reads files serially.
+    unsigned int readThreadCount;
+
+    /// If provided, this function will be used to exclude specific elements
+    /// (those returning false) from the read operation, along with all of
+    /// their descendants.  The function is invoked once the attributes of an
+    /// element have been read, but before any of its children.  Defaults to
+    /// nullptr.
+    ElementPredicate elementPredicate;
 };
 
 /// @class XmlWriteOptions
@@ -129,6 +143,41 @@ MX_FORMAT_API void readFromXmlFile(DocumentPtr doc,
 /// @throws ExceptionParseError if the document cannot be parsed.
 MX_FORMAT_API void readFromXmlString(DocumentPtr doc, const string& str, const XmlReadOptions* readOptions = nullptr);
 
+/// Read a Document as XML from the given character buffer, building
+/// elements directly from parse events rather than from an intermediate
+/// XML tree.  This reduces the peak memory required to read large documents,
+/// and elements excluded by the element predicate of the read options are
+/// skipped without being constructed.
+/// @param doc The Document into which data is read.
+/// @param buffer The character buffer from which data is read.
+/// @param size The size of the buffer in bytes.
+/// @param readOptions An optional pointer to an XmlReadOptions object.
+///    If provided, then the given options will affect the behavior of the
+///    read function.  Defaults to a null pointer.
+/// @throws ExceptionParseError if the document cannot be parsed.
+MX_FORMAT_API void readFromXmlBufferStreaming(DocumentPtr doc, const char* buffer, size_t size, const XmlReadOptions* readOptions = nullptr);
+
+/// Read a Document as XML from the given filename, building elements
+/// directly from parse events rather than from an intermediate XML tree.
+/// As with readFromXmlFile, XInclude references are read before the other
+/// children of the document.  They are read with the XInclude read function
+/// of the read options, except that the default function is replaced by this
+/// function, whether or not read options are given.
+/// @param doc The Document into which data is read.
+/// @param filename The filename from which data is read.  This argument can
+///    be supplied either as a FilePath or a standard string.
+/// @param searchPath An optional sequence of file paths that will be applied
+///    in order when searching for the given file and its includes.
+/// @param readOptions An optional pointer to an XmlReadOptions object.
+///    If provided, then the given options will affect the behavior of the read
+///    function.  Defaults to a null pointer.
+/// @throws ExceptionParseError if the document cannot be parsed.
+/// @throws ExceptionFileMissing if the file cannot be opened.
+MX_FORMAT_API void readFromXmlFileStreaming(DocumentPtr doc,
+                     FilePath filename,
+                     FileSearchPath searchPath = FileSearchPath(),
+                     const XmlReadOptions* readOptions = nullptr);
+
 /// @}
 /// @name Write Functions
 /// @{
@@ -30,6 +30,15 @@ void LightCompoundNodeGlsl::initialize(const InterfaceElement& element, GenConte
 {
     CompoundNode::initialize(element, context);
 
+    // Prepend the light struct instance name on all input socket variables,
+    // since in generated code these inputs will be members of the light struct.
+    // This is done once here rather than when the light is bound, since the
+    // implementation may be shared by many contexts.
+    for (ShaderGraphInputSocket* inputSocket : _rootGraph->getInputSockets())
+    {
+        inputSocket->setVariable("light." + inputSocket->getVariable());
+    }
+
     // Store light uniforms for all inputs on the interface
     const NodeGraph& graph = static_cast<const NodeGraph&>(element);
     NodeDefPtr nodeDef = graph.getNodeDef();
@@ -64,6 +73,7 @@ void LightCompoundNodeGlsl::createVariables(const ShaderNode&, GenContext& conte
 void LightCompoundNodeGlsl::emitFunctionDefinition(const ShaderNode& node, GenContext& context, ShaderStage& stage) const
 {
     BEGIN_SHADER_STAGE(stage, Stage::PIXEL)
+        std::lock_guard<std::mutex> guard(_emitMutex);
         const GlslShaderGenerator& shadergen = static_cast<const GlslShaderGenerator&>(context.getShaderGenerator());
 
         // Emit functions for all child nodes
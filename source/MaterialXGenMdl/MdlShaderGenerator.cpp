@@ -278,7 +278,7 @@ ShaderPtr MdlShaderGenerator::generate(const string& name, ElementPtr element, G
     }
 
     // Perform token substitution
-    replaceTokens(_tokenSubstitutions, stage);
+    replaceTokens(context.getTokenSubstitutions(), stage);
 
     return shader;
 }
@@ -33,6 +33,7 @@ void CompoundNodeMdl::initialize(const InterfaceElement& element, GenContext& co
 void CompoundNodeMdl::emitFunctionDefinition(const ShaderNode&, GenContext& context, ShaderStage& stage) const
 {
     BEGIN_SHADER_STAGE(stage, Stage::PIXEL)
+        std::lock_guard<std::mutex> guard(_emitMutex);
         const ShaderGenerator& shadergen = context.getShaderGenerator();
         const Syntax& syntax = shadergen.getSyntax();
 
@@ -206,11 +206,11 @@ ShaderPtr OslShaderGenerator::generate(const string& name, ElementPtr element, G
     // depending on the vertical flip flag.
     if (context.getOptions().fileTextureVerticalFlip)
     {
-        _tokenSubstitutions[ShaderGenerator::T_FILE_TRANSFORM_UV] = "stdlib/" + OslShaderGenerator::TARGET + "/lib/mx_transform_uv_vflip.osl";
+        context.addTokenSubstitution(ShaderGenerator::T_FILE_TRANSFORM_UV, "stdlib/" + OslShaderGenerator::TARGET + "/lib/mx_transform_uv_vflip.osl");
     }
     else
     {
-        _tokenSubstitutions[ShaderGenerator::T_FILE_TRANSFORM_UV] = "stdlib/" + OslShaderGenerator::TARGET + "/lib/mx_transform_uv.osl";
+        context.addTokenSubstitution(ShaderGenerator::T_FILE_TRANSFORM_UV, "stdlib/" + OslShaderGenerator::TARGET + "/lib/mx_transform_uv.osl");
     }
 
     // Emit function definitions for all nodes
@@ -294,7 +294,7 @@ ShaderPtr OslShaderGenerator::generate(const string& name, ElementPtr element, G
     emitScopeEnd(stage);
 
     // Perform token substitution
-    replaceTokens(_tokenSubstitutions, stage);
+    replaceTokens(context.getTokenSubstitutions(), stage);
 
     return shader;
 }
@@ -9,6 +9,59 @@
 namespace MaterialX
 {
 
+//
+// ShaderNodeImplCache methods
+//
+
+ShaderNodeImplCache::ShaderNodeImplCache() :
+    _hitCount(0),
+    _missCount(0)
+{
+}
+
+void ShaderNodeImplCache::add(const string& name, ShaderNodeImplPtr impl)
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    _impls[name] = impl;
+}
+
+ShaderNodeImplPtr ShaderNodeImplCache::find(const string& name) const
+{
+    ShaderNodeImplPtr impl;
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        auto it = _impls.find(name);
+        if (it != _impls.end())
+        {
+            impl = it->second;
+        }
+    }
+    if (impl)
+    {
+        _hitCount++;
+    }
+    else
+    {
+        _missCount++;
+    }
+    return impl;
+}
+
+void ShaderNodeImplCache::getNames(StringSet& names) const
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    for (const auto& it : _impls)
+    {
+        names.insert(it.first);
+    }
+}
+
+void ShaderNodeImplCache::clear()
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    _impls.clear();
+}
+
 //
 // GenContext methods
 //
@@ -21,6 +74,9 @@ GenContext::GenContext(ShaderGeneratorPtr sg) :
         throw ExceptionShaderGenError("GenContext must have a valid shader generator");
     }
 
+    // Initialize token substitutions from the shader generator
+    _tokenSubstitutions = _sg->getTokenSubstitutions();
+
     // Collect and cache reserved words from the shader generator
     StringSet reservedWords;
 
@@ -41,17 +97,30 @@ GenContext::GenContext(ShaderGeneratorPtr sg) :
 
 void GenContext::addNodeImplementation(const string& name, ShaderNodeImplPtr impl)
 {
+    if (_nodeImplCache)
+    {
+        _nodeImplCache->add(name, impl);
+        return;
+    }
     _nodeImpls[name] = impl;
 }
 
 ShaderNodeImplPtr GenContext::findNodeImplementation(const string& name) const
 {
     auto it = _nodeImpls.find(name);
-    return it != _nodeImpls.end() ? it->second : nullptr;
+    if (it != _nodeImpls.end())
+    {
+        return it->second;
+    }
+    return _nodeImplCache ? _nodeImplCache->find(name) : nullptr;
 }
 
 void GenContext::getNodeImplementationNames(StringSet& names)
 {
+    if (_nodeImplCache)
+    {
+        _nodeImplCache->getNames(names);
+    }
     for (auto it : _nodeImpls)
     {
         names.insert(it.first);
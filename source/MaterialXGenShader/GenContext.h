@@ -17,9 +17,75 @@
 
 #include <MaterialXFormat/File.h>
 
+#include <atomic>
+#include <mutex>
+
 namespace MaterialX
 {
 
+/// @class ShaderNodeImplCache
+/// A thread-safe cache of shader node implementations, which may be attached
+/// to any number of generation contexts in order to share implementations
+/// between them.
+///
+/// A cache should only be shared by contexts using the same shader generator,
+/// data libraries and generation options.  Implementations that hold a graph,
+/// such as compound implementations, are shared as well, and serialize the
+/// emission of their graphs, since nodes such as LayerNode edit a graph
+/// temporarily while its code is emitted.
+class MX_GENSHADER_API ShaderNodeImplCache
+{
+  public:
+    ShaderNodeImplCache();
+    ~ShaderNodeImplCache() { }
+
+    /// Create a new implementation cache.
+    static ShaderNodeImplCachePtr create()
+    {
+        return std::make_shared<ShaderNodeImplCache>();
+    }
+
+    /// Add an implementation to the cache.
+    void add(const string& name, ShaderNodeImplPtr impl);
+
+    /// Find and return a cached implementation, or return nullptr if no
+    /// implementation is found.  Each call counts as a hit or a miss.
+    ShaderNodeImplPtr find(const string& name) const;
+
+    /// Get the names of all cached implementations.
+    void getNames(StringSet& names) const;
+
+    /// Clear all cached implementations.
+    void clear();
+
+    /// Return the number of lookups that found a cached implementation.
+    size_t getHitCount() const
+    {
+        return _hitCount;
+    }
+
+    /// Return the number of lookups that found no cached implementation.
+    size_t getMissCount() const
+    {
+        return _missCount;
+    }
+
+    /// Reset the hit and miss counters to zero.
+    void resetCounters()
+    {
+        _hitCount = 0;
+        _missCount = 0;
+    }
+
+  protected:
+    using ImplMap = std::unordered_map<string, ShaderNodeImplPtr>;
+
+    ImplMap _impls;
+    mutable std::mutex _mutex;
+    mutable std::atomic<size_t> _hitCount;
+    mutable std::atomic<size_t> _missCount;
+};
+
 /// @class GenContext 
 /// A context class for shader generation.
 /// Used for thread local storage of data needed during shader generation.
@@ -79,7 +145,23 @@ class MX_GENSHADER_API GenContext
         return _reservedWords;
     }
 
-    /// Cache a shader node implementation.
+    /// Add or replace a token substitution for this context. Substitutions
+    /// are initialized from the shader generator, and substitutions that
+    /// depend on generation options are set here, keeping the shader
+    /// generator itself unmodified during generation.
+    void addTokenSubstitution(const string& token, const string& substitution)
+    {
+        _tokenSubstitutions[token] = substitution;
+    }
+
+    /// Return the map of token substitutions used in this context.
+    const StringMap& getTokenSubstitutions() const
+    {
+        return _tokenSubstitutions;
+    }
+
+    /// Cache a shader node implementation, either in this context or in
+    /// its attached implementation cache.
     void addNodeImplementation(const string& name, ShaderNodeImplPtr impl);
 
     /// Find and return a cached shader node implementation,
@@ -89,9 +171,26 @@ class MX_GENSHADER_API GenContext
     /// Get the names of all cached node implementations.
     void getNodeImplementationNames(StringSet& names);
 
-    /// Clear all cached shader node implementation.
+    /// Clear all shader node implementations cached in this context.
+    /// Implementations held by an attached implementation cache are
+    /// not affected.
     void clearNodeImplementations();
 
+    /// Attach an implementation cache to this context, which then holds all
+    /// implementations added to the context.  The cache may be shared with
+    /// other contexts, including contexts used concurrently on other threads.
+    /// Pass nullptr to detach the current cache.
+    void setNodeImplementationCache(ShaderNodeImplCachePtr cache)
+    {
+        _nodeImplCache = cache;
+    }
+
+    /// Return the attached implementation cache, if any.
+    ShaderNodeImplCachePtr getNodeImplementationCache() const
+    {
+        return _nodeImplCache;
+    }
+
     /// Add user data to the context to make it
     /// available during shader generator.
     void pushUserData(const string& name, GenUserDataPtr data)
@@ -172,9 +271,15 @@ class MX_GENSHADER_API GenContext
     // Set of globally reserved words.
     StringSet _reservedWords;
 
+    // Token substitutions.
+    StringMap _tokenSubstitutions;
+
     // Cached shader node implementations.
     std::unordered_map<string, ShaderNodeImplPtr> _nodeImpls;
 
+    // Shared implementation cache.
+    ShaderNodeImplCachePtr _nodeImplCache;
+
     // User data
     std::unordered_map<string, vector<GenUserDataPtr>> _userData;
 
@@ -27,7 +27,9 @@ enum ShaderInterfaceType
     /// Create a reduced interface with uniforms only for
     /// the inputs that has been declared in the shaders
     /// nodedef interface. If values on other inputs are
-    /// changed the shader needs to be rebuilt.
+    /// changed the shader needs to be rebuilt. Nodes whose
+    /// inputs are all constant are evaluated during generation
+    /// and replaced by their resulting values.
     SHADER_INTERFACE_REDUCED
 };
 
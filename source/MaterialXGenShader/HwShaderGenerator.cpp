@@ -396,12 +396,10 @@ ShaderPtr HwShaderGenerator::createShader(const string& name, ElementPtr element
                     if (!input->getConnection() && input->getType() == Type::FILENAME)
                     {
                         // Create the uniform using the filename type to make this uniform into a texture sampler.
+                        // The input is left unmodified, since compound graphs may be shared by other shaders,
+                        // and getUpstreamResult refers to the uniform by name during code generation.
                         ShaderPort* filename = psPublicUniforms->add(Type::FILENAME, input->getVariable(), input->getValue());
                         filename->setPath(input->getPath());
-
-                        // Assing the uniform name to the input value
-                        // so we can reference it during code generation.
-                        input->setValue(Value::createValue(input->getVariable()));
                     }
                 }
             }
@@ -489,6 +487,17 @@ void HwShaderGenerator::emitFunctionCall(const ShaderNode& node, GenContext& con
     }
 }
 
+string HwShaderGenerator::getUpstreamResult(const ShaderInput* input, GenContext& context) const
+{
+    if (!input->getConnection() && input->getType() == Type::FILENAME &&
+        input->getNode()->hasClassification(ShaderNode::Classification::FILETEXTURE))
+    {
+        // Refer to the texture sampler uniform created for this input.
+        return input->getVariable();
+    }
+    return ShaderGenerator::getUpstreamResult(input, context);
+}
+
 void HwShaderGenerator::emitTextureNodes(const ShaderGraph& graph, GenContext& context, ShaderStage& stage) const
 {
     // Emit function calls for all texturing nodes
@@ -582,19 +591,7 @@ void HwShaderGenerator::bindLightShader(const NodeDef& nodeDef, unsigned int lig
 
     ShaderNodePtr shader = ShaderNode::create(nullptr, nodeDef.getNodeString(), nodeDef, context);
 
-    // Check if this is a graph implementation.
-    // If so prepend the light struct instance name on all input socket variables,
-    // since in generated code these inputs will be members of the light struct.
-    ShaderGraph* graph = shader->getImplementation().getGraph();
-    if (graph)
-    {
-        for (ShaderGraphInputSocket* inputSockets : graph->getInputSockets())
-        {
-            inputSockets->setVariable("light." + inputSockets->getVariable());
-        }
-    }
-
-    lightShaders->bind(lightTypeId, shader);
+    lightShaders->bind(lightTypeId, shader, nodeDef.getSelf()->asA<NodeDef>());
 }
 
 void HwShaderGenerator::unbindLightShader(unsigned int lightTypeId, GenContext& context)
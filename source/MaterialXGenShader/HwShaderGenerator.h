@@ -315,22 +315,26 @@ class MX_GENSHADER_API HwLightShaders : public GenUserData
         return std::make_shared<HwLightShaders>();
     }
 
-    /// Bind a light shader to a light type id.
-    void bind(unsigned int type, ShaderNodePtr shader)
+    /// Bind a light shader to a light type id, optionally recording the
+    /// node definition from which the light shader was created.
+    void bind(unsigned int type, ShaderNodePtr shader, ConstNodeDefPtr nodeDef = nullptr)
     {
         _shaders[type] = shader;
+        _nodeDefs[type] = nodeDef;
     }
 
     /// Unbind a light shader previously bound to a light type id.
     void unbind(unsigned int type)
     {
         _shaders.erase(type);
+        _nodeDefs.erase(type);
     }
 
     /// Clear all light shaders previously bound.
     void clear()
     {
         _shaders.clear();
+        _nodeDefs.clear();
     }
 
     /// Return the light shader bound to the given light type,
@@ -347,8 +351,17 @@ class MX_GENSHADER_API HwLightShaders : public GenUserData
         return _shaders;
     }
 
+    /// Return the node definition of the light shader bound to the given
+    /// light type, or nullptr if none was recorded.
+    ConstNodeDefPtr getNodeDef(unsigned int type) const
+    {
+        auto it = _nodeDefs.find(type);
+        return it != _nodeDefs.end() ? it->second : nullptr;
+    }
+
   protected:
     std::unordered_map<unsigned int, ShaderNodePtr> _shaders;
+    std::unordered_map<unsigned int, ConstNodeDefPtr> _nodeDefs;
 };
 
 /// @class HwShaderGenerator
@@ -360,6 +373,10 @@ class MX_GENSHADER_API HwShaderGenerator : public ShaderGenerator
     void emitFunctionCall(const ShaderNode& node, GenContext& context, ShaderStage& stage, 
                           bool checkScope = true) const override;
 
+    /// Return the variable name to use for an input, where unconnected filename
+    /// inputs on file texture nodes refer to their texture sampler uniforms.
+    string getUpstreamResult(const ShaderInput* input, GenContext& context) const override;
+
     /// Emit code for all texturing nodes.
     virtual void emitTextureNodes(const ShaderGraph& graph, GenContext& context, ShaderStage& stage) const;
 
@@ -25,6 +25,7 @@ class ShaderOutput;
 class ShaderNodeImpl;
 class GenOptions;
 class GenContext;
+class ShaderNodeImplCache;
 class TypeDesc;
 
 /// A string stream
@@ -40,6 +41,8 @@ using ShaderGeneratorPtr = shared_ptr<ShaderGenerator>;
 using ShaderNodeImplPtr = shared_ptr<ShaderNodeImpl>;
 /// Shared pointer to a GenContext
 using GenContextPtr = shared_ptr<GenContext>;
+/// Shared pointer to a ShaderNodeImplCache
+using ShaderNodeImplCachePtr = shared_ptr<ShaderNodeImplCache>;
 
 template<class T> using CreatorFunction = shared_ptr<T>(*)();
 
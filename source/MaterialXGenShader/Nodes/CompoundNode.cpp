@@ -58,6 +58,7 @@ void CompoundNode::createVariables(const ShaderNode&, GenContext& context, Shade
 void CompoundNode::emitFunctionDefinition(const ShaderNode&, GenContext& context, ShaderStage& stage) const
 {
     BEGIN_SHADER_STAGE(stage, Stage::PIXEL)
+        std::lock_guard<std::mutex> guard(_emitMutex);
         const ShaderGenerator& shadergen = context.getShaderGenerator();
         const Syntax& syntax = shadergen.getSyntax();
 
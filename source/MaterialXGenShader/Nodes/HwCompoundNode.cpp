@@ -18,6 +18,7 @@ ShaderNodeImplPtr HwCompoundNode::create()
 void HwCompoundNode::emitFunctionDefinition(const ShaderNode& node, GenContext& context, ShaderStage& stage) const
 {
     BEGIN_SHADER_STAGE(stage, Stage::PIXEL)
+        std::lock_guard<std::mutex> guard(_emitMutex);
         const HwShaderGenerator& shadergen = static_cast<const HwShaderGenerator&>(context.getShaderGenerator());
 
         // Emit functions for all child nodes
@@ -122,6 +123,7 @@ void HwCompoundNode::emitFunctionCall(const ShaderNode& node, GenContext& contex
     BEGIN_SHADER_STAGE(stage, Stage::VERTEX)
         // Emit function calls for all child nodes to the vertex shader stage
         // TODO: Is this ever usefull?
+        std::lock_guard<std::mutex> guard(_emitMutex);
         shadergen.emitFunctionCalls(*_rootGraph, context, stage);
     END_SHADER_STAGE(stage, Stage::VERTEX)
 
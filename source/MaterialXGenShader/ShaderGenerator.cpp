@@ -418,7 +418,7 @@ void ShaderGenerator::finalizeShaderGraph(ShaderGraph& graph)
 
             // Find vertical layering nodes connected to this thinfilm.
             vector<ShaderNode*> layerNodes;
-            for (ShaderInput* dest : output->getConnections())
+            for (ShaderInput* dest : output->getOrderedConnections())
             {
                 ShaderNode* layerNode = dest->getNode();
 
@@ -470,7 +470,7 @@ void ShaderGenerator::finalizeShaderGraph(ShaderGraph& graph)
                     // Iterate a copy of the connection set since the original set will
                     // change when breaking connections.
                     base->breakConnection();
-                    ShaderInputSet downstreamConnections = layerNode->getOutput()->getConnections();
+                    ShaderInputVec downstreamConnections = layerNode->getOutput()->getOrderedConnections();
                     for (ShaderInput* downstream : downstreamConnections)
                     {
                         downstream->breakConnection();
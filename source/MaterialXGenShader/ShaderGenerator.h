@@ -217,7 +217,7 @@ class MX_GENSHADER_API ShaderGenerator
     Factory<ShaderNodeImpl> _implFactory;
     ColorManagementSystemPtr _colorManagementSystem;
     UnitSystemPtr _unitSystem;
-    mutable StringMap _tokenSubstitutions;
+    StringMap _tokenSubstitutions;
 
     friend ShaderGraph;
 };
@@ -9,12 +9,449 @@
 #include <MaterialXGenShader/ShaderGenerator.h>
 #include <MaterialXGenShader/Util.h>
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <queue>
 
 namespace MaterialX
 {
 
+namespace
+{
+
+using FloatVec = vector<float>;
+
+// Nodes that are evaluated at generation time when all of their inputs are
+// constant.
+const StringSet FOLDABLE_NODES =
+{
+    "add", "subtract", "multiply", "divide", "modulo", "invert", "absval",
+    "floor", "ceil", "power", "sin", "cos", "tan", "asin", "acos", "atan2",
+    "sqrt", "ln", "exp", "sign", "clamp", "min", "max", "normalize",
+    "magnitude", "dotproduct", "crossproduct", "mix", "remap", "smoothstep",
+    "convert", "swizzle", "combine2", "combine3", "combine4", "extract", "dot"
+};
+
+template<class T> FloatVec getVectorFloats(const T& vec)
+{
+    FloatVec result(T::numElements());
+    for (size_t i = 0; i < T::numElements(); i++)
+    {
+        result[i] = vec[i];
+    }
+    return result;
+}
+
+template<class T> ValuePtr createVectorValue(const FloatVec& floats)
+{
+    T vec;
+    for (size_t i = 0; i < T::numElements(); i++)
+    {
+        vec[i] = floats[i];
+    }
+    return Value::createValue<T>(vec);
+}
+
+// Return the components of a scalar or vector value.
+bool getFloats(ValuePtr value, FloatVec& floats)
+{
+    if (!value)
+    {
+        return false;
+    }
+    if (value->isA<float>())
+    {
+        floats = { value->asA<float>() };
+    }
+    else if (value->isA<int>())
+    {
+        floats = { (float) value->asA<int>() };
+    }
+    else if (value->isA<bool>())
+    {
+        floats = { value->asA<bool>() ? 1.0f : 0.0f };
+    }
+    else if (value->isA<Color3>())
+    {
+        floats = getVectorFloats(value->asA<Color3>());
+    }
+    else if (value->isA<Color4>())
+    {
+        floats = getVectorFloats(value->asA<Color4>());
+    }
+    else if (value->isA<Vector2>())
+    {
+        floats = getVectorFloats(value->asA<Vector2>());
+    }
+    else if (value->isA<Vector3>())
+    {
+        floats = getVectorFloats(value->asA<Vector3>());
+    }
+    else if (value->isA<Vector4>())
+    {
+        floats = getVectorFloats(value->asA<Vector4>());
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+// Create a value of the given type from its components.
+ValuePtr createFloatValue(const FloatVec& floats, const TypeDesc* type)
+{
+    if (floats.size() != type->getSize())
+    {
+        return nullptr;
+    }
+    if (type == Type::FLOAT)
+    {
+        return Value::createValue<float>(floats[0]);
+    }
+    if (type == Type::COLOR3)
+    {
+        return createVectorValue<Color3>(floats);
+    }
+    if (type == Type::COLOR4)
+    {
+        return createVectorValue<Color4>(floats);
+    }
+    if (type == Type::VECTOR2)
+    {
+        return createVectorValue<Vector2>(floats);
+    }
+    if (type == Type::VECTOR3)
+    {
+        return createVectorValue<Vector3>(floats);
+    }
+    if (type == Type::VECTOR4)
+    {
+        return createVectorValue<Vector4>(floats);
+    }
+    return nullptr;
+}
+
+// Evaluates a stdlib node with constant arguments, following the
+// semantics of the shading language implementations.
+class ConstantEvaluator
+{
+  public:
+    ConstantEvaluator(const std::unordered_map<string, FloatVec>& args, const TypeDesc* inType, size_t size) :
+        _args(args),
+        _inType(inType),
+        _size(size)
+    {
+    }
+
+    bool evaluate(const string& category, const string& channels, FloatVec& result)
+    {
+        if (category == "add")
+            return binary("in1", "in2", result, [](float a, float b) { return a + b; });
+        if (category == "subtract")
+            return binary("in1", "in2", result, [](float a, float b) { return a - b; });
+        if (category == "multiply")
+            return binary("in1", "in2", result, [](float a, float b) { return a * b; });
+        if (category == "divide")
+            return binary("in1", "in2", result, [](float a, float b) { return a / b; });
+        if (category == "modulo")
+            return binary("in1", "in2", result, [](float a, float b) { return a - b * std::floor(a / b); });
+        if (category == "invert")
+            return binary("amount", "in", result, [](float a, float b) { return a - b; });
+        if (category == "power")
+            return binary("in1", "in2", result, [](float a, float b) { return a < 0.0f ? NAN : std::pow(a, b); });
+        if (category == "atan2")
+            return binary("in1", "in2", result, [](float a, float b) { return (a == 0.0f && b == 0.0f) ? NAN : std::atan2(a, b); });
+        if (category == "min")
+            return binary("in1", "in2", result, [](float a, float b) { return std::min(a, b); });
+        if (category == "max")
+            return binary("in1", "in2", result, [](float a, float b) { return std::max(a, b); });
+        if (category == "absval")
+            return unary("in", result, [](float a) { return std::abs(a); });
+        if (category == "floor")
+            return unary("in", result, [](float a) { return std::floor(a); });
+        if (category == "ceil")
+            return unary("in", result, [](float a) { return std::ceil(a); });
+        if (category == "sin")
+            return unary("in", result, [](float a) { return std::sin(a); });
+        if (category == "cos")
+            return unary("in", result, [](float a) { return std::cos(a); });
+        if (category == "tan")
+            return unary("in", result, [](float a) { return std::tan(a); });
+        if (category == "asin")
+            return unary("in", result, [](float a) { return std::asin(a); });
+        if (category == "acos")
+            return unary("in", result, [](float a) { return std::acos(a); });
+        if (category == "sqrt")
+            return unary("in", result, [](float a) { return std::sqrt(a); });
+        if (category == "ln")
+            return unary("in", result, [](float a) { return a <= 0.0f ? NAN : std::log(a); });
+        if (category == "exp")
+            return unary("in", result, [](float a) { return std::exp(a); });
+        if (category == "sign")
+            return unary("in", result, [](float a) { return a > 0.0f ? 1.0f : (a < 0.0f ? -1.0f : 0.0f); });
+        if (category == "dot")
+            return unary("in", result, [](float a) { return a; });
+        if (category == "clamp")
+            return ternary("in", "low", "high", result, [](float a, float low, float high) { return std::min(std::max(a, low), high); });
+        if (category == "mix")
+            return ternary("bg", "fg", "mix", result, [](float bg, float fg, float m) { return bg * (1.0f - m) + fg * m; });
+        if (category == "smoothstep")
+        {
+            return ternary("in", "low", "high", result, [](float a, float low, float high)
+            {
+                if (a <= low)
+                    return 0.0f;
+                if (a >= high)
+                    return 1.0f;
+                float t = (a - low) / (high - low);
+                return t * t * (3.0f - 2.0f * t);
+            });
+        }
+        if (category == "remap")
+            return remap(result);
+        if (category == "normalize" || category == "magnitude" || category == "dotproduct")
+            return geometric(category, result);
+        if (category == "crossproduct")
+            return crossproduct(result);
+        if (category == "combine2" || category == "combine3" || category == "combine4")
+            return combine(result);
+        if (category == "extract")
+            return extract(result);
+        if (category == "convert")
+            return convert(result);
+        if (category == "swizzle")
+            return swizzle(channels, result);
+        return false;
+    }
+
+  protected:
+    const FloatVec* get(const string& name) const
+    {
+        auto it = _args.find(name);
+        if (it == _args.end() || (it->second.size() != 1 && it->second.size() != _size))
+        {
+            return nullptr;
+        }
+        return &it->second;
+    }
+
+    static float at(const FloatVec& vec, size_t i)
+    {
+        return vec.size() == 1 ? vec[0] : vec[i];
+    }
+
+    template<class F> bool unary(const string& a, FloatVec& result, F func)
+    {
+        const FloatVec* va = get(a);
+        if (!va)
+        {
+            return false;
+        }
+        result.resize(_size);
+        for (size_t i = 0; i < _size; i++)
+        {
+            result[i] = func(at(*va, i));
+        }
+        return true;
+    }
+
+    template<class F> bool binary(const string& a, const string& b, FloatVec& result, F func)
+    {
+        const FloatVec* va = get(a);
+        const FloatVec* vb = get(b);
+        if (!va || !vb)
+        {
+            return false;
+        }
+        result.resize(_size);
+        for (size_t i = 0; i < _size; i++)
+        {
+            result[i] = func(at(*va, i), at(*vb, i));
+        }
+        return true;
+    }
+
+    template<class F> bool ternary(const string& a, const string& b, const string& c, FloatVec& result, F func)
+    {
+        const FloatVec* va = get(a);
+        const FloatVec* vb = get(b);
+        const FloatVec* vc = get(c);
+        if (!va || !vb || !vc)
+        {
+            return false;
+        }
+        result.resize(_size);
+        for (size_t i = 0; i < _size; i++)
+        {
+            result[i] = func(at(*va, i), at(*vb, i), at(*vc, i));
+        }
+        return true;
+    }
+
+    bool remap(FloatVec& result)
+    {
+        const FloatVec* in = get("in");
+        const FloatVec* inLow = get("inlow");
+        const FloatVec* inHigh = get("inhigh");
+        const FloatVec* outLow = get("outlow");
+        const FloatVec* outHigh = get("outhigh");
+        if (!in || !inLow || !inHigh || !outLow || !outHigh)
+        {
+            return false;
+        }
+        result.resize(_size);
+        for (size_t i = 0; i < _size; i++)
+        {
+            result[i] = at(*outLow, i) + (at(*in, i) - at(*inLow, i)) *
+                        (at(*outHigh, i) - at(*outLow, i)) / (at(*inHigh, i) - at(*inLow, i));
+        }
+        return true;
+    }
+
+    bool geometric(const string& category, FloatVec& result)
+    {
+        auto in1 = _args.find(category == "dotproduct" ? "in1" : "in");
+        auto in2 = _args.find(category == "dotproduct" ? "in2" : "in");
+        if (in1 == _args.end() || in2 == _args.end() || in1->second.size() != in2->second.size())
+        {
+            return false;
+        }
+        float dot = 0.0f;
+        for (size_t i = 0; i < in1->second.size(); i++)
+        {
+            dot += in1->second[i] * in2->second[i];
+        }
+        if (category == "dotproduct")
+        {
+            result = { dot };
+        }
+        else if (category == "magnitude")
+        {
+            result = { std::sqrt(dot) };
+        }
+        else
+        {
+            if (dot <= 0.0f || in1->second.size() != _size)
+            {
+                return false;
+            }
+            const float length = std::sqrt(dot);
+            result.resize(_size);
+            for (size_t i = 0; i < _size; i++)
+            {
+                result[i] = in1->second[i] / length;
+            }
+        }
+        return true;
+    }
+
+    bool crossproduct(FloatVec& result)
+    {
+        auto in1 = _args.find("in1");
+        auto in2 = _args.find("in2");
+        if (_size != 3 || in1 == _args.end() || in2 == _args.end() ||
+            in1->second.size() != 3 || in2->second.size() != 3)
+        {
+            return false;
+        }
+        const FloatVec& a = in1->second;
+        const FloatVec& b = in2->second;
+        result = { a[1] * b[2] - a[2] * b[1],
+                   a[2] * b[0] - a[0] * b[2],
+                   a[0] * b[1] - a[1] * b[0] };
+        return true;
+    }
+
+    bool combine(FloatVec& result)
+    {
+        result.clear();
+        for (const char* name : { "in1", "in2", "in3", "in4" })
+        {
+            auto it = _args.find(name);
+            if (it != _args.end())
+            {
+                result.insert(result.end(), it->second.begin(), it->second.end());
+            }
+        }
+        return result.size() == _size;
+    }
+
+    bool extract(FloatVec& result)
+    {
+        auto in = _args.find("in");
+        auto index = _args.find("index");
+        if (in == _args.end() || index == _args.end() || index->second.size() != 1)
+        {
+            return false;
+        }
+        const int i = (int) index->second[0];
+        if (i < 0 || i >= (int) in->second.size())
+        {
+            return false;
+        }
+        result = { in->second[i] };
+        return true;
+    }
+
+    bool convert(FloatVec& result)
+    {
+        auto in = _args.find("in");
+        if (in == _args.end())
+        {
+            return false;
+        }
+        const FloatVec& src = in->second;
+        if (src.size() == 1)
+        {
+            result.assign(_size, src[0]);
+            return true;
+        }
+
+        // Truncate, or pad with zero for a third and one for a fourth component.
+        result.resize(_size);
+        for (size_t i = 0; i < _size; i++)
+        {
+            result[i] = i < src.size() ? src[i] : (i == 3 ? 1.0f : 0.0f);
+        }
+        return true;
+    }
+
+    bool swizzle(const string& channels, FloatVec& result)
+    {
+        auto in = _args.find("in");
+        if (in == _args.end() || !_inType || channels.size() != _size)
+        {
+            return false;
+        }
+        result.resize(_size);
+        for (size_t i = 0; i < _size; i++)
+        {
+            const char ch = channels[i];
+            if (ch == '0' || ch == '1')
+            {
+                result[i] = ch == '1' ? 1.0f : 0.0f;
+                continue;
+            }
+            const int index = in->second.size() == 1 ? 0 : _inType->getChannelIndex(ch);
+            if (index < 0 || index >= (int) in->second.size())
+            {
+                return false;
+            }
+            result[i] = in->second[index];
+        }
+        return true;
+    }
+
+  protected:
+    const std::unordered_map<string, FloatVec>& _args;
+    const TypeDesc* _inType;
+    const size_t _size;
+};
+
+} // anonymous namespace
+
 //
 // ShaderGraph methods
 //
@@ -311,7 +748,7 @@ void ShaderGraph::addColorTransformNode(ShaderOutput* output, const ColorSpaceTr
         ShaderNode* colorTransformNode = colorTransformNodePtr.get();
         ShaderOutput* colorTransformNodeOutput = colorTransformNode->getOutput(0);
 
-        ShaderInputSet inputs = output->getConnections();
+        ShaderInputVec inputs = output->getOrderedConnections();
         for (ShaderInput* input : inputs)
         {
             input->breakConnection();
@@ -375,7 +812,7 @@ void ShaderGraph::addUnitTransformNode(ShaderOutput* output, const UnitTransform
         ShaderNode* unitTransformNode = unitTransformNodePtr.get();
         ShaderOutput* unitTransformNodeOutput = unitTransformNode->getOutput(0);
 
-        ShaderInputSet inputs = output->getConnections();
+        ShaderInputVec inputs = output->getOrderedConnections();
         for (ShaderInput* input : inputs)
         {
             string inname = input->getFullName();
@@ -953,7 +1390,7 @@ void ShaderGraph::finalize(GenContext& context)
                 // emit this for each layering instance used.
                 bool exclude = true;
                 const ShaderOutput* output = node->getOutput();
-                for (const ShaderInput* downstreamInput : output->getConnections())
+                for (const ShaderInput* downstreamInput : output->getOrderedConnections())
                 {
                     if (!downstreamInput->getNode()->hasClassification(ShaderNode::Classification::LAYER) ||
                         downstreamInput->getName() != "top")
@@ -1025,56 +1462,78 @@ void ShaderGraph::disconnect(ShaderNode* node) const
 
 void ShaderGraph::optimize(GenContext& context)
 {
+    // Constant folding removes the inputs of folded nodes from the shader
+    // interface, so it's only done when a reduced interface is requested.
+    const bool foldConstants = context.getOptions().shaderInterfaceType == SHADER_INTERFACE_REDUCED;
+
+    // Repeat until no more edits are found, since each edit may turn
+    // the inputs of downstream nodes into constant values.
+    std::set<ShaderNode*> editedNodes;
     size_t numEdits = 0;
-    for (ShaderNode* node : getNodes())
+    bool edited = true;
+    while (edited)
     {
-        if (node->hasClassification(ShaderNode::Classification::CONSTANT))
+        edited = false;
+        for (ShaderNode* node : getNodes())
         {
-            // Constant nodes can be removed by assigning their value downstream
-            // But don't remove it if it's connected upstream, i.e. it's value
-            // input is published.
-            ShaderInput* valueInput = node->getInput(0);
-            if (!valueInput->getConnection())
+            if (editedNodes.count(node))
             {
-                bypass(context, node, 0);
-                ++numEdits;
+                continue;
             }
-        }
-        else if (node->hasClassification(ShaderNode::Classification::IFELSE))
-        {
-            // Check if we have a constant conditional expression
-            ShaderInput* intest = node->getInput("intest");
-            if (!intest->getConnection())
-            {
-                // Find which branch should be taken
-                ShaderInput* cutoff = node->getInput("cutoff");
-                ValuePtr value = intest->getValue();
-                const float intestValue = value ? value->asA<float>() : 0.0f;
-                const int branch = (intestValue <= cutoff->getValue()->asA<float>() ? 2 : 3);
 
-                // Bypass the conditional using the taken branch
-                bypass(context, node, branch);
-
-                ++numEdits;
+            if (node->hasClassification(ShaderNode::Classification::CONSTANT))
+            {
+                // Constant nodes can be removed by assigning their value downstream
+                // But don't remove it if it's connected upstream, i.e. it's value
+                // input is published.
+                ShaderInput* valueInput = node->getInput(0);
+                if (!valueInput->getConnection())
+                {
+                    bypass(context, node, 0);
+                    editedNodes.insert(node);
+                }
             }
-        }
-        else if (node->hasClassification(ShaderNode::Classification::SWITCH))
-        {
-            // Check if we have a constant conditional expression
-            const ShaderInput* which = node->getInput("which");
-            if (!which->getConnection())
+            else if (node->hasClassification(ShaderNode::Classification::IFELSE))
             {
-                // Find which branch should be taken
-                ValuePtr value = which->getValue();
-                const int branch = int(value==nullptr ? 0 :
-                    (which->getType() == Type::FLOAT ? value->asA<float>() : value->asA<int>()));
-
-                // Bypass the conditional using the taken branch
-                bypass(context, node, branch);
-
-                ++numEdits;
+                // Check if we have a constant conditional expression
+                ShaderInput* intest = node->getInput("intest");
+                if (!intest->getConnection())
+                {
+                    // Find which branch should be taken
+                    ShaderInput* cutoff = node->getInput("cutoff");
+                    ValuePtr value = intest->getValue();
+                    const float intestValue = value ? value->asA<float>() : 0.0f;
+                    const int branch = (intestValue <= cutoff->getValue()->asA<float>() ? 2 : 3);
+
+                    // Bypass the conditional using the taken branch
+                    bypass(context, node, branch);
+                    editedNodes.insert(node);
+                }
+            }
+            else if (node->hasClassification(ShaderNode::Classification::SWITCH))
+            {
+                // Check if we have a constant conditional expression
+                const ShaderInput* which = node->getInput("which");
+                if (!which->getConnection())
+                {
+                    // Find which branch should be taken
+                    ValuePtr value = which->getValue();
+                    const int branch = int(value==nullptr ? 0 :
+                        (which->getType() == Type::FLOAT ? value->asA<float>() : value->asA<int>()));
+
+                    // Bypass the conditional using the taken branch
+                    bypass(context, node, branch);
+                    editedNodes.insert(node);
+                }
+            }
+            else if (foldConstants && fold(context, node))
+            {
+                editedNodes.insert(node);
             }
         }
+
+        edited = editedNodes.size() > numEdits;
+        numEdits = editedNodes.size();
     }
 
     if (numEdits > 0)
@@ -1122,7 +1581,7 @@ void ShaderGraph::bypass(GenContext& context, ShaderNode* node, size_t inputInde
         // Re-route the upstream output to the downstream inputs.
         // Iterate a copy of the connection set since the
         // original set will change when breaking connections.
-        ShaderInputSet downstreamConnections = output->getConnections();
+        ShaderInputVec downstreamConnections = output->getOrderedConnections();
         for (ShaderInput* downstream : downstreamConnections)
         {
             output->breakConnection(downstream);
@@ -1135,7 +1594,7 @@ void ShaderGraph::bypass(GenContext& context, ShaderNode* node, size_t inputInde
         // so push the input's value and element path downstream instead.
         // Iterate a copy of the connection set since the
         // original set will change when breaking connections.
-        ShaderInputSet downstreamConnections = output->getConnections();
+        ShaderInputVec downstreamConnections = output->getOrderedConnections();
         for (ShaderInput* downstream : downstreamConnections)
         {
             output->breakConnection(downstream);
@@ -1163,6 +1622,92 @@ void ShaderGraph::bypass(GenContext& context, ShaderNode* node, size_t inputInde
     }
 }
 
+bool ShaderGraph::fold(GenContext& context, ShaderNode* node)
+{
+    const string& category = node->getCategory();
+    if (!FOLDABLE_NODES.count(category) || node->numOutputs() != 1)
+    {
+        return false;
+    }
+    ShaderOutput* output = node->getOutput();
+    const TypeDesc* outputType = output->getType();
+    if (output->getConnections().empty())
+    {
+        return false;
+    }
+
+    // Gather the input values, all of which must be constant.
+    std::unordered_map<string, FloatVec> args;
+    const TypeDesc* inType = nullptr;
+    string channels;
+    for (const ShaderInput* input : node->getInputs())
+    {
+        if (input->getConnection())
+        {
+            return false;
+        }
+        if (input->getType() == Type::STRING)
+        {
+            if (input->getName() == "channels" && input->getValue())
+            {
+                channels = input->getValue()->getValueString();
+            }
+            continue;
+        }
+        FloatVec floats;
+        if (!getFloats(input->getValue(), floats) || floats.size() != input->getType()->getSize())
+        {
+            return false;
+        }
+        if (input->getName() == "in")
+        {
+            inType = input->getType();
+        }
+        args[input->getName()] = floats;
+    }
+
+    FloatVec result;
+    ConstantEvaluator evaluator(args, inType, outputType->getSize());
+    if (!evaluator.evaluate(category, channels, result))
+    {
+        return false;
+    }
+    for (float f : result)
+    {
+        if (!std::isfinite(f))
+        {
+            return false;
+        }
+    }
+    ValuePtr value = createFloatValue(result, outputType);
+    if (!value)
+    {
+        return false;
+    }
+
+    // Push the value downstream, swizzling it where needed.
+    // Iterate a copy of the connection set since the
+    // original set will change when breaking connections.
+    ShaderInputVec downstreamConnections = output->getOrderedConnections();
+    for (ShaderInput* downstream : downstreamConnections)
+    {
+        output->breakConnection(downstream);
+        downstream->setValue(value);
+        const string& downstreamChannels = downstream->getChannels();
+        if (!downstreamChannels.empty())
+        {
+            downstream->setValue(context.getShaderGenerator().getSyntax().getSwizzledValue(value,
+                                                                                          outputType,
+                                                                                          downstreamChannels,
+                                                                                          downstream->getType()));
+            downstream->setChannels(EMPTY_STRING);
+        }
+    }
+
+    _foldedNodes.push_back(node->getName());
+    return true;
+}
+
 void ShaderGraph::topologicalSort()
 {
     // Calculate a topological order of the children, using Kahn's algorithm
@@ -1208,7 +1753,7 @@ void ShaderGraph::topologicalSort()
         // adding node to the queue if in-degrees becomes 0.
         for (const auto& output : node->getOutputs())
         {
-            for (const auto& input : output->getConnections())
+            for (const auto& input : output->getOrderedConnections())
             {
                 if (input->getNode() != this)
                 {
@@ -106,6 +106,10 @@ class MX_GENSHADER_API ShaderGraph : public ShaderNode
     /// Return the map of unique identifiers used in the scope of this graph.
     IdentifierMap& getIdentifierMap() { return _identifiers; }
 
+    /// Return the names of nodes that were folded into constant values
+    /// when the graph was optimized.
+    const StringVec& getFoldedNodes() const { return _foldedNodes; }
+
   protected:
     static ShaderGraphPtr createSurfaceShader(
         const string& name,
@@ -164,6 +168,11 @@ class MX_GENSHADER_API ShaderGraph : public ShaderNode
     /// with the output's downstream connections.
     void bypass(GenContext& context, ShaderNode* node, size_t inputIndex, size_t outputIndex = 0);
 
+    /// Fold a node whose inputs are all constant, evaluating it and
+    /// pushing the resulting value to its downstream connections.
+    /// Returns true if the node was folded.
+    bool fold(GenContext& context, ShaderNode* node);
+
     /// Sort the nodes in topological order.
     /// @throws ExceptionFoundCycle if a cycle is encountered.
     void topologicalSort();
@@ -191,6 +200,7 @@ class MX_GENSHADER_API ShaderGraph : public ShaderNode
     std::unordered_map<string, ShaderNodePtr> _nodeMap;
     std::vector<ShaderNode*> _nodeOrder;
     IdentifierMap _identifiers;
+    StringVec _foldedNodes;
 
     // Temporary storage for inputs that require color transformations
     std::unordered_map<ShaderInput*, ColorSpaceTransform> _inputColorTransformMap;
@@ -9,6 +9,8 @@
 #include <MaterialXGenShader/ShaderGenerator.h>
 #include <MaterialXGenShader/Util.h>
 
+#include <algorithm>
+
 namespace MaterialX
 {
 
@@ -48,6 +50,7 @@ void ShaderInput::makeConnection(ShaderOutput* src)
     breakConnection();
     _connection = src;
     src->_connections.insert(this);
+    src->_orderedConnections.push_back(this);
 }
 
 void ShaderInput::breakConnection()
@@ -55,6 +58,8 @@ void ShaderInput::breakConnection()
     if (_connection)
     {
         _connection->_connections.erase(this);
+        ShaderInputVec& connections = _connection->_orderedConnections;
+        connections.erase(std::find(connections.begin(), connections.end(), this));
         _connection = nullptr;
     }
 }
@@ -86,8 +91,8 @@ void ShaderOutput::breakConnection(ShaderInput* dst)
 
 void ShaderOutput::breakConnections()
 {
-    ShaderInputSet inputSet(_connections);
-    for (ShaderInput* input : inputSet)
+    ShaderInputVec inputs(_orderedConnections);
+    for (ShaderInput* input : inputs)
     {
         input->breakConnection();
     }
@@ -200,6 +205,7 @@ void ShaderNode::ScopeInfo::merge(const ScopeInfo &fromScope)
 ShaderNodePtr ShaderNode::create(const ShaderGraph* parent, const string& name, const NodeDef& nodeDef, GenContext& context)
 {
     ShaderNodePtr newNode = std::make_shared<ShaderNode>(parent, name);
+    newNode->_category = nodeDef.getNodeString();
 
     const ShaderGenerator& shadergen = context.getShaderGenerator();
 
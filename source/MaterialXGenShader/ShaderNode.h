@@ -34,8 +34,10 @@ using ShaderInputPtr = shared_ptr<class ShaderInput>;
 using ShaderOutputPtr = shared_ptr<class ShaderOutput>;
 /// Shared pointer to a ShaderNode
 using ShaderNodePtr = shared_ptr<class ShaderNode>;
-/// Shared pointer to a ShaderInput
+/// A set of ShaderInput pointers
 using ShaderInputSet = std::set<ShaderInput*>;
+/// A vector of ShaderInput pointers
+using ShaderInputVec = vector<ShaderInput*>;
 
 
 /// Metadata to be exported to generated shader.
@@ -298,6 +300,12 @@ class MX_GENSHADER_API ShaderOutput : public ShaderPort
     /// empty if not connected.
     const ShaderInputSet& getConnections() const { return _connections; }
 
+    /// Return the connections to downstream node inputs, in the order
+    /// the connections were made, empty if not connected.  Unlike the
+    /// set returned by getConnections, this order does not depend on the
+    /// addresses of the inputs.
+    const ShaderInputVec& getOrderedConnections() const { return _orderedConnections; }
+
     /// Make a connection from this output to the given input
     void makeConnection(ShaderInput* dst);
 
@@ -309,6 +317,7 @@ class MX_GENSHADER_API ShaderOutput : public ShaderPort
 
   protected:
     ShaderInputSet _connections;
+    ShaderInputVec _orderedConnections;
     friend class ShaderInput;
 };
 
@@ -438,6 +447,13 @@ class MX_GENSHADER_API ShaderNode
         return _name;
     }
 
+    /// Return the node category of the nodedef this node was created from,
+    /// or an empty string if the node was not created from a nodedef.
+    const string& getCategory() const
+    {
+        return _category;
+    }
+
     /// Return the implementation used for this node.
     const ShaderNodeImpl& getImplementation() const
     {
@@ -536,6 +552,7 @@ class MX_GENSHADER_API ShaderNode
 
     const ShaderGraph* _parent;
     string _name;
+    string _category;
     uint32_t _classification;
     uint32_t _flags;
 
@@ -0,0 +1,828 @@
+//
+// TM & (c) 2021 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXGenShader/ShaderSourceCache.h>
+
+#include <MaterialXGenShader/GenContext.h>
+#include <MaterialXGenShader/HwShaderGenerator.h>
+#include <MaterialXGenShader/Shader.h>
+#include <MaterialXGenShader/ShaderGenerator.h>
+#include <MaterialXGenShader/TypeDesc.h>
+
+#include <MaterialXCore/Util.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <sys/stat.h>
+#else
+#include <dlfcn.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <typeinfo>
+
+namespace MaterialX
+{
+
+const size_t ShaderSourceCache::DEFAULT_MAX_SIZE = 256 * 1024 * 1024;
+
+namespace
+{
+
+const string ENTRY_EXTENSION = "mxsc";
+const string INDEX_FILENAME = "index.txt";
+const string ENTRY_HEADER = "MaterialXShaderCache";
+const string ENTRY_FORMAT_VERSION = "1";
+
+const StringSet SHARED_CATEGORIES =
+{
+    "typedef", "geompropdef", "unitdef", "unittypedef"
+};
+
+// A 128-bit digest built from two 64-bit FNV-1a lanes with distinct offset
+// bases, which is stable across platforms and runs.
+class KeyDigest
+{
+  public:
+    KeyDigest() :
+        _lane1(LANE1_OFFSET_BASIS)
+    {
+    }
+
+    template <class T> void add(const T& value)
+    {
+        _lane0.add(value);
+        _lane1.add(value);
+    }
+
+    string get() const
+    {
+        return toHex(_lane0.get()) + toHex(_lane1.get());
+    }
+
+  private:
+    static string toHex(uint64_t value)
+    {
+        static const char* DIGITS = "0123456789abcdef";
+        string str(16, '0');
+        for (int i = 15; i >= 0; i--)
+        {
+            str[i] = DIGITS[value & 0xf];
+            value >>= 4;
+        }
+        return str;
+    }
+
+  private:
+    static const uint64_t LANE1_OFFSET_BASIS = 7809847782465536322ull;
+
+    FnvHash _lane0;
+    FnvHash _lane1;
+};
+
+// A marker whose address identifies the module containing this library.
+const char MODULE_MARKER = 0;
+
+// Return a string identifying the build of the module containing the given
+// address, from the path, size and modification time of its file, or an
+// empty string if the module cannot be found.
+string getModuleIdentity(const void* address)
+{
+    string path;
+#if defined(_WIN32)
+    HMODULE module = nullptr;
+    if (GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                           static_cast<LPCSTR>(address), &module))
+    {
+        char buffer[MAX_PATH];
+        DWORD length = GetModuleFileNameA(module, buffer, MAX_PATH);
+        path.assign(buffer, length);
+    }
+    struct _stat64 info;
+    if (path.empty() || _stat64(path.c_str(), &info) != 0)
+    {
+        return EMPTY_STRING;
+    }
+#else
+    Dl_info moduleInfo;
+    if (dladdr(const_cast<void*>(address), &moduleInfo) && moduleInfo.dli_fname)
+    {
+        path = moduleInfo.dli_fname;
+    }
+    struct stat info;
+    if (path.empty() || stat(path.c_str(), &info) != 0)
+    {
+        return EMPTY_STRING;
+    }
+#endif
+    return path + " " + std::to_string((uint64_t) info.st_size) + " " + std::to_string((int64_t) info.st_mtime);
+}
+
+void addElementContent(KeyDigest& digest, ConstElementPtr elem)
+{
+    digest.add(elem->getCategory());
+    digest.add(elem->getName());
+    StringVec attrNames = elem->getAttributeNames();
+    digest.add((uint64_t) attrNames.size());
+    for (const string& attrName : attrNames)
+    {
+        digest.add(attrName);
+        digest.add(elem->getAttribute(attrName));
+    }
+    const ElementVec& children = elem->getChildren();
+    digest.add((uint64_t) children.size());
+    for (ConstElementPtr child : children)
+    {
+        addElementContent(digest, child);
+    }
+}
+
+bool readBinaryFile(const FilePath& path, string& contents)
+{
+    std::ifstream file(path.asString(), std::ios::in | std::ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+    std::stringstream stream;
+    stream << file.rdbuf();
+    if (!stream)
+    {
+        return false;
+    }
+    contents = stream.str();
+    return true;
+}
+
+bool writeBinaryFile(const FilePath& path, const string& contents)
+{
+    std::ofstream file(path.asString(), std::ios::out | std::ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+    file.write(contents.data(), (std::streamsize) contents.size());
+    file.close();
+    return !file.fail();
+}
+
+// Return a temporary path for the given file, unique to the calling process
+// and thread, so that concurrent writers never share a temporary file.
+FilePath getTemporaryPath(const FilePath& path)
+{
+    static std::atomic<unsigned long> counter(0);
+#if defined(_WIN32)
+    unsigned long processId = (unsigned long) GetCurrentProcessId();
+#else
+    unsigned long processId = (unsigned long) getpid();
+#endif
+    size_t threadId = std::hash<std::thread::id>()(std::this_thread::get_id());
+    return path.asString() + ".tmp." + std::to_string(processId) + "." + std::to_string(threadId) + "." +
+           std::to_string(counter.fetch_add(1, std::memory_order_relaxed));
+}
+
+// Write a file through a temporary file, which then replaces the file in a
+// single rename, so that readers never see a partially written or missing
+// file.
+bool replaceFile(const FilePath& path, const string& contents)
+{
+    FilePath tempPath = getTemporaryPath(path);
+    if (!writeBinaryFile(tempPath, contents))
+    {
+        std::remove(tempPath.asString().c_str());
+        return false;
+    }
+#if defined(_WIN32)
+    bool renamed = MoveFileExA(tempPath.asString().c_str(), path.asString().c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    bool renamed = std::rename(tempPath.asString().c_str(), path.asString().c_str()) == 0;
+#endif
+    if (!renamed)
+    {
+        std::remove(tempPath.asString().c_str());
+        return false;
+    }
+    return true;
+}
+
+size_t getFileSize(const FilePath& path)
+{
+    std::ifstream file(path.asString(), std::ios::in | std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        return 0;
+    }
+    std::streamoff size = file.tellg();
+    return size > 0 ? (size_t) size : 0;
+}
+
+string serializeEntry(const string& key, const StringMap& stageSources)
+{
+    std::set<string> stageNames;
+    for (const auto& stage : stageSources)
+    {
+        stageNames.insert(stage.first);
+    }
+
+    string data = ENTRY_HEADER + " " + ENTRY_FORMAT_VERSION + " " + key + "\n";
+    for (const string& stageName : stageNames)
+    {
+        const string& code = stageSources.at(stageName);
+        data += stageName + " " + std::to_string(code.size()) + "\n";
+        data += code;
+    }
+    return data;
+}
+
+bool parseEntry(const string& data, const string& key, StringMap& stageSources)
+{
+    const string header = ENTRY_HEADER + " " + ENTRY_FORMAT_VERSION + " " + key + "\n";
+    if (data.compare(0, header.size(), header) != 0)
+    {
+        return false;
+    }
+
+    StringMap result;
+    size_t pos = header.size();
+    while (pos < data.size())
+    {
+        size_t lineEnd = data.find('\n', pos);
+        if (lineEnd == string::npos)
+        {
+            return false;
+        }
+        string line = data.substr(pos, lineEnd - pos);
+        size_t space = line.rfind(' ');
+        if (space == string::npos || space == 0)
+        {
+            return false;
+        }
+        string stageName = line.substr(0, space);
+        string sizeString = line.substr(space + 1);
+        if (sizeString.empty() || sizeString.find_first_not_of("0123456789") != string::npos)
+        {
+            return false;
+        }
+        size_t size = (size_t) std::stoull(sizeString);
+        pos = lineEnd + 1;
+        if (size > data.size() - pos)
+        {
+            return false;
+        }
+        result[stageName] = data.substr(pos, size);
+        pos += size;
+    }
+
+    if (result.empty())
+    {
+        return false;
+    }
+    stageSources = result;
+    return true;
+}
+
+} // anonymous namespace
+
+//
+// ShaderSourceCache methods
+//
+
+ShaderSourceCache::ShaderSourceCache(const FilePath& directory, size_t maxSize) :
+    _directory(directory),
+    _maxSize(maxSize),
+    _totalSize(0),
+    _indexModified(false),
+    _hitCount(0),
+    _missCount(0)
+{
+    if (!_directory.exists())
+    {
+        FilePath parent = _directory.getParentPath();
+        FilePathVec missing { _directory };
+        while (!parent.isEmpty() && !parent.exists())
+        {
+            missing.push_back(parent);
+            parent = parent.getParentPath();
+        }
+        for (auto it = missing.rbegin(); it != missing.rend(); ++it)
+        {
+            it->createDirectory();
+        }
+    }
+    if (!_directory.isDirectory())
+    {
+        throw Exception("Unable to create shader cache directory: " + _directory.asString());
+    }
+
+    // Restore the recency order of indexed entries, most recent first.
+    string indexData;
+    if (readBinaryFile(_directory / INDEX_FILENAME, indexData))
+    {
+        std::istringstream stream(indexData);
+        string key;
+        while (std::getline(stream, key))
+        {
+            if (key.empty() || _entryMap.count(key))
+            {
+                continue;
+            }
+            FilePath path = getEntryPath(key);
+            if (path.exists())
+            {
+                size_t size = getFileSize(path);
+                _entries.push_back({ key, size });
+                _entryMap[key] = std::prev(_entries.end());
+                _totalSize += size;
+            }
+        }
+    }
+
+    // Entries missing from the index are treated as least recently used.
+    FilePathVec filenames = _directory.getFilesInDirectory(ENTRY_EXTENSION);
+    std::sort(filenames.begin(), filenames.end(), [](const FilePath& a, const FilePath& b)
+    {
+        return a.asString() < b.asString();
+    });
+    for (const FilePath& filename : filenames)
+    {
+        string baseName = filename.asString();
+        string key = baseName.substr(0, baseName.size() - ENTRY_EXTENSION.size() - 1);
+        if (!_entryMap.count(key))
+        {
+            size_t size = getFileSize(_directory / filename);
+            _entries.push_back({ key, size });
+            _entryMap[key] = std::prev(_entries.end());
+            _totalSize += size;
+            _indexModified = true;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    evict();
+}
+
+ShaderSourceCache::~ShaderSourceCache()
+{
+    try
+    {
+        flush();
+    }
+    catch (std::exception&)
+    {
+    }
+}
+
+StringMap ShaderSourceCache::generate(const string& name, ElementPtr element, GenContext& context)
+{
+    const string key = computeKey(name, element, context);
+
+    StringMap stageSources;
+    if (find(key, stageSources))
+    {
+        return stageSources;
+    }
+
+    ShaderPtr shader = context.getShaderGenerator().generate(name, element, context);
+    if (!shader)
+    {
+        throw ExceptionShaderGenError("Failed to generate shader for element: " + element->getNamePath());
+    }
+    for (size_t i = 0; i < shader->numStages(); ++i)
+    {
+        const ShaderStage& stage = shader->getStage(i);
+        stageSources[stage.getName()] = stage.getSourceCode();
+    }
+    store(key, stageSources);
+    return stageSources;
+}
+
+string ShaderSourceCache::computeKey(const string& name, ConstElementPtr element, GenContext& context)
+{
+    ShaderGenerator& shadergen = context.getShaderGenerator();
+    const string& target = shadergen.getTarget();
+    const GenOptions& options = context.getOptions();
+
+    KeyDigest digest;
+    digest.add(name);
+    digest.add(target);
+    digest.add(getVersionString());
+
+    // The builds of this library and of the module defining the generator,
+    // so that code changes between versions invalidate existing entries.
+    digest.add(getModuleIdentity(&MODULE_MARKER));
+    digest.add(getModuleIdentity(&typeid(shadergen)));
+
+    // Generation options.
+    digest.add((uint64_t) options.shaderInterfaceType);
+    digest.add((uint64_t) options.fileTextureVerticalFlip);
+    digest.add(options.targetColorSpaceOverride);
+    digest.add(options.targetDistanceUnit);
+    digest.add((uint64_t) options.addUpstreamDependencies);
+    digest.add((uint64_t) options.hwTransparency);
+    digest.add((uint64_t) options.hwSpecularEnvironmentMethod);
+    digest.add((uint64_t) options.hwDirectionalAlbedoMethod);
+    digest.add((uint64_t) options.hwWriteDepthMoments);
+    digest.add((uint64_t) options.hwShadowMap);
+    digest.add((uint64_t) options.hwAmbientOcclusion);
+    digest.add((uint64_t) options.hwMaxActiveLightSources);
+    digest.add((uint64_t) options.hwNormalizeUdimTexCoords);
+    digest.add((uint64_t) options.hwWriteAlbedoTable);
+    digest.add((uint64_t) options.hwMaxRadianceSamples);
+
+    // Generator state.
+    ColorManagementSystemPtr cms = shadergen.getColorManagementSystem();
+    digest.add(cms ? cms->getName() : EMPTY_STRING);
+    UnitSystemPtr unitSystem = shadergen.getUnitSystem();
+    digest.add(unitSystem ? unitSystem->getName() : EMPTY_STRING);
+
+    std::set<std::pair<string, string>> substitutions(context.getTokenSubstitutions().begin(),
+                                                      context.getTokenSubstitutions().end());
+    digest.add((uint64_t) substitutions.size());
+    for (const auto& substitution : substitutions)
+    {
+        digest.add(substitution.first);
+        digest.add(substitution.second);
+    }
+
+    HwLightShadersPtr lightShaders = context.getUserData<HwLightShaders>(HW::USER_DATA_LIGHT_SHADERS);
+    if (lightShaders)
+    {
+        std::map<unsigned int, const ShaderNode*> boundShaders;
+        for (const auto& bound : lightShaders->get())
+        {
+            boundShaders[bound.first] = bound.second.get();
+        }
+        digest.add((uint64_t) boundShaders.size());
+        for (const auto& bound : boundShaders)
+        {
+            digest.add((uint64_t) bound.first);
+            digest.add(bound.second->getName());
+            digest.add(bound.second->getImplementation().getName());
+            digest.add((uint64_t) bound.second->getImplementation().getHash());
+        }
+    }
+
+    ShaderMetadataRegistryPtr registry = context.getUserData<ShaderMetadataRegistry>(ShaderMetadataRegistry::USER_DATA_NAME);
+    if (registry)
+    {
+        const ShaderMetadataVec& metadata = registry->getAllMetadata();
+        digest.add((uint64_t) metadata.size());
+        for (const ShaderMetadata& data : metadata)
+        {
+            digest.add(data.name);
+            digest.add(data.type ? data.type->getName() : EMPTY_STRING);
+            digest.add(data.value ? data.value->getValueString() : EMPTY_STRING);
+        }
+    }
+
+    // Document-wide state.
+    ConstDocumentPtr doc = element->getDocument();
+    for (const string& attrName : doc->getAttributeNames())
+    {
+        digest.add(attrName);
+        digest.add(doc->getAttribute(attrName));
+    }
+    for (ElementPtr child : doc->getChildren())
+    {
+        if (SHARED_CATEGORIES.count(child->getCategory()))
+        {
+            addElementContent(digest, child);
+        }
+    }
+
+    // Content upstream of the element.  Each scope is a top-level element,
+    // or the graph containing the element, and is hashed as a whole.
+    std::set<string> libraryFiles;
+    std::set<std::pair<string, string>> libraryTrees;
+    std::set<std::pair<string, string>> libraryRoots;
+    std::set<ConstElementPtr> visited;
+    std::deque<ConstElementPtr> scopes;
+    auto addScope = [&visited, &scopes](ConstElementPtr scope)
+    {
+        if (scope && visited.insert(scope).second)
+        {
+            scopes.push_back(scope);
+        }
+    };
+
+    ConstElementPtr parent = element->getParent();
+    addScope(parent && parent->isA<NodeGraph>() ? parent : element);
+    while (!scopes.empty())
+    {
+        ConstElementPtr scope = scopes.front();
+        scopes.pop_front();
+        addElementContent(digest, scope);
+
+        for (ElementPtr elem : scope->traverseTree())
+        {
+            PortElementPtr port = elem->asA<PortElement>();
+            if (port)
+            {
+                // Connections to top-level nodes and graphs.
+                if (port->hasNodeGraphString())
+                {
+                    addScope(doc->getNodeGraph(port->getNodeGraphString()));
+                }
+                if (port->hasNodeName())
+                {
+                    ElementPtr portParent = port->getParent();
+                    ConstElementPtr graph = portParent->isA<Node>() ? portParent->getParent() : portParent;
+                    if (graph == doc)
+                    {
+                        addScope(doc->getNode(port->getNodeName()));
+                    }
+                }
+                continue;
+            }
+
+            NodePtr node = elem->asA<Node>();
+            if (!node)
+            {
+                continue;
+            }
+            NodeDefPtr nodeDef = node->getNodeDef(target);
+            if (!nodeDef)
+            {
+                continue;
+            }
+            addScope(nodeDef);
+            if (!nodeDef->getActiveSourceUri().empty())
+            {
+                libraryFiles.insert(nodeDef->getActiveSourceUri());
+            }
+
+            InterfaceElementPtr impl = nodeDef->getImplementation(target);
+            addScope(impl);
+            ImplementationPtr implElem = impl ? impl->asA<Implementation>() : nullptr;
+            if (implElem && !implElem->getFile().empty())
+            {
+                FilePath resolvedFile = context.resolveSourceFile(implElem->getFile());
+                if (resolvedFile.exists())
+                {
+                    libraryFiles.insert(resolvedFile.asString());
+
+                    // Find the library directory containing the file, and the
+                    // search path directory containing the library.
+                    const string extension = resolvedFile.getExtension();
+                    FilePath relativeFile = implElem->getFile();
+                    if (!relativeFile.isAbsolute() && relativeFile.size() > 1)
+                    {
+                        FilePath root = resolvedFile;
+                        for (size_t i = 0; i < relativeFile.size(); i++)
+                        {
+                            root = root.getParentPath();
+                        }
+                        libraryTrees.emplace((root / relativeFile[0]).asString(), extension);
+                        libraryRoots.emplace(root.asString(), extension);
+                    }
+                    else
+                    {
+                        libraryTrees.emplace(resolvedFile.getParentPath().asString(), extension);
+                    }
+                }
+            }
+        }
+    }
+
+    // Library file contents, including all source files of the same type
+    // as the implementation files, which may be included by the generated
+    // code: those in the directory tree of each library, and those at the
+    // top level of the search path directory containing the library.
+    digest.add((uint64_t) libraryFiles.size());
+    for (const string& file : libraryFiles)
+    {
+        digest.add(file);
+        digest.add(getFileHash(file));
+    }
+    digest.add((uint64_t) libraryTrees.size());
+    for (const auto& tree : libraryTrees)
+    {
+        digest.add(tree.first);
+        digest.add(getDirectoryHash(tree.first, tree.second, true));
+    }
+    digest.add((uint64_t) libraryRoots.size());
+    for (const auto& root : libraryRoots)
+    {
+        digest.add(root.first);
+        digest.add(getDirectoryHash(root.first, root.second, false));
+    }
+
+    return digest.get();
+}
+
+bool ShaderSourceCache::find(const string& key, StringMap& stageSources)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    FilePath path = getEntryPath(key);
+    auto it = _entryMap.find(key);
+    if (it == _entryMap.end())
+    {
+        // Adopt entries written by other processes.
+        if (!path.exists())
+        {
+            _missCount++;
+            return false;
+        }
+        _entries.push_front({ key, getFileSize(path) });
+        _entryMap[key] = _entries.begin();
+        _totalSize += _entries.front().size;
+        it = _entryMap.find(key);
+    }
+
+    string data;
+    if (!readBinaryFile(path, data) || !parseEntry(data, key, stageSources))
+    {
+        removeEntry(key);
+        _missCount++;
+        return false;
+    }
+
+    _entries.splice(_entries.begin(), _entries, it->second);
+    _indexModified = true;
+    _hitCount++;
+    return true;
+}
+
+void ShaderSourceCache::store(const string& key, const StringMap& stageSources)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    const string data = serializeEntry(key, stageSources);
+    auto it = _entryMap.find(key);
+    if (it != _entryMap.end())
+    {
+        _totalSize -= it->second->size;
+        _entries.erase(it->second);
+        _entryMap.erase(it);
+    }
+    if (!replaceFile(getEntryPath(key), data))
+    {
+        return;
+    }
+
+    _entries.push_front({ key, data.size() });
+    _entryMap[key] = _entries.begin();
+    _totalSize += data.size();
+    _indexModified = true;
+    evict();
+}
+
+void ShaderSourceCache::clear()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        while (!_entries.empty())
+        {
+            string key = _entries.back().key;
+            removeEntry(key);
+        }
+        _indexModified = true;
+    }
+    flush();
+}
+
+void ShaderSourceCache::flush()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_indexModified)
+    {
+        return;
+    }
+
+    string indexData;
+    for (const Entry& entry : _entries)
+    {
+        indexData += entry.key + "\n";
+    }
+    if (replaceFile(_directory / INDEX_FILENAME, indexData))
+    {
+        _indexModified = false;
+    }
+}
+
+void ShaderSourceCache::setMaxSize(size_t maxSize)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _maxSize = maxSize;
+    evict();
+}
+
+size_t ShaderSourceCache::getMaxSize() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _maxSize;
+}
+
+size_t ShaderSourceCache::getTotalSize() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _totalSize;
+}
+
+size_t ShaderSourceCache::getEntryCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _entries.size();
+}
+
+string ShaderSourceCache::getFileHash(const FilePath& path)
+{
+    const string pathString = path.asString();
+    {
+        std::lock_guard<std::mutex> lock(_fileHashMutex);
+        auto it = _fileHashes.find(pathString);
+        if (it != _fileHashes.end())
+        {
+            return it->second;
+        }
+    }
+
+    KeyDigest digest;
+    string contents;
+    digest.add((uint64_t) readBinaryFile(path, contents));
+    digest.add(contents);
+
+    const string hash = digest.get();
+    std::lock_guard<std::mutex> lock(_fileHashMutex);
+    _fileHashes[pathString] = hash;
+    return hash;
+}
+
+string ShaderSourceCache::getDirectoryHash(const FilePath& directory, const string& extension, bool recursive)
+{
+    const string pattern = (directory / (recursive ? "**." : "*.")).asString() + extension;
+    {
+        std::lock_guard<std::mutex> lock(_fileHashMutex);
+        auto it = _fileHashes.find(pattern);
+        if (it != _fileHashes.end())
+        {
+            return it->second;
+        }
+    }
+
+    FilePathVec directories = recursive ? directory.getSubDirectories() : FilePathVec{ directory };
+    std::set<string> files;
+    for (const FilePath& subDirectory : directories)
+    {
+        for (const FilePath& filename : subDirectory.getFilesInDirectory(extension))
+        {
+            files.insert((subDirectory / filename).asString());
+        }
+    }
+
+    KeyDigest digest;
+    for (const string& file : files)
+    {
+        digest.add(file);
+        digest.add(getFileHash(file));
+    }
+
+    const string hash = digest.get();
+    std::lock_guard<std::mutex> lock(_fileHashMutex);
+    _fileHashes[pattern] = hash;
+    return hash;
+}
+
+FilePath ShaderSourceCache::getEntryPath(const string& key) const
+{
+    return _directory / (key + "." + ENTRY_EXTENSION);
+}
+
+void ShaderSourceCache::removeEntry(const string& key)
+{
+    auto it = _entryMap.find(key);
+    if (it == _entryMap.end())
+    {
+        return;
+    }
+    _totalSize -= it->second->size;
+    _entries.erase(it->second);
+    _entryMap.erase(it);
+    _indexModified = true;
+    std::remove(getEntryPath(key).asString().c_str());
+}
+
+void ShaderSourceCache::evict()
+{
+    while (_totalSize > _maxSize && !_entries.empty())
+    {
+        string key = _entries.back().key;
+        removeEntry(key);
+    }
+}
+
+} // namespace MaterialX
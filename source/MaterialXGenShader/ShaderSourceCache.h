@@ -0,0 +1,168 @@
+//
+// TM & (c) 2021 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_SHADERSOURCECACHE_H
+#define MATERIALX_SHADERSOURCECACHE_H
+
+/// @file
+/// Persistent cache of generated shader source code
+
+#include <MaterialXGenShader/Export.h>
+
+#include <MaterialXFormat/File.h>
+
+#include <MaterialXCore/Document.h>
+
+#include <atomic>
+#include <list>
+#include <mutex>
+
+namespace MaterialX
+{
+
+/// A shared pointer to a ShaderSourceCache
+using ShaderSourceCachePtr = shared_ptr<class ShaderSourceCache>;
+
+/// @class ShaderSourceCache
+/// A persistent cache of generated shader source code, stored as one file
+/// per shader in a local directory and reused across processes.
+///
+/// Entries are keyed by a hash of the shader name, the content upstream of
+/// the element, the definitions and implementations it depends on, the
+/// generator target, color management and unit systems, the MaterialX
+/// library version, the builds of the generator and shader generation
+/// libraries, the generation options, and bound light shaders and metadata.
+/// The contents of the data library files used by the element's document,
+/// including the source code files of the target, are part of the key, so
+/// editing a library invalidates the entries generated from it.
+/// Library files are read once per cache object, so edits made while a
+/// cache object is alive are only seen by a new cache object.
+///
+/// When the total size of the entries exceeds the maximum size, the least
+/// recently used entries are removed.  A cache object may be used from
+/// multiple threads.
+class MX_GENSHADER_API ShaderSourceCache
+{
+  public:
+    /// Open the cache in the given directory, creating the directory if
+    /// needed.
+    ShaderSourceCache(const FilePath& directory, size_t maxSize = DEFAULT_MAX_SIZE);
+    ~ShaderSourceCache();
+
+    /// Create a new cache in the given directory.
+    static ShaderSourceCachePtr create(const FilePath& directory, size_t maxSize = DEFAULT_MAX_SIZE)
+    {
+        return std::make_shared<ShaderSourceCache>(directory, maxSize);
+    }
+
+    /// Return the source code of each stage of a shader for the given
+    /// element, mapped by stage name.  The source code is read from the
+    /// cache if available, and otherwise generated with the given context
+    /// and stored in the cache.
+    StringMap generate(const string& name, ElementPtr element, GenContext& context);
+
+    /// Return the key identifying the shader generated for the given element.
+    string computeKey(const string& name, ConstElementPtr element, GenContext& context);
+
+    /// Find the stage source code stored for the given key, returning true
+    /// if found.  Each call counts as a hit or a miss.
+    bool find(const string& key, StringMap& stageSources);
+
+    /// Store stage source code for the given key, evicting the least
+    /// recently used entries as needed.
+    void store(const string& key, const StringMap& stageSources);
+
+    /// Remove all entries from the cache.
+    void clear();
+
+    /// Write the recency order of entries to the cache directory.  This is
+    /// done automatically when the cache object is destroyed.
+    void flush();
+
+    /// Return the cache directory.
+    const FilePath& getDirectory() const
+    {
+        return _directory;
+    }
+
+    /// Set the maximum total size of entries in bytes, evicting the least
+    /// recently used entries as needed.
+    void setMaxSize(size_t maxSize);
+
+    /// Return the maximum total size of entries in bytes.
+    size_t getMaxSize() const;
+
+    /// Return the total size of entries in bytes.
+    size_t getTotalSize() const;
+
+    /// Return the number of entries.
+    size_t getEntryCount() const;
+
+    /// Return the number of lookups that found a stored entry.
+    size_t getHitCount() const
+    {
+        return _hitCount;
+    }
+
+    /// Return the number of lookups that found no stored entry.
+    size_t getMissCount() const
+    {
+        return _missCount;
+    }
+
+    /// Reset the hit and miss counters to zero.
+    void resetCounters()
+    {
+        _hitCount = 0;
+        _missCount = 0;
+    }
+
+  public:
+    static const size_t DEFAULT_MAX_SIZE;
+
+  protected:
+    struct Entry
+    {
+        string key;
+        size_t size;
+    };
+    using EntryList = std::list<Entry>;
+
+    // Return the hash of the contents of the given file.
+    string getFileHash(const FilePath& path);
+
+    // Return the hash of the contents of all files with the given extension
+    // in a directory, or in its directory tree if recursive is true.
+    string getDirectoryHash(const FilePath& directory, const string& extension, bool recursive);
+
+    // Return the path of the entry with the given key.
+    FilePath getEntryPath(const string& key) const;
+
+    // Remove an entry and its file.  The mutex must be held.
+    void removeEntry(const string& key);
+
+    // Remove the least recently used entries until the total size is
+    // within bounds.  The mutex must be held.
+    void evict();
+
+  protected:
+    FilePath _directory;
+    size_t _maxSize;
+    size_t _totalSize;
+    bool _indexModified;
+    EntryList _entries;
+    std::unordered_map<string, EntryList::iterator> _entryMap;
+    mutable std::mutex _mutex;
+
+    StringMap _fileHashes;
+    std::mutex _fileHashMutex;
+
+    std::atomic<size_t> _hitCount;
+    std::atomic<size_t> _missCount;
+};
+
+} // namespace MaterialX
+
+#endif
@@ -327,7 +327,7 @@ void ShaderStage::addBlock(const string& str, GenContext& context)
 void ShaderStage::addInclude(const string& file, GenContext& context)
 {
     string modifiedFile = file;
-    tokenSubstitution(context.getShaderGenerator().getTokenSubstitutions(), modifiedFile);
+    tokenSubstitution(context.getTokenSubstitutions(), modifiedFile);
     FilePath resolvedFile = context.resolveSourceFile(modifiedFile);
 
     if (!_includes.count(resolvedFile))
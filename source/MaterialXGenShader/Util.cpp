@@ -5,7 +5,12 @@
 
 #include <MaterialXGenShader/Util.h>
 
+#include <MaterialXGenShader/GenContext.h>
 #include <MaterialXGenShader/HwShaderGenerator.h>
+#include <MaterialXGenShader/Shader.h>
+
+#include <atomic>
+#include <thread>
 
 namespace MaterialX
 {
@@ -563,4 +568,134 @@ bool hasElementAttributes(OutputPtr output, const StringVec& attributes)
     return false;
 }
 
+vector<ShaderPtr> generateShaders(const vector<TypedElementPtr>& elements, GenContext& context, unsigned int threadCount)
+{
+    ShaderGenerator& shadergen = context.getShaderGenerator();
+
+    // Share implementations through the cache attached to the given context,
+    // or through a new cache if none is attached.
+    ShaderNodeImplCachePtr cache = context.getNodeImplementationCache();
+    if (!cache)
+    {
+        cache = ShaderNodeImplCache::create();
+    }
+    GenContext cacheContext(context);
+    cacheContext.clearNodeImplementations();
+    cacheContext.setNodeImplementationCache(cache);
+
+    // Populate the cache with implementations from source code and
+    // generator factories, so that each is created only once.
+    StringSet implNames;
+    std::unordered_set<ConstDocumentPtr> documents;
+    for (TypedElementPtr element : elements)
+    {
+        documents.insert(element->getDocument());
+    }
+    for (ConstDocumentPtr doc : documents)
+    {
+        for (NodeDefPtr nodeDef : doc->getNodeDefs())
+        {
+            InterfaceElementPtr impl = nodeDef->getImplementation(shadergen.getTarget());
+            if (impl && impl->isA<Implementation>() && !implNames.count(impl->getName()))
+            {
+                implNames.insert(impl->getName());
+                try
+                {
+                    shadergen.getImplementation(*impl, cacheContext);
+                }
+                catch (Exception&)
+                {
+                    // Implementations that fail here will report their
+                    // errors when generating the elements that use them.
+                }
+            }
+        }
+    }
+
+    // Bound lights are bound again in the context of each element, so that
+    // each context holds its own light shader nodes.  Shader metadata is only
+    // read during generation, so its registry is shared.
+    HwLightShadersPtr lightShaders = context.getUserData<HwLightShaders>(HW::USER_DATA_LIGHT_SHADERS);
+    ShaderMetadataRegistryPtr metadataRegistry = context.getUserData<ShaderMetadataRegistry>(ShaderMetadataRegistry::USER_DATA_NAME);
+
+    const Value::FloatFormat floatFormat = Value::getFloatFormat();
+    const int floatPrecision = Value::getFloatPrecision();
+
+    vector<ShaderPtr> shaders(elements.size());
+    vector<std::exception_ptr> errors(elements.size());
+    auto generateElement = [&](size_t index)
+    {
+        try
+        {
+            ScopedFloatFormatting fmt(floatFormat, floatPrecision);
+            GenContext elementContext(cacheContext);
+            elementContext.clearNodeImplementations();
+            elementContext.clearUserData();
+            if (metadataRegistry)
+            {
+                elementContext.pushUserData(ShaderMetadataRegistry::USER_DATA_NAME, metadataRegistry);
+            }
+            if (lightShaders)
+            {
+                for (const auto& it : lightShaders->get())
+                {
+                    ConstNodeDefPtr nodeDef = lightShaders->getNodeDef(it.first);
+                    if (nodeDef)
+                    {
+                        HwShaderGenerator::bindLightShader(*nodeDef, it.first, elementContext);
+                    }
+                }
+            }
+
+            TypedElementPtr element = elements[index];
+            shaders[index] = shadergen.generate(element->getName(), element, elementContext);
+        }
+        catch (...)
+        {
+            errors[index] = std::current_exception();
+        }
+    };
+
+    if (threadCount == 0)
+    {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    threadCount = (unsigned int) std::min((size_t) threadCount, elements.size());
+    if (threadCount <= 1)
+    {
+        for (size_t i = 0; i < elements.size(); i++)
+        {
+            generateElement(i);
+        }
+    }
+    else
+    {
+        std::atomic<size_t> nextElement(0);
+        vector<std::thread> threads;
+        for (unsigned int i = 0; i < threadCount; i++)
+        {
+            threads.emplace_back([&]()
+            {
+                for (size_t index = nextElement++; index < elements.size(); index = nextElement++)
+                {
+                    generateElement(index);
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    for (const std::exception_ptr& error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+    return shaders;
+}
+
 } // namespace MaterialX
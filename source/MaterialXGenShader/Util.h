@@ -93,6 +93,28 @@ MX_GENSHADER_API NodePtr connectsToWorldSpaceNode(OutputPtr output);
 /// @param attributes Attributes to test for
 MX_GENSHADER_API bool hasElementAttributes(OutputPtr output, const StringVec& attributes);
 
+/// Generate shaders for a list of renderable elements, distributing the
+/// elements across a pool of threads.
+///
+/// Each element is generated with its own copy of the given context, in
+/// which the light shaders bound in the given context are bound again and
+/// the shader metadata registry is shared, while other user data is cleared.
+/// Node implementations, including compound implementations, are shared
+/// through the implementation cache attached to the given context, or
+/// through a new cache if none is attached.  Implementations defined by
+/// Implementation elements in the documents of the given elements are added
+/// to the cache before generation starts.  The float formatting of the
+/// calling thread is applied on all threads, and the documents must not be
+/// modified during generation.
+/// @param elements Renderable elements to generate shaders for
+/// @param context Context holding the shader generator and its settings
+/// @param threadCount Number of threads to use, where zero selects the
+///    number of hardware threads
+/// @return Generated shaders, in the order of the given elements
+/// @throws The first exception thrown while generating, in element order
+MX_GENSHADER_API vector<ShaderPtr> generateShaders(const vector<TypedElementPtr>& elements, GenContext& context,
+                                                   unsigned int threadCount = 0);
+
 } // namespace MaterialX
 
 #endif
@@ -0,0 +1,433 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXRender/CpuBakeScheduler.h>
+
+#include <MaterialXRender/ShaderRenderer.h>
+#include <MaterialXRender/StbImageLoader.h>
+
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+namespace MaterialX
+{
+
+const unsigned int CpuBakeScheduler::DEFAULT_TILE_SIZE = 64;
+
+namespace
+{
+
+const size_t NONE = std::numeric_limits<size_t>::max();
+
+// Return the color written to the frame buffer by the GLSL baker for an
+// output value of the given type.
+Color4 getOutputColor(const float* value, const TypeDesc* type)
+{
+    if (type->getBaseType() == TypeDesc::BASETYPE_BOOLEAN)
+    {
+        return Color4(0.0f, 0.0f, 0.0f, 1.0f);
+    }
+    switch (type->getSize())
+    {
+        case 1: return Color4(value[0], value[0], value[0], 1.0f);
+        case 2: return Color4(value[0], value[1], 0.0f, 1.0f);
+        case 3: return Color4(value[0], value[1], value[2], 1.0f);
+        default: return Color4(value[0], value[1], value[2], value[3]);
+    }
+}
+
+float linearToSrgb(float x)
+{
+    return x <= 0.0031308f ? x * 12.92f : 1.055f * std::pow(x, 1.0f / 2.4f) - 0.055f;
+}
+
+// The state of an image during a bake, whose bands of tiles are indexed
+// from the top of the image.
+class BakeState
+{
+  public:
+    // Write a band of tiles spanning the given rows, accumulating the colors
+    // of its texels.
+    void writeBand(const vector<ImagePtr>& tiles, unsigned int y0, unsigned int y1, unsigned int tileSize)
+    {
+        unsigned char* row = (unsigned char*) rowImage->getResourceBuffer();
+        const size_t texelBytes = (size_t) rowImage->getBaseStride() * 4;
+        for (unsigned int y = y1; y-- > y0; )
+        {
+            for (size_t tx = 0; tx < tiles.size(); tx++)
+            {
+                const ImagePtr& tile = tiles[tx];
+                std::memcpy(row + tx * tileSize * texelBytes,
+                            (const unsigned char*) tile->getResourceBuffer() + (size_t) (y - y0) * tile->getRowStride(),
+                            tile->getRowStride());
+            }
+            for (unsigned int x = 0; x < rowImage->getWidth(); x++)
+            {
+                const Color4 color = rowImage->getTexelColor(x, 0);
+                if (!hasColor)
+                {
+                    firstColor = color;
+                    hasColor = true;
+                }
+                else if (isUniform && color != firstColor)
+                {
+                    isUniform = false;
+                }
+                for (size_t c = 0; c < 4; c++)
+                {
+                    colorSum[c] += color[c];
+                }
+            }
+            if (writer && !writer->writeRows(rowImage))
+            {
+                writer = nullptr;
+            }
+        }
+    }
+
+  public:
+    ImageWriterPtr writer;
+    ImagePtr rowImage;
+    vector<vector<ImagePtr>> bands;
+    vector<size_t> remainingTiles;
+    vector<size_t> bandMemory;
+    size_t nextBand = 0;
+    bool writing = false;
+
+    bool hasColor = false;
+    bool isUniform = true;
+    Color4 firstColor;
+    double colorSum[4] = { 0.0, 0.0, 0.0, 0.0 };
+};
+
+} // anonymous namespace
+
+//
+// CpuBakeScheduler methods
+//
+
+CpuBakeScheduler::CpuBakeScheduler(unsigned int width, unsigned int height, Image::BaseType baseType) :
+    _width(width),
+    _height(height),
+    _baseType(baseType),
+    _threadCount(0),
+    _tileSize(DEFAULT_TILE_SIZE),
+    _memoryBudget(0),
+    _imageHandler(ImageHandler::create(StbImageLoader::create())),
+    _peakMemory(0)
+{
+}
+
+size_t CpuBakeScheduler::addImage(CpuEvaluatorPtr evaluator, bool encodeSrgb, const FilePath& filename)
+{
+    ScheduledImage image;
+    image.evaluator = evaluator;
+    image.encodeSrgb = encodeSrgb;
+    image.filename = filename;
+    _images.push_back(image);
+    return _images.size() - 1;
+}
+
+void CpuBakeScheduler::run()
+{
+    _peakMemory = 0;
+    if (_images.empty() || !_width || !_height)
+    {
+        return;
+    }
+
+    // Tiles are ordered by image, then by band from the top of the image,
+    // so that bands complete in the order in which they are written.
+    const unsigned int tileSize = _tileSize;
+    const unsigned int tilesX = (_width + tileSize - 1) / tileSize;
+    const unsigned int bandCount = (_height + tileSize - 1) / tileSize;
+    const size_t tilesPerImage = (size_t) tilesX * bandCount;
+    const size_t tileCount = tilesPerImage * _images.size();
+    const size_t texelBytes = (size_t) Image::create(1, 1, 4, _baseType)->getBaseStride() * 4;
+
+    // Encoding and clamping follow the frame buffer of the GLSL baker, where
+    // only 8-bit images are stored in sRGB.
+    const bool clamp = _baseType == Image::BaseType::UINT8 || _baseType == Image::BaseType::UINT16;
+
+    struct TileBounds
+    {
+        size_t image;
+        unsigned int band, tx;
+        unsigned int x0, y0, x1, y1;
+    };
+    auto getTileBounds = [&](size_t index)
+    {
+        TileBounds bounds;
+        bounds.image = index / tilesPerImage;
+        const size_t tile = index % tilesPerImage;
+        bounds.band = (unsigned int) (tile / tilesX);
+        bounds.tx = (unsigned int) (tile % tilesX);
+        bounds.x0 = bounds.tx * tileSize;
+        bounds.x1 = std::min(bounds.x0 + tileSize, _width);
+        bounds.y1 = _height - bounds.band * tileSize;
+        bounds.y0 = bounds.y1 > tileSize ? bounds.y1 - tileSize : 0;
+        return bounds;
+    };
+    auto getTileMemory = [&](size_t index)
+    {
+        const TileBounds bounds = getTileBounds(index);
+        const CpuEvaluator& evaluator = *_images[bounds.image].evaluator;
+        const size_t texelCount = (size_t) (bounds.x1 - bounds.x0) * (bounds.y1 - bounds.y0);
+        const size_t sampleBytes = sizeof(Vector2) + sizeof(Vector3) + evaluator.getOutputType()->getSize() * sizeof(float);
+        return texelCount * (texelBytes + sampleBytes) + evaluator.getRegisterMemorySize();
+    };
+
+    vector<BakeState> states(_images.size());
+    for (size_t i = 0; i < _images.size(); i++)
+    {
+        if (!_images[i].evaluator || !_images[i].evaluator->getOutputType())
+        {
+            throw ExceptionRenderError("No graph has been compiled for CPU evaluation");
+        }
+        _images[i].result = CpuBakedImage();
+        states[i].bands.resize(bandCount);
+        states[i].remainingTiles.resize(bandCount, tilesX);
+        states[i].bandMemory.resize(bandCount, 0);
+    }
+
+    std::mutex mutex;
+    std::mutex callbackMutex;
+    std::condition_variable condition;
+    std::exception_ptr error;
+    size_t nextTile = 0;
+    size_t completedTiles = 0;
+    size_t memory = 0;
+    size_t dispatchBand = NONE;
+    size_t dispatchBandMemory = 0;
+
+    // A tile may start once it fits in the budget, or once all memory in
+    // flight belongs to its own band, which cannot complete without it.
+    auto canStart = [&](size_t index)
+    {
+        if (_memoryBudget == 0 || memory + getTileMemory(index) <= _memoryBudget)
+        {
+            return true;
+        }
+        return memory == (index / tilesX == dispatchBand ? dispatchBandMemory : 0);
+    };
+
+    // Write the completed bands of an image in order, releasing their
+    // memory, and finish the image after its last band.
+    auto writeBands = [&](size_t imageIndex)
+    {
+        ScheduledImage& image = _images[imageIndex];
+        BakeState& state = states[imageIndex];
+        while (true)
+        {
+            size_t band;
+            vector<ImagePtr> tiles;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (error || state.writing || state.nextBand >= bandCount || state.remainingTiles[state.nextBand] > 0)
+                {
+                    return;
+                }
+                state.writing = true;
+                band = state.nextBand;
+                tiles.swap(state.bands[band]);
+            }
+
+            if (band == 0)
+            {
+                state.rowImage = Image::create(_width, 1, 4, _baseType);
+                state.rowImage->createResourceBuffer();
+                if (!image.filename.isEmpty() && _imageHandler)
+                {
+                    state.writer = _imageHandler->createImageWriter(image.filename, _width, _height, 4, _baseType);
+                }
+            }
+
+            const unsigned int y1 = _height - (unsigned int) band * tileSize;
+            const unsigned int y0 = y1 > tileSize ? y1 - tileSize : 0;
+            state.writeBand(tiles, y0, y1, tileSize);
+            tiles.clear();
+
+            if (band + 1 == bandCount)
+            {
+                CpuBakedImage& result = image.result;
+                result.isUniform = state.isUniform;
+                result.uniformColor = state.isUniform ? state.firstColor : Color4();
+                const double texelCount = (double) _width * _height;
+                result.averageColor = Color4((float) (state.colorSum[0] / texelCount), (float) (state.colorSum[1] / texelCount),
+                                             (float) (state.colorSum[2] / texelCount), (float) (state.colorSum[3] / texelCount));
+                if (state.writer && !state.isUniform && state.writer->finish())
+                {
+                    result.filename = image.filename;
+                }
+                state.writer = nullptr;
+                state.rowImage = nullptr;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            state.writing = false;
+            state.nextBand++;
+            memory -= state.bandMemory[band];
+            condition.notify_all();
+        }
+    };
+
+    auto worker = [&]()
+    {
+        CpuSamples samples;
+        vector<float> result;
+        while (true)
+        {
+            size_t index;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [&]() { return error || nextTile >= tileCount || canStart(nextTile); });
+                if (error || nextTile >= tileCount)
+                {
+                    return;
+                }
+                index = nextTile++;
+                const size_t tileMemory = getTileMemory(index);
+                const size_t band = index / tilesX;
+                if (band != dispatchBand)
+                {
+                    dispatchBand = band;
+                    dispatchBandMemory = 0;
+                }
+                dispatchBandMemory += tileMemory;
+                memory += tileMemory;
+                _peakMemory = std::max(_peakMemory, memory);
+                states[index / tilesPerImage].bandMemory[band % bandCount] += tileMemory;
+                condition.notify_all();
+            }
+
+            try
+            {
+                const TileBounds bounds = getTileBounds(index);
+                const ScheduledImage& image = _images[bounds.image];
+                const CpuEvaluator& evaluator = *image.evaluator;
+                const TypeDesc* outputType = evaluator.getOutputType();
+                const size_t outputSize = outputType->getSize();
+                const bool srgb = image.encodeSrgb && _baseType == Image::BaseType::UINT8;
+                const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+                // Evaluate the tile at its texel centers.
+                samples.texcoords.clear();
+                samples.positions.clear();
+                for (unsigned int y = bounds.y0; y < bounds.y1; y++)
+                {
+                    for (unsigned int x = bounds.x0; x < bounds.x1; x++)
+                    {
+                        const Vector2 uv((x + 0.5f) / _width, (y + 0.5f) / _height);
+                        samples.texcoords.push_back(uv);
+                        samples.positions.push_back(Vector3(uv[0] * 2.0f - 1.0f, uv[1] * 2.0f - 1.0f, 0.0f));
+                    }
+                }
+                evaluator.evaluate(samples, result);
+
+                ImagePtr tile = Image::create(bounds.x1 - bounds.x0, bounds.y1 - bounds.y0, 4, _baseType);
+                tile->createResourceBuffer();
+                size_t sample = 0;
+                for (unsigned int y = 0; y < tile->getHeight(); y++)
+                {
+                    for (unsigned int x = 0; x < tile->getWidth(); x++, sample++)
+                    {
+                        Color4 color = getOutputColor(&result[sample * outputSize], outputType);
+                        for (size_t c = 0; c < 4; c++)
+                        {
+                            if (clamp)
+                            {
+                                color[c] = std::min(std::max(color[c], 0.0f), 1.0f);
+                            }
+                            if (srgb && c < 3)
+                            {
+                                color[c] = linearToSrgb(color[c]);
+                            }
+                        }
+                        tile->setTexelColor(x, y, color);
+                    }
+                }
+
+                CpuBakeTile bakeTile;
+                bakeTile.image = bounds.image;
+                bakeTile.x = bounds.x0;
+                bakeTile.y = bounds.y0;
+                bakeTile.width = bounds.x1 - bounds.x0;
+                bakeTile.height = bounds.y1 - bounds.y0;
+                bakeTile.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    BakeState& state = states[bounds.image];
+                    state.bands[bounds.band].resize(tilesX);
+                    state.bands[bounds.band][bounds.tx] = tile;
+                    state.remainingTiles[bounds.band]--;
+                }
+                {
+                    std::lock_guard<std::mutex> lock(callbackMutex);
+                    completedTiles++;
+                    if (_tileCallback)
+                    {
+                        _tileCallback(bakeTile);
+                    }
+                    if (_progressCallback)
+                    {
+                        _progressCallback(completedTiles, tileCount);
+                    }
+                }
+
+                writeBands(bounds.image);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
+                condition.notify_all();
+                return;
+            }
+        }
+    };
+
+    size_t threadCount = _threadCount;
+    if (threadCount == 0)
+    {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    threadCount = std::min(threadCount, tileCount);
+
+    if (threadCount <= 1)
+    {
+        worker();
+    }
+    else
+    {
+        vector<std::thread> threads;
+        for (size_t i = 0; i < threadCount; i++)
+        {
+            threads.emplace_back(worker);
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    // Partially written files are removed as their writers are released.
+    if (error)
+    {
+        states.clear();
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace MaterialX
@@ -0,0 +1,244 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_CPUBAKESCHEDULER_H
+#define MATERIALX_CPUBAKESCHEDULER_H
+
+/// @file
+/// Tiled scheduling of texture bakes on the CPU
+
+#include <MaterialXRender/CpuEvaluator.h>
+
+#include <functional>
+
+namespace MaterialX
+{
+
+/// A shared pointer to a CpuBakeScheduler
+using CpuBakeSchedulerPtr = shared_ptr<class CpuBakeScheduler>;
+
+/// @class CpuBakeTile
+/// A tile of an image baked by a CpuBakeScheduler.
+class MX_RENDER_API CpuBakeTile
+{
+  public:
+    /// The index of the image to which the tile belongs.
+    size_t image = 0;
+
+    /// The texel bounds of the tile, with rows ordered from the bottom of
+    /// the image.
+    unsigned int x = 0;
+    unsigned int y = 0;
+    unsigned int width = 0;
+    unsigned int height = 0;
+
+    /// The time in seconds spent evaluating the tile.
+    double seconds = 0.0;
+};
+
+/// @class CpuBakedImage
+/// The result of baking an image with a CpuBakeScheduler.
+class MX_RENDER_API CpuBakedImage
+{
+  public:
+    /// The file to which the image was written, or an empty path if no file
+    /// was written.
+    FilePath filename;
+
+    /// True if every texel of the image has the same color.
+    bool isUniform = false;
+
+    /// The color of every texel of a uniform image.
+    Color4 uniformColor;
+
+    /// The average color of the image.
+    Color4 averageColor;
+};
+
+/// A function called as tiles are completed, with the number of completed
+/// tiles and the total number of tiles.
+using CpuBakeProgressCallback = std::function<void(size_t completedTiles, size_t tileCount)>;
+
+/// A function called with each completed tile.
+using CpuBakeTileCallback = std::function<void(const CpuBakeTile& tile)>;
+
+/// @class CpuBakeScheduler
+/// A scheduler for baking compiled graphs to images on the CPU.
+///
+/// The images added to a schedule are split into square tiles, which are
+/// evaluated across a pool of worker threads.  Each band of tiles is
+/// written to disk as soon as it and the bands above it are complete, so
+/// the tiles resident in memory are limited to those in flight.  A memory
+/// budget bounds the bytes held by these tiles, with the exception that a
+/// single band of tiles is always allowed to progress.
+///
+/// Images are saved through the image writers of the image handler, which
+/// encode rows as their bands arrive in formats that their loaders write by
+/// rows: PNG files of 8-bit images and Radiance HDR files of float images
+/// with the stb image loader, and the scanline formats of OpenImageIO.  Other
+/// formats, such as BMP, TGA and JPEG with the stb image loader, are assembled
+/// in a full image outside of the memory budget, and saved once complete.
+class MX_RENDER_API CpuBakeScheduler
+{
+  public:
+    virtual ~CpuBakeScheduler() { }
+
+    static CpuBakeSchedulerPtr create(unsigned int width = 1024, unsigned int height = 1024, Image::BaseType baseType = Image::BaseType::UINT8)
+    {
+        return CpuBakeSchedulerPtr(new CpuBakeScheduler(width, height, baseType));
+    }
+
+    /// Set the number of threads evaluating tiles.  Defaults to zero, which
+    /// uses one thread per hardware thread.
+    void setThreadCount(size_t threadCount)
+    {
+        _threadCount = threadCount;
+    }
+
+    /// Return the number of threads evaluating tiles.
+    size_t getThreadCount() const
+    {
+        return _threadCount;
+    }
+
+    /// Set the width and height in texels of tiles.  Defaults to 64.
+    void setTileSize(unsigned int tileSize)
+    {
+        _tileSize = std::max(tileSize, 1u);
+    }
+
+    /// Return the width and height in texels of tiles.
+    unsigned int getTileSize() const
+    {
+        return _tileSize;
+    }
+
+    /// Set the budget in bytes for tiles in flight, including their texels
+    /// and the samples and registers used to evaluate them.  Defaults to
+    /// zero, which places no limit beyond the number of threads.
+    void setMemoryBudget(size_t memoryBudget)
+    {
+        _memoryBudget = memoryBudget;
+    }
+
+    /// Return the budget in bytes for tiles in flight.
+    size_t getMemoryBudget() const
+    {
+        return _memoryBudget;
+    }
+
+    /// Set the image handler used to save images.  Defaults to a handler
+    /// with an StbImageLoader.
+    void setImageHandler(ImageHandlerPtr imageHandler)
+    {
+        _imageHandler = imageHandler;
+    }
+
+    /// Return the image handler.
+    ImageHandlerPtr getImageHandler() const
+    {
+        return _imageHandler;
+    }
+
+    /// Set a function to be called as tiles are completed.  Callbacks are
+    /// made from worker threads, one at a time.
+    void setProgressCallback(CpuBakeProgressCallback callback)
+    {
+        _progressCallback = callback;
+    }
+
+    /// Return the function called as tiles are completed.
+    CpuBakeProgressCallback getProgressCallback() const
+    {
+        return _progressCallback;
+    }
+
+    /// Set a function to be called with each completed tile and the time
+    /// spent evaluating it.  Callbacks are made from worker threads, one at
+    /// a time.
+    void setTileCallback(CpuBakeTileCallback callback)
+    {
+        _tileCallback = callback;
+    }
+
+    /// Return the function called with each completed tile.
+    CpuBakeTileCallback getTileCallback() const
+    {
+        return _tileCallback;
+    }
+
+    /// Add an image to the schedule, returning its index.
+    /// @param evaluator The compiled graph evaluated at each texel.
+    /// @param encodeSrgb If true, colors are encoded in sRGB in 8-bit images.
+    /// @param filename The file to which the image is written if its texels
+    ///    are not uniform.  If empty, only the colors of the image are
+    ///    computed.
+    size_t addImage(CpuEvaluatorPtr evaluator, bool encodeSrgb, const FilePath& filename = FilePath());
+
+    /// Return the number of images in the schedule.
+    size_t getImageCount() const
+    {
+        return _images.size();
+    }
+
+    /// Bake all images in the schedule.
+    /// @throws ExceptionRenderError if a graph cannot be evaluated.
+    void run();
+
+    /// Return the result of baking the image with the given index.
+    const CpuBakedImage& getBakedImage(size_t index) const
+    {
+        return _images.at(index).result;
+    }
+
+    /// Return the peak number of bytes held by tiles in flight during the
+    /// last call to run.
+    size_t getPeakMemory() const
+    {
+        return _peakMemory;
+    }
+
+    /// Remove all images from the schedule.
+    void clear()
+    {
+        _images.clear();
+    }
+
+  protected:
+    class ScheduledImage
+    {
+      public:
+        CpuEvaluatorPtr evaluator;
+        bool encodeSrgb = false;
+        FilePath filename;
+        CpuBakedImage result;
+    };
+
+  protected:
+    CpuBakeScheduler(unsigned int width, unsigned int height, Image::BaseType baseType);
+
+  public:
+    /// The default width and height in texels of tiles.
+    static const unsigned int DEFAULT_TILE_SIZE;
+
+  protected:
+    unsigned int _width;
+    unsigned int _height;
+    Image::BaseType _baseType;
+    size_t _threadCount;
+    unsigned int _tileSize;
+    size_t _memoryBudget;
+
+    ImageHandlerPtr _imageHandler;
+    CpuBakeProgressCallback _progressCallback;
+    CpuBakeTileCallback _tileCallback;
+
+    vector<ScheduledImage> _images;
+    size_t _peakMemory;
+};
+
+} // namespace MaterialX
+
+#endif
@@ -0,0 +1,627 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXRender/CpuEvaluator.h>
+
+#include <MaterialXRender/ShaderRenderer.h>
+
+#include <MaterialXGenShader/GenContext.h>
+
+#include <limits>
+
+namespace MaterialX
+{
+
+const size_t CpuEvaluator::BATCH_SIZE = 256;
+
+namespace
+{
+
+const size_t NO_REGISTER = std::numeric_limits<size_t>::max();
+
+const Vector3 DEFAULT_NORMAL(0.0f, 0.0f, 1.0f);
+const Vector3 DEFAULT_TANGENT(1.0f, 0.0f, 0.0f);
+
+using EnumMap = std::unordered_map<string, int>;
+
+const EnumMap ADDRESS_MODES =
+{
+    { "constant", 0 },
+    { "clamp", 1 },
+    { "periodic", 2 },
+    { "mirror", 3 }
+};
+
+const EnumMap FILTER_TYPES =
+{
+    { "closest", 0 },
+    { "linear", 1 },
+    { "cubic", 2 }
+};
+
+// Return true if values of the given type can be held in a register.
+bool isNumeric(const TypeDesc* type)
+{
+    if (!type || type->getSize() > 4 || type->getSemantic() == TypeDesc::SEMANTIC_MATRIX)
+    {
+        return false;
+    }
+    return type->getBaseType() == TypeDesc::BASETYPE_FLOAT ||
+           type->getBaseType() == TypeDesc::BASETYPE_INTEGER ||
+           type->getBaseType() == TypeDesc::BASETYPE_BOOLEAN;
+}
+
+template<class T> vector<float> getVectorFloats(const T& vec)
+{
+    vector<float> result(T::numElements());
+    for (size_t i = 0; i < T::numElements(); i++)
+    {
+        result[i] = vec[i];
+    }
+    return result;
+}
+
+// Return the components of a numeric value, or zeros if the value is
+// missing or of another size.
+vector<float> getFloats(ValuePtr value, size_t size)
+{
+    vector<float> floats;
+    if (!value)
+        floats = {};
+    else if (value->isA<float>())
+        floats = { value->asA<float>() };
+    else if (value->isA<int>())
+        floats = { (float) value->asA<int>() };
+    else if (value->isA<bool>())
+        floats = { value->asA<bool>() ? 1.0f : 0.0f };
+    else if (value->isA<Color3>())
+        floats = getVectorFloats(value->asA<Color3>());
+    else if (value->isA<Color4>())
+        floats = getVectorFloats(value->asA<Color4>());
+    else if (value->isA<Vector2>())
+        floats = getVectorFloats(value->asA<Vector2>());
+    else if (value->isA<Vector3>())
+        floats = getVectorFloats(value->asA<Vector3>());
+    else if (value->isA<Vector4>())
+        floats = getVectorFloats(value->asA<Vector4>());
+
+    if (floats.size() == 1)
+    {
+        floats.resize(size, floats[0]);
+    }
+    else if (floats.size() != size)
+    {
+        floats.assign(size, 0.0f);
+    }
+    return floats;
+}
+
+// Return an integer enumeration value, given either as an integer or by name.
+int getEnumValue(ValuePtr value, const EnumMap& names, int defaultValue)
+{
+    if (value && value->isA<int>())
+    {
+        return value->asA<int>();
+    }
+    if (value && value->isA<string>())
+    {
+        auto it = names.find(value->asA<string>());
+        if (it != names.end())
+        {
+            return it->second;
+        }
+    }
+    return defaultValue;
+}
+
+// Return the indices of the components selected by the given channels,
+// with -1 for a zero and -2 for a one, returning false if a channel is invalid.
+bool getChannelIndices(const string& channels, const TypeDesc* type, vector<int>& indices)
+{
+    for (char ch : channels)
+    {
+        if (ch == '0' || ch == '1')
+        {
+            indices.push_back(ch == '1' ? -2 : -1);
+            continue;
+        }
+        const int index = type->getSize() == 1 ? 0 : type->getChannelIndex(ch);
+        if (index < 0)
+        {
+            return false;
+        }
+        indices.push_back(index);
+    }
+    return true;
+}
+
+// Return true if a transform between the given spaces leaves values
+// unchanged.  As in the hardware shader generators, the model and object
+// spaces are equivalent, and only transforms between these and the world
+// space are applied.
+bool isIdentityTransform(const string& fromSpace, const string& toSpace)
+{
+    auto isLocal = [](const string& space)
+    {
+        return space == "model" || space == "object";
+    };
+    return !(isLocal(fromSpace) && toSpace == "world") &&
+           !(fromSpace == "world" && isLocal(toSpace));
+}
+
+// Return the name of the kernel applying a color transform, given the name
+// of its implementation in the default color management system, e.g.
+// "IM_srgb_texture_to_lin_rec709_color3_genglsl" for the kernel
+// "srgb_texture_to_linear".  Returns an empty string if the implementation
+// is not a transform to the linear working space.
+string getColorTransformKernelName(const string& implName)
+{
+    const string PREFIX = "IM_";
+    const string LINEAR_TARGET = "_to_lin_rec709_";
+
+    if (implName.compare(0, PREFIX.size(), PREFIX) != 0)
+    {
+        return EMPTY_STRING;
+    }
+    const size_t pos = implName.rfind(LINEAR_TARGET);
+    if (pos == string::npos || pos <= PREFIX.size())
+    {
+        return EMPTY_STRING;
+    }
+    return implName.substr(PREFIX.size(), pos - PREFIX.size()) + "_to_linear";
+}
+
+// Return the name of the kernel evaluating a node.  Color transform nodes
+// have no node definition, and are identified by their implementation name.
+string getKernelName(const ShaderNode& node)
+{
+    if (!node.getCategory().empty())
+    {
+        return node.getCategory();
+    }
+    return getColorTransformKernelName(node.getImplementation().getName());
+}
+
+} // anonymous namespace
+
+//
+// CpuSamples methods
+//
+
+size_t CpuSamples::size() const
+{
+    return std::max(std::max(texcoords.size(), positions.size()),
+                    std::max(normals.size(), tangents.size()));
+}
+
+void CpuSamples::resize(size_t count)
+{
+    texcoords.resize(count, Vector2(0.0f));
+    positions.resize(count, Vector3(0.0f));
+    normals.resize(count, DEFAULT_NORMAL);
+    tangents.resize(count, DEFAULT_TANGENT);
+}
+
+//
+// CpuEvaluator methods
+//
+
+CpuEvaluator::CpuEvaluator() :
+    _instructionSet(getCpuInstructionSet()),
+    _outputRegister(NO_REGISTER),
+    _outputType(nullptr),
+    _registerSize(0)
+{
+}
+
+CpuEvaluator::~CpuEvaluator()
+{
+}
+
+void CpuEvaluator::compile(ElementPtr element, GenContext& context)
+{
+    ShaderGraphPtr graph = ShaderGraph::create(nullptr, element->getName(), element, context);
+    compile(*graph, context);
+}
+
+void CpuEvaluator::compile(const ShaderGraph& graph, GenContext& context, size_t outputIndex)
+{
+    _registers.clear();
+    _instructions.clear();
+    _outputRegister = NO_REGISTER;
+    _outputType = nullptr;
+    _registerSize = 0;
+
+    if (outputIndex >= graph.numOutputSockets())
+    {
+        throw ExceptionRenderError("Graph '" + graph.getName() + "' has no output at index " + std::to_string(outputIndex));
+    }
+    const ShaderGraphOutputSocket* socket = graph.getOutputSocket(outputIndex);
+    if (!isNumeric(socket->getType()))
+    {
+        throw ExceptionRenderError("Output '" + socket->getName() + "' of type '" + socket->getType()->getName() + "' cannot be evaluated on the CPU");
+    }
+
+    Scope scope;
+    compileGraph(graph, context, scope);
+    const size_t outputRegister = getInputRegister(socket, scope);
+
+    // Lay out the registers of a batch.
+    size_t offset = 0;
+    for (Register& reg : _registers)
+    {
+        reg.offset = offset;
+        offset += reg.size * BATCH_SIZE;
+    }
+    _registerSize = offset;
+    _outputRegister = outputRegister;
+    _outputType = socket->getType();
+}
+
+void CpuEvaluator::compileGraph(const ShaderGraph& graph, GenContext& context, Scope& scope)
+{
+    for (const ShaderNode* node : graph.getNodes())
+    {
+        compileNode(*node, context, scope);
+    }
+}
+
+void CpuEvaluator::compileNode(const ShaderNode& node, GenContext& context, Scope& scope)
+{
+    static const std::unordered_map<string, Source> GEOMETRIC_SOURCES =
+    {
+        { "texcoord", Source::TEXCOORD },
+        { "position", Source::POSITION },
+        { "normal", Source::NORMAL },
+        { "tangent", Source::TANGENT }
+    };
+    static const StringSet TRANSFORM_NODES =
+    {
+        "transformpoint",
+        "transformvector",
+        "transformnormal"
+    };
+
+    const string kernelName = getKernelName(node);
+
+    // Geometric nodes read the sample attributes.
+    auto geometric = GEOMETRIC_SOURCES.find(kernelName);
+    if (geometric != GEOMETRIC_SOURCES.end())
+    {
+        const ShaderOutput* output = node.getOutput();
+        const size_t reg = getSourceRegister(geometric->second);
+        if (_registers[reg].size == output->getType()->getSize())
+        {
+            scope.registers[output] = reg;
+        }
+        else
+        {
+            Instruction instruction;
+            instruction.kernel = getCpuKernelDef("convert", _instructionSet)->kernel;
+            instruction.inputs.push_back(reg);
+            instruction.outputs.push_back(addRegister(output->getType()->getSize(), Source::TEMPORARY));
+            _instructions.push_back(instruction);
+            scope.registers[output] = instruction.outputs[0];
+        }
+        return;
+    }
+
+    const CpuKernelDef* kernelDef = getCpuKernelDef(kernelName, _instructionSet);
+    if (!kernelDef)
+    {
+        // Expand nodes implemented as graphs.
+        const ShaderGraph* graph = node.getImplementation().getGraph();
+        if (!graph)
+        {
+            throw ExceptionRenderError("Node '" + node.getName() + "' of category '" + kernelName + "' cannot be evaluated on the CPU");
+        }
+        Scope graphScope;
+        for (const ShaderGraphInputSocket* socket : graph->getInputSockets())
+        {
+            const ShaderInput* input = node.getInput(socket->getName());
+            if (!input)
+            {
+                continue;
+            }
+            graphScope.values[socket] = getInputValue(input, scope);
+            if (isNumeric(input->getType()))
+            {
+                graphScope.registers[socket] = getInputRegister(input, scope);
+            }
+        }
+        compileGraph(*graph, context, graphScope);
+        for (const ShaderGraphOutputSocket* socket : graph->getOutputSockets())
+        {
+            const ShaderOutput* output = node.getOutput(socket->getName());
+            if (output && isNumeric(output->getType()))
+            {
+                scope.registers[output] = getInputRegister(socket, graphScope);
+            }
+        }
+        return;
+    }
+
+    // Sample attributes have no transforms between spaces, so transform
+    // nodes are only evaluated where they leave their input unchanged.
+    if (TRANSFORM_NODES.count(kernelName))
+    {
+        const ShaderInput* fromSpaceInput = node.getInput("fromspace");
+        const ShaderInput* toSpaceInput = node.getInput("tospace");
+        ValuePtr fromSpace = fromSpaceInput ? getInputValue(fromSpaceInput, scope) : nullptr;
+        ValuePtr toSpace = toSpaceInput ? getInputValue(toSpaceInput, scope) : nullptr;
+        const string fromSpaceString = fromSpace ? fromSpace->getValueString() : EMPTY_STRING;
+        const string toSpaceString = toSpace ? toSpace->getValueString() : EMPTY_STRING;
+        if (!isIdentityTransform(fromSpaceString, toSpaceString))
+        {
+            throw ExceptionRenderError("Node '" + node.getName() + "' transforms from space '" + fromSpaceString +
+                                       "' to space '" + toSpaceString + "', which cannot be evaluated on the CPU");
+        }
+    }
+
+    Instruction instruction;
+    instruction.kernel = kernelDef->kernel;
+    for (const string& inputName : kernelDef->inputs)
+    {
+        const ShaderInput* input = node.getInput(inputName);
+        if (!input)
+        {
+            if (!kernelDef->optionalInputs.count(inputName))
+            {
+                throw ExceptionRenderError("Node '" + node.getName() + "' has no input '" + inputName + "'");
+            }
+            instruction.inputs.push_back(NO_REGISTER);
+            continue;
+        }
+        if (!isNumeric(input->getType()))
+        {
+            throw ExceptionRenderError("Input '" + input->getFullName() + "' of type '" + input->getType()->getName() + "' cannot be evaluated on the CPU");
+        }
+        instruction.inputs.push_back(getInputRegister(input, scope));
+    }
+    for (const ShaderOutput* output : node.getOutputs())
+    {
+        if (!isNumeric(output->getType()))
+        {
+            throw ExceptionRenderError("Output '" + output->getFullName() + "' of type '" + output->getType()->getName() + "' cannot be evaluated on the CPU");
+        }
+        const size_t reg = addRegister(output->getType()->getSize(), Source::TEMPORARY);
+        instruction.outputs.push_back(reg);
+        scope.registers[output] = reg;
+    }
+    compileParams(node, context, scope, instruction.params);
+    _instructions.push_back(instruction);
+}
+
+void CpuEvaluator::compileParams(const ShaderNode& node, GenContext& context, const Scope& scope, CpuKernelParams& params)
+{
+    // Resolve swizzle channels against the type of the swizzled input.
+    const ShaderInput* channels = node.getInput("channels");
+    const ShaderInput* in = node.getInput("in");
+    if (channels && in)
+    {
+        ValuePtr value = getInputValue(channels, scope);
+        const string channelString = value && value->isA<string>() ? value->asA<string>() : EMPTY_STRING;
+        if (!getChannelIndices(channelString, in->getType(), params.channels))
+        {
+            throw ExceptionRenderError("Invalid channels '" + channelString + "' on node '" + node.getName() + "'");
+        }
+    }
+
+    // Load the images of image nodes.
+    const ShaderInput* file = node.getInput("file");
+    if (file && file->getType() == Type::FILENAME)
+    {
+        ValuePtr value = getInputValue(file, scope);
+        const string filename = value ? value->getValueString() : EMPTY_STRING;
+        if (_imageHandler && !filename.empty())
+        {
+            params.image = _imageHandler->acquireImage(filename);
+        }
+
+        using AddressMode = ImageSamplingProperties::AddressMode;
+        using FilterType = ImageSamplingProperties::FilterType;
+        ImageSamplingProperties& sampling = params.samplingProperties;
+        const ShaderInput* uaddressmode = node.getInput("uaddressmode");
+        const ShaderInput* vaddressmode = node.getInput("vaddressmode");
+        const ShaderInput* filtertype = node.getInput("filtertype");
+        sampling.uaddressMode = AddressMode(getEnumValue(uaddressmode ? getInputValue(uaddressmode, scope) : nullptr, ADDRESS_MODES, (int) AddressMode::PERIODIC));
+        sampling.vaddressMode = AddressMode(getEnumValue(vaddressmode ? getInputValue(vaddressmode, scope) : nullptr, ADDRESS_MODES, (int) AddressMode::PERIODIC));
+        sampling.filterType = FilterType(getEnumValue(filtertype ? getInputValue(filtertype, scope) : nullptr, FILTER_TYPES, (int) FilterType::LINEAR));
+        params.verticalFlip = context.getOptions().fileTextureVerticalFlip;
+    }
+}
+
+size_t CpuEvaluator::getInputRegister(const ShaderInput* input, const Scope& scope)
+{
+    const TypeDesc* type = input->getType();
+    const ShaderOutput* connection = input->getConnection();
+    if (!connection)
+    {
+        return addConstantRegister(input->getValue(), type);
+    }
+
+    size_t reg = NO_REGISTER;
+    auto it = scope.registers.find(connection);
+    if (it != scope.registers.end())
+    {
+        reg = it->second;
+    }
+    else if (connection->getNode() && connection->getNode()->isAGraph())
+    {
+        // Interface inputs take their published values.
+        reg = addConstantRegister(connection->getValue(), connection->getType());
+    }
+    else
+    {
+        throw ExceptionRenderError("Input '" + input->getFullName() + "' is connected to an output that cannot be evaluated on the CPU");
+    }
+
+    // Convert between types, applying input channels if specified.
+    const string& channels = input->getChannels();
+    if (channels.empty() && _registers[reg].size == type->getSize())
+    {
+        return reg;
+    }
+    Instruction instruction;
+    instruction.inputs.push_back(reg);
+    instruction.outputs.push_back(addRegister(type->getSize(), Source::TEMPORARY));
+    if (channels.empty())
+    {
+        instruction.kernel = getCpuKernelDef("convert", _instructionSet)->kernel;
+    }
+    else
+    {
+        instruction.kernel = getCpuKernelDef("swizzle", _instructionSet)->kernel;
+        if (!getChannelIndices(channels, connection->getType(), instruction.params.channels))
+        {
+            throw ExceptionRenderError("Invalid channels '" + channels + "' on input '" + input->getFullName() + "'");
+        }
+    }
+    _instructions.push_back(instruction);
+    return instruction.outputs[0];
+}
+
+ValuePtr CpuEvaluator::getInputValue(const ShaderInput* input, const Scope& scope) const
+{
+    const ShaderOutput* connection = input->getConnection();
+    if (!connection)
+    {
+        return input->getValue();
+    }
+    auto it = scope.values.find(connection);
+    return it != scope.values.end() ? it->second : connection->getValue();
+}
+
+size_t CpuEvaluator::addRegister(size_t size, Source source, const vector<float>& value)
+{
+    Register reg;
+    reg.size = size;
+    reg.source = source;
+    reg.value = value;
+    reg.offset = 0;
+    _registers.push_back(reg);
+    return _registers.size() - 1;
+}
+
+size_t CpuEvaluator::addConstantRegister(ValuePtr value, const TypeDesc* type)
+{
+    const size_t size = type->getSize();
+    return addRegister(size, Source::CONSTANT, getFloats(value, size));
+}
+
+size_t CpuEvaluator::getSourceRegister(Source source)
+{
+    for (size_t i = 0; i < _registers.size(); i++)
+    {
+        if (_registers[i].source == source)
+        {
+            return i;
+        }
+    }
+    return addRegister(source == Source::TEXCOORD ? 2 : 3, source);
+}
+
+void CpuEvaluator::evaluate(const CpuSamples& samples, vector<float>& result) const
+{
+    if (!_outputType)
+    {
+        throw ExceptionRenderError("No graph has been compiled for CPU evaluation");
+    }
+
+    const size_t count = samples.size();
+    const size_t outputSize = _outputType->getSize();
+    result.resize(count * outputSize);
+
+    // Allocate the registers of a batch, and fill constant registers.
+    vector<float> storage(_registerSize);
+    for (const Register& reg : _registers)
+    {
+        if (reg.source == Source::CONSTANT)
+        {
+            for (size_t c = 0; c < reg.size; c++)
+            {
+                float* data = &storage[reg.offset + c * BATCH_SIZE];
+                std::fill(data, data + BATCH_SIZE, reg.value[c]);
+            }
+        }
+    }
+
+    // Bind the arguments of each instruction.
+    vector<CpuKernelArgs> args(_instructions.size());
+    for (size_t k = 0; k < _instructions.size(); k++)
+    {
+        const Instruction& instruction = _instructions[k];
+        CpuKernelArgs& arg = args[k];
+        arg.stride = BATCH_SIZE;
+        arg.params = &instruction.params;
+        for (size_t reg : instruction.inputs)
+        {
+            arg.inputs.push_back(reg != NO_REGISTER ? &storage[_registers[reg].offset] : nullptr);
+            arg.inputSizes.push_back(reg != NO_REGISTER ? _registers[reg].size : 0);
+        }
+        for (size_t reg : instruction.outputs)
+        {
+            arg.outputs.push_back(&storage[_registers[reg].offset]);
+            arg.outputSizes.push_back(_registers[reg].size);
+        }
+    }
+
+    const Register& output = _registers[_outputRegister];
+    for (size_t start = 0; start < count; start += BATCH_SIZE)
+    {
+        const size_t batchCount = std::min(BATCH_SIZE, count - start);
+
+        // Read the sample attributes.
+        for (const Register& reg : _registers)
+        {
+            float* data = &storage[reg.offset];
+            if (reg.source == Source::TEXCOORD)
+            {
+                for (size_t i = 0; i < batchCount; i++)
+                {
+                    const size_t index = start + i;
+                    const Vector2 uv = index < samples.texcoords.size() ? samples.texcoords[index] : Vector2(0.0f);
+                    data[i] = uv[0];
+                    data[BATCH_SIZE + i] = uv[1];
+                }
+            }
+            else if (reg.source == Source::POSITION || reg.source == Source::NORMAL || reg.source == Source::TANGENT)
+            {
+                const vector<Vector3>& attribute = reg.source == Source::POSITION ? samples.positions :
+                                                   reg.source == Source::NORMAL ? samples.normals : samples.tangents;
+                const Vector3 fallback = reg.source == Source::POSITION ? Vector3(0.0f) :
+                                         reg.source == Source::NORMAL ? DEFAULT_NORMAL : DEFAULT_TANGENT;
+                for (size_t i = 0; i < batchCount; i++)
+                {
+                    const size_t index = start + i;
+                    const Vector3 vec = index < attribute.size() ? attribute[index] : fallback;
+                    for (size_t c = 0; c < 3; c++)
+                    {
+                        data[c * BATCH_SIZE + i] = vec[c];
+                    }
+                }
+            }
+        }
+
+        // Run the instructions.
+        for (size_t k = 0; k < _instructions.size(); k++)
+        {
+            args[k].count = batchCount;
+            _instructions[k].kernel(args[k]);
+        }
+
+        // Interleave the output components.
+        const float* data = &storage[output.offset];
+        for (size_t i = 0; i < batchCount; i++)
+        {
+            for (size_t c = 0; c < outputSize; c++)
+            {
+                result[(start + i) * outputSize + c] = data[c * BATCH_SIZE + i];
+            }
+        }
+    }
+}
+
+} // namespace MaterialX
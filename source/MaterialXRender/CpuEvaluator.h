@@ -0,0 +1,191 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_CPUEVALUATOR_H
+#define MATERIALX_CPUEVALUATOR_H
+
+/// @file
+/// Evaluation of shader graphs on the CPU
+
+#include <MaterialXRender/CpuKernels.h>
+
+#include <MaterialXGenShader/ShaderGraph.h>
+
+namespace MaterialX
+{
+
+/// A shared pointer to a CpuEvaluator
+using CpuEvaluatorPtr = shared_ptr<class CpuEvaluator>;
+
+/// @class CpuSamples
+/// The geometric attributes of the points at which a graph is evaluated.
+/// Attributes that are left empty take a default value: zero for texture
+/// coordinates and positions, (0, 0, 1) for normals, and (1, 0, 0) for
+/// tangents.
+class MX_RENDER_API CpuSamples
+{
+  public:
+    /// Return the number of samples, given by the largest attribute.
+    size_t size() const;
+
+    /// Resize each attribute to the given number of samples.
+    void resize(size_t count);
+
+  public:
+    vector<Vector2> texcoords;
+    vector<Vector3> positions;
+    vector<Vector3> normals;
+    vector<Vector3> tangents;
+};
+
+/// @class CpuEvaluator
+/// Evaluates the output of a shader graph on the CPU.
+///
+/// A graph is compiled into a list of instructions, each applying the kernel
+/// of a standard library node to a batch of samples, vectorized for the
+/// instruction set of the evaluator where available.  Nodes implemented as
+/// node graphs are expanded into their graph, and geometric nodes read the
+/// sample attributes, ignoring their space and index.  Nodes without a CPU
+/// kernel, transforms between the world space and the model or object
+/// space, and outputs of non-numeric types cause compilation to fail.
+///
+/// Compiling a graph with SHADER_INTERFACE_REDUCED folds constant branches
+/// before evaluation.  Once compiled, a graph may be evaluated from multiple
+/// threads.
+class MX_RENDER_API CpuEvaluator
+{
+  public:
+    CpuEvaluator();
+    ~CpuEvaluator();
+
+    /// Create a new evaluator.
+    static CpuEvaluatorPtr create()
+    {
+        return std::make_shared<CpuEvaluator>();
+    }
+
+    /// Set the image handler used to load the images of image nodes.
+    void setImageHandler(ImageHandlerPtr imageHandler)
+    {
+        _imageHandler = imageHandler;
+    }
+
+    /// Return the image handler used to load images.
+    ImageHandlerPtr getImageHandler() const
+    {
+        return _imageHandler;
+    }
+
+    /// Set the instruction set of the kernels used by subsequently compiled
+    /// graphs.  Defaults to the widest instruction set supported by the host.
+    void setInstructionSet(CpuInstructionSet instructionSet)
+    {
+        _instructionSet = instructionSet;
+    }
+
+    /// Return the instruction set of the kernels used by compiled graphs.
+    CpuInstructionSet getInstructionSet() const
+    {
+        return _instructionSet;
+    }
+
+    /// Compile the graph upstream of the given output or node, using the
+    /// shader generator and options of the given context.
+    /// @throws ExceptionRenderError if the graph cannot be evaluated on the CPU.
+    void compile(ElementPtr element, GenContext& context);
+
+    /// Compile the given output socket of a shader graph.
+    /// @throws ExceptionRenderError if the graph cannot be evaluated on the CPU.
+    void compile(const ShaderGraph& graph, GenContext& context, size_t outputIndex = 0);
+
+    /// Return the type of the compiled output, or nullptr if no graph has
+    /// been compiled.
+    const TypeDesc* getOutputType() const
+    {
+        return _outputType;
+    }
+
+    /// Return the number of instructions of the compiled graph.
+    size_t getInstructionCount() const
+    {
+        return _instructions.size();
+    }
+
+    /// Return the size in bytes of the registers allocated by each call to
+    /// evaluate.
+    size_t getRegisterMemorySize() const
+    {
+        return _registerSize * sizeof(float);
+    }
+
+    /// Evaluate the compiled graph at the given samples.  The components of
+    /// the output at each sample are stored consecutively in the result.
+    void evaluate(const CpuSamples& samples, vector<float>& result) const;
+
+  public:
+    /// The number of samples evaluated by each kernel call.
+    static const size_t BATCH_SIZE;
+
+  protected:
+    enum class Source
+    {
+        TEMPORARY,
+        CONSTANT,
+        TEXCOORD,
+        POSITION,
+        NORMAL,
+        TANGENT
+    };
+
+    struct Register
+    {
+        size_t size;
+        Source source;
+        vector<float> value;
+        size_t offset;
+    };
+
+    struct Instruction
+    {
+        CpuKernel kernel;
+        vector<size_t> inputs;
+        vector<size_t> outputs;
+        CpuKernelParams params;
+    };
+
+    struct Scope
+    {
+        std::unordered_map<const ShaderOutput*, size_t> registers;
+        std::unordered_map<const ShaderOutput*, ValuePtr> values;
+    };
+
+    void compileGraph(const ShaderGraph& graph, GenContext& context, Scope& scope);
+    void compileNode(const ShaderNode& node, GenContext& context, Scope& scope);
+    void compileParams(const ShaderNode& node, GenContext& context, const Scope& scope, CpuKernelParams& params);
+
+    // Return the register holding the value of an input, adding
+    // registers and instructions as needed.
+    size_t getInputRegister(const ShaderInput* input, const Scope& scope);
+
+    // Return the uniform value of an input.
+    ValuePtr getInputValue(const ShaderInput* input, const Scope& scope) const;
+
+    size_t addRegister(size_t size, Source source, const vector<float>& value = vector<float>());
+    size_t addConstantRegister(ValuePtr value, const TypeDesc* type);
+    size_t getSourceRegister(Source source);
+
+  protected:
+    ImageHandlerPtr _imageHandler;
+    CpuInstructionSet _instructionSet;
+    vector<Register> _registers;
+    vector<Instruction> _instructions;
+    size_t _outputRegister;
+    const TypeDesc* _outputType;
+    size_t _registerSize;
+};
+
+} // namespace MaterialX
+
+#endif
@@ -0,0 +1,1445 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXRender/CpuKernels.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace MaterialX
+{
+
+const size_t CpuKernelArgs::BATCH_ALIGNMENT = 16;
+
+// Vectorized kernels of each instruction set, defined in their own
+// translation units.  The maps are empty if the instruction set was not
+// compiled.
+std::unordered_map<string, CpuKernel> getSse4CpuKernels();
+std::unordered_map<string, CpuKernel> getAvx2CpuKernels();
+std::unordered_map<string, CpuKernel> getAvx512CpuKernels();
+
+namespace
+{
+
+const float FLOAT_EPS = 1e-8f;
+const float PI = std::acos(-1.0f);
+
+//
+// Helpers applying a function to each component of the output
+//
+
+template<class F> void unaryOp(const CpuKernelArgs& args, F func)
+{
+    for (size_t c = 0; c < args.outputSizes[0]; c++)
+    {
+        const float* a = args.input(0, c);
+        float* out = args.output(0, c);
+        for (size_t i = 0; i < args.count; i++)
+        {
+            out[i] = func(a[i]);
+        }
+    }
+}
+
+template<class F> void binaryOp(const CpuKernelArgs& args, F func)
+{
+    for (size_t c = 0; c < args.outputSizes[0]; c++)
+    {
+        const float* a = args.input(0, c);
+        const float* b = args.input(1, c);
+        float* out = args.output(0, c);
+        for (size_t i = 0; i < args.count; i++)
+        {
+            out[i] = func(a[i], b[i]);
+        }
+    }
+}
+
+template<class F> void ternaryOp(const CpuKernelArgs& args, F func)
+{
+    for (size_t c = 0; c < args.outputSizes[0]; c++)
+    {
+        const float* a = args.input(0, c);
+        const float* b = args.input(1, c);
+        const float* d = args.input(2, c);
+        float* out = args.output(0, c);
+        for (size_t i = 0; i < args.count; i++)
+        {
+            out[i] = func(a[i], b[i], d[i]);
+        }
+    }
+}
+
+// Apply a blend function of the fg and bg inputs, weighted by the mix input.
+template<class F> void blendOp(const CpuKernelArgs& args, F func)
+{
+    ternaryOp(args, [func](float fg, float bg, float m)
+    {
+        return m * func(fg, bg) + (1.0f - m) * bg;
+    });
+}
+
+// Copy the first input to the output, converting between sizes.
+void copyInput(const CpuKernelArgs& args, size_t index)
+{
+    const size_t inSize = args.inputSizes[index];
+    for (size_t c = 0; c < args.outputSizes[0]; c++)
+    {
+        float* out = args.output(0, c);
+        if (inSize == 1 || c < inSize)
+        {
+            std::copy(args.input(index, c), args.input(index, c) + args.count, out);
+        }
+        else
+        {
+            // Pad with zero for a third and one for a fourth component.
+            std::fill(out, out + args.count, c == 3 ? 1.0f : 0.0f);
+        }
+    }
+}
+
+// Copy the alpha of a four-component input to the output.
+void copyAlpha(const CpuKernelArgs& args)
+{
+    if (args.outputSizes[0] == 4 && args.inputSizes[0] == 4)
+    {
+        std::copy(args.input(0, 3), args.input(0, 3) + args.count, args.output(0, 3));
+    }
+}
+
+//
+// Math kernels
+//
+
+void addKernel(const CpuKernelArgs& args)
+{
+    binaryOp(args, [](float a, float b) { return a + b; });
+}
+
+void subtractKernel(const CpuKernelArgs& args)
+{
+    binaryOp(args, [](float a, float b) { return a - b; });
+}
+
+void multiplyKernel(const CpuKernelArgs& args)
+{
+    binaryOp(args, [](float a, float b) { return a * b; });
+}
+
+void divideKernel(const CpuKernelArgs& args)
+{
+    binaryOp(args, [](float a, float b) { return a / b; });
+}
+
+void moduloKernel(const CpuKernelArgs& args)
+{
+    binaryOp(args, [](float a, float b) { return a - b * std::floor(a / b); });
+}
+
+void invertKernel(const CpuKernelArgs& args)
+{
+    binaryOp(args, [](float amount, float a) { return amount - a; });
+}
+
+void powerKernel(const CpuKernelArgs& args)
+{
+    binaryOp(args, [](float a, float b) { return std::pow(a, b); });
+}
+
+void atan2Kernel(const CpuKernelArgs& args)
+{
+    binaryOp(args, [](float a, float b) { return std::atan2(a, b); });
+}
+
+void minKernel(const CpuKernelArgs& args)
+{
+    binaryOp(args, [](float a, float b) { return std::min(a, b); });
+}
+
+void maxKernel(const CpuKernelArgs& args)
+{
+    binaryOp(args, [](float a, float b) { return std::max(a, b); });
+}
+
+void absvalKernel(const CpuKernelArgs& args)
+{
+    unaryOp(args, [](float a) { return std::abs(a); });
+}
+
+void floorKernel(const CpuKernelArgs& args)
+{
+    unaryOp(args, [](float a) { return std::floor(a); });
+}
+
+void ceilKernel(const CpuKernelArgs& args)
+{
+    unaryOp(args, [](float a) { return std::ceil(a); });
+}
+
+void sinKernel(const CpuKernelArgs& args)
+{
+    unaryOp(args, [](float a) { return std::sin(a); });
+}
+
+void cosKernel(const CpuKernelArgs& args)
+{
+    unaryOp(args, [](float a) { return std::cos(a); });
+}
+
+void tanKernel(const CpuKernelArgs& args)
+{
+    unaryOp(args, [](float a) { return std::tan(a); });
+}
+
+void asinKernel(const CpuKernelArgs& args)
+{
+    unaryOp(args, [](float a) { return std::asin(a); });
+}
+
+void acosKernel(const CpuKernelArgs& args)
+{
+    unaryOp(args, [](float a) { return std::acos(a); });
+}
+
+void sqrtKernel(const CpuKernelArgs& args)
+{
+    unaryOp(args, [](float a) { return std::sqrt(a); });
+}
+
+void lnKernel(const CpuKernelArgs& args)
+{
+    unaryOp(args, [](float a) { return std::log(a); });
+}
+
+void expKernel(const CpuKernelArgs& args)
+{
+    unaryOp(args, [](float a) { return std::exp(a); });
+}
+
+void signKernel(const CpuKernelArgs& args)
+{
+    unaryOp(args, [](float a) { return a > 0.0f ? 1.0f : (a < 0.0f ? -1.0f : 0.0f); });
+}
+
+void clampKernel(const CpuKernelArgs& args)
+{
+    ternaryOp(args, [](float a, float low, float high) { return std::min(std::max(a, low), high); });
+}
+
+void mixKernel(const CpuKernelArgs& args)
+{
+    ternaryOp(args, [](float bg, float fg, float m) { return bg * (1.0f - m) + fg * m; });
+}
+
+void smoothstepKernel(const CpuKernelArgs& args)
+{
+    ternaryOp(args, [](float a, float low, float high)
+    {
+        if (a <= low)
+            return 0.0f;
+        if (a >= high)
+            return 1.0f;
+        float t = (a - low) / (high - low);
+        return t * t * (3.0f - 2.0f * t);
+    });
+}
+
+void remapKernel(const CpuKernelArgs& args)
+{
+    for (size_t c = 0; c < args.outputSizes[0]; c++)
+    {
+        const float* in = args.input(0, c);
+        const float* inLow = args.input(1, c);
+        const float* inHigh = args.input(2, c);
+        const float* outLow = args.input(3, c);
+        const float* outHigh = args.input(4, c);
+        float* out = args.output(0, c);
+        for (size_t i = 0; i < args.count; i++)
+        {
+            out[i] = outLow[i] + (in[i] - inLow[i]) * (outHigh[i] - outLow[i]) / (inHigh[i] - inLow[i]);
+        }
+    }
+}
+
+//
+// Geometric kernels
+//
+
+void dotproductKernel(const CpuKernelArgs& args)
+{
+    float* out = args.output(0, 0);
+    std::fill(out, out + args.count, 0.0f);
+    for (size_t c = 0; c < args.inputSizes[0]; c++)
+    {
+        const float* a = args.input(0, c);
+        const float* b = args.input(1, c);
+        for (size_t i = 0; i < args.count; i++)
+        {
+            out[i] += a[i] * b[i];
+        }
+    }
+}
+
+void magnitudeKernel(const CpuKernelArgs& args)
+{
+    float* out = args.output(0, 0);
+    std::fill(out, out + args.count, 0.0f);
+    for (size_t c = 0; c < args.inputSizes[0]; c++)
+    {
+        const float* a = args.input(0, c);
+        for (size_t i = 0; i < args.count; i++)
+        {
+            out[i] += a[i] * a[i];
+        }
+    }
+    for (size_t i = 0; i < args.count; i++)
+    {
+        out[i] = std::sqrt(out[i]);
+    }
+}
+
+void normalizeKernel(const CpuKernelArgs& args)
+{
+    const size_t size = args.outputSizes[0];
+    for (size_t i = 0; i < args.count; i++)
+    {
+        float dot = 0.0f;
+        for (size_t c = 0; c < size; c++)
+        {
+            const float a = args.input(0, c)[i];
+            dot += a * a;
+        }
+        const float scale = 1.0f / std::sqrt(dot);
+        for (size_t c = 0; c < size; c++)
+        {
+            args.output(0, c)[i] = args.input(0, c)[i] * scale;
+        }
+    }
+}
+
+void crossproductKernel(const CpuKernelArgs& args)
+{
+    const float* ax = args.input(0, 0);
+    const float* ay = args.input(0, 1);
+    const float* az = args.input(0, 2);
+    const float* bx = args.input(1, 0);
+    const float* by = args.input(1, 1);
+    const float* bz = args.input(1, 2);
+    float* outx = args.output(0, 0);
+    float* outy = args.output(0, 1);
+    float* outz = args.output(0, 2);
+    for (size_t i = 0; i < args.count; i++)
+    {
+        const float x = ay[i] * bz[i] - az[i] * by[i];
+        const float y = az[i] * bx[i] - ax[i] * bz[i];
+        const float z = ax[i] * by[i] - ay[i] * bx[i];
+        outx[i] = x;
+        outy[i] = y;
+        outz[i] = z;
+    }
+}
+
+void rotate2dKernel(const CpuKernelArgs& args)
+{
+    const float* x = args.input(0, 0);
+    const float* y = args.input(0, 1);
+    const float* amount = args.input(1, 0);
+    float* outx = args.output(0, 0);
+    float* outy = args.output(0, 1);
+    for (size_t i = 0; i < args.count; i++)
+    {
+        const float radians = amount[i] * PI / 180.0f;
+        const float sa = std::sin(radians);
+        const float ca = std::cos(radians);
+        const float rx = ca * x[i] + sa * y[i];
+        const float ry = -sa * x[i] + ca * y[i];
+        outx[i] = rx;
+        outy[i] = ry;
+    }
+}
+
+void rotate3dKernel(const CpuKernelArgs& args)
+{
+    for (size_t i = 0; i < args.count; i++)
+    {
+        const float radians = args.input(1, 0)[i] * PI / 180.0f;
+        Vector3 axis(args.input(2, 0)[i], args.input(2, 1)[i], args.input(2, 2)[i]);
+        axis = axis.getNormalized();
+        const float s = std::sin(radians);
+        const float c = std::cos(radians);
+        const float oc = 1.0f - c;
+
+        // The rows of the rotation matrix, applied to a column vector as in
+        // the shading language implementation.
+        const Vector3 in(args.input(0, 0)[i], args.input(0, 1)[i], args.input(0, 2)[i]);
+        const Vector3 col0(oc * axis[0] * axis[0] + c, oc * axis[0] * axis[1] + axis[2] * s, oc * axis[2] * axis[0] - axis[1] * s);
+        const Vector3 col1(oc * axis[0] * axis[1] - axis[2] * s, oc * axis[1] * axis[1] + c, oc * axis[1] * axis[2] + axis[0] * s);
+        const Vector3 col2(oc * axis[2] * axis[0] + axis[1] * s, oc * axis[1] * axis[2] - axis[0] * s, oc * axis[2] * axis[2] + c);
+        const Vector3 out = col0 * in[0] + col1 * in[1] + col2 * in[2];
+        for (size_t k = 0; k < 3; k++)
+        {
+            args.output(0, k)[i] = out[k];
+        }
+    }
+}
+
+//
+// Channel kernels
+//
+
+void copyKernel(const CpuKernelArgs& args)
+{
+    copyInput(args, 0);
+}
+
+void combineKernel(const CpuKernelArgs& args)
+{
+    size_t c = 0;
+    for (size_t k = 0; k < args.inputs.size(); k++)
+    {
+        for (size_t j = 0; j < args.inputSizes[k] && c < args.outputSizes[0]; j++, c++)
+        {
+            const float* in = args.input(k, j);
+            std::copy(in, in + args.count, args.output(0, c));
+        }
+    }
+}
+
+void swizzleKernel(const CpuKernelArgs& args)
+{
+    const vector<int>& channels = args.params->channels;
+    for (size_t c = 0; c < args.outputSizes[0]; c++)
+    {
+        float* out = args.output(0, c);
+        const int index = c < channels.size() ? channels[c] : -1;
+        if (index < 0)
+        {
+            std::fill(out, out + args.count, index == -2 ? 1.0f : 0.0f);
+        }
+        else
+        {
+            const float* in = args.input(0, (size_t) index);
+            std::copy(in, in + args.count, out);
+        }
+    }
+}
+
+void separateKernel(const CpuKernelArgs& args)
+{
+    for (size_t k = 0; k < args.outputs.size(); k++)
+    {
+        const float* in = args.input(0, k);
+        std::copy(in, in + args.count, args.output(k, 0));
+    }
+}
+
+//
+// Conditional kernels
+//
+
+template<class F> void conditionalOp(const CpuKernelArgs& args, F compare)
+{
+    const float* value1 = args.input(0, 0);
+    const float* value2 = args.input(1, 0);
+    for (size_t c = 0; c < args.outputSizes[0]; c++)
+    {
+        const float* in1 = args.input(2, c);
+        const float* in2 = args.input(3, c);
+        float* out = args.output(0, c);
+        for (size_t i = 0; i < args.count; i++)
+        {
+            out[i] = compare(value1[i], value2[i]) ? in1[i] : in2[i];
+        }
+    }
+}
+
+void ifgreaterKernel(const CpuKernelArgs& args)
+{
+    conditionalOp(args, [](float a, float b) { return a > b; });
+}
+
+void ifgreatereqKernel(const CpuKernelArgs& args)
+{
+    conditionalOp(args, [](float a, float b) { return a >= b; });
+}
+
+void ifequalKernel(const CpuKernelArgs& args)
+{
+    conditionalOp(args, [](float a, float b) { return a == b; });
+}
+
+void switchKernel(const CpuKernelArgs& args)
+{
+    // The last input selects among the preceding inputs, and the output is
+    // zero if no input is selected.
+    const size_t branches = args.inputs.size() - 1;
+    const float* which = args.input(branches, 0);
+    for (size_t c = 0; c < args.outputSizes[0]; c++)
+    {
+        float* out = args.output(0, c);
+        for (size_t i = 0; i < args.count; i++)
+        {
+            float value = 0.0f;
+            for (size_t k = 0; k < branches; k++)
+            {
+                if (args.inputs[k] && which[i] < (float) (k + 1))
+                {
+                    value = args.input(k, c)[i];
+                    break;
+                }
+            }
+            out[i] = value;
+        }
+    }
+}
+
+//
+// Compositing kernels
+//
+
+void plusKernel(const CpuKernelArgs& args)
+{
+    blendOp(args, [](float fg, float bg) { return bg + fg; });
+}
+
+void minusKernel(const CpuKernelArgs& args)
+{
+    blendOp(args, [](float fg, float bg) { return bg - fg; });
+}
+
+void differenceKernel(const CpuKernelArgs& args)
+{
+    blendOp(args, [](float fg, float bg) { return std::abs(bg - fg); });
+}
+
+void screenKernel(const CpuKernelArgs& args)
+{
+    blendOp(args, [](float fg, float bg) { return (1.0f - (1.0f - fg)) * (1.0f - bg); });
+}
+
+void overlayKernel(const CpuKernelArgs& args)
+{
+    blendOp(args, [](float fg, float bg) { return fg < 0.5f ? 2.0f * fg * bg : 1.0f - (1.0f - fg) * (1.0f - bg); });
+}
+
+void burnKernel(const CpuKernelArgs& args)
+{
+    ternaryOp(args, [](float fg, float bg, float m)
+    {
+        if (std::abs(fg) < FLOAT_EPS)
+            return 0.0f;
+        return m * (1.0f - (1.0f - bg) / fg) + (1.0f - m) * bg;
+    });
+}
+
+void dodgeKernel(const CpuKernelArgs& args)
+{
+    ternaryOp(args, [](float fg, float bg, float m)
+    {
+        if (std::abs(1.0f - fg) < FLOAT_EPS)
+            return 0.0f;
+        return m * (bg / (1.0f - fg)) + (1.0f - m) * bg;
+    });
+}
+
+void insideKernel(const CpuKernelArgs& args)
+{
+    binaryOp(args, [](float a, float mask) { return a * mask; });
+}
+
+void outsideKernel(const CpuKernelArgs& args)
+{
+    binaryOp(args, [](float a, float mask) { return a * (1.0f - mask); });
+}
+
+// Apply a function of the fg and bg colors and alphas to each component,
+// weighted by the mix input.
+template<class F> void alphaCompositeOp(const CpuKernelArgs& args, F func)
+{
+    const float* fgAlpha = args.input(0, 3);
+    const float* bgAlpha = args.input(1, 3);
+    const float* m = args.input(2, 0);
+    for (size_t c = 0; c < 4; c++)
+    {
+        const float* fg = args.input(0, c);
+        const float* bg = args.input(1, c);
+        float* out = args.output(0, c);
+        for (size_t i = 0; i < args.count; i++)
+        {
+            out[i] = m[i] * func(fg[i], bg[i], fgAlpha[i], bgAlpha[i], c) + (1.0f - m[i]) * bg[i];
+        }
+    }
+}
+
+void overKernel(const CpuKernelArgs& args)
+{
+    alphaCompositeOp(args, [](float fg, float bg, float fa, float, size_t) { return fg + bg * (1.0f - fa); });
+}
+
+void inKernel(const CpuKernelArgs& args)
+{
+    alphaCompositeOp(args, [](float fg, float, float, float ba, size_t) { return fg * ba; });
+}
+
+void outKernel(const CpuKernelArgs& args)
+{
+    alphaCompositeOp(args, [](float fg, float, float, float ba, size_t) { return fg * (1.0f - ba); });
+}
+
+void maskKernel(const CpuKernelArgs& args)
+{
+    alphaCompositeOp(args, [](float, float bg, float fa, float, size_t) { return bg * fa; });
+}
+
+void matteKernel(const CpuKernelArgs& args)
+{
+    alphaCompositeOp(args, [](float fg, float bg, float fa, float ba, size_t c)
+    {
+        return c < 3 ? fg * fa + bg * (1.0f - fa) : fa + ba * (1.0f - fa);
+    });
+}
+
+void disjointoverKernel(const CpuKernelArgs& args)
+{
+    alphaCompositeOp(args, [](float fg, float bg, float fa, float ba, size_t c)
+    {
+        const float summedAlpha = fa + ba;
+        if (c == 3)
+            return std::min(summedAlpha, 1.0f);
+        if (summedAlpha <= 1.0f)
+            return fg + bg;
+        if (std::abs(ba) < FLOAT_EPS)
+            return 0.0f;
+        return fg + bg * (1.0f - fa) / ba;
+    });
+}
+
+void premultKernel(const CpuKernelArgs& args)
+{
+    const float* alpha = args.input(0, 3);
+    for (size_t c = 0; c < 3; c++)
+    {
+        const float* in = args.input(0, c);
+        float* out = args.output(0, c);
+        for (size_t i = 0; i < args.count; i++)
+        {
+            out[i] = in[i] * alpha[i];
+        }
+    }
+    copyAlpha(args);
+}
+
+void unpremultKernel(const CpuKernelArgs& args)
+{
+    const float* alpha = args.input(0, 3);
+    for (size_t c = 0; c < 3; c++)
+    {
+        const float* in = args.input(0, c);
+        float* out = args.output(0, c);
+        for (size_t i = 0; i < args.count; i++)
+        {
+            out[i] = in[i] / alpha[i];
+        }
+    }
+    copyAlpha(args);
+}
+
+//
+// Color kernels
+//
+
+void luminanceKernel(const CpuKernelArgs& args)
+{
+    const float* r = args.input(0, 0);
+    const float* g = args.input(0, 1);
+    const float* b = args.input(0, 2);
+    const float* lr = args.input(1, 0);
+    const float* lg = args.input(1, 1);
+    const float* lb = args.input(1, 2);
+    float* out = args.output(0, 0);
+    for (size_t i = 0; i < args.count; i++)
+    {
+        out[i] = r[i] * lr[i] + g[i] * lg[i] + b[i] * lb[i];
+    }
+    for (size_t c = 1; c < 3; c++)
+    {
+        std::copy(out, out + args.count, args.output(0, c));
+    }
+    copyAlpha(args);
+}
+
+Vector3 hsvToRgb(const Vector3& hsv)
+{
+    float h = hsv[0];
+    const float s = hsv[1];
+    const float v = hsv[2];
+    if (s < 0.0001f)
+    {
+        return Vector3(v, v, v);
+    }
+    h = 6.0f * (h - std::floor(h));
+    const int hi = (int) h;
+    const float f = h - (float) hi;
+    const float p = v * (1.0f - s);
+    const float q = v * (1.0f - s * f);
+    const float t = v * (1.0f - s * (1.0f - f));
+    switch (hi)
+    {
+        case 0: return Vector3(v, t, p);
+        case 1: return Vector3(q, v, p);
+        case 2: return Vector3(p, v, t);
+        case 3: return Vector3(p, q, v);
+        case 4: return Vector3(t, p, v);
+        default: return Vector3(v, p, q);
+    }
+}
+
+Vector3 rgbToHsv(const Vector3& rgb)
+{
+    const float r = rgb[0];
+    const float g = rgb[1];
+    const float b = rgb[2];
+    const float mincomp = std::min(r, std::min(g, b));
+    const float maxcomp = std::max(r, std::max(g, b));
+    const float delta = maxcomp - mincomp;
+    const float v = maxcomp;
+    const float s = maxcomp > 0.0f ? delta / maxcomp : 0.0f;
+    float h = 0.0f;
+    if (s > 0.0f)
+    {
+        if (r >= maxcomp)
+            h = (g - b) / delta;
+        else if (g >= maxcomp)
+            h = 2.0f + (b - r) / delta;
+        else
+            h = 4.0f + (r - g) / delta;
+        h *= (1.0f / 6.0f);
+        if (h < 0.0f)
+            h += 1.0f;
+    }
+    return Vector3(h, s, v);
+}
+
+Vector3 ap1ToRec709(const Vector3& rgb)
+{
+    return Vector3(1.705079555511475f * rgb[0] - 0.6242334842681885f * rgb[1] - 0.0808461606502533f * rgb[2],
+                   -0.1297005265951157f * rgb[0] + 1.138468623161316f * rgb[1] - 0.008768022060394287f * rgb[2],
+                   -0.02416634373366833f * rgb[0] - 0.1246141716837883f * rgb[1] + 1.148780584335327f * rgb[2]);
+}
+
+Vector3 g22Ap1ToRec709(const Vector3& rgb)
+{
+    return ap1ToRec709(Vector3(std::pow(std::max(0.0f, rgb[0]), 2.2f),
+                               std::pow(std::max(0.0f, rgb[1]), 2.2f),
+                               std::pow(std::max(0.0f, rgb[2]), 2.2f)));
+}
+
+template<Vector3 (*F)(const Vector3&)> void colorSpaceKernel(const CpuKernelArgs& args)
+{
+    for (size_t i = 0; i < args.count; i++)
+    {
+        const Vector3 out = F(Vector3(args.input(0, 0)[i], args.input(0, 1)[i], args.input(0, 2)[i]));
+        for (size_t c = 0; c < 3; c++)
+        {
+            args.output(0, c)[i] = out[c];
+        }
+    }
+    copyAlpha(args);
+}
+
+void srgbTextureToLinearKernel(const CpuKernelArgs& args)
+{
+    for (size_t c = 0; c < 3; c++)
+    {
+        const float* in = args.input(0, c);
+        float* out = args.output(0, c);
+        for (size_t i = 0; i < args.count; i++)
+        {
+            const float x = in[i];
+            out[i] = x > 0.03928571566939354f ?
+                     std::pow(std::max(0.0f, 0.9478672742843628f * x + 0.05213269963860512f), 2.4f) :
+                     x * 0.07738015800714493f;
+        }
+    }
+    copyAlpha(args);
+}
+
+template<int GAMMA> void gammaToLinearKernel(const CpuKernelArgs& args)
+{
+    const float gamma = (float) GAMMA / 10.0f;
+    for (size_t c = 0; c < 3; c++)
+    {
+        const float* in = args.input(0, c);
+        float* out = args.output(0, c);
+        for (size_t i = 0; i < args.count; i++)
+        {
+            out[i] = std::pow(std::max(0.0f, in[i]), gamma);
+        }
+    }
+    if (args.outputSizes[0] == 4)
+    {
+        const float* in = args.input(0, 3);
+        float* out = args.output(0, 3);
+        for (size_t i = 0; i < args.count; i++)
+        {
+            out[i] = std::max(0.0f, in[i]);
+        }
+    }
+}
+
+//
+// Texture kernels
+//
+
+void ramplrKernel(const CpuKernelArgs& args)
+{
+    const float* u = args.input(2, 0);
+    for (size_t c = 0; c < args.outputSizes[0]; c++)
+    {
+        const float* left = args.input(0, c);
+        const float* right = args.input(1, c);
+        float* out = args.output(0, c);
+        for (size_t i = 0; i < args.count; i++)
+        {
+            const float t = std::min(std::max(u[i], 0.0f), 1.0f);
+            out[i] = left[i] * (1.0f - t) + right[i] * t;
+        }
+    }
+}
+
+void ramptbKernel(const CpuKernelArgs& args)
+{
+    const float* v = args.input(2, 1);
+    for (size_t c = 0; c < args.outputSizes[0]; c++)
+    {
+        const float* top = args.input(0, c);
+        const float* bottom = args.input(1, c);
+        float* out = args.output(0, c);
+        for (size_t i = 0; i < args.count; i++)
+        {
+            const float t = std::min(std::max(v[i], 0.0f), 1.0f);
+            out[i] = top[i] * (1.0f - t) + bottom[i] * t;
+        }
+    }
+}
+
+// Split at the center along the given texture coordinate.  Screen-space
+// derivatives are not available on the CPU, so the antialiased step of the
+// shading language implementation reduces to a hard step.
+template<size_t AXIS> void splitKernel(const CpuKernelArgs& args)
+{
+    const float* center = args.input(2, 0);
+    const float* coord = args.input(3, AXIS);
+    for (size_t c = 0; c < args.outputSizes[0]; c++)
+    {
+        const float* first = args.input(0, c);
+        const float* second = args.input(1, c);
+        float* out = args.output(0, c);
+        for (size_t i = 0; i < args.count; i++)
+        {
+            out[i] = coord[i] >= center[i] ? second[i] : first[i];
+        }
+    }
+}
+
+// Return the texel index for the given address mode, or -1 for texels
+// outside of a constant border.
+int wrapTexel(int x, int size, ImageSamplingProperties::AddressMode mode)
+{
+    switch (mode)
+    {
+        case ImageSamplingProperties::AddressMode::CONSTANT:
+            return (x < 0 || x >= size) ? -1 : x;
+        case ImageSamplingProperties::AddressMode::CLAMP:
+            return std::min(std::max(x, 0), size - 1);
+        case ImageSamplingProperties::AddressMode::MIRROR:
+        {
+            int m = x % (2 * size);
+            m = m < 0 ? m + 2 * size : m;
+            return m < size ? m : 2 * size - 1 - m;
+        }
+        default:
+        {
+            int m = x % size;
+            return m < 0 ? m + size : m;
+        }
+    }
+}
+
+void imageKernel(const CpuKernelArgs& args)
+{
+    const CpuKernelParams& params = *args.params;
+    const size_t size = args.outputSizes[0];
+    const Image* image = params.image.get();
+    if (!image || image->getWidth() <= 1 || !image->getResourceBuffer())
+    {
+        copyInput(args, 0);
+        return;
+    }
+
+    const ImageSamplingProperties& sampling = params.samplingProperties;
+    const bool linear = sampling.filterType != ImageSamplingProperties::FilterType::CLOSEST;
+    const int width = (int) image->getWidth();
+    const int height = (int) image->getHeight();
+    const float* u = args.input(1, 0);
+    const float* v = args.input(1, 1);
+    const bool transform = args.inputs[2] && args.inputs[3];
+    for (size_t i = 0; i < args.count; i++)
+    {
+        float s = u[i];
+        float t = v[i];
+        if (transform)
+        {
+            s = s * args.input(2, 0)[i] + args.input(3, 0)[i];
+            t = t * args.input(2, 1)[i] + args.input(3, 1)[i];
+        }
+        if (params.verticalFlip)
+        {
+            t = 1.0f - t;
+        }
+
+        // Gather the texels and weights of the filter footprint.
+        const float x = s * width - (linear ? 0.5f : 0.0f);
+        const float y = t * height - (linear ? 0.5f : 0.0f);
+        const int x0 = (int) std::floor(x);
+        const int y0 = (int) std::floor(y);
+        const float fx = linear ? x - x0 : 0.0f;
+        const float fy = linear ? y - y0 : 0.0f;
+        const int taps = linear ? 2 : 1;
+        float result[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        for (int ty = 0; ty < taps; ty++)
+        {
+            const int row = wrapTexel(y0 + ty, height, sampling.vaddressMode);
+            const float wy = ty ? fy : 1.0f - fy;
+            for (int tx = 0; tx < taps; tx++)
+            {
+                const int col = wrapTexel(x0 + tx, width, sampling.uaddressMode);
+                const float weight = wy * (tx ? fx : 1.0f - fx);
+                if (weight == 0.0f)
+                {
+                    continue;
+                }
+                Color4 texel;
+                if (row < 0 || col < 0)
+                {
+                    // Texels outside of a constant border take the default value.
+                    for (size_t c = 0; c < 4; c++)
+                    {
+                        texel[c] = c < size ? args.input(0, c)[i] : 1.0f;
+                    }
+                }
+                else
+                {
+                    texel = image->getTexelColor((unsigned int) col, (unsigned int) row);
+                }
+                for (size_t c = 0; c < 4; c++)
+                {
+                    result[c] += weight * texel[c];
+                }
+            }
+        }
+        for (size_t c = 0; c < size; c++)
+        {
+            args.output(0, c)[i] = result[c];
+        }
+    }
+}
+
+//
+// Noise kernels, following the noise library of the shading language
+// implementations.
+//
+
+uint32_t rotl32(uint32_t x, int k)
+{
+    return (x << k) | (x >> (32 - k));
+}
+
+uint32_t bjfinal(uint32_t a, uint32_t b, uint32_t c)
+{
+    c ^= b; c -= rotl32(b, 14);
+    a ^= c; a -= rotl32(c, 11);
+    b ^= a; b -= rotl32(a, 25);
+    c ^= b; c -= rotl32(b, 16);
+    a ^= c; a -= rotl32(c, 4);
+    b ^= a; b -= rotl32(a, 14);
+    c ^= b; c -= rotl32(b, 24);
+    return c;
+}
+
+uint32_t hashInt(int x, int y)
+{
+    const uint32_t seed = 0xdeadbeefu + (2u << 2u) + 13u;
+    return bjfinal(seed + (uint32_t) x, seed + (uint32_t) y, seed);
+}
+
+uint32_t hashInt(int x, int y, int z)
+{
+    const uint32_t seed = 0xdeadbeefu + (3u << 2u) + 13u;
+    return bjfinal(seed + (uint32_t) x, seed + (uint32_t) y, seed + (uint32_t) z);
+}
+
+int floorInt(float x)
+{
+    return x < 0.0f ? (int) x - 1 : (int) x;
+}
+
+float floorFrac(float x, int& i)
+{
+    i = floorInt(x);
+    return x - (float) i;
+}
+
+float fade(float t)
+{
+    return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+}
+
+float bitsTo01(uint32_t bits)
+{
+    return (float) bits / (float) 0xffffffffu;
+}
+
+float gradient(uint32_t hash, float x, float y)
+{
+    const uint32_t h = hash & 7u;
+    const float u = h < 4u ? x : y;
+    const float v = 2.0f * (h < 4u ? y : x);
+    return ((h & 1u) ? -u : u) + ((h & 2u) ? -v : v);
+}
+
+float gradient(uint32_t hash, float x, float y, float z)
+{
+    const uint32_t h = hash & 15u;
+    const float u = h < 8u ? x : y;
+    const float v = h < 4u ? y : ((h == 12u || h == 14u) ? x : z);
+    return ((h & 1u) ? -u : u) + ((h & 2u) ? -v : v);
+}
+
+float bilerp(float v0, float v1, float v2, float v3, float s, float t)
+{
+    const float s1 = 1.0f - s;
+    return (1.0f - t) * (v0 * s1 + v1 * s) + t * (v2 * s1 + v3 * s);
+}
+
+float trilerp(const float* v, float s, float t, float r)
+{
+    const float s1 = 1.0f - s;
+    const float t1 = 1.0f - t;
+    const float r1 = 1.0f - r;
+    return (r1 * (t1 * (v[0] * s1 + v[1] * s) + t * (v[2] * s1 + v[3] * s)) +
+            r * (t1 * (v[4] * s1 + v[5] * s) + t * (v[6] * s1 + v[7] * s)));
+}
+
+// Return a byte of the hash for the given channel, or the full hash for a
+// scalar noise.
+uint32_t channelHash(uint32_t hash, int channel)
+{
+    return channel < 0 ? hash : (hash >> (8 * channel)) & 0xFFu;
+}
+
+float perlinNoise(float px, float py, int channel)
+{
+    int X, Y;
+    const float fx = floorFrac(px, X);
+    const float fy = floorFrac(py, Y);
+    const float u = fade(fx);
+    const float v = fade(fy);
+    const float result = bilerp(
+        gradient(channelHash(hashInt(X, Y), channel), fx, fy),
+        gradient(channelHash(hashInt(X + 1, Y), channel), fx - 1.0f, fy),
+        gradient(channelHash(hashInt(X, Y + 1), channel), fx, fy - 1.0f),
+        gradient(channelHash(hashInt(X + 1, Y + 1), channel), fx - 1.0f, fy - 1.0f),
+        u, v);
+    return 0.6616f * result;
+}
+
+float perlinNoise(float px, float py, float pz, int channel)
+{
+    int X, Y, Z;
+    const float fx = floorFrac(px, X);
+    const float fy = floorFrac(py, Y);
+    const float fz = floorFrac(pz, Z);
+    float corners[8];
+    for (int k = 0; k < 8; k++)
+    {
+        const int dx = k & 1;
+        const int dy = (k >> 1) & 1;
+        const int dz = (k >> 2) & 1;
+        corners[k] = gradient(channelHash(hashInt(X + dx, Y + dy, Z + dz), channel),
+                              fx - (float) dx, fy - (float) dy, fz - (float) dz);
+    }
+    return 0.9820f * trilerp(corners, fade(fx), fade(fy), fade(fz));
+}
+
+float fractalNoise(float px, float py, float pz, int octaves, float lacunarity, float diminish, int channel)
+{
+    float result = 0.0f;
+    float amplitude = 1.0f;
+    for (int i = 0; i < octaves; i++)
+    {
+        result += amplitude * perlinNoise(px, py, pz, channel);
+        amplitude *= diminish;
+        px *= lacunarity;
+        py *= lacunarity;
+        pz *= lacunarity;
+    }
+    return result;
+}
+
+// Vector noise uses one byte of the hash per channel, and a fourth channel
+// is a scalar noise at an offset position.
+void noise2dKernel(const CpuKernelArgs& args)
+{
+    const size_t size = args.outputSizes[0];
+    const float* x = args.input(2, 0);
+    const float* y = args.input(2, 1);
+    for (size_t c = 0; c < size; c++)
+    {
+        const float* amplitude = args.input(0, c);
+        const float* pivot = args.input(1, 0);
+        float* out = args.output(0, c);
+        for (size_t i = 0; i < args.count; i++)
+        {
+            float value;
+            if (size == 1)
+                value = perlinNoise(x[i], y[i], -1);
+            else if (c < 3)
+                value = perlinNoise(x[i], y[i], (int) c);
+            else
+                value = perlinNoise(x[i] + 19.0f, y[i] + 73.0f, -1);
+            out[i] = value * amplitude[i] + pivot[i];
+        }
+    }
+}
+
+void noise3dKernel(const CpuKernelArgs& args)
+{
+    const size_t size = args.outputSizes[0];
+    const float* x = args.input(2, 0);
+    const float* y = args.input(2, 1);
+    const float* z = args.input(2, 2);
+    for (size_t c = 0; c < size; c++)
+    {
+        const float* amplitude = args.input(0, c);
+        const float* pivot = args.input(1, 0);
+        float* out = args.output(0, c);
+        for (size_t i = 0; i < args.count; i++)
+        {
+            float value;
+            if (size == 1)
+                value = perlinNoise(x[i], y[i], z[i], -1);
+            else if (c < 3)
+                value = perlinNoise(x[i], y[i], z[i], (int) c);
+            else
+                value = perlinNoise(x[i] + 19.0f, y[i] + 73.0f, z[i] + 29.0f, -1);
+            out[i] = value * amplitude[i] + pivot[i];
+        }
+    }
+}
+
+void fractal3dKernel(const CpuKernelArgs& args)
+{
+    const size_t size = args.outputSizes[0];
+    const float* octaves = args.input(1, 0);
+    const float* lacunarity = args.input(2, 0);
+    const float* diminish = args.input(3, 0);
+    const float* x = args.input(4, 0);
+    const float* y = args.input(4, 1);
+    const float* z = args.input(4, 2);
+    for (size_t c = 0; c < size; c++)
+    {
+        const float* amplitude = args.input(0, c);
+        float* out = args.output(0, c);
+        for (size_t i = 0; i < args.count; i++)
+        {
+            const int oct = (int) octaves[i];
+            float value;
+            if (size == 1)
+                value = fractalNoise(x[i], y[i], z[i], oct, lacunarity[i], diminish[i], -1);
+            else if (c < 3)
+                value = fractalNoise(x[i], y[i], z[i], oct, lacunarity[i], diminish[i], (int) c);
+            else
+                value = fractalNoise(x[i] + 19.0f, y[i] + 193.0f, z[i] + 17.0f, oct, lacunarity[i], diminish[i], -1);
+            out[i] = value * amplitude[i];
+        }
+    }
+}
+
+void cellnoise2dKernel(const CpuKernelArgs& args)
+{
+    const float* x = args.input(0, 0);
+    const float* y = args.input(0, 1);
+    float* out = args.output(0, 0);
+    for (size_t i = 0; i < args.count; i++)
+    {
+        out[i] = bitsTo01(hashInt(floorInt(x[i]), floorInt(y[i])));
+    }
+}
+
+void cellnoise3dKernel(const CpuKernelArgs& args)
+{
+    const float* x = args.input(0, 0);
+    const float* y = args.input(0, 1);
+    const float* z = args.input(0, 2);
+    float* out = args.output(0, 0);
+    for (size_t i = 0; i < args.count; i++)
+    {
+        out[i] = bitsTo01(hashInt(floorInt(x[i]), floorInt(y[i]), floorInt(z[i])));
+    }
+}
+
+using CpuKernelDefMap = std::unordered_map<string, CpuKernelDef>;
+
+CpuKernelDefMap createKernelDefs()
+{
+    CpuKernelDefMap defs;
+    auto add = [&defs](const string& category, const StringVec& inputs, CpuKernel kernel, const StringSet& optionalInputs)
+    {
+        CpuKernelDef def;
+        def.inputs = inputs;
+        def.optionalInputs = optionalInputs;
+        def.kernel = kernel;
+        defs[category] = def;
+    };
+    const StringVec IN = { "in" };
+    const StringVec IN12 = { "in1", "in2" };
+    const StringVec BLEND = { "fg", "bg", "mix" };
+
+    // Math
+    add("add", IN12, addKernel, {});
+    add("subtract", IN12, subtractKernel, {});
+    add("multiply", IN12, multiplyKernel, {});
+    add("divide", IN12, divideKernel, {});
+    add("modulo", IN12, moduloKernel, {});
+    add("invert", { "amount", "in" }, invertKernel, {});
+    add("power", IN12, powerKernel, {});
+    add("atan2", IN12, atan2Kernel, {});
+    add("min", IN12, minKernel, {});
+    add("max", IN12, maxKernel, {});
+    add("absval", IN, absvalKernel, {});
+    add("floor", IN, floorKernel, {});
+    add("ceil", IN, ceilKernel, {});
+    add("sin", IN, sinKernel, {});
+    add("cos", IN, cosKernel, {});
+    add("tan", IN, tanKernel, {});
+    add("asin", IN, asinKernel, {});
+    add("acos", IN, acosKernel, {});
+    add("sqrt", IN, sqrtKernel, {});
+    add("ln", IN, lnKernel, {});
+    add("exp", IN, expKernel, {});
+    add("sign", IN, signKernel, {});
+    add("clamp", { "in", "low", "high" }, clampKernel, {});
+    add("mix", { "bg", "fg", "mix" }, mixKernel, {});
+    add("smoothstep", { "in", "low", "high" }, smoothstepKernel, {});
+    add("remap", { "in", "inlow", "inhigh", "outlow", "outhigh" }, remapKernel, {});
+
+    // Geometric
+    add("dotproduct", IN12, dotproductKernel, {});
+    add("magnitude", IN, magnitudeKernel, {});
+    add("normalize", IN, normalizeKernel, {});
+    add("crossproduct", IN12, crossproductKernel, {});
+    add("rotate2d", { "in", "amount" }, rotate2dKernel, {});
+    add("rotate3d", { "in", "amount", "axis" }, rotate3dKernel, {});
+    // Transforms are only compiled where they leave values unchanged.
+    add("transformpoint", IN, copyKernel, {});
+    add("transformvector", IN, copyKernel, {});
+    add("transformnormal", IN, copyKernel, {});
+
+    // Channel
+    add("constant", { "value" }, copyKernel, {});
+    add("dot", IN, copyKernel, {});
+    add("convert", IN, copyKernel, {});
+    add("swizzle", IN, swizzleKernel, {});
+    add("combine2", IN12, combineKernel, {});
+    add("combine3", { "in1", "in2", "in3" }, combineKernel, {});
+    add("combine4", { "in1", "in2", "in3", "in4" }, combineKernel, {});
+    add("separate2", IN, separateKernel, {});
+    add("separate3", IN, separateKernel, {});
+    add("separate4", IN, separateKernel, {});
+
+    // Conditional
+    const StringVec IF = { "value1", "value2", "in1", "in2" };
+    add("ifgreater", IF, ifgreaterKernel, {});
+    add("ifgreatereq", IF, ifgreatereqKernel, {});
+    add("ifequal", IF, ifequalKernel, {});
+    add("switch", { "in1", "in2", "in3", "in4", "in5", "which" }, switchKernel, { "in3", "in4", "in5" });
+
+    // Compositing
+    add("plus", BLEND, plusKernel, {});
+    add("minus", BLEND, minusKernel, {});
+    add("difference", BLEND, differenceKernel, {});
+    add("screen", BLEND, screenKernel, {});
+    add("overlay", BLEND, overlayKernel, {});
+    add("burn", BLEND, burnKernel, {});
+    add("dodge", BLEND, dodgeKernel, {});
+    add("inside", { "in", "mask" }, insideKernel, {});
+    add("outside", { "in", "mask" }, outsideKernel, {});
+    add("over", BLEND, overKernel, {});
+    add("in", BLEND, inKernel, {});
+    add("out", BLEND, outKernel, {});
+    add("mask", BLEND, maskKernel, {});
+    add("matte", BLEND, matteKernel, {});
+    add("disjointover", BLEND, disjointoverKernel, {});
+    add("premult", IN, premultKernel, {});
+    add("unpremult", IN, unpremultKernel, {});
+
+    // Color
+    add("luminance", { "in", "lumacoeffs" }, luminanceKernel, {});
+    add("rgbtohsv", IN, colorSpaceKernel<rgbToHsv>, {});
+    add("hsvtorgb", IN, colorSpaceKernel<hsvToRgb>, {});
+    add("srgb_texture_to_linear", IN, srgbTextureToLinearKernel, {});
+    add("gamma18_to_linear", IN, gammaToLinearKernel<18>, {});
+    add("gamma22_to_linear", IN, gammaToLinearKernel<22>, {});
+    add("gamma24_to_linear", IN, gammaToLinearKernel<24>, {});
+    add("acescg_to_linear", IN, colorSpaceKernel<ap1ToRec709>, {});
+    add("g22_ap1_to_linear", IN, colorSpaceKernel<g22Ap1ToRec709>, {});
+
+    // Texture
+    add("image", { "default", "texcoord", "uv_scale", "uv_offset" }, imageKernel, { "uv_scale", "uv_offset" });
+    add("ramplr", { "valuel", "valuer", "texcoord" }, ramplrKernel, {});
+    add("ramptb", { "valuet", "valueb", "texcoord" }, ramptbKernel, {});
+    add("splitlr", { "valuel", "valuer", "center", "texcoord" }, splitKernel<0>, {});
+    add("splittb", { "valuet", "valueb", "center", "texcoord" }, splitKernel<1>, {});
+
+    // Procedural
+    add("noise2d", { "amplitude", "pivot", "texcoord" }, noise2dKernel, {});
+    add("noise3d", { "amplitude", "pivot", "position" }, noise3dKernel, {});
+    add("fractal3d", { "amplitude", "octaves", "lacunarity", "diminish", "position" }, fractal3dKernel, {});
+    add("cellnoise2d", { "texcoord" }, cellnoise2dKernel, {});
+    add("cellnoise3d", { "position" }, cellnoise3dKernel, {});
+
+    return defs;
+}
+
+// Return the kernel definitions of each instruction set, replacing the
+// scalar kernels with the vectorized kernels of each supported instruction
+// set in turn.
+vector<CpuKernelDefMap> createInstructionSetKernelDefs()
+{
+    vector<CpuKernelDefMap> tables = { createKernelDefs() };
+    const CpuInstructionSet vectorSets[] = { CpuInstructionSet::SSE4, CpuInstructionSet::AVX2, CpuInstructionSet::AVX512 };
+    for (CpuInstructionSet instructionSet : vectorSets)
+    {
+        CpuKernelDefMap defs = tables.back();
+        if (isCpuInstructionSetSupported(instructionSet))
+        {
+            const std::unordered_map<string, CpuKernel> kernels =
+                instructionSet == CpuInstructionSet::SSE4 ? getSse4CpuKernels() :
+                instructionSet == CpuInstructionSet::AVX2 ? getAvx2CpuKernels() : getAvx512CpuKernels();
+            for (const auto& pair : kernels)
+            {
+                defs[pair.first].kernel = pair.second;
+            }
+        }
+        tables.push_back(defs);
+    }
+    return tables;
+}
+
+// Return true if the host processor and operating system support the
+// given instruction set.
+bool isHostInstructionSetSupported(CpuInstructionSet instructionSet)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+    __cpuid(info, 1);
+    const bool sse41 = (info[2] & (1 << 19)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx2 = false;
+    bool avx512f = false;
+    if (maxLeaf >= 7)
+    {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+        avx512f = (info[1] & (1 << 16)) != 0;
+    }
+
+    // The operating system must save the vector registers of each width.
+    const unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+    const bool avxState = (xcr0 & 0x6) == 0x6;
+    const bool avx512State = (xcr0 & 0xE6) == 0xE6;
+    switch (instructionSet)
+    {
+        case CpuInstructionSet::SSE4: return sse41;
+        case CpuInstructionSet::AVX2: return avx2 && avxState;
+        case CpuInstructionSet::AVX512: return avx512f && avx512State;
+        default: return true;
+    }
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+    __builtin_cpu_init();
+    switch (instructionSet)
+    {
+        case CpuInstructionSet::SSE4: return __builtin_cpu_supports("sse4.1") != 0;
+        case CpuInstructionSet::AVX2: return __builtin_cpu_supports("avx2") != 0;
+        case CpuInstructionSet::AVX512: return __builtin_cpu_supports("avx512f") != 0;
+        default: return true;
+    }
+#else
+    return instructionSet == CpuInstructionSet::SCALAR;
+#endif
+}
+
+} // anonymous namespace
+
+const CpuKernelDef* getCpuKernelDef(const string& category)
+{
+    return getCpuKernelDef(category, getCpuInstructionSet());
+}
+
+const CpuKernelDef* getCpuKernelDef(const string& category, CpuInstructionSet instructionSet)
+{
+    static const vector<CpuKernelDefMap> KERNEL_DEFS = createInstructionSetKernelDefs();
+    const CpuKernelDefMap& defs = KERNEL_DEFS[(size_t) instructionSet];
+    auto it = defs.find(category);
+    return it != defs.end() ? &it->second : nullptr;
+}
+
+CpuInstructionSet getCpuInstructionSet()
+{
+    static const CpuInstructionSet INSTRUCTION_SET =
+        isCpuInstructionSetSupported(CpuInstructionSet::AVX512) ? CpuInstructionSet::AVX512 :
+        isCpuInstructionSetSupported(CpuInstructionSet::AVX2) ? CpuInstructionSet::AVX2 :
+        isCpuInstructionSetSupported(CpuInstructionSet::SSE4) ? CpuInstructionSet::SSE4 :
+        CpuInstructionSet::SCALAR;
+    return INSTRUCTION_SET;
+}
+
+bool isCpuInstructionSetSupported(CpuInstructionSet instructionSet)
+{
+    // Vectorized kernels are compiled for x86-64 targets, and AVX-512
+    // kernels require Visual Studio 2017 or newer.
+#if defined(__x86_64__) || defined(_M_X64)
+#if defined(_MSC_VER) && _MSC_VER < 1910
+    if (instructionSet == CpuInstructionSet::AVX512)
+    {
+        return false;
+    }
+#endif
+    return isHostInstructionSetSupported(instructionSet);
+#else
+    return instructionSet == CpuInstructionSet::SCALAR;
+#endif
+}
+
+string getCpuInstructionSetName(CpuInstructionSet instructionSet)
+{
+    switch (instructionSet)
+    {
+        case CpuInstructionSet::SSE4: return "sse4";
+        case CpuInstructionSet::AVX2: return "avx2";
+        case CpuInstructionSet::AVX512: return "avx512";
+        default: return "scalar";
+    }
+}
+
+} // namespace MaterialX
@@ -0,0 +1,139 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_CPUKERNELS_H
+#define MATERIALX_CPUKERNELS_H
+
+/// @file
+/// Kernels evaluating standard library nodes on the CPU
+
+#include <MaterialXRender/Export.h>
+#include <MaterialXRender/ImageHandler.h>
+
+namespace MaterialX
+{
+
+/// @class CpuKernelParams
+/// Uniform parameters of a node evaluated by a CPU kernel, resolved when
+/// its graph is compiled.
+class MX_RENDER_API CpuKernelParams
+{
+  public:
+    /// For each component of the output of a swizzle, the index of the
+    /// input component to copy, or -1 for zero and -2 for one.
+    vector<int> channels;
+
+    /// The image sampled by an image node.  Images with a width of one
+    /// texel or less are treated as missing, and the default value is used.
+    ImagePtr image;
+
+    /// The sampling properties of an image node.
+    ImageSamplingProperties samplingProperties;
+
+    /// If true, image lookups are flipped in the V direction.
+    bool verticalFlip = false;
+};
+
+/// Instruction sets for which CPU kernels are compiled.
+enum class CpuInstructionSet
+{
+    SCALAR,
+    SSE4,
+    AVX2,
+    AVX512
+};
+
+/// @class CpuKernelArgs
+/// Arguments of a CPU kernel, holding the values of the ports of a node for
+/// a batch of samples.  Values are stored by component, with the values of
+/// component c of all samples starting at offset c * stride.
+///
+/// Vectorized kernels process samples in groups of up to BATCH_ALIGNMENT,
+/// and may write values past the count of samples, so the stride must be a
+/// multiple of BATCH_ALIGNMENT.
+class MX_RENDER_API CpuKernelArgs
+{
+  public:
+    /// Return the values of component c of the input at the given index.
+    /// Inputs with a single component are broadcast to all components.
+    const float* input(size_t index, size_t c) const
+    {
+        return inputs[index] + (inputSizes[index] == 1 ? 0 : c * stride);
+    }
+
+    /// Return the values of component c of the output at the given index.
+    float* output(size_t index, size_t c) const
+    {
+        return outputs[index] + c * stride;
+    }
+
+  public:
+    /// The number of samples in the batch.
+    size_t count = 0;
+
+    /// The distance between the components of a port value.
+    size_t stride = 0;
+
+    /// The input values, in the order declared by the kernel.  Optional
+    /// inputs that the node lacks have a null pointer and a size of zero.
+    vector<const float*> inputs;
+    vector<size_t> inputSizes;
+
+    /// The output values, in the order of the node outputs.
+    vector<float*> outputs;
+    vector<size_t> outputSizes;
+
+    /// The uniform parameters of the node.
+    const CpuKernelParams* params = nullptr;
+
+  public:
+    /// The number of samples that the stride must be a multiple of.
+    static const size_t BATCH_ALIGNMENT;
+};
+
+/// A function evaluating a node for a batch of samples.
+using CpuKernel = void (*)(const CpuKernelArgs& args);
+
+/// @class CpuKernelDef
+/// The definition of a CPU kernel for a node category.
+class MX_RENDER_API CpuKernelDef
+{
+  public:
+    /// The names of the node inputs passed to the kernel, in order.
+    StringVec inputs;
+
+    /// The names of inputs that may be missing from a node.
+    StringSet optionalInputs;
+
+    /// The kernel function.
+    CpuKernel kernel;
+};
+
+/// Return the kernel definition for the given node category, or nullptr if
+/// the category has no CPU kernel.  Color transform nodes are identified by
+/// their transform, e.g. "srgb_texture_to_linear".  The kernel uses the
+/// widest instruction set supported by the host.
+MX_RENDER_API const CpuKernelDef* getCpuKernelDef(const string& category);
+
+/// Return the kernel definition for the given node category, using kernels
+/// of the given instruction set where available.  Kernels without a
+/// vectorized version, and instruction sets that the host does not support,
+/// fall back to the widest supported instruction set below the given one.
+MX_RENDER_API const CpuKernelDef* getCpuKernelDef(const string& category, CpuInstructionSet instructionSet);
+
+/// Return the widest instruction set for which CPU kernels were compiled and
+/// which the host supports.
+MX_RENDER_API CpuInstructionSet getCpuInstructionSet();
+
+/// Return true if kernels of the given instruction set were compiled and the
+/// host supports the instruction set.
+MX_RENDER_API bool isCpuInstructionSetSupported(CpuInstructionSet instructionSet);
+
+/// Return the name of the given instruction set, e.g. "avx2".
+MX_RENDER_API string getCpuInstructionSetName(CpuInstructionSet instructionSet);
+
+} // namespace MaterialX
+
+#endif
@@ -0,0 +1,154 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXRender/CpuKernels.h>
+
+#include <algorithm>
+#include <cstdint>
+
+// The instruction set is enabled only for the kernels below, which are
+// called once the host has been found to support it.
+#if defined(__x86_64__) || defined(_M_X64)
+#define MATERIALX_CPU_AVX2_KERNELS
+#endif
+
+#ifdef MATERIALX_CPU_AVX2_KERNELS
+
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace MaterialX
+{
+
+namespace
+{
+
+struct Float8
+{
+    Float8() { }
+    explicit Float8(float x) : v(_mm256_set1_ps(x)) { }
+    Float8(__m256 x) : v(x) { }
+    __m256 v;
+};
+
+struct Int8
+{
+    Int8() { }
+    explicit Int8(int x) : v(_mm256_set1_epi32(x)) { }
+    Int8(__m256i x) : v(x) { }
+    __m256i v;
+};
+
+struct Mask8
+{
+    Mask8() { }
+    Mask8(__m256 x) : v(x) { }
+    __m256 v;
+};
+
+Float8 operator+(Float8 a, Float8 b) { return _mm256_add_ps(a.v, b.v); }
+Float8 operator-(Float8 a, Float8 b) { return _mm256_sub_ps(a.v, b.v); }
+Float8 operator*(Float8 a, Float8 b) { return _mm256_mul_ps(a.v, b.v); }
+Float8 operator/(Float8 a, Float8 b) { return _mm256_div_ps(a.v, b.v); }
+Float8 operator-(Float8 a) { return _mm256_xor_ps(a.v, _mm256_set1_ps(-0.0f)); }
+
+Mask8 operator<(Float8 a, Float8 b) { return _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ); }
+Mask8 operator<=(Float8 a, Float8 b) { return _mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ); }
+Mask8 operator>(Float8 a, Float8 b) { return _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ); }
+Mask8 operator>=(Float8 a, Float8 b) { return _mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ); }
+Mask8 operator==(Float8 a, Float8 b) { return _mm256_cmp_ps(a.v, b.v, _CMP_EQ_OQ); }
+Mask8 operator&(Mask8 a, Mask8 b) { return _mm256_and_ps(a.v, b.v); }
+Mask8 operator|(Mask8 a, Mask8 b) { return _mm256_or_ps(a.v, b.v); }
+
+Float8 select(Mask8 m, Float8 a, Float8 b) { return _mm256_blendv_ps(b.v, a.v, m.v); }
+
+// The arguments are swapped to match std::min and std::max, which return
+// their first argument if either is NaN.
+Float8 min(Float8 a, Float8 b) { return _mm256_min_ps(b.v, a.v); }
+Float8 max(Float8 a, Float8 b) { return _mm256_max_ps(b.v, a.v); }
+
+Float8 abs(Float8 a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v); }
+Float8 floor(Float8 a) { return _mm256_floor_ps(a.v); }
+Float8 ceil(Float8 a) { return _mm256_ceil_ps(a.v); }
+Float8 sqrt(Float8 a) { return _mm256_sqrt_ps(a.v); }
+
+Int8 operator+(Int8 a, Int8 b) { return _mm256_add_epi32(a.v, b.v); }
+Int8 operator-(Int8 a, Int8 b) { return _mm256_sub_epi32(a.v, b.v); }
+Int8 operator*(Int8 a, Int8 b) { return _mm256_mullo_epi32(a.v, b.v); }
+Int8 operator^(Int8 a, Int8 b) { return _mm256_xor_si256(a.v, b.v); }
+Int8 operator&(Int8 a, Int8 b) { return _mm256_and_si256(a.v, b.v); }
+Int8 operator|(Int8 a, Int8 b) { return _mm256_or_si256(a.v, b.v); }
+
+Mask8 operator<(Int8 a, Int8 b) { return _mm256_castsi256_ps(_mm256_cmpgt_epi32(b.v, a.v)); }
+Mask8 operator==(Int8 a, Int8 b) { return _mm256_castsi256_ps(_mm256_cmpeq_epi32(a.v, b.v)); }
+
+Int8 select(Mask8 m, Int8 a, Int8 b)
+{
+    return _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(b.v), _mm256_castsi256_ps(a.v), m.v));
+}
+
+Int8 min(Int8 a, Int8 b) { return _mm256_min_epi32(a.v, b.v); }
+Int8 max(Int8 a, Int8 b) { return _mm256_max_epi32(a.v, b.v); }
+
+Int8 shiftLeft(Int8 a, int n) { return _mm256_sll_epi32(a.v, _mm_cvtsi32_si128(n)); }
+Int8 shiftRight(Int8 a, int n) { return _mm256_srl_epi32(a.v, _mm_cvtsi32_si128(n)); }
+
+Int8 truncate(Float8 a) { return _mm256_cvttps_epi32(a.v); }
+Float8 toFloat(Int8 a) { return _mm256_cvtepi32_ps(a.v); }
+
+// Convert the high and low halves of unsigned integers exactly, so that
+// their sum is rounded once.
+Float8 unsignedToFloat(Int8 a)
+{
+    const __m256 high = _mm256_cvtepi32_ps(_mm256_srli_epi32(a.v, 16));
+    const __m256 low = _mm256_cvtepi32_ps(_mm256_and_si256(a.v, _mm256_set1_epi32(0xFFFF)));
+    return _mm256_add_ps(_mm256_mul_ps(high, _mm256_set1_ps(65536.0f)), low);
+}
+
+struct Avx2
+{
+    static const size_t WIDTH = 8;
+    using Float = Float8;
+    using Int = Int8;
+    using Mask = Mask8;
+
+    static Float8 load(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, Float8 a) { _mm256_storeu_ps(p, a.v); }
+    static void store(int32_t* p, Int8 a) { _mm256_storeu_si256((__m256i*) p, a.v); }
+};
+
+} // anonymous namespace
+
+} // namespace MaterialX
+
+#include <MaterialXRender/CpuSimdKernels.h>
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif
+
+namespace MaterialX
+{
+
+std::unordered_map<string, CpuKernel> getAvx2CpuKernels()
+{
+#ifdef MATERIALX_CPU_AVX2_KERNELS
+    return createSimdKernels<Avx2>();
+#else
+    return std::unordered_map<string, CpuKernel>();
+#endif
+}
+
+} // namespace MaterialX
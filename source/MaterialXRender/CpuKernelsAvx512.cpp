@@ -0,0 +1,151 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXRender/CpuKernels.h>
+
+#include <algorithm>
+#include <cstdint>
+
+// The instruction set is enabled only for the kernels below, which are
+// called once the host has been found to support it.  Visual Studio
+// provides the intrinsics from version 2017.
+#if defined(__x86_64__) || (defined(_M_X64) && _MSC_VER >= 1910)
+#define MATERIALX_CPU_AVX512_KERNELS
+#endif
+
+#ifdef MATERIALX_CPU_AVX512_KERNELS
+
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx512f"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#endif
+
+namespace MaterialX
+{
+
+namespace
+{
+
+struct Float16
+{
+    Float16() { }
+    explicit Float16(float x) : v(_mm512_set1_ps(x)) { }
+    Float16(__m512 x) : v(x) { }
+    __m512 v;
+};
+
+struct Int16
+{
+    Int16() { }
+    explicit Int16(int x) : v(_mm512_set1_epi32(x)) { }
+    Int16(__m512i x) : v(x) { }
+    __m512i v;
+};
+
+struct Mask16
+{
+    Mask16() { }
+    Mask16(__mmask16 x) : m(x) { }
+    __mmask16 m;
+};
+
+// The unmasked forms of some intrinsics merge their result into an
+// undefined vector, so the masked forms are used with every lane enabled.
+const __mmask16 ALL_LANES = 0xFFFF;
+
+__m512 bitAnd(__m512 a, __m512i b) { return _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(a), b)); }
+__m512 bitXor(__m512 a, __m512i b) { return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a), b)); }
+
+Float16 operator+(Float16 a, Float16 b) { return _mm512_add_ps(a.v, b.v); }
+Float16 operator-(Float16 a, Float16 b) { return _mm512_sub_ps(a.v, b.v); }
+Float16 operator*(Float16 a, Float16 b) { return _mm512_mul_ps(a.v, b.v); }
+Float16 operator/(Float16 a, Float16 b) { return _mm512_div_ps(a.v, b.v); }
+Float16 operator-(Float16 a) { return bitXor(a.v, _mm512_set1_epi32((int) 0x80000000u)); }
+
+Mask16 operator<(Float16 a, Float16 b) { return _mm512_cmp_ps_mask(a.v, b.v, _CMP_LT_OQ); }
+Mask16 operator<=(Float16 a, Float16 b) { return _mm512_cmp_ps_mask(a.v, b.v, _CMP_LE_OQ); }
+Mask16 operator>(Float16 a, Float16 b) { return _mm512_cmp_ps_mask(a.v, b.v, _CMP_GT_OQ); }
+Mask16 operator>=(Float16 a, Float16 b) { return _mm512_cmp_ps_mask(a.v, b.v, _CMP_GE_OQ); }
+Mask16 operator==(Float16 a, Float16 b) { return _mm512_cmp_ps_mask(a.v, b.v, _CMP_EQ_OQ); }
+Mask16 operator&(Mask16 a, Mask16 b) { return _mm512_kand(a.m, b.m); }
+Mask16 operator|(Mask16 a, Mask16 b) { return _mm512_kor(a.m, b.m); }
+
+Float16 select(Mask16 m, Float16 a, Float16 b) { return _mm512_mask_blend_ps(m.m, b.v, a.v); }
+
+// The arguments are swapped to match std::min and std::max, which return
+// their first argument if either is NaN.
+Float16 min(Float16 a, Float16 b) { return _mm512_mask_min_ps(b.v, ALL_LANES, b.v, a.v); }
+Float16 max(Float16 a, Float16 b) { return _mm512_mask_max_ps(b.v, ALL_LANES, b.v, a.v); }
+
+Float16 abs(Float16 a) { return bitAnd(a.v, _mm512_set1_epi32(0x7FFFFFFF)); }
+Float16 floor(Float16 a) { return _mm512_mask_roundscale_ps(a.v, ALL_LANES, a.v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+Float16 ceil(Float16 a) { return _mm512_mask_roundscale_ps(a.v, ALL_LANES, a.v, _MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC); }
+Float16 sqrt(Float16 a) { return _mm512_mask_sqrt_ps(a.v, ALL_LANES, a.v); }
+
+Int16 operator+(Int16 a, Int16 b) { return _mm512_add_epi32(a.v, b.v); }
+Int16 operator-(Int16 a, Int16 b) { return _mm512_sub_epi32(a.v, b.v); }
+Int16 operator*(Int16 a, Int16 b) { return _mm512_mullo_epi32(a.v, b.v); }
+Int16 operator^(Int16 a, Int16 b) { return _mm512_xor_si512(a.v, b.v); }
+Int16 operator&(Int16 a, Int16 b) { return _mm512_and_si512(a.v, b.v); }
+Int16 operator|(Int16 a, Int16 b) { return _mm512_or_si512(a.v, b.v); }
+
+Mask16 operator<(Int16 a, Int16 b) { return _mm512_cmplt_epi32_mask(a.v, b.v); }
+Mask16 operator==(Int16 a, Int16 b) { return _mm512_cmpeq_epi32_mask(a.v, b.v); }
+
+Int16 select(Mask16 m, Int16 a, Int16 b) { return _mm512_mask_blend_epi32(m.m, b.v, a.v); }
+
+Int16 min(Int16 a, Int16 b) { return _mm512_mask_min_epi32(a.v, ALL_LANES, a.v, b.v); }
+Int16 max(Int16 a, Int16 b) { return _mm512_mask_max_epi32(a.v, ALL_LANES, a.v, b.v); }
+
+Int16 shiftLeft(Int16 a, int n) { return _mm512_mask_sll_epi32(a.v, ALL_LANES, a.v, _mm_cvtsi32_si128(n)); }
+Int16 shiftRight(Int16 a, int n) { return _mm512_mask_srl_epi32(a.v, ALL_LANES, a.v, _mm_cvtsi32_si128(n)); }
+
+Int16 truncate(Float16 a) { return _mm512_mask_cvttps_epi32(_mm512_castps_si512(a.v), ALL_LANES, a.v); }
+Float16 toFloat(Int16 a) { return _mm512_mask_cvtepi32_ps(_mm512_castsi512_ps(a.v), ALL_LANES, a.v); }
+Float16 unsignedToFloat(Int16 a) { return _mm512_mask_cvtepu32_ps(_mm512_castsi512_ps(a.v), ALL_LANES, a.v); }
+
+struct Avx512
+{
+    static const size_t WIDTH = 16;
+    using Float = Float16;
+    using Int = Int16;
+    using Mask = Mask16;
+
+    static Float16 load(const float* p) { return _mm512_loadu_ps(p); }
+    static void store(float* p, Float16 a) { _mm512_storeu_ps(p, a.v); }
+    static void store(int32_t* p, Int16 a) { _mm512_storeu_si512(p, a.v); }
+};
+
+} // anonymous namespace
+
+} // namespace MaterialX
+
+#include <MaterialXRender/CpuSimdKernels.h>
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif
+
+namespace MaterialX
+{
+
+std::unordered_map<string, CpuKernel> getAvx512CpuKernels()
+{
+#ifdef MATERIALX_CPU_AVX512_KERNELS
+    return createSimdKernels<Avx512>();
+#else
+    return std::unordered_map<string, CpuKernel>();
+#endif
+}
+
+} // namespace MaterialX
@@ -0,0 +1,154 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXRender/CpuKernels.h>
+
+#include <algorithm>
+#include <cstdint>
+
+// The instruction set is enabled only for the kernels below, which are
+// called once the host has been found to support it.
+#if defined(__x86_64__) || defined(_M_X64)
+#define MATERIALX_CPU_SSE4_KERNELS
+#endif
+
+#ifdef MATERIALX_CPU_SSE4_KERNELS
+
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("sse4.1"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse4.1")
+#endif
+
+namespace MaterialX
+{
+
+namespace
+{
+
+struct Float4
+{
+    Float4() { }
+    explicit Float4(float x) : v(_mm_set1_ps(x)) { }
+    Float4(__m128 x) : v(x) { }
+    __m128 v;
+};
+
+struct Int4
+{
+    Int4() { }
+    explicit Int4(int x) : v(_mm_set1_epi32(x)) { }
+    Int4(__m128i x) : v(x) { }
+    __m128i v;
+};
+
+struct Mask4
+{
+    Mask4() { }
+    Mask4(__m128 x) : v(x) { }
+    __m128 v;
+};
+
+Float4 operator+(Float4 a, Float4 b) { return _mm_add_ps(a.v, b.v); }
+Float4 operator-(Float4 a, Float4 b) { return _mm_sub_ps(a.v, b.v); }
+Float4 operator*(Float4 a, Float4 b) { return _mm_mul_ps(a.v, b.v); }
+Float4 operator/(Float4 a, Float4 b) { return _mm_div_ps(a.v, b.v); }
+Float4 operator-(Float4 a) { return _mm_xor_ps(a.v, _mm_set1_ps(-0.0f)); }
+
+Mask4 operator<(Float4 a, Float4 b) { return _mm_cmplt_ps(a.v, b.v); }
+Mask4 operator<=(Float4 a, Float4 b) { return _mm_cmple_ps(a.v, b.v); }
+Mask4 operator>(Float4 a, Float4 b) { return _mm_cmpgt_ps(a.v, b.v); }
+Mask4 operator>=(Float4 a, Float4 b) { return _mm_cmpge_ps(a.v, b.v); }
+Mask4 operator==(Float4 a, Float4 b) { return _mm_cmpeq_ps(a.v, b.v); }
+Mask4 operator&(Mask4 a, Mask4 b) { return _mm_and_ps(a.v, b.v); }
+Mask4 operator|(Mask4 a, Mask4 b) { return _mm_or_ps(a.v, b.v); }
+
+Float4 select(Mask4 m, Float4 a, Float4 b) { return _mm_blendv_ps(b.v, a.v, m.v); }
+
+// The arguments are swapped to match std::min and std::max, which return
+// their first argument if either is NaN.
+Float4 min(Float4 a, Float4 b) { return _mm_min_ps(b.v, a.v); }
+Float4 max(Float4 a, Float4 b) { return _mm_max_ps(b.v, a.v); }
+
+Float4 abs(Float4 a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v); }
+Float4 floor(Float4 a) { return _mm_floor_ps(a.v); }
+Float4 ceil(Float4 a) { return _mm_ceil_ps(a.v); }
+Float4 sqrt(Float4 a) { return _mm_sqrt_ps(a.v); }
+
+Int4 operator+(Int4 a, Int4 b) { return _mm_add_epi32(a.v, b.v); }
+Int4 operator-(Int4 a, Int4 b) { return _mm_sub_epi32(a.v, b.v); }
+Int4 operator*(Int4 a, Int4 b) { return _mm_mullo_epi32(a.v, b.v); }
+Int4 operator^(Int4 a, Int4 b) { return _mm_xor_si128(a.v, b.v); }
+Int4 operator&(Int4 a, Int4 b) { return _mm_and_si128(a.v, b.v); }
+Int4 operator|(Int4 a, Int4 b) { return _mm_or_si128(a.v, b.v); }
+
+Mask4 operator<(Int4 a, Int4 b) { return _mm_castsi128_ps(_mm_cmplt_epi32(a.v, b.v)); }
+Mask4 operator==(Int4 a, Int4 b) { return _mm_castsi128_ps(_mm_cmpeq_epi32(a.v, b.v)); }
+
+Int4 select(Mask4 m, Int4 a, Int4 b)
+{
+    return _mm_castps_si128(_mm_blendv_ps(_mm_castsi128_ps(b.v), _mm_castsi128_ps(a.v), m.v));
+}
+
+Int4 min(Int4 a, Int4 b) { return _mm_min_epi32(a.v, b.v); }
+Int4 max(Int4 a, Int4 b) { return _mm_max_epi32(a.v, b.v); }
+
+Int4 shiftLeft(Int4 a, int n) { return _mm_sll_epi32(a.v, _mm_cvtsi32_si128(n)); }
+Int4 shiftRight(Int4 a, int n) { return _mm_srl_epi32(a.v, _mm_cvtsi32_si128(n)); }
+
+Int4 truncate(Float4 a) { return _mm_cvttps_epi32(a.v); }
+Float4 toFloat(Int4 a) { return _mm_cvtepi32_ps(a.v); }
+
+// Convert the high and low halves of unsigned integers exactly, so that
+// their sum is rounded once.
+Float4 unsignedToFloat(Int4 a)
+{
+    const __m128 high = _mm_cvtepi32_ps(_mm_srli_epi32(a.v, 16));
+    const __m128 low = _mm_cvtepi32_ps(_mm_and_si128(a.v, _mm_set1_epi32(0xFFFF)));
+    return _mm_add_ps(_mm_mul_ps(high, _mm_set1_ps(65536.0f)), low);
+}
+
+struct Sse4
+{
+    static const size_t WIDTH = 4;
+    using Float = Float4;
+    using Int = Int4;
+    using Mask = Mask4;
+
+    static Float4 load(const float* p) { return _mm_loadu_ps(p); }
+    static void store(float* p, Float4 a) { _mm_storeu_ps(p, a.v); }
+    static void store(int32_t* p, Int4 a) { _mm_storeu_si128((__m128i*) p, a.v); }
+};
+
+} // anonymous namespace
+
+} // namespace MaterialX
+
+#include <MaterialXRender/CpuSimdKernels.h>
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif
+
+namespace MaterialX
+{
+
+std::unordered_map<string, CpuKernel> getSse4CpuKernels()
+{
+#ifdef MATERIALX_CPU_SSE4_KERNELS
+    return createSimdKernels<Sse4>();
+#else
+    return std::unordered_map<string, CpuKernel>();
+#endif
+}
+
+} // namespace MaterialX
@@ -0,0 +1,1140 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_CPUSIMDKERNELS_H
+#define MATERIALX_CPUSIMDKERNELS_H
+
+/// @file
+/// Vectorized kernels evaluating standard library nodes on the CPU.
+///
+/// This header is internal to MaterialXRender.  It is included by the
+/// translation unit of each instruction set, after the instruction set has
+/// been enabled and a class V has been defined with:
+///   - Float, Int and Mask types holding WIDTH floats, 32-bit integers and
+///     comparison results, with arithmetic and comparison operators.
+///   - Static load and store functions for floats and integers.
+///   - Free functions min, max, abs, floor, ceil, sqrt, select, truncate, toFloat,
+///     unsignedToFloat, shiftLeft and shiftRight, found through argument
+///     dependent lookup.
+/// The kernels follow the order of operations of the scalar kernels, so that
+/// the results of all instruction sets match.
+
+#include <MaterialXRender/CpuKernels.h>
+
+#include <algorithm>
+#include <cstdint>
+
+namespace MaterialX
+{
+
+namespace
+{
+
+const float SIMD_FLOAT_EPS = 1e-8f;
+
+//
+// Helpers applying an operation to each component of the output
+//
+
+template<class V, class Op> void unaryOp(const CpuKernelArgs& args, Op op)
+{
+    for (size_t c = 0; c < args.outputSizes[0]; c++)
+    {
+        const float* a = args.input(0, c);
+        float* out = args.output(0, c);
+        for (size_t i = 0; i < args.count; i += V::WIDTH)
+        {
+            V::store(out + i, op(V::load(a + i)));
+        }
+    }
+}
+
+template<class V, class Op> void binaryOp(const CpuKernelArgs& args, Op op)
+{
+    for (size_t c = 0; c < args.outputSizes[0]; c++)
+    {
+        const float* a = args.input(0, c);
+        const float* b = args.input(1, c);
+        float* out = args.output(0, c);
+        for (size_t i = 0; i < args.count; i += V::WIDTH)
+        {
+            V::store(out + i, op(V::load(a + i), V::load(b + i)));
+        }
+    }
+}
+
+template<class V, class Op> void ternaryOp(const CpuKernelArgs& args, Op op)
+{
+    for (size_t c = 0; c < args.outputSizes[0]; c++)
+    {
+        const float* a = args.input(0, c);
+        const float* b = args.input(1, c);
+        const float* d = args.input(2, c);
+        float* out = args.output(0, c);
+        for (size_t i = 0; i < args.count; i += V::WIDTH)
+        {
+            V::store(out + i, op(V::load(a + i), V::load(b + i), V::load(d + i)));
+        }
+    }
+}
+
+// Apply a blend operation of the fg and bg inputs, weighted by the mix input.
+template<class V, class Op> void blendOp(const CpuKernelArgs& args, Op op)
+{
+    using Float = typename V::Float;
+    for (size_t c = 0; c < args.outputSizes[0]; c++)
+    {
+        const float* fg = args.input(0, c);
+        const float* bg = args.input(1, c);
+        const float* m = args.input(2, c);
+        float* out = args.output(0, c);
+        for (size_t i = 0; i < args.count; i += V::WIDTH)
+        {
+            const Float vfg = V::load(fg + i);
+            const Float vbg = V::load(bg + i);
+            const Float vm = V::load(m + i);
+            V::store(out + i, vm * op(vfg, vbg) + (Float(1.0f) - vm) * vbg);
+        }
+    }
+}
+
+template<class V, template<class> class Op> void unaryKernel(const CpuKernelArgs& args)
+{
+    unaryOp<V>(args, Op<V>());
+}
+
+template<class V, template<class> class Op> void binaryKernel(const CpuKernelArgs& args)
+{
+    binaryOp<V>(args, Op<V>());
+}
+
+template<class V, template<class> class Op> void ternaryKernel(const CpuKernelArgs& args)
+{
+    ternaryOp<V>(args, Op<V>());
+}
+
+template<class V, template<class> class Op> void blendKernel(const CpuKernelArgs& args)
+{
+    blendOp<V>(args, Op<V>());
+}
+
+// Copy the first input to the output, converting between sizes.
+void copyInput(const CpuKernelArgs& args, size_t index)
+{
+    const size_t inSize = args.inputSizes[index];
+    for (size_t c = 0; c < args.outputSizes[0]; c++)
+    {
+        float* out = args.output(0, c);
+        if (inSize == 1 || c < inSize)
+        {
+            std::copy(args.input(index, c), args.input(index, c) + args.count, out);
+        }
+        else
+        {
+            std::fill(out, out + args.count, c == 3 ? 1.0f : 0.0f);
+        }
+    }
+}
+
+// Copy the alpha of a four-component input to the output.
+void copyAlpha(const CpuKernelArgs& args)
+{
+    if (args.outputSizes[0] == 4 && args.inputSizes[0] == 4)
+    {
+        std::copy(args.input(0, 3), args.input(0, 3) + args.count, args.output(0, 3));
+    }
+}
+
+//
+// Math operations
+//
+
+template<class V> struct AddOp
+{
+    using Float = typename V::Float;
+    Float operator()(Float a, Float b) const { return a + b; }
+};
+
+template<class V> struct SubtractOp
+{
+    using Float = typename V::Float;
+    Float operator()(Float a, Float b) const { return a - b; }
+};
+
+template<class V> struct MultiplyOp
+{
+    using Float = typename V::Float;
+    Float operator()(Float a, Float b) const { return a * b; }
+};
+
+template<class V> struct DivideOp
+{
+    using Float = typename V::Float;
+    Float operator()(Float a, Float b) const { return a / b; }
+};
+
+template<class V> struct ModuloOp
+{
+    using Float = typename V::Float;
+    Float operator()(Float a, Float b) const { return a - b * floor(a / b); }
+};
+
+template<class V> struct InvertOp
+{
+    using Float = typename V::Float;
+    Float operator()(Float amount, Float a) const { return amount - a; }
+};
+
+template<class V> struct MinOp
+{
+    using Float = typename V::Float;
+    Float operator()(Float a, Float b) const { return min(a, b); }
+};
+
+template<class V> struct MaxOp
+{
+    using Float = typename V::Float;
+    Float operator()(Float a, Float b) const { return max(a, b); }
+};
+
+template<class V> struct AbsvalOp
+{
+    using Float = typename V::Float;
+    Float operator()(Float a) const { return abs(a); }
+};
+
+template<class V> struct FloorOp
+{
+    using Float = typename V::Float;
+    Float operator()(Float a) const { return floor(a); }
+};
+
+template<class V> struct CeilOp
+{
+    using Float = typename V::Float;
+    Float operator()(Float a) const { return ceil(a); }
+};
+
+template<class V> struct SqrtOp
+{
+    using Float = typename V::Float;
+    Float operator()(Float a) const { return sqrt(a); }
+};
+
+template<class V> struct SignOp
+{
+    using Float = typename V::Float;
+    Float operator()(Float a) const
+    {
+        return select(a > Float(0.0f), Float(1.0f), select(a < Float(0.0f), Float(-1.0f), Float(0.0f)));
+    }
+};
+
+template<class V> struct ClampOp
+{
+    using Float = typename V::Float;
+    Float operator()(Float a, Float low, Float high) const { return min(max(a, low), high); }
+};
+
+template<class V> struct MixOp
+{
+    using Float = typename V::Float;
+    Float operator()(Float bg, Float fg, Float m) const { return bg * (Float(1.0f) - m) + fg * m; }
+};
+
+template<class V> struct SmoothstepOp
+{
+    using Float = typename V::Float;
+    Float operator()(Float a, Float low, Float high) const
+    {
+        const Float t = (a - low) / (high - low);
+        const Float result = t * t * (Float(3.0f) - Float(2.0f) * t);
+        return select(a <= low, Float(0.0f), select(a >= high, Float(1.0f), result));
+    }
+};
+
+template<class V> void remapKernel(const CpuKernelArgs& args)
+{
+    for (size_t c = 0; c < args.outputSizes[0]; c++)
+    {
+        const float* in = args.input(0, c);
+        const float* inLow = args.input(1, c);
+        const float* inHigh = args.input(2, c);
+        const float* outLow = args.input(3, c);
+        const float* outHigh = args.input(4, c);
+        float* out = args.output(0, c);
+        for (size_t i = 0; i < args.count; i += V::WIDTH)
+        {
+            const typename V::Float vInLow = V::load(inLow + i);
+            const typename V::Float vOutLow = V::load(outLow + i);
+            V::store(out + i, vOutLow + (V::load(in + i) - vInLow) * (V::load(outHigh + i) - vOutLow) / (V::load(inHigh + i) - vInLow));
+        }
+    }
+}
+
+//
+// Geometric kernels
+//
+
+template<class V> void dotproductKernel(const CpuKernelArgs& args)
+{
+    using Float = typename V::Float;
+    float* out = args.output(0, 0);
+    for (size_t i = 0; i < args.count; i += V::WIDTH)
+    {
+        Float dot(0.0f);
+        for (size_t c = 0; c < args.inputSizes[0]; c++)
+        {
+            dot = dot + V::load(args.input(0, c) + i) * V::load(args.input(1, c) + i);
+        }
+        V::store(out + i, dot);
+    }
+}
+
+template<class V> void magnitudeKernel(const CpuKernelArgs& args)
+{
+    using Float = typename V::Float;
+    float* out = args.output(0, 0);
+    for (size_t i = 0; i < args.count; i += V::WIDTH)
+    {
+        Float dot(0.0f);
+        for (size_t c = 0; c < args.inputSizes[0]; c++)
+        {
+            const Float a = V::load(args.input(0, c) + i);
+            dot = dot + a * a;
+        }
+        V::store(out + i, sqrt(dot));
+    }
+}
+
+template<class V> void normalizeKernel(const CpuKernelArgs& args)
+{
+    using Float = typename V::Float;
+    const size_t size = args.outputSizes[0];
+    for (size_t i = 0; i < args.count; i += V::WIDTH)
+    {
+        Float dot(0.0f);
+        for (size_t c = 0; c < size; c++)
+        {
+            const Float a = V::load(args.input(0, c) + i);
+            dot = dot + a * a;
+        }
+        const Float scale = Float(1.0f) / sqrt(dot);
+        for (size_t c = 0; c < size; c++)
+        {
+            V::store(args.output(0, c) + i, V::load(args.input(0, c) + i) * scale);
+        }
+    }
+}
+
+template<class V> void crossproductKernel(const CpuKernelArgs& args)
+{
+    using Float = typename V::Float;
+    for (size_t i = 0; i < args.count; i += V::WIDTH)
+    {
+        const Float ax = V::load(args.input(0, 0) + i);
+        const Float ay = V::load(args.input(0, 1) + i);
+        const Float az = V::load(args.input(0, 2) + i);
+        const Float bx = V::load(args.input(1, 0) + i);
+        const Float by = V::load(args.input(1, 1) + i);
+        const Float bz = V::load(args.input(1, 2) + i);
+        V::store(args.output(0, 0) + i, ay * bz - az * by);
+        V::store(args.output(0, 1) + i, az * bx - ax * bz);
+        V::store(args.output(0, 2) + i, ax * by - ay * bx);
+    }
+}
+
+//
+// Conditional kernels
+//
+
+template<class V> struct GreaterOp
+{
+    using Float = typename V::Float;
+    typename V::Mask operator()(Float a, Float b) const { return a > b; }
+};
+
+template<class V> struct GreaterEqualOp
+{
+    using Float = typename V::Float;
+    typename V::Mask operator()(Float a, Float b) const { return a >= b; }
+};
+
+template<class V> struct EqualOp
+{
+    using Float = typename V::Float;
+    typename V::Mask operator()(Float a, Float b) const { return a == b; }
+};
+
+template<class V, template<class> class Op> void conditionalKernel(const CpuKernelArgs& args)
+{
+    const Op<V> compare;
+    const float* value1 = args.input(0, 0);
+    const float* value2 = args.input(1, 0);
+    for (size_t c = 0; c < args.outputSizes[0]; c++)
+    {
+        const float* in1 = args.input(2, c);
+        const float* in2 = args.input(3, c);
+        float* out = args.output(0, c);
+        for (size_t i = 0; i < args.count; i += V::WIDTH)
+        {
+            V::store(out + i, select(compare(V::load(value1 + i), V::load(value2 + i)), V::load(in1 + i), V::load(in2 + i)));
+        }
+    }
+}
+
+//
+// Compositing operations
+//
+
+template<class V> struct PlusOp
+{
+    using Float = typename V::Float;
+    Float operator()(Float fg, Float bg) const { return bg + fg; }
+};
+
+template<class V> struct MinusOp
+{
+    using Float = typename V::Float;
+    Float operator()(Float fg, Float bg) const { return bg - fg; }
+};
+
+template<class V> struct DifferenceOp
+{
+    using Float = typename V::Float;
+    Float operator()(Float fg, Float bg) const { return abs(bg - fg); }
+};
+
+template<class V> struct ScreenOp
+{
+    using Float = typename V::Float;
+    Float operator()(Float fg, Float bg) const { return (Float(1.0f) - (Float(1.0f) - fg)) * (Float(1.0f) - bg); }
+};
+
+template<class V> struct OverlayOp
+{
+    using Float = typename V::Float;
+    Float operator()(Float fg, Float bg) const
+    {
+        return select(fg < Float(0.5f), Float(2.0f) * fg * bg, Float(1.0f) - (Float(1.0f) - fg) * (Float(1.0f) - bg));
+    }
+};
+
+template<class V> struct BurnOp
+{
+    using Float = typename V::Float;
+    Float operator()(Float fg, Float bg, Float m) const
+    {
+        const Float result = m * (Float(1.0f) - (Float(1.0f) - bg) / fg) + (Float(1.0f) - m) * bg;
+        return select(abs(fg) < Float(SIMD_FLOAT_EPS), Float(0.0f), result);
+    }
+};
+
+template<class V> struct DodgeOp
+{
+    using Float = typename V::Float;
+    Float operator()(Float fg, Float bg, Float m) const
+    {
+        const Float result = m * (bg / (Float(1.0f) - fg)) + (Float(1.0f) - m) * bg;
+        return select(abs(Float(1.0f) - fg) < Float(SIMD_FLOAT_EPS), Float(0.0f), result);
+    }
+};
+
+template<class V> struct InsideOp
+{
+    using Float = typename V::Float;
+    Float operator()(Float a, Float mask) const { return a * mask; }
+};
+
+template<class V> struct OutsideOp
+{
+    using Float = typename V::Float;
+    Float operator()(Float a, Float mask) const { return a * (Float(1.0f) - mask); }
+};
+
+// Apply an operation of the fg and bg colors and alphas to each component,
+// weighted by the mix input.
+template<class V, template<class> class Op> void alphaCompositeKernel(const CpuKernelArgs& args)
+{
+    using Float = typename V::Float;
+    const Op<V> op;
+    const float* fgAlpha = args.input(0, 3);
+    const float* bgAlpha = args.input(1, 3);
+    const float* m = args.input(2, 0);
+    for (size_t c = 0; c < 4; c++)
+    {
+        const float* fg = args.input(0, c);
+        const float* bg = args.input(1, c);
+        float* out = args.output(0, c);
+        for (size_t i = 0; i < args.count; i += V::WIDTH)
+        {
+            const Float vbg = V::load(bg + i);
+            const Float vm = V::load(m + i);
+            const Float value = op(V::load(fg + i), vbg, V::load(fgAlpha + i), V::load(bgAlpha + i), c);
+            V::store(out + i, vm * value + (Float(1.0f) - vm) * vbg);
+        }
+    }
+}
+
+template<class V> struct OverOp
+{
+    using Float = typename V::Float;
+    Float operator()(Float fg, Float bg, Float fa, Float, size_t) const { return fg + bg * (Float(1.0f) - fa); }
+};
+
+template<class V> struct InOp
+{
+    using Float = typename V::Float;
+    Float operator()(Float fg, Float, Float, Float ba, size_t) const { return fg * ba; }
+};
+
+template<class V> struct OutOp
+{
+    using Float = typename V::Float;
+    Float operator()(Float fg, Float, Float, Float ba, size_t) const { return fg * (Float(1.0f) - ba); }
+};
+
+template<class V> struct MaskOp
+{
+    using Float = typename V::Float;
+    Float operator()(Float, Float bg, Float fa, Float, size_t) const { return bg * fa; }
+};
+
+template<class V> struct MatteOp
+{
+    using Float = typename V::Float;
+    Float operator()(Float fg, Float bg, Float fa, Float ba, size_t c) const
+    {
+        return c < 3 ? fg * fa + bg * (Float(1.0f) - fa) : fa + ba * (Float(1.0f) - fa);
+    }
+};
+
+template<class V> struct DisjointoverOp
+{
+    using Float = typename V::Float;
+    Float operator()(Float fg, Float bg, Float fa, Float ba, size_t c) const
+    {
+        const Float summedAlpha = fa + ba;
+        if (c == 3)
+        {
+            return min(summedAlpha, Float(1.0f));
+        }
+        const Float result = select(abs(ba) < Float(SIMD_FLOAT_EPS), Float(0.0f), fg + bg * (Float(1.0f) - fa) / ba);
+        return select(summedAlpha <= Float(1.0f), fg + bg, result);
+    }
+};
+
+template<class V> struct PremultOp
+{
+    using Float = typename V::Float;
+    Float operator()(Float a, Float alpha) const { return a * alpha; }
+};
+
+template<class V> struct UnpremultOp
+{
+    using Float = typename V::Float;
+    Float operator()(Float a, Float alpha) const { return a / alpha; }
+};
+
+template<class V, template<class> class Op> void alphaKernel(const CpuKernelArgs& args)
+{
+    const Op<V> op;
+    const float* alpha = args.input(0, 3);
+    for (size_t c = 0; c < 3; c++)
+    {
+        const float* in = args.input(0, c);
+        float* out = args.output(0, c);
+        for (size_t i = 0; i < args.count; i += V::WIDTH)
+        {
+            V::store(out + i, op(V::load(in + i), V::load(alpha + i)));
+        }
+    }
+    copyAlpha(args);
+}
+
+//
+// Color kernels
+//
+
+template<class V> void luminanceKernel(const CpuKernelArgs& args)
+{
+    float* out = args.output(0, 0);
+    for (size_t i = 0; i < args.count; i += V::WIDTH)
+    {
+        V::store(out + i, V::load(args.input(0, 0) + i) * V::load(args.input(1, 0) + i) +
+                          V::load(args.input(0, 1) + i) * V::load(args.input(1, 1) + i) +
+                          V::load(args.input(0, 2) + i) * V::load(args.input(1, 2) + i));
+    }
+    for (size_t c = 1; c < 3; c++)
+    {
+        std::copy(out, out + args.count, args.output(0, c));
+    }
+    copyAlpha(args);
+}
+
+template<class V> void hsvtorgbKernel(const CpuKernelArgs& args)
+{
+    using Float = typename V::Float;
+    using Int = typename V::Int;
+    const Float one(1.0f);
+    for (size_t i = 0; i < args.count; i += V::WIDTH)
+    {
+        Float h = V::load(args.input(0, 0) + i);
+        const Float s = V::load(args.input(0, 1) + i);
+        const Float v = V::load(args.input(0, 2) + i);
+        h = Float(6.0f) * (h - floor(h));
+        const Int hi = truncate(h);
+        const Float f = h - toFloat(hi);
+        const Float p = v * (one - s);
+        const Float q = v * (one - s * f);
+        const Float t = v * (one - s * (one - f));
+
+        // Select the components of each sextant of the hue circle.
+        const typename V::Mask hi0 = hi == Int(0);
+        const typename V::Mask hi1 = hi == Int(1);
+        const typename V::Mask hi2 = hi == Int(2);
+        const typename V::Mask hi3 = hi == Int(3);
+        const typename V::Mask hi4 = hi == Int(4);
+        const Float r = select(hi0, v, select(hi1, q, select(hi2, p, select(hi3, p, select(hi4, t, v)))));
+        const Float g = select(hi0, t, select(hi1, v, select(hi2, v, select(hi3, q, p))));
+        const Float b = select(hi0, p, select(hi1, p, select(hi2, t, select(hi3, v, select(hi4, v, q)))));
+
+        const typename V::Mask gray = s < Float(0.0001f);
+        V::store(args.output(0, 0) + i, select(gray, v, r));
+        V::store(args.output(0, 1) + i, select(gray, v, g));
+        V::store(args.output(0, 2) + i, select(gray, v, b));
+    }
+    copyAlpha(args);
+}
+
+template<class V> void rgbtohsvKernel(const CpuKernelArgs& args)
+{
+    using Float = typename V::Float;
+    const Float zero(0.0f);
+    for (size_t i = 0; i < args.count; i += V::WIDTH)
+    {
+        const Float r = V::load(args.input(0, 0) + i);
+        const Float g = V::load(args.input(0, 1) + i);
+        const Float b = V::load(args.input(0, 2) + i);
+        const Float mincomp = min(r, min(g, b));
+        const Float maxcomp = max(r, max(g, b));
+        const Float delta = maxcomp - mincomp;
+        const Float s = select(maxcomp > zero, delta / maxcomp, zero);
+        Float h = select(r >= maxcomp, (g - b) / delta,
+                  select(g >= maxcomp, Float(2.0f) + (b - r) / delta,
+                                       Float(4.0f) + (r - g) / delta));
+        h = h * Float(1.0f / 6.0f);
+        h = select(h < zero, h + Float(1.0f), h);
+        V::store(args.output(0, 0) + i, select(s > zero, h, zero));
+        V::store(args.output(0, 1) + i, s);
+        V::store(args.output(0, 2) + i, maxcomp);
+    }
+    copyAlpha(args);
+}
+
+//
+// Texture kernels
+//
+
+// Return the remainder of x modulo a positive size, in [0, size).
+template<class V> typename V::Int moduloInt(typename V::Int x, int size)
+{
+    using Int = typename V::Int;
+    const Int vsize(size);
+
+    // Estimate the quotient in floating point, and correct its rounding.
+    const Int quotient = truncate(floor(toFloat(x) / typename V::Float((float) size)));
+    Int m = x - quotient * vsize;
+    m = select(m < Int(0), m + vsize, m);
+    m = select(m < vsize, m, m - vsize);
+    return min(max(m, Int(0)), Int(size - 1));
+}
+
+// Return the texel indices for the given address mode, and set the valid
+// mask to exclude texels outside of a constant border.
+template<class V> typename V::Int wrapTexel(typename V::Int x, int size, ImageSamplingProperties::AddressMode mode, typename V::Mask& valid)
+{
+    using Int = typename V::Int;
+    valid = x == x;
+    switch (mode)
+    {
+        case ImageSamplingProperties::AddressMode::CONSTANT:
+            valid = (Int(-1) < x) & (x < Int(size));
+            return min(max(x, Int(0)), Int(size - 1));
+        case ImageSamplingProperties::AddressMode::CLAMP:
+            return min(max(x, Int(0)), Int(size - 1));
+        case ImageSamplingProperties::AddressMode::MIRROR:
+        {
+            const Int m = moduloInt<V>(x, 2 * size);
+            return select(m < Int(size), m, Int(2 * size - 1) - m);
+        }
+        default:
+            return moduloInt<V>(x, size);
+    }
+}
+
+// Texture coordinates and filter weights are computed for a group of
+// samples at once, while texels are read one at a time, as images may be
+// stored in any format.
+template<class V> void imageKernel(const CpuKernelArgs& args)
+{
+    using Float = typename V::Float;
+    using Int = typename V::Int;
+    using Mask = typename V::Mask;
+
+    const CpuKernelParams& params = *args.params;
+    const size_t size = args.outputSizes[0];
+    const Image* image = params.image.get();
+    if (!image || image->getWidth() <= 1 || !image->getResourceBuffer())
+    {
+        copyInput(args, 0);
+        return;
+    }
+
+    const ImageSamplingProperties& sampling = params.samplingProperties;
+    const bool linear = sampling.filterType != ImageSamplingProperties::FilterType::CLOSEST;
+    const int width = (int) image->getWidth();
+    const int height = (int) image->getHeight();
+    const bool transform = args.inputs[2] && args.inputs[3];
+    const int taps = linear ? 2 : 1;
+    const Float one(1.0f);
+    const Float zero(0.0f);
+
+    int32_t rows[V::WIDTH];
+    int32_t cols[V::WIDTH];
+    int32_t valids[V::WIDTH];
+    float weights[V::WIDTH];
+    float texels[4][V::WIDTH];
+    for (size_t i = 0; i < args.count; i += V::WIDTH)
+    {
+        Float s = V::load(args.input(1, 0) + i);
+        Float t = V::load(args.input(1, 1) + i);
+        if (transform)
+        {
+            s = s * V::load(args.input(2, 0) + i) + V::load(args.input(3, 0) + i);
+            t = t * V::load(args.input(2, 1) + i) + V::load(args.input(3, 1) + i);
+        }
+        if (params.verticalFlip)
+        {
+            t = one - t;
+        }
+
+        const Float x = s * Float((float) width) - Float(linear ? 0.5f : 0.0f);
+        const Float y = t * Float((float) height) - Float(linear ? 0.5f : 0.0f);
+        const Int x0 = truncate(floor(x));
+        const Int y0 = truncate(floor(y));
+        const Float fx = linear ? x - toFloat(x0) : zero;
+        const Float fy = linear ? y - toFloat(y0) : zero;
+        Float result[4] = { zero, zero, zero, zero };
+        for (int ty = 0; ty < taps; ty++)
+        {
+            Mask rowValid;
+            const Int row = wrapTexel<V>(y0 + Int(ty), height, sampling.vaddressMode, rowValid);
+            const Float wy = ty ? fy : one - fy;
+            for (int tx = 0; tx < taps; tx++)
+            {
+                Mask colValid;
+                const Int col = wrapTexel<V>(x0 + Int(tx), width, sampling.uaddressMode, colValid);
+                const Float weight = wy * (tx ? fx : one - fx);
+                V::store(rows, row);
+                V::store(cols, col);
+                V::store(valids, select(rowValid & colValid, Int(1), Int(0)));
+                V::store(weights, weight);
+
+                // Read the texels of the group, using the default value
+                // outside of a constant border, and zero for lanes with no
+                // weight.
+                for (size_t j = 0; j < V::WIDTH; j++)
+                {
+                    if (weights[j] == 0.0f)
+                    {
+                        for (size_t c = 0; c < 4; c++)
+                        {
+                            texels[c][j] = 0.0f;
+                        }
+                        continue;
+                    }
+                    Color4 texel;
+                    if (!valids[j])
+                    {
+                        for (size_t c = 0; c < 4; c++)
+                        {
+                            texel[c] = c < size ? args.input(0, c)[i + j] : 1.0f;
+                        }
+                    }
+                    else
+                    {
+                        texel = image->getTexelColor((unsigned int) cols[j], (unsigned int) rows[j]);
+                    }
+                    for (size_t c = 0; c < 4; c++)
+                    {
+                        texels[c][j] = texel[c];
+                    }
+                }
+
+                for (size_t c = 0; c < size; c++)
+                {
+                    result[c] = result[c] + weight * V::load(texels[c]);
+                }
+            }
+        }
+        for (size_t c = 0; c < size; c++)
+        {
+            V::store(args.output(0, c) + i, result[c]);
+        }
+    }
+}
+
+//
+// Noise kernels, following the scalar kernels with lanes of 32-bit
+// unsigned integers.
+//
+
+template<class V> typename V::Int rotl32(typename V::Int x, int k)
+{
+    return shiftLeft(x, k) | shiftRight(x, 32 - k);
+}
+
+template<class V> typename V::Int bjfinal(typename V::Int a, typename V::Int b, typename V::Int c)
+{
+    c = (c ^ b) - rotl32<V>(b, 14);
+    a = (a ^ c) - rotl32<V>(c, 11);
+    b = (b ^ a) - rotl32<V>(a, 25);
+    c = (c ^ b) - rotl32<V>(b, 16);
+    a = (a ^ c) - rotl32<V>(c, 4);
+    b = (b ^ a) - rotl32<V>(a, 14);
+    c = (c ^ b) - rotl32<V>(b, 24);
+    return c;
+}
+
+template<class V> typename V::Int hashInt(typename V::Int x, typename V::Int y)
+{
+    const typename V::Int seed((int) (0xdeadbeefu + (2u << 2u) + 13u));
+    return bjfinal<V>(seed + x, seed + y, seed);
+}
+
+template<class V> typename V::Int hashInt(typename V::Int x, typename V::Int y, typename V::Int z)
+{
+    const typename V::Int seed((int) (0xdeadbeefu + (3u << 2u) + 13u));
+    return bjfinal<V>(seed + x, seed + y, seed + z);
+}
+
+template<class V> typename V::Int floorInt(typename V::Float x)
+{
+    const typename V::Int i = truncate(x);
+    return select(x < typename V::Float(0.0f), i - typename V::Int(1), i);
+}
+
+template<class V> typename V::Float fade(typename V::Float t)
+{
+    using Float = typename V::Float;
+    return t * t * t * (t * (t * Float(6.0f) - Float(15.0f)) + Float(10.0f));
+}
+
+template<class V> typename V::Float bitsTo01(typename V::Int bits)
+{
+    return unsignedToFloat(bits) / typename V::Float((float) 0xffffffffu);
+}
+
+template<class V> typename V::Float gradient(typename V::Int hash, typename V::Float x, typename V::Float y)
+{
+    using Int = typename V::Int;
+    const Int h = hash & Int(7);
+    const typename V::Mask low = h < Int(4);
+    const typename V::Float u = select(low, x, y);
+    const typename V::Float v = typename V::Float(2.0f) * select(low, y, x);
+    return select((h & Int(1)) == Int(1), -u, u) + select((h & Int(2)) == Int(2), -v, v);
+}
+
+template<class V> typename V::Float gradient(typename V::Int hash, typename V::Float x, typename V::Float y, typename V::Float z)
+{
+    using Int = typename V::Int;
+    const Int h = hash & Int(15);
+    const typename V::Float u = select(h < Int(8), x, y);
+    const typename V::Float v = select(h < Int(4), y, select((h == Int(12)) | (h == Int(14)), x, z));
+    return select((h & Int(1)) == Int(1), -u, u) + select((h & Int(2)) == Int(2), -v, v);
+}
+
+template<class V> typename V::Float bilerp(typename V::Float v0, typename V::Float v1, typename V::Float v2, typename V::Float v3,
+                                           typename V::Float s, typename V::Float t)
+{
+    using Float = typename V::Float;
+    const Float s1 = Float(1.0f) - s;
+    return (Float(1.0f) - t) * (v0 * s1 + v1 * s) + t * (v2 * s1 + v3 * s);
+}
+
+template<class V> typename V::Float trilerp(const typename V::Float* v, typename V::Float s, typename V::Float t, typename V::Float r)
+{
+    using Float = typename V::Float;
+    const Float s1 = Float(1.0f) - s;
+    const Float t1 = Float(1.0f) - t;
+    const Float r1 = Float(1.0f) - r;
+    return (r1 * (t1 * (v[0] * s1 + v[1] * s) + t * (v[2] * s1 + v[3] * s)) +
+            r * (t1 * (v[4] * s1 + v[5] * s) + t * (v[6] * s1 + v[7] * s)));
+}
+
+// Return a byte of the hash for the given channel, or the full hash for a
+// scalar noise.
+template<class V> typename V::Int channelHash(typename V::Int hash, int channel)
+{
+    return channel < 0 ? hash : shiftRight(hash, 8 * channel) & typename V::Int(0xFF);
+}
+
+template<class V> typename V::Float perlinNoise(typename V::Float px, typename V::Float py, int channel)
+{
+    using Float = typename V::Float;
+    using Int = typename V::Int;
+    const Int X = floorInt<V>(px);
+    const Int Y = floorInt<V>(py);
+    const Float fx = px - toFloat(X);
+    const Float fy = py - toFloat(Y);
+    const Float one(1.0f);
+    const Float result = bilerp<V>(
+        gradient<V>(channelHash<V>(hashInt<V>(X, Y), channel), fx, fy),
+        gradient<V>(channelHash<V>(hashInt<V>(X + Int(1), Y), channel), fx - one, fy),
+        gradient<V>(channelHash<V>(hashInt<V>(X, Y + Int(1)), channel), fx, fy - one),
+        gradient<V>(channelHash<V>(hashInt<V>(X + Int(1), Y + Int(1)), channel), fx - one, fy - one),
+        fade<V>(fx), fade<V>(fy));
+    return Float(0.6616f) * result;
+}
+
+template<class V> typename V::Float perlinNoise(typename V::Float px, typename V::Float py, typename V::Float pz, int channel)
+{
+    using Float = typename V::Float;
+    using Int = typename V::Int;
+    const Int X = floorInt<V>(px);
+    const Int Y = floorInt<V>(py);
+    const Int Z = floorInt<V>(pz);
+    const Float fx = px - toFloat(X);
+    const Float fy = py - toFloat(Y);
+    const Float fz = pz - toFloat(Z);
+    Float corners[8];
+    for (int k = 0; k < 8; k++)
+    {
+        const int dx = k & 1;
+        const int dy = (k >> 1) & 1;
+        const int dz = (k >> 2) & 1;
+        corners[k] = gradient<V>(channelHash<V>(hashInt<V>(X + Int(dx), Y + Int(dy), Z + Int(dz)), channel),
+                                 fx - Float((float) dx), fy - Float((float) dy), fz - Float((float) dz));
+    }
+    return Float(0.9820f) * trilerp<V>(corners, fade<V>(fx), fade<V>(fy), fade<V>(fz));
+}
+
+// Lanes may request different numbers of octaves, so octaves are summed up
+// to the largest count of the group, and masked in each lane.
+template<class V> typename V::Float fractalNoise(typename V::Float px, typename V::Float py, typename V::Float pz, typename V::Int octaves,
+                                                 typename V::Float lacunarity, typename V::Float diminish, int channel)
+{
+    using Float = typename V::Float;
+    using Int = typename V::Int;
+    int32_t counts[V::WIDTH];
+    V::store(counts, octaves);
+    const int maxOctaves = *std::max_element(counts, counts + V::WIDTH);
+
+    Float result(0.0f);
+    Float amplitude(1.0f);
+    for (int i = 0; i < maxOctaves; i++)
+    {
+        result = select(Int(i) < octaves, result + amplitude * perlinNoise<V>(px, py, pz, channel), result);
+        amplitude = amplitude * diminish;
+        px = px * lacunarity;
+        py = py * lacunarity;
+        pz = pz * lacunarity;
+    }
+    return result;
+}
+
+// Vector noise uses one byte of the hash per channel, and a fourth channel
+// is a scalar noise at an offset position.
+template<class V> void noise2dKernel(const CpuKernelArgs& args)
+{
+    using Float = typename V::Float;
+    const size_t size = args.outputSizes[0];
+    const float* x = args.input(2, 0);
+    const float* y = args.input(2, 1);
+    for (size_t c = 0; c < size; c++)
+    {
+        const float* amplitude = args.input(0, c);
+        const float* pivot = args.input(1, 0);
+        float* out = args.output(0, c);
+        for (size_t i = 0; i < args.count; i += V::WIDTH)
+        {
+            const Float vx = V::load(x + i);
+            const Float vy = V::load(y + i);
+            Float value;
+            if (size == 1)
+                value = perlinNoise<V>(vx, vy, -1);
+            else if (c < 3)
+                value = perlinNoise<V>(vx, vy, (int) c);
+            else
+                value = perlinNoise<V>(vx + Float(19.0f), vy + Float(73.0f), -1);
+            V::store(out + i, value * V::load(amplitude + i) + V::load(pivot + i));
+        }
+    }
+}
+
+template<class V> void noise3dKernel(const CpuKernelArgs& args)
+{
+    using Float = typename V::Float;
+    const size_t size = args.outputSizes[0];
+    const float* x = args.input(2, 0);
+    const float* y = args.input(2, 1);
+    const float* z = args.input(2, 2);
+    for (size_t c = 0; c < size; c++)
+    {
+        const float* amplitude = args.input(0, c);
+        const float* pivot = args.input(1, 0);
+        float* out = args.output(0, c);
+        for (size_t i = 0; i < args.count; i += V::WIDTH)
+        {
+            const Float vx = V::load(x + i);
+            const Float vy = V::load(y + i);
+            const Float vz = V::load(z + i);
+            Float value;
+            if (size == 1)
+                value = perlinNoise<V>(vx, vy, vz, -1);
+            else if (c < 3)
+                value = perlinNoise<V>(vx, vy, vz, (int) c);
+            else
+                value = perlinNoise<V>(vx + Float(19.0f), vy + Float(73.0f), vz + Float(29.0f), -1);
+            V::store(out + i, value * V::load(amplitude + i) + V::load(pivot + i));
+        }
+    }
+}
+
+template<class V> void fractal3dKernel(const CpuKernelArgs& args)
+{
+    using Float = typename V::Float;
+    const size_t size = args.outputSizes[0];
+    const float* octaves = args.input(1, 0);
+    const float* lacunarity = args.input(2, 0);
+    const float* diminish = args.input(3, 0);
+    const float* x = args.input(4, 0);
+    const float* y = args.input(4, 1);
+    const float* z = args.input(4, 2);
+    for (size_t c = 0; c < size; c++)
+    {
+        const float* amplitude = args.input(0, c);
+        float* out = args.output(0, c);
+        for (size_t i = 0; i < args.count; i += V::WIDTH)
+        {
+            const typename V::Int oct = truncate(V::load(octaves + i));
+            const Float lac = V::load(lacunarity + i);
+            const Float dim = V::load(diminish + i);
+            const Float vx = V::load(x + i);
+            const Float vy = V::load(y + i);
+            const Float vz = V::load(z + i);
+            Float value;
+            if (size == 1)
+                value = fractalNoise<V>(vx, vy, vz, oct, lac, dim, -1);
+            else if (c < 3)
+                value = fractalNoise<V>(vx, vy, vz, oct, lac, dim, (int) c);
+            else
+                value = fractalNoise<V>(vx + Float(19.0f), vy + Float(193.0f), vz + Float(17.0f), oct, lac, dim, -1);
+            V::store(out + i, value * V::load(amplitude + i));
+        }
+    }
+}
+
+template<class V> void cellnoise2dKernel(const CpuKernelArgs& args)
+{
+    const float* x = args.input(0, 0);
+    const float* y = args.input(0, 1);
+    float* out = args.output(0, 0);
+    for (size_t i = 0; i < args.count; i += V::WIDTH)
+    {
+        V::store(out + i, bitsTo01<V>(hashInt<V>(floorInt<V>(V::load(x + i)), floorInt<V>(V::load(y + i)))));
+    }
+}
+
+template<class V> void cellnoise3dKernel(const CpuKernelArgs& args)
+{
+    const float* x = args.input(0, 0);
+    const float* y = args.input(0, 1);
+    const float* z = args.input(0, 2);
+    float* out = args.output(0, 0);
+    for (size_t i = 0; i < args.count; i += V::WIDTH)
+    {
+        V::store(out + i, bitsTo01<V>(hashInt<V>(floorInt<V>(V::load(x + i)), floorInt<V>(V::load(y + i)), floorInt<V>(V::load(z + i)))));
+    }
+}
+
+// Return the vectorized kernels for the instruction set V, by category.
+template<class V> std::unordered_map<string, CpuKernel> createSimdKernels()
+{
+    std::unordered_map<string, CpuKernel> kernels;
+
+    // Math
+    kernels["add"] = binaryKernel<V, AddOp>;
+    kernels["subtract"] = binaryKernel<V, SubtractOp>;
+    kernels["multiply"] = binaryKernel<V, MultiplyOp>;
+    kernels["divide"] = binaryKernel<V, DivideOp>;
+    kernels["modulo"] = binaryKernel<V, ModuloOp>;
+    kernels["invert"] = binaryKernel<V, InvertOp>;
+    kernels["min"] = binaryKernel<V, MinOp>;
+    kernels["max"] = binaryKernel<V, MaxOp>;
+    kernels["absval"] = unaryKernel<V, AbsvalOp>;
+    kernels["floor"] = unaryKernel<V, FloorOp>;
+    kernels["ceil"] = unaryKernel<V, CeilOp>;
+    kernels["sqrt"] = unaryKernel<V, SqrtOp>;
+    kernels["sign"] = unaryKernel<V, SignOp>;
+    kernels["clamp"] = ternaryKernel<V, ClampOp>;
+    kernels["mix"] = ternaryKernel<V, MixOp>;
+    kernels["smoothstep"] = ternaryKernel<V, SmoothstepOp>;
+    kernels["remap"] = remapKernel<V>;
+
+    // Geometric
+    kernels["dotproduct"] = dotproductKernel<V>;
+    kernels["magnitude"] = magnitudeKernel<V>;
+    kernels["normalize"] = normalizeKernel<V>;
+    kernels["crossproduct"] = crossproductKernel<V>;
+
+    // Conditional
+    kernels["ifgreater"] = conditionalKernel<V, GreaterOp>;
+    kernels["ifgreatereq"] = conditionalKernel<V, GreaterEqualOp>;
+    kernels["ifequal"] = conditionalKernel<V, EqualOp>;
+
+    // Compositing
+    kernels["plus"] = blendKernel<V, PlusOp>;
+    kernels["minus"] = blendKernel<V, MinusOp>;
+    kernels["difference"] = blendKernel<V, DifferenceOp>;
+    kernels["screen"] = blendKernel<V, ScreenOp>;
+    kernels["overlay"] = blendKernel<V, OverlayOp>;
+    kernels["burn"] = ternaryKernel<V, BurnOp>;
+    kernels["dodge"] = ternaryKernel<V, DodgeOp>;
+    kernels["inside"] = binaryKernel<V, InsideOp>;
+    kernels["outside"] = binaryKernel<V, OutsideOp>;
+    kernels["over"] = alphaCompositeKernel<V, OverOp>;
+    kernels["in"] = alphaCompositeKernel<V, InOp>;
+    kernels["out"] = alphaCompositeKernel<V, OutOp>;
+    kernels["mask"] = alphaCompositeKernel<V, MaskOp>;
+    kernels["matte"] = alphaCompositeKernel<V, MatteOp>;
+    kernels["disjointover"] = alphaCompositeKernel<V, DisjointoverOp>;
+    kernels["premult"] = alphaKernel<V, PremultOp>;
+    kernels["unpremult"] = alphaKernel<V, UnpremultOp>;
+
+    // Color
+    kernels["luminance"] = luminanceKernel<V>;
+    kernels["rgbtohsv"] = rgbtohsvKernel<V>;
+    kernels["hsvtorgb"] = hsvtorgbKernel<V>;
+
+    // Texture
+    kernels["image"] = imageKernel<V>;
+
+    // Procedural
+    kernels["noise2d"] = noise2dKernel<V>;
+    kernels["noise3d"] = noise3dKernel<V>;
+    kernels["fractal3d"] = fractal3dKernel<V>;
+    kernels["cellnoise2d"] = cellnoise2dKernel<V>;
+    kernels["cellnoise3d"] = cellnoise3dKernel<V>;
+
+    return kernels;
+}
+
+} // anonymous namespace
+
+} // namespace MaterialX
+
+#endif
@@ -0,0 +1,90 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <MaterialXRender/CpuTextureBaker.h>
+
+#include <MaterialXRender/OiioImageLoader.h>
+#include <MaterialXRender/StbImageLoader.h>
+
+#include <ostream>
+
+namespace MaterialX
+{
+
+CpuTextureBaker::CpuTextureBaker(unsigned int width, unsigned int height, Image::BaseType baseType) :
+    TextureBakerBase(baseType),
+    _width(width),
+    _height(height),
+    _threadCount(0),
+    _tileSize(CpuBakeScheduler::DEFAULT_TILE_SIZE),
+    _memoryBudget(0)
+{
+    // Initialize our image handler.
+    _imageHandler = ImageHandler::create(StbImageLoader::create());
+#if MATERIALX_BUILD_OIIO
+    _imageHandler->addLoader(OiioImageLoader::create());
+#endif
+}
+
+void CpuTextureBaker::bakeGraphOutputs(const BakedOutputVec& outputs, GenContext& context)
+{
+    if (outputs.empty())
+    {
+        return;
+    }
+
+    // Compile each output and add it to a shared schedule.  Images that are
+    // averaged to constants are not written to disk.
+    CpuBakeSchedulerPtr scheduler = CpuBakeScheduler::create(_width, _height, _textureBaseType);
+    for (const auto& pair : outputs)
+    {
+        CpuEvaluatorPtr evaluator = CpuEvaluator::create();
+        evaluator->setImageHandler(_imageHandler);
+        evaluator->compile(pair.first, context);
+        scheduler->addImage(evaluator, isSrgbEncoded(pair.first), _averageImages ? FilePath() : pair.second);
+    }
+
+    // Evaluate and write the scheduled images.
+    scheduler->setThreadCount(_threadCount);
+    scheduler->setTileSize(_tileSize);
+    scheduler->setMemoryBudget(_memoryBudget);
+    scheduler->setImageHandler(_imageHandler);
+    scheduler->setProgressCallback(_progressCallback);
+    scheduler->setTileCallback(_tileCallback);
+    scheduler->run();
+
+    // Construct baked image records.
+    for (size_t i = 0; i < outputs.size(); i++)
+    {
+        const CpuBakedImage& result = scheduler->getBakedImage(i);
+        BakedImage baked;
+        baked.filename = outputs[i].second;
+        if (_averageImages)
+        {
+            baked.uniformColor = result.averageColor;
+            baked.isUniform = true;
+        }
+        else if (result.isUniform)
+        {
+            baked.uniformColor = result.uniformColor;
+            baked.isUniform = true;
+        }
+        else if (_outputStream)
+        {
+            // Non-uniform images have been written to disk by the scheduler.
+            if (result.filename.isEmpty())
+            {
+                *_outputStream << "Failed to write baked image: " << baked.filename.asString() << std::endl;
+            }
+            else
+            {
+                *_outputStream << "Wrote baked image: " << baked.filename.asString() << std::endl;
+            }
+        }
+        _bakedImageMap[outputs[i].first].push_back(baked);
+    }
+}
+
+} // namespace MaterialX
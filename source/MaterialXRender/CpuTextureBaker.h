@@ -0,0 +1,157 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_CPUTEXTUREBAKER_H
+#define MATERIALX_CPUTEXTUREBAKER_H
+
+/// @file
+/// Texture baking on the CPU
+
+#include <MaterialXRender/CpuBakeScheduler.h>
+#include <MaterialXRender/TextureBakerBase.h>
+
+namespace MaterialX
+{
+
+/// A shared pointer to a CpuTextureBaker
+using CpuTextureBakerPtr = shared_ptr<class CpuTextureBaker>;
+
+/// @class CpuTextureBaker
+/// A helper class for baking procedural material content to textures on the
+/// CPU, without a graphics context.
+///
+/// Graph outputs are evaluated by a CpuEvaluator at the texel centers of the
+/// baked image.  The outputs of each shader are baked together by a
+/// CpuBakeScheduler, whose tiles are distributed across threads and streamed
+/// to disk within a memory budget.  Positions are taken from the
+/// texture-space quad in [-1, 1], and unit conversions are not applied.
+class MX_RENDER_API CpuTextureBaker : public TextureBakerBase
+{
+  public:
+    virtual ~CpuTextureBaker() { }
+
+    static CpuTextureBakerPtr create(unsigned int width = 1024, unsigned int height = 1024, Image::BaseType baseType = Image::BaseType::UINT8)
+    {
+        return CpuTextureBakerPtr(new CpuTextureBaker(width, height, baseType));
+    }
+
+    /// Set the shader generator whose node implementations are evaluated when
+    /// baking documents.  It must be set before calling createBakeDocuments
+    /// or bakeAllMaterials, and its target libraries must be loaded in the
+    /// baked documents.
+    void setShaderGenerator(ShaderGeneratorPtr generator)
+    {
+        _generator = generator;
+    }
+
+    /// Return the shader generator used to bake documents.
+    ShaderGeneratorPtr getShaderGenerator() const
+    {
+        return _generator;
+    }
+
+    /// Set the image handler used to load images and write baked images.
+    void setImageHandler(ImageHandlerPtr imageHandler)
+    {
+        _imageHandler = imageHandler;
+    }
+
+    /// Return the image handler.
+    ImageHandlerPtr getImageHandler() const
+    {
+        return _imageHandler;
+    }
+
+    /// Set the number of threads evaluating the tiles of baked images.
+    /// Defaults to zero, which uses one thread per hardware thread.
+    void setThreadCount(size_t threadCount)
+    {
+        _threadCount = threadCount;
+    }
+
+    /// Return the number of threads evaluating the tiles of baked images.
+    size_t getThreadCount() const
+    {
+        return _threadCount;
+    }
+
+    /// Set the width and height in texels of the tiles of baked images.
+    /// Defaults to CpuBakeScheduler::DEFAULT_TILE_SIZE.
+    void setTileSize(unsigned int tileSize)
+    {
+        _tileSize = tileSize;
+    }
+
+    /// Return the width and height in texels of the tiles of baked images.
+    unsigned int getTileSize() const
+    {
+        return _tileSize;
+    }
+
+    /// Set the budget in bytes for tiles in flight while baking the outputs
+    /// of a shader.  Defaults to zero, which places no limit beyond the
+    /// number of threads.
+    void setMemoryBudget(size_t memoryBudget)
+    {
+        _memoryBudget = memoryBudget;
+    }
+
+    /// Return the budget in bytes for tiles in flight.
+    size_t getMemoryBudget() const
+    {
+        return _memoryBudget;
+    }
+
+    /// Set a function to be called as the tiles of the outputs of each
+    /// shader are completed.
+    void setProgressCallback(CpuBakeProgressCallback callback)
+    {
+        _progressCallback = callback;
+    }
+
+    /// Return the function called as tiles are completed.
+    CpuBakeProgressCallback getProgressCallback() const
+    {
+        return _progressCallback;
+    }
+
+    /// Set a function to be called with each completed tile, whose image
+    /// index counts the outputs baked for a shader.
+    void setTileCallback(CpuBakeTileCallback callback)
+    {
+        _tileCallback = callback;
+    }
+
+    /// Return the function called with each completed tile.
+    CpuBakeTileCallback getTileCallback() const
+    {
+        return _tileCallback;
+    }
+
+  protected:
+    CpuTextureBaker(unsigned int width, unsigned int height, Image::BaseType baseType);
+
+    void bakeGraphOutputs(const BakedOutputVec& outputs, GenContext& context) override;
+
+    ImageHandlerPtr getBakeImageHandler() const override
+    {
+        return _imageHandler;
+    }
+
+  protected:
+    unsigned int _width;
+    unsigned int _height;
+    size_t _threadCount;
+    unsigned int _tileSize;
+    size_t _memoryBudget;
+    CpuBakeProgressCallback _progressCallback;
+    CpuBakeTileCallback _tileCallback;
+
+    ImageHandlerPtr _imageHandler;
+};
+
+} // namespace MaterialX
+
+#endif
@@ -8,6 +8,7 @@
 #include <MaterialXGenShader/Shader.h>
 #include <MaterialXGenShader/Util.h>
 
+#include <cstring>
 #include <iostream>
 
 namespace MaterialX
@@ -35,6 +36,74 @@ const string ImageLoader::TX_EXTENSION = "tx";
 const string ImageLoader::TXT_EXTENSION = "txt";
 const string ImageLoader::TXR_EXTENSION = "txr";
 
+namespace
+{
+
+// A writer assembling rows in a full image, which is saved by the first of
+// the given loaders that succeeds once the writer is finished.
+class AssembledImageWriter : public ImageWriter
+{
+  public:
+    AssembledImageWriter(const FilePath& filePath, const vector<ImageLoaderPtr>& loaders, ImagePtr image) :
+        _filePath(filePath),
+        _loaders(loaders),
+        _image(image),
+        _rowCount(0)
+    {
+    }
+
+    bool writeRows(ConstImagePtr rows) override
+    {
+        if (!_image || !rows || !rows->getResourceBuffer() ||
+            rows->getWidth() != _image->getWidth() ||
+            rows->getChannelCount() != _image->getChannelCount() ||
+            rows->getBaseType() != _image->getBaseType() ||
+            rows->getHeight() > _image->getHeight() - _rowCount)
+        {
+            return false;
+        }
+        std::memcpy((char*) _image->getResourceBuffer() + (size_t) _rowCount * _image->getRowStride(),
+                    rows->getResourceBuffer(), (size_t) rows->getHeight() * _image->getRowStride());
+        _rowCount += rows->getHeight();
+        return true;
+    }
+
+    bool finish() override
+    {
+        ImagePtr image = _image;
+        _image = nullptr;
+        if (!image || _rowCount != image->getHeight())
+        {
+            return false;
+        }
+        for (ImageLoaderPtr loader : _loaders)
+        {
+            bool saved = false;
+            try
+            {
+                saved = loader->saveImage(_filePath, image);
+            }
+            catch (std::exception& e)
+            {
+                std::cerr << "Exception in image I/O library: " << e.what() << std::endl;
+            }
+            if (saved)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+  private:
+    FilePath _filePath;
+    vector<ImageLoaderPtr> _loaders;
+    ImagePtr _image;
+    unsigned int _rowCount;
+};
+
+} // anonymous namespace
+
 //
 // ImageLoader methods
 //
@@ -49,6 +118,11 @@ ImagePtr ImageLoader::loadImage(const FilePath&)
     return nullptr;
 }
 
+ImageWriterPtr ImageLoader::createImageWriter(const FilePath&, unsigned int, unsigned int, unsigned int, Image::BaseType)
+{
+    return nullptr;
+}
+
 //
 // ImageHandler methods
 //
@@ -119,6 +193,42 @@ bool ImageHandler::saveImage(const FilePath& filePath,
     return false;
 }
 
+ImageWriterPtr ImageHandler::createImageWriter(const FilePath& filePath, unsigned int width, unsigned int height,
+                                               unsigned int channelCount, Image::BaseType baseType)
+{
+    FilePath foundFilePath = _searchPath.find(filePath);
+    if (foundFilePath.isEmpty() || !width || !height || !channelCount)
+    {
+        return nullptr;
+    }
+
+    const vector<ImageLoaderPtr>& loaders = _imageLoaders[foundFilePath.getExtension()];
+    if (loaders.empty())
+    {
+        return nullptr;
+    }
+    for (ImageLoaderPtr loader : loaders)
+    {
+        ImageWriterPtr writer;
+        try
+        {
+            writer = loader->createImageWriter(foundFilePath, width, height, channelCount, baseType);
+        }
+        catch (std::exception& e)
+        {
+            std::cerr << "Exception in image I/O library: " << e.what() << std::endl;
+        }
+        if (writer)
+        {
+            return writer;
+        }
+    }
+
+    ImagePtr image = Image::create(width, height, channelCount, baseType);
+    image->createResourceBuffer();
+    return std::make_shared<AssembledImageWriter>(foundFilePath, loaders, image);
+}
+
 ImagePtr ImageHandler::acquireImage(const FilePath& filePath)
 {
     // Resolve the input filepath.
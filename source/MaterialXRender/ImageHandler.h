@@ -27,6 +27,7 @@ extern MX_RENDER_API const string DEFAULT_COLOR_SUFFIX;
 
 class ImageHandler;
 class ImageLoader;
+class ImageWriter;
 class VariableBlock;
 
 /// Shared pointer to an ImageHandler
@@ -35,6 +36,9 @@ using ImageHandlerPtr = std::shared_ptr<ImageHandler>;
 /// Shared pointer to an ImageLoader
 using ImageLoaderPtr = std::shared_ptr<ImageLoader>;
 
+/// Shared pointer to an ImageWriter
+using ImageWriterPtr = std::shared_ptr<ImageWriter>;
+
 /// Map from strings to vectors of image loaders
 using ImageLoaderMap = std::unordered_map< string, std::vector<ImageLoaderPtr> >;
 
@@ -87,6 +91,29 @@ class MX_RENDER_API ImageSamplingProperties
     Color4 defaultColor = { 0.0f, 0.0f, 0.0f, 1.0f };
 };
 
+/// @class ImageWriter
+/// Abstract base class for writers that save an image to the file system as
+/// its rows arrive, from the top of the image to the bottom.  A writer that
+/// is released before the image is finished leaves no file behind.
+class MX_RENDER_API ImageWriter
+{
+  public:
+    ImageWriter()
+    {
+    }
+    virtual ~ImageWriter() { }
+
+    /// Write the next rows of the image.
+    /// @param rows An image with the width, channel count and base type of
+    ///    the written image, whose rows follow those previously written.
+    /// @return if write succeeded
+    virtual bool writeRows(ConstImagePtr rows) = 0;
+
+    /// Complete the image once all of its rows have been written.
+    /// @return if the image was saved
+    virtual bool finish() = 0;
+};
+
 /// @class ImageLoader
 /// Abstract base class for file-system image loaders
 class MX_RENDER_API ImageLoader
@@ -135,6 +162,21 @@ class MX_RENDER_API ImageLoader
     /// @return On success, a shared pointer to the loaded image; otherwise an empty shared pointer.
     virtual ImagePtr loadImage(const FilePath& filePath);
 
+    /// Create a writer that saves an image to the file system as its rows
+    /// arrive.  The default implementation returns an empty shared pointer,
+    /// indicating that the loader does not support writing images by rows.
+    /// @param filePath File path to be written
+    /// @param width Width of the image
+    /// @param height Height of the image
+    /// @param channelCount Number of channels of the image
+    /// @param baseType Base type of the image channels
+    /// @return On success, a shared pointer to the writer; otherwise an empty shared pointer.
+    virtual ImageWriterPtr createImageWriter(const FilePath& filePath,
+                                             unsigned int width,
+                                             unsigned int height,
+                                             unsigned int channelCount,
+                                             Image::BaseType baseType);
+
   protected:
     // List of supported string extensions
     StringSet _extensions;
@@ -169,6 +211,19 @@ class MX_RENDER_API ImageHandler
     /// @return if save succeeded
     bool saveImage(const FilePath& filePath, ConstImagePtr image, bool verticalFlip = false);
 
+    /// Create a writer that saves an image to disk as its rows arrive.  The
+    /// first image loader which can write the file name extension by rows
+    /// will be used.  Otherwise the rows are assembled in a full image, which
+    /// is saved as with saveImage once the writer is finished.
+    /// @param filePath File path to be written
+    /// @param width Width of the image
+    /// @param height Height of the image
+    /// @param channelCount Number of channels of the image
+    /// @param baseType Base type of the image channels
+    /// @return On success, a shared pointer to the writer; otherwise an empty shared pointer.
+    ImageWriterPtr createImageWriter(const FilePath& filePath, unsigned int width, unsigned int height,
+                                     unsigned int channelCount, Image::BaseType baseType);
+
     /// Acquire an image from the cache or file system.  If the image is not
     /// found in the cache, then each image loader will be applied in turn.
     /// @param filePath File path of the image.
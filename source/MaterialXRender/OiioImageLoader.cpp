@@ -18,36 +18,157 @@
     #pragma warning(pop)
 #endif
 
+#include <cstdio>
+
 namespace MaterialX
 {
 
-bool OiioImageLoader::saveImage(const FilePath& filePath,
-                                ConstImagePtr image,
-                                bool verticalFlip)
+namespace
 {
-    OIIO::ImageSpec imageSpec;
-    imageSpec.width = image->getWidth();
-    imageSpec.height = image->getHeight();
-    imageSpec.nchannels = image->getChannelCount();
 
-    OIIO::TypeDesc format;
-    switch (image->getBaseType())
+#if OIIO_VERSION < 10903
+using ImageOutputPtr = OIIO::ImageOutput*;
+#else
+using ImageOutputPtr = std::unique_ptr<OIIO::ImageOutput>;
+#endif
+
+// Return the OpenImageIO format of the given base type, or false if the
+// base type is not supported.
+bool getImageFormat(Image::BaseType baseType, OIIO::TypeDesc& format)
+{
+    switch (baseType)
     {
         case Image::BaseType::UINT8:
             format = OIIO::TypeDesc::UINT8;
-            break;
+            return true;
         case Image::BaseType::UINT16:
             format = OIIO::TypeDesc::UINT16;
-            break;
+            return true;
         case Image::BaseType::HALF:
             format = OIIO::TypeDesc::HALF;
-            break;
+            return true;
         case Image::BaseType::FLOAT:
             format = OIIO::TypeDesc::FLOAT;
-            break;
+            return true;
         default:
             return false;
     }
+}
+
+// A writer passing rows to an OpenImageIO image output as scanlines.  Rows
+// are written to a temporary file, which replaces the destination file once
+// the image is finished.
+class OiioImageWriter : public ImageWriter
+{
+  public:
+    OiioImageWriter(ImageOutputPtr imageOutput, const FilePath& filePath, const string& partialFilename,
+                    const OIIO::ImageSpec& imageSpec) :
+        _imageOutput(std::move(imageOutput)),
+        _filename(filePath.asString()),
+        _partialFilename(partialFilename),
+        _imageSpec(imageSpec),
+        _rowCount(0)
+    {
+    }
+
+    ~OiioImageWriter()
+    {
+        if (_imageOutput)
+        {
+            close();
+            std::remove(_partialFilename.c_str());
+        }
+    }
+
+    bool writeRows(ConstImagePtr rows) override
+    {
+        if (!_imageOutput || !rows || !rows->getResourceBuffer() ||
+            (int) rows->getWidth() != _imageSpec.width ||
+            (int) rows->getChannelCount() != _imageSpec.nchannels ||
+            rows->getBaseType() != getBaseType() ||
+            (int) rows->getHeight() > _imageSpec.height - _rowCount)
+        {
+            return false;
+        }
+        const char* data = static_cast<const char*>(rows->getResourceBuffer());
+        for (unsigned int y = 0; y < rows->getHeight(); y++, _rowCount++)
+        {
+            if (!_imageOutput->write_scanline(_rowCount, 0, _imageSpec.format, data + (size_t) y * rows->getRowStride()))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool finish() override
+    {
+        if (!_imageOutput)
+        {
+            return false;
+        }
+        bool success = _rowCount == _imageSpec.height && close();
+        if (success)
+        {
+            std::remove(_filename.c_str());
+            success = std::rename(_partialFilename.c_str(), _filename.c_str()) == 0;
+        }
+        if (!success)
+        {
+            std::remove(_partialFilename.c_str());
+        }
+        return success;
+    }
+
+  private:
+    // Close and release the image output, returning true if successful.
+    bool close()
+    {
+        const bool closed = _imageOutput->close();
+
+        // Handle deallocation in OpenImageIO 1.x
+        #if OIIO_VERSION < 10903
+        OIIO::ImageOutput::destroy(_imageOutput);
+        #endif
+        _imageOutput = nullptr;
+        return closed;
+    }
+
+    Image::BaseType getBaseType() const
+    {
+        switch (_imageSpec.format.basetype)
+        {
+            case OIIO::TypeDesc::UINT16: return Image::BaseType::UINT16;
+            case OIIO::TypeDesc::HALF: return Image::BaseType::HALF;
+            case OIIO::TypeDesc::FLOAT: return Image::BaseType::FLOAT;
+            default: return Image::BaseType::UINT8;
+        }
+    }
+
+  private:
+    ImageOutputPtr _imageOutput;
+    string _filename;
+    string _partialFilename;
+    OIIO::ImageSpec _imageSpec;
+    int _rowCount;
+};
+
+} // anonymous namespace
+
+bool OiioImageLoader::saveImage(const FilePath& filePath,
+                                ConstImagePtr image,
+                                bool verticalFlip)
+{
+    OIIO::ImageSpec imageSpec;
+    imageSpec.width = image->getWidth();
+    imageSpec.height = image->getHeight();
+    imageSpec.nchannels = image->getChannelCount();
+
+    OIIO::TypeDesc format;
+    if (!getImageFormat(image->getBaseType(), format))
+    {
+        return false;
+    }
 
     bool written = false;
     auto imageOutput = OIIO::ImageOutput::create(filePath.asString());
@@ -80,6 +201,37 @@ bool OiioImageLoader::saveImage(const FilePath& filePath,
     return written;
 }
 
+ImageWriterPtr OiioImageLoader::createImageWriter(const FilePath& filePath,
+                                                  unsigned int width,
+                                                  unsigned int height,
+                                                  unsigned int channelCount,
+                                                  Image::BaseType baseType)
+{
+    OIIO::TypeDesc format;
+    if (!getImageFormat(baseType, format))
+    {
+        return nullptr;
+    }
+
+    // The output plugin is chosen by the extension of the destination file.
+    ImageOutputPtr imageOutput = OIIO::ImageOutput::create(filePath.asString());
+    if (!imageOutput)
+    {
+        return nullptr;
+    }
+    OIIO::ImageSpec imageSpec((int) width, (int) height, (int) channelCount, format);
+    const string partialFilename = filePath.asString() + ".partial";
+    if (!imageOutput->open(partialFilename, imageSpec))
+    {
+        // Handle deallocation in OpenImageIO 1.x
+        #if OIIO_VERSION < 10903
+        OIIO::ImageOutput::destroy(imageOutput);
+        #endif
+        return nullptr;
+    }
+    return std::make_shared<OiioImageWriter>(std::move(imageOutput), filePath, partialFilename, imageSpec);
+}
+
 ImagePtr OiioImageLoader::loadImage(const FilePath& filePath)
 {
     auto imageInput = OIIO::ImageInput::open(filePath);
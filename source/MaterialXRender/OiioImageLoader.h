@@ -53,6 +53,14 @@ class MX_RENDER_API OiioImageLoader : public ImageLoader
 
     /// Load an image from the file system.
     ImagePtr loadImage(const FilePath& filePath) override;
+
+    /// Create a writer that saves an image to the file system as its rows
+    /// arrive, passing them to OpenImageIO as scanlines.
+    ImageWriterPtr createImageWriter(const FilePath& filePath,
+                                     unsigned int width,
+                                     unsigned int height,
+                                     unsigned int channelCount,
+                                     Image::BaseType baseType) override;
 };
 
 } // namespace MaterialX
@@ -24,9 +24,562 @@
     #pragma warning(pop)
 #endif
 
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
 namespace MaterialX
 {
 
+namespace
+{
+
+// A writer encoding float rows as a Radiance HDR file with the scanline
+// encoder of stb_image_write, clamping negative components, which the format
+// cannot represent, to zero.  Rows are written to a temporary file, which
+// replaces the destination file once the image is finished.
+class StbHdrImageWriter : public ImageWriter
+{
+  public:
+    StbHdrImageWriter(const FilePath& filePath, unsigned int width, unsigned int height, unsigned int channelCount) :
+        _filename(filePath.asString()),
+        _partialFilename(_filename + ".partial"),
+        _stream(_partialFilename.c_str(), std::ios::binary),
+        _width(width),
+        _height(height),
+        _channelCount(channelCount),
+        _rowCount(0),
+        _scanline(width * channelCount),
+        _scratch(width * 4)
+    {
+        stbi__start_write_callbacks(&_context, &writeToStream, &_stream);
+
+        // Write the header of stbi_write_hdr.
+        const string header = "#?RADIANCE\n# Written by stb_image_write.h\nFORMAT=32-bit_rle_rgbe\n"
+                              "EXPOSURE=          1.0000000000000\n\n-Y " + std::to_string(height) +
+                              " +X " + std::to_string(width) + "\n";
+        _stream.write(header.data(), header.size());
+    }
+
+    ~StbHdrImageWriter()
+    {
+        if (_stream.is_open())
+        {
+            _stream.close();
+            std::remove(_partialFilename.c_str());
+        }
+    }
+
+    bool writeRows(ConstImagePtr rows) override
+    {
+        if (!_stream.is_open() || !rows || !rows->getResourceBuffer() ||
+            rows->getWidth() != _width ||
+            rows->getChannelCount() != _channelCount ||
+            rows->getBaseType() != Image::BaseType::FLOAT ||
+            rows->getHeight() > _height - _rowCount)
+        {
+            return false;
+        }
+
+        const float* data = static_cast<const float*>(rows->getResourceBuffer());
+        for (unsigned int y = 0; y < rows->getHeight(); y++)
+        {
+            const float* row = data + (size_t) y * _scanline.size();
+            for (size_t i = 0; i < _scanline.size(); i++)
+            {
+                _scanline[i] = std::max(row[i], 0.0f);
+            }
+            stbiw__write_hdr_scanline(&_context, (int) _width, (int) _channelCount, _scratch.data(), _scanline.data());
+        }
+        _rowCount += rows->getHeight();
+        return !_stream.fail();
+    }
+
+    bool finish() override
+    {
+        if (!_stream.is_open())
+        {
+            return false;
+        }
+        _stream.close();
+        bool success = _rowCount == _height && !_stream.fail();
+        if (success)
+        {
+            std::remove(_filename.c_str());
+            success = std::rename(_partialFilename.c_str(), _filename.c_str()) == 0;
+        }
+        if (!success)
+        {
+            std::remove(_partialFilename.c_str());
+        }
+        return success;
+    }
+
+  private:
+    static void writeToStream(void* context, void* data, int size)
+    {
+        static_cast<std::ofstream*>(context)->write(static_cast<const char*>(data), size);
+    }
+
+  private:
+    string _filename;
+    string _partialFilename;
+    std::ofstream _stream;
+    stbi__write_context _context;
+    unsigned int _width;
+    unsigned int _height;
+    unsigned int _channelCount;
+    unsigned int _rowCount;
+    vector<float> _scanline;
+    vector<unsigned char> _scratch;
+};
+
+// A writer encoding 8-bit rows as a PNG file.  Rows are filtered and
+// compressed as they arrive, following the filter selection and the fixed
+// Huffman compressor of stbi_write_png, so that the written file matches
+// the file saved by stbi_write_png for the same image.  Only the rows within
+// the compression window of the deflate stream are retained.  Rows are
+// written to a temporary file, which replaces the destination file once the
+// image is finished.
+class StbPngImageWriter : public ImageWriter
+{
+  public:
+    StbPngImageWriter(const FilePath& filePath, unsigned int width, unsigned int height, unsigned int channelCount) :
+        _filename(filePath.asString()),
+        _partialFilename(_filename + ".partial"),
+        _stream(_partialFilename.c_str(), std::ios::binary),
+        _width(width),
+        _height(height),
+        _channelCount(channelCount),
+        _rowCount(0),
+        _rowBytes((size_t) width * channelCount),
+        _prevRow(_rowBytes),
+        _lineBuffer(_rowBytes),
+        _hashTable(stbiw__ZHASH),
+        _dataStart(0),
+        _position(0),
+        _totalBytes((size_t) height * (_rowBytes + 1)),
+        _bitBuffer(0),
+        _bitCount(0),
+        _adler1(1),
+        _adler2(0),
+        _adlerCount(0),
+        _idatOffset(0),
+        _idatLength(0),
+        _crc(0)
+    {
+        static const unsigned char SIGNATURE[] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+        static const unsigned char COLOR_TYPES[] = { 0, 0, 4, 2, 6 };
+        _stream.write((const char*) SIGNATURE, sizeof(SIGNATURE));
+
+        unsigned char header[13];
+        writeUint32(header, width);
+        writeUint32(header + 4, height);
+        header[8] = 8;
+        header[9] = COLOR_TYPES[channelCount];
+        header[10] = header[11] = header[12] = 0;
+        writeChunk("IHDR", header, sizeof(header));
+
+        // Begin the data chunk, whose length is written once it is known.
+        _idatOffset = _stream.tellp();
+        unsigned char idatHeader[8] = { 0, 0, 0, 0, 'I', 'D', 'A', 'T' };
+        _stream.write((const char*) idatHeader, sizeof(idatHeader));
+        _crc = updateCrc(0xFFFFFFFFu, idatHeader + 4, 4);
+
+        // Begin the zlib stream with a single fixed Huffman block.
+        _output.push_back(0x78);
+        _output.push_back(0x5e);
+        addBits(1, 1);
+        addBits(1, 2);
+    }
+
+    ~StbPngImageWriter()
+    {
+        if (_stream.is_open())
+        {
+            _stream.close();
+            std::remove(_partialFilename.c_str());
+        }
+    }
+
+    bool writeRows(ConstImagePtr rows) override
+    {
+        if (!_stream.is_open() || !rows || !rows->getResourceBuffer() ||
+            rows->getWidth() != _width ||
+            rows->getChannelCount() != _channelCount ||
+            rows->getBaseType() != Image::BaseType::UINT8 ||
+            rows->getHeight() > _height - _rowCount)
+        {
+            return false;
+        }
+
+        const unsigned char* data = static_cast<const unsigned char*>(rows->getResourceBuffer());
+        for (unsigned int y = 0; y < rows->getHeight(); y++)
+        {
+            const unsigned char* row = data + (size_t) y * rows->getRowStride();
+            appendFilteredRow(row);
+            std::memcpy(_prevRow.data(), row, _rowBytes);
+            _rowCount++;
+        }
+        compress(false);
+        writeOutput();
+        return !_stream.fail();
+    }
+
+    bool finish() override
+    {
+        if (!_stream.is_open())
+        {
+            return false;
+        }
+        bool success = _rowCount == _height;
+        if (success)
+        {
+            compress(true);
+            addHuffman(256);
+            while (_bitCount)
+            {
+                addBits(0, 1);
+            }
+            _adler1 %= 65521;
+            _adler2 %= 65521;
+            _output.push_back((unsigned char) (_adler2 >> 8));
+            _output.push_back((unsigned char) _adler2);
+            _output.push_back((unsigned char) (_adler1 >> 8));
+            _output.push_back((unsigned char) _adler1);
+            writeOutput();
+
+            // Complete the data chunk, and write the final chunk.
+            unsigned char crc[4];
+            writeUint32(crc, ~_crc);
+            _stream.write((const char*) crc, sizeof(crc));
+            const std::streampos endOffset = _stream.tellp();
+            unsigned char length[4];
+            writeUint32(length, _idatLength);
+            _stream.seekp(_idatOffset);
+            _stream.write((const char*) length, sizeof(length));
+            _stream.seekp(endOffset);
+            writeChunk("IEND", nullptr, 0);
+        }
+        _stream.close();
+        success = success && !_stream.fail();
+        if (success)
+        {
+            std::remove(_filename.c_str());
+            success = std::rename(_partialFilename.c_str(), _filename.c_str()) == 0;
+        }
+        if (!success)
+        {
+            std::remove(_partialFilename.c_str());
+        }
+        return success;
+    }
+
+  private:
+    // Filter a row with the given filter type, as in stbiw__encode_png_line,
+    // where the first row has no previous row to predict from.
+    void filterRow(const unsigned char* z, int filterType)
+    {
+        static const int FIRST_ROW_TYPES[] = { 0, 1, 0, 5, 6 };
+        const int type = _rowCount ? filterType : FIRST_ROW_TYPES[filterType];
+        const unsigned char* p = _prevRow.data();
+        const int n = (int) _channelCount;
+        const int count = (int) _rowBytes;
+        signed char* out = _lineBuffer.data();
+        for (int i = 0; i < count; i++)
+        {
+            int value = z[i];
+            switch (type)
+            {
+                case 1: value = z[i] - (i < n ? 0 : z[i - n]); break;
+                case 2: value = z[i] - p[i]; break;
+                case 3: value = z[i] - (i < n ? p[i] >> 1 : (z[i - n] + p[i]) >> 1); break;
+                case 4: value = z[i] - (i < n ? stbiw__paeth(0, p[i], 0) : stbiw__paeth(z[i - n], p[i], p[i - n])); break;
+                case 5: value = z[i] - (i < n ? 0 : z[i - n] >> 1); break;
+                case 6: value = z[i] - (i < n ? 0 : stbiw__paeth(z[i - n], 0, 0)); break;
+                default: break;
+            }
+            out[i] = (signed char) value;
+        }
+    }
+
+    // Append a row to the data to compress, with the filter that minimizes
+    // the sum of absolute filtered values, unless a filter is forced.
+    void appendFilteredRow(const unsigned char* row)
+    {
+        const bool forceFilter = stbi_write_force_png_filter >= 0 && stbi_write_force_png_filter < 5;
+        int bestFilter = forceFilter ? stbi_write_force_png_filter : 0;
+        int bestEstimate = 0x7fffffff;
+        for (int filterType = 0; filterType < 5 && !forceFilter; filterType++)
+        {
+            filterRow(row, filterType);
+            int estimate = 0;
+            for (signed char value : _lineBuffer)
+            {
+                estimate += std::abs((int) value);
+            }
+            if (estimate < bestEstimate)
+            {
+                bestEstimate = estimate;
+                bestFilter = filterType;
+            }
+        }
+        filterRow(row, bestFilter);
+
+        appendData((unsigned char) bestFilter);
+        for (signed char value : _lineBuffer)
+        {
+            appendData((unsigned char) value);
+        }
+    }
+
+    void appendData(unsigned char value)
+    {
+        _data.push_back(value);
+        _adler1 += value;
+        _adler2 += _adler1;
+        if (++_adlerCount == 5552)
+        {
+            _adler1 %= 65521;
+            _adler2 %= 65521;
+            _adlerCount = 0;
+        }
+    }
+
+    unsigned char* getData(size_t position)
+    {
+        return _data.data() + (position - _dataStart);
+    }
+
+    // Compress the appended data as in stbi_zlib_compress.  Until the final
+    // row has arrived, only positions whose matches cannot extend beyond the
+    // appended data are compressed.
+    void compress(bool final)
+    {
+        static const unsigned short LENGTH_CODES[] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258, 259 };
+        static const unsigned char LENGTH_BITS[] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+        static const unsigned short DISTANCE_CODES[] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577, 32768 };
+        static const unsigned char DISTANCE_BITS[] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+        const size_t QUALITY = (size_t) stbi_write_png_compression_level < 5 ? 5 : (size_t) stbi_write_png_compression_level;
+        const size_t MAX_MATCH = 258;
+
+        const long long dataEnd = (long long) (_dataStart + _data.size());
+        const long long dataLen = final ? (long long) _totalBytes : dataEnd;
+        auto countMatch = [&](size_t a, size_t b, long long limit)
+        {
+            const unsigned char* pa = getData(a);
+            const unsigned char* pb = getData(b);
+            int i = 0;
+            for (; i < limit && i < (int) MAX_MATCH; ++i)
+            {
+                if (pa[i] != pb[i])
+                    break;
+            }
+            return i;
+        };
+
+        long long i = (long long) _position;
+        while (i < dataLen - 3 && (final || i + (long long) MAX_MATCH + 1 <= dataEnd))
+        {
+            // Hash the next 3 bytes of data to be compressed.
+            int h = (int) (stbiw__zhash(getData((size_t) i)) & (stbiw__ZHASH - 1));
+            int best = 3;
+            long long bestLoc = -1;
+            vector<size_t>& hashList = _hashTable[h];
+            for (size_t entry : hashList)
+            {
+                if ((long long) entry > i - 32768)
+                {
+                    int d = countMatch(entry, (size_t) i, dataLen - i);
+                    if (d >= best)
+                    {
+                        best = d;
+                        bestLoc = (long long) entry;
+                    }
+                }
+            }
+            if (hashList.size() == 2 * QUALITY)
+            {
+                hashList.erase(hashList.begin(), hashList.begin() + QUALITY);
+            }
+            hashList.push_back((size_t) i);
+
+            if (bestLoc >= 0)
+            {
+                // Emit a literal if the match at the next byte is better.
+                h = (int) (stbiw__zhash(getData((size_t) i + 1)) & (stbiw__ZHASH - 1));
+                for (size_t entry : _hashTable[h])
+                {
+                    if ((long long) entry > i - 32767 && countMatch(entry, (size_t) i + 1, dataLen - i - 1) > best)
+                    {
+                        bestLoc = -1;
+                        break;
+                    }
+                }
+            }
+
+            if (bestLoc >= 0)
+            {
+                const int d = (int) (i - bestLoc);
+                int j = 0;
+                for (; best > LENGTH_CODES[j + 1] - 1; ++j);
+                addHuffman(j + 257);
+                if (LENGTH_BITS[j])
+                    addBits(best - LENGTH_CODES[j], LENGTH_BITS[j]);
+                for (j = 0; d > DISTANCE_CODES[j + 1] - 1; ++j);
+                addBits(stbiw__zlib_bitrev(j, 5), 5);
+                if (DISTANCE_BITS[j])
+                    addBits(d - DISTANCE_CODES[j], DISTANCE_BITS[j]);
+                i += best;
+            }
+            else
+            {
+                addHuffman(*getData((size_t) i));
+                ++i;
+            }
+        }
+        if (final)
+        {
+            // Write out the final bytes.
+            for (; i < dataLen; ++i)
+            {
+                addHuffman(*getData((size_t) i));
+            }
+        }
+        _position = (size_t) i;
+
+        // Release data that is no longer within the compression window.
+        const size_t WINDOW_SIZE = 32768;
+        if (_position > _dataStart + 2 * WINDOW_SIZE)
+        {
+            const size_t released = _position - WINDOW_SIZE - _dataStart;
+            _data.erase(_data.begin(), _data.begin() + released);
+            _dataStart += released;
+        }
+    }
+
+    void addBits(unsigned int code, int bitCount)
+    {
+        _bitBuffer |= code << _bitCount;
+        _bitCount += bitCount;
+        while (_bitCount >= 8)
+        {
+            _output.push_back((unsigned char) _bitBuffer);
+            _bitBuffer >>= 8;
+            _bitCount -= 8;
+        }
+    }
+
+    // Add a symbol with the fixed Huffman code of the deflate format.
+    void addHuffman(int n)
+    {
+        if (n <= 143)
+            addBits(stbiw__zlib_bitrev(0x30 + n, 8), 8);
+        else if (n <= 255)
+            addBits(stbiw__zlib_bitrev(0x190 + n - 144, 9), 9);
+        else if (n <= 279)
+            addBits(stbiw__zlib_bitrev(n - 256, 7), 7);
+        else
+            addBits(stbiw__zlib_bitrev(0xc0 + n - 280, 8), 8);
+    }
+
+    // Write the compressed output to the data chunk.
+    void writeOutput()
+    {
+        if (_output.empty())
+        {
+            return;
+        }
+        _stream.write((const char*) _output.data(), _output.size());
+        _crc = updateCrc(_crc, _output.data(), _output.size());
+        _idatLength += (unsigned int) _output.size();
+        _output.clear();
+    }
+
+    void writeChunk(const char* type, const unsigned char* data, size_t size)
+    {
+        unsigned char chunkHeader[8];
+        writeUint32(chunkHeader, (unsigned int) size);
+        std::memcpy(chunkHeader + 4, type, 4);
+        _stream.write((const char*) chunkHeader, sizeof(chunkHeader));
+        unsigned int crc = updateCrc(0xFFFFFFFFu, chunkHeader + 4, 4);
+        if (size)
+        {
+            _stream.write((const char*) data, size);
+            crc = updateCrc(crc, data, size);
+        }
+        unsigned char crcBytes[4];
+        writeUint32(crcBytes, ~crc);
+        _stream.write((const char*) crcBytes, sizeof(crcBytes));
+    }
+
+    static void writeUint32(unsigned char* out, unsigned int value)
+    {
+        out[0] = (unsigned char) (value >> 24);
+        out[1] = (unsigned char) (value >> 16);
+        out[2] = (unsigned char) (value >> 8);
+        out[3] = (unsigned char) value;
+    }
+
+    static unsigned int updateCrc(unsigned int crc, const unsigned char* data, size_t size)
+    {
+        static const vector<unsigned int> CRC_TABLE = []()
+        {
+            vector<unsigned int> table(256);
+            for (unsigned int n = 0; n < 256; n++)
+            {
+                unsigned int c = n;
+                for (int k = 0; k < 8; k++)
+                {
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                }
+                table[n] = c;
+            }
+            return table;
+        }();
+        for (size_t i = 0; i < size; i++)
+        {
+            crc = CRC_TABLE[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return crc;
+    }
+
+  private:
+    string _filename;
+    string _partialFilename;
+    std::ofstream _stream;
+    unsigned int _width;
+    unsigned int _height;
+    unsigned int _channelCount;
+    unsigned int _rowCount;
+    size_t _rowBytes;
+    vector<unsigned char> _prevRow;
+    vector<signed char> _lineBuffer;
+
+    // Filtered data within the compression window, starting at the given
+    // position of the zlib input, and the hashed positions of earlier data.
+    vector<unsigned char> _data;
+    vector<vector<size_t>> _hashTable;
+    size_t _dataStart;
+    size_t _position;
+    size_t _totalBytes;
+
+    unsigned int _bitBuffer;
+    int _bitCount;
+    vector<unsigned char> _output;
+    unsigned int _adler1;
+    unsigned int _adler2;
+    unsigned int _adlerCount;
+
+    std::streampos _idatOffset;
+    unsigned int _idatLength;
+    unsigned int _crc;
+};
+
+} // anonymous namespace
+
 bool StbImageLoader::saveImage(const FilePath& filePath,
                                ConstImagePtr image,
                                bool verticalFlip)
@@ -86,6 +639,30 @@ bool StbImageLoader::saveImage(const FilePath& filePath,
     return (returnValue == 1);
 }
 
+ImageWriterPtr StbImageLoader::createImageWriter(const FilePath& filePath,
+                                                 unsigned int width,
+                                                 unsigned int height,
+                                                 unsigned int channelCount,
+                                                 Image::BaseType baseType)
+{
+    // PNG files of 8-bit images and Radiance HDR files of float images are
+    // written by rows, while other formats are encoded as a whole.
+    if (!width || !height || channelCount < 1 || channelCount > 4)
+    {
+        return nullptr;
+    }
+    const string extension = filePath.getExtension();
+    if (extension == PNG_EXTENSION && baseType == Image::BaseType::UINT8)
+    {
+        return std::make_shared<StbPngImageWriter>(filePath, width, height, channelCount);
+    }
+    if (extension == HDR_EXTENSION && baseType == Image::BaseType::FLOAT)
+    {
+        return std::make_shared<StbHdrImageWriter>(filePath, width, height, channelCount);
+    }
+    return nullptr;
+}
+
 ImagePtr StbImageLoader::loadImage(const FilePath& filePath)
 {
     int width = 0;
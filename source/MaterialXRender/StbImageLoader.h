@@ -47,6 +47,16 @@ class MX_RENDER_API StbImageLoader : public ImageLoader
 
     /// Load an image from the file system.
     ImagePtr loadImage(const FilePath& filePath) override;
+
+    /// Create a writer that saves an image to the file system as its rows
+    /// arrive.  PNG files of 8-bit images and Radiance HDR files of float
+    /// images are written by rows, while the other formats of the loader
+    /// are left to be assembled by the image handler.
+    ImageWriterPtr createImageWriter(const FilePath& filePath,
+                                     unsigned int width,
+                                     unsigned int height,
+                                     unsigned int channelCount,
+                                     Image::BaseType baseType) override;
 };
 
 } // namespace MaterialX
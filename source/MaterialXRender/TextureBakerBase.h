@@ -0,0 +1,234 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#ifndef MATERIALX_TEXTUREBAKERBASE_H
+#define MATERIALX_TEXTUREBAKERBASE_H
+
+/// @file
+/// Base class for texture bakers
+
+#include <MaterialXRender/ImageHandler.h>
+
+#include <MaterialXGenShader/GenContext.h>
+
+#include <iosfwd>
+
+namespace MaterialX
+{
+
+/// A vector of baked documents with their associated names.
+using BakedDocumentVec = std::vector<std::pair<std::string, DocumentPtr>>;
+
+/// @class TextureBakerBase
+/// Base class for helpers that bake procedural material content to textures.
+///
+/// The base class selects the graph outputs of each material, optimizes the
+/// baked results, and writes the baked documents.  Derived classes supply
+/// the evaluation of graph outputs to images.
+class MX_RENDER_API TextureBakerBase
+{
+  public:
+    virtual ~TextureBakerBase() { }
+
+    /// Set the file extension for baked textures.
+    void setExtension(const string& extension)
+    {
+        _extension = extension;
+    }
+
+    /// Return the file extension for baked textures.
+    const string& getExtension() const
+    {
+        return _extension;
+    }
+
+    /// Set the color space in which color textures are encoded.
+    ///
+    /// By default, this color space is srgb_texture, and color inputs are
+    /// automatically transformed to this space by the baker.  If another color
+    /// space is set, then the input graph is responsible for transforming
+    /// colors to this space.
+    void setColorSpace(const string& colorSpace)
+    {
+        _colorSpace = colorSpace;
+    }
+
+    /// Return the color space in which color textures are encoded.
+    const string& getColorSpace() const
+    {
+        return _colorSpace;
+    }
+
+    /// Set whether images should be averaged to generate constants.  Defaults to false.
+    void setAverageImages(bool enable)
+    {
+        _averageImages = enable;
+    }
+
+    /// Return whether images should be averaged to generate constants.
+    bool getAverageImages() const
+    {
+        return _averageImages;
+    }
+
+    /// Set whether uniform textures should be stored as constants.  Defaults to true.
+    void setOptimizeConstants(bool enable)
+    {
+        _optimizeConstants = enable;
+    }
+
+    /// Return whether uniform textures should be stored as constants.
+    bool getOptimizeConstants() const
+    {
+        return _optimizeConstants;
+    }
+
+    /// Set the output location for baked texture images.  Defaults to the root folder
+    /// of the destination material.
+    void setOutputImagePath(const FilePath& outputImagePath)
+    {
+        _outputImagePath = outputImagePath;
+    }
+
+    /// Get the current output location for baked texture images.
+    const FilePath& getOutputImagePath()
+    {
+        return _outputImagePath;
+    }
+
+    /// Set the name of the baked graph element.
+    void setBakedGraphName(const string& name)
+    {
+        _bakedGraphName= name;
+    }
+
+    /// Return the name of the baked graph element.
+    const string& getBakedGraphName() const
+    {
+        return _bakedGraphName;
+    }
+
+    /// Set the name of the baked geometry info element.
+    void setBakedGeomInfoName(const string& name)
+    {
+        _bakedGeomInfoName = name;
+    }
+
+    /// Return the name of the baked geometry info element.
+    const string& getBakedGeomInfoName() const
+    {
+        return _bakedGeomInfoName;
+    }
+
+    /// Set the output stream for reporting progress and warnings.  Defaults to std::cout.
+    void setOutputStream(std::ostream* outputStream)
+    {
+        _outputStream = outputStream;
+    }
+
+    /// Return the output stream for reporting progress and warnings.
+    std::ostream* getOutputStream() const
+    {
+        return _outputStream;
+    }
+
+    /// Set whether to create a short name for baked images by hashing the baked image filenames
+    /// This is useful for file systems which may have a maximum limit on filename size.
+    /// By default names are not hashed.
+    void setHashImageNames(bool enable)
+    {
+        _hashImageNames = enable;
+    }
+
+    /// Return whether automatic baked texture resolution is set.
+    bool getHashImageNames() const
+    {
+        return _hashImageNames;
+    }
+
+    /// Bake textures for all graph inputs of the given shader.
+    void bakeShaderInputs(NodePtr material, NodePtr shader, GenContext& context, const string& udim = EMPTY_STRING);
+
+    /// Bake a texture for the given graph output.
+    void bakeGraphOutput(OutputPtr output, GenContext& context, const FilePath& filename);
+
+    /// Optimize baked textures before writing.
+    void optimizeBakedTextures(NodePtr shader);
+
+    /// Write the baked material with textures to a document.
+    DocumentPtr bakeMaterial(NodePtr shader, const StringVec& udimSet);
+
+    /// Bake all materials in the given document and return them as a vector.
+    /// @throws ExceptionRenderError if no shader generator has been set.
+    BakedDocumentVec createBakeDocuments(DocumentPtr doc, const FileSearchPath& searchPath);
+
+    /// Bake all materials in the given document and write them to disk.  If multiple documents are written,
+    /// then the given output filename will be used as a template.
+    void bakeAllMaterials(DocumentPtr doc, const FileSearchPath& searchPath, const FilePath& outputFileName);
+
+  protected:
+    class BakedImage
+    {
+      public:
+        FilePath filename;
+        Color4 uniformColor;
+        bool isUniform = false;
+    };
+    class BakedConstant
+    {
+      public:
+        Color4 color;
+        bool isDefault = false;
+    };
+    using BakedImageVec = vector<BakedImage>;
+    using BakedImageMap = std::unordered_map<OutputPtr, BakedImageVec>;
+    using BakedConstantMap = std::unordered_map<OutputPtr, BakedConstant>;
+    using BakedOutputVec = vector<std::pair<OutputPtr, FilePath>>;
+
+  protected:
+    TextureBakerBase(Image::BaseType baseType);
+
+    // Bake each graph output to its texture file, adding a record for each
+    // to the baked image map.
+    virtual void bakeGraphOutputs(const BakedOutputVec& outputs, GenContext& context) = 0;
+
+    // Return the image handler used to load and write images.
+    virtual ImageHandlerPtr getBakeImageHandler() const = 0;
+
+    // Prepare the generation context used to bake documents.
+    virtual void initializeContext(GenContext&) { }
+
+    // Return true if the baked image of the given output is encoded in sRGB.
+    bool isSrgbEncoded(OutputPtr output) const;
+
+    // Generate a texture filename for the given graph output.
+    FilePath generateTextureFilename(OutputPtr output, const string& srName, const string& udim);
+
+    // Write a baked image to disk, returning true if the write was successful.
+    bool writeBakedImage(const BakedImage& baked, ImagePtr image);
+
+  protected:
+    Image::BaseType _textureBaseType;
+    string _extension;
+    string _colorSpace;
+    bool _averageImages;
+    bool _optimizeConstants;
+    FilePath _outputImagePath;
+    string _bakedGraphName;
+    string _bakedGeomInfoName;
+    std::ostream* _outputStream;
+    bool _hashImageNames;
+
+    ShaderGeneratorPtr _generator;
+    ConstNodePtr _material;
+    BakedImageMap _bakedImageMap;
+    BakedConstantMap _bakedConstantMap;
+
+    std::unordered_map<string, NodePtr> _worldSpaceNodes;
+};
+
+} // namespace MaterialX
+
+#endif
@@ -10,6 +10,10 @@
 #include <MaterialXFormat/Util.h>
 #include <MaterialXFormat/XmlIo.h>
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 namespace mx = MaterialX;
 
 TEST_CASE("Document", "[document]")
@@ -109,6 +113,328 @@ TEST_CASE("Document", "[document]")
     REQUIRE(doc->validate());
 }
 
+TEST_CASE("Document cache", "[document]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+
+    // Populate the cache with an initial nodedef and implementation.
+    mx::NodeDefPtr nodeDef = doc->addNodeDef("ND_simple", "color3", "simple");
+    mx::ImplementationPtr impl = doc->addImplementation("IM_simple");
+    impl->setNodeDef(nodeDef);
+    REQUIRE(doc->getMatchingNodeDefs("simple").size() == 1);
+    REQUIRE(doc->getMatchingImplementations("ND_simple").size() == 1);
+
+    // Add elements to a valid cache.
+    mx::NodeDefPtr nodeDef2 = doc->addNodeDef("ND_simple2", "float", "simple");
+    REQUIRE(doc->getMatchingNodeDefs("simple").size() == 2);
+    mx::NodeGraphPtr graph = doc->addNodeGraph();
+    mx::NodePtr node = graph->addNode("simple", "node1", "color3");
+    mx::OutputPtr output = graph->addOutput("out", "color3");
+    output->setNodeName(node->getName());
+    REQUIRE(doc->getMatchingPorts("node1").size() == 1);
+
+    // Modify cached attributes.
+    nodeDef2->setNodeString("simple2");
+    REQUIRE(doc->getMatchingNodeDefs("simple").size() == 1);
+    REQUIRE(doc->getMatchingNodeDefs("simple2").size() == 1);
+    impl->setNodeDef(nodeDef2);
+    REQUIRE(doc->getMatchingImplementations("ND_simple").empty());
+    REQUIRE(doc->getMatchingImplementations("ND_simple2").size() == 1);
+    output->removeAttribute(mx::PortElement::NODE_NAME_ATTRIBUTE);
+    REQUIRE(doc->getMatchingPorts("node1").empty());
+    output->setNodeName(node->getName());
+    REQUIRE(doc->getMatchingPorts("node1").size() == 1);
+
+    // Remove elements from a valid cache.
+    doc->removeNodeGraph(graph->getName());
+    REQUIRE(doc->getMatchingPorts("node1").empty());
+    doc->removeNodeDef(nodeDef2->getName());
+    REQUIRE(doc->getMatchingNodeDefs("simple2").empty());
+
+    // Changes to removed elements are not reflected in the cache.
+    nodeDef2->setNodeString("simple");
+    output->setNodeName("node1");
+    REQUIRE(doc->getMatchingNodeDefs("simple").size() == 1);
+    REQUIRE(doc->getMatchingPorts("node1").empty());
+
+    // Namespace changes are reflected in qualified lookups.
+    doc->setNamespace("custom");
+    REQUIRE(doc->getMatchingNodeDefs("custom:simple").size() == 1);
+    REQUIRE(doc->getMatchingNodeDefs("simple").empty());
+
+    // Verify that incremental updates match a full rebuild of the cache.
+    doc->invalidateCache();
+    REQUIRE(doc->getMatchingNodeDefs("custom:simple").size() == 1);
+    REQUIRE(doc->getMatchingImplementations("custom:ND_simple2").size() == 1);
+}
+
+TEST_CASE("Data libraries", "[document]")
+{
+    // Create a shared library document.
+    mx::DocumentPtr library = mx::createDocument();
+    mx::NodeDefPtr nodeDef = library->addNodeDef("ND_simple", "color3", "simple");
+    mx::ImplementationPtr impl = library->addImplementation("IM_simple");
+    impl->setNodeDef(nodeDef);
+    mx::TypeDefPtr typeDef = library->addTypeDef("spectrum");
+
+    // Reference the library from two documents.
+    mx::DocumentPtr doc1 = mx::createDocument();
+    mx::DocumentPtr doc2 = mx::createDocument();
+    doc1->addDataLibrary(library);
+    doc2->addDataLibrary(library);
+    REQUIRE_THROWS(doc1->addDataLibrary(doc1));
+    REQUIRE(doc1->hasDataLibraries());
+    REQUIRE(doc1->getDataLibraries().size() == 1);
+
+    // Definitions are resolved through the library without being copied.
+    REQUIRE(doc1->getChildren().empty());
+    REQUIRE(doc1->getNodeDef("ND_simple") == nodeDef);
+    REQUIRE(doc2->getNodeDef("ND_simple") == nodeDef);
+    REQUIRE(doc1->getImplementation("IM_simple") == impl);
+    REQUIRE(doc1->getTypeDef("spectrum") == typeDef);
+    REQUIRE(doc1->getMatchingNodeDefs("simple").size() == 1);
+    REQUIRE(doc1->getMatchingImplementations("ND_simple").size() == 1);
+    REQUIRE(!doc1->getNodeDef("ND_missing"));
+
+    // Nodes resolve their declarations through the library.
+    mx::NodePtr node = doc1->addNode("simple", "node1", "color3");
+    REQUIRE(node->getNodeDef() == nodeDef);
+    node->setNodeDefString("ND_simple");
+    REQUIRE(node->getNodeDef() == nodeDef);
+    REQUIRE(doc1->validate());
+
+    // Local definitions take precedence over library definitions.
+    mx::NodeDefPtr localNodeDef = doc1->addNodeDef("ND_simple", "color3", "simple");
+    REQUIRE(doc1->getNodeDef("ND_simple") == localNodeDef);
+    REQUIRE(doc1->getMatchingNodeDefs("simple").size() == 2);
+    REQUIRE(doc1->getMatchingNodeDefs("simple")[0] == localNodeDef);
+
+    // Copies retain their library references.
+    mx::DocumentPtr doc3 = doc2->copy();
+    REQUIRE(doc3->getNodeDef("ND_simple") == nodeDef);
+
+    // Clear the library references.
+    doc2->clearDataLibraries();
+    REQUIRE(!doc2->getNodeDef("ND_simple"));
+    REQUIRE(doc2->getMatchingNodeDefs("simple").empty());
+
+    // Cycles of library references are rejected, directly or through
+    // intermediate libraries.
+    mx::DocumentPtr libraryA = mx::createDocument();
+    mx::DocumentPtr libraryB = mx::createDocument();
+    mx::DocumentPtr libraryC = mx::createDocument();
+    libraryA->addDataLibrary(libraryB);
+    REQUIRE_THROWS_AS(libraryB->addDataLibrary(libraryA), mx::Exception&);
+    libraryB->addDataLibrary(libraryC);
+    REQUIRE_THROWS_AS(libraryC->addDataLibrary(libraryA), mx::Exception&);
+    REQUIRE(libraryB->getDataLibraries().size() == 1);
+    REQUIRE(!libraryC->hasDataLibraries());
+    REQUIRE(!libraryA->getNodeDef("ND_missing"));
+    REQUIRE(libraryA->getMatchingNodeDefs("simple").empty());
+}
+
+TEST_CASE("Element arena", "[document]")
+{
+    mx::FileSearchPath searchPath(mx::FilePath::getCurrentPath());
+
+    // Load the standard libraries with and without an element arena.
+    mx::DocumentPtr heapDoc = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, heapDoc);
+    mx::DocumentPtr arenaDoc = mx::createDocument();
+    mx::ElementArenaPtr arena = mx::ElementArena::create();
+    arenaDoc->setElementArena(arena);
+    mx::loadLibraries({ "libraries" }, searchPath, arenaDoc);
+    REQUIRE(*arenaDoc == *heapDoc);
+    REQUIRE(arena->getAllocatedBytes() > 0);
+    REQUIRE(arena->getBlockCount() < arenaDoc->getChildren().size());
+
+    // Copies are allocated from an arena of their own.
+    mx::DocumentPtr arenaCopy = arenaDoc->copy();
+    REQUIRE(arenaCopy->getElementArena());
+    REQUIRE(arenaCopy->getElementArena() != arena);
+    REQUIRE(*arenaCopy == *arenaDoc);
+
+    // Released memory is recycled by the arena.
+    size_t allocatedBytes = arena->getAllocatedBytes();
+    mx::NodeGraphPtr nodeGraph = arenaDoc->addNodeGraph("graph1");
+    nodeGraph->addNode("constant", "node1", "color3");
+    REQUIRE(arena->getAllocatedBytes() > allocatedBytes);
+    arenaDoc->removeNodeGraph("graph1");
+    nodeGraph = nullptr;
+    REQUIRE(arena->getAllocatedBytes() == allocatedBytes);
+
+    // Child and attribute containers are drawn from the arena.
+    mx::NodeDefPtr nodeDef = arenaDoc->getNodeDefs().front();
+    allocatedBytes = arena->getAllocatedBytes();
+    nodeDef->setAttribute("arenaTest1", "value1");
+    nodeDef->setAttribute("arenaTest2", "value2");
+    nodeDef->setAttribute("arenaTest3", "value3");
+    REQUIRE(arena->getAllocatedBytes() > allocatedBytes);
+    REQUIRE(nodeDef->getChildren().get_allocator().getArena() == arena);
+
+    // Elements remain valid after their document is released.
+    mx::ElementPtr elem = arenaDoc->getChildren().front();
+    std::string elemName = elem->getName();
+    arenaDoc = nullptr;
+    arenaCopy = nullptr;
+    arena = nullptr;
+    REQUIRE(elem->getName() == elemName);
+}
+
+TEST_CASE("Threaded element arena", "[document]")
+{
+    const size_t THREAD_COUNT = 8;
+    const size_t ROUNDS = 2000;
+    const size_t SIZES[] = { 8, 24, 40, 96, 200, 1000 };
+
+    mx::ElementArenaPtr arena = mx::ElementArena::create();
+    std::vector<std::vector<std::pair<unsigned char*, size_t>>> handoffs(THREAD_COUNT);
+    std::atomic<bool> corrupted(false);
+
+    // Each thread allocates and fills blocks of varying size class, releases
+    // half of them, and hands the rest to its neighbor for release.
+    auto allocateBlocks = [&](size_t index)
+    {
+        std::vector<std::pair<unsigned char*, size_t>> kept;
+        for (size_t i = 0; i < ROUNDS; i++)
+        {
+            size_t size = SIZES[(i + index) % (sizeof(SIZES) / sizeof(SIZES[0]))];
+            unsigned char* ptr = static_cast<unsigned char*>(arena->allocate(size));
+            std::fill(ptr, ptr + size, (unsigned char) index);
+            kept.emplace_back(ptr, size);
+        }
+        for (size_t i = 0; i < kept.size(); i += 2)
+        {
+            if (kept[i].first[kept[i].second - 1] != (unsigned char) index)
+            {
+                corrupted = true;
+            }
+            arena->deallocate(kept[i].first, kept[i].second);
+        }
+        for (size_t i = 1; i < kept.size(); i += 2)
+        {
+            handoffs[index].push_back(kept[i]);
+        }
+    };
+    auto releaseBlocks = [&](size_t index)
+    {
+        size_t source = (index + 1) % THREAD_COUNT;
+        for (const auto& block : handoffs[source])
+        {
+            if (block.first[0] != (unsigned char) source)
+            {
+                corrupted = true;
+            }
+            arena->deallocate(block.first, block.second);
+        }
+    };
+
+    using Task = std::function<void(size_t)>;
+    for (const Task& task : { Task(allocateBlocks), Task(releaseBlocks) })
+    {
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < THREAD_COUNT; i++)
+        {
+            threads.emplace_back(task, i);
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+    }
+    REQUIRE(!corrupted);
+    REQUIRE(arena->getAllocatedBytes() == 0);
+
+    // Memory released by other threads is recycled rather than reserved anew.
+    size_t blockCount = arena->getBlockCount();
+    std::vector<void*> blocks;
+    for (size_t i = 0; i < ROUNDS; i++)
+    {
+        blocks.push_back(arena->allocate(40));
+    }
+    for (void* ptr : blocks)
+    {
+        arena->deallocate(ptr, 40);
+    }
+    REQUIRE(arena->getBlockCount() == blockCount);
+}
+
+TEST_CASE("Threaded document lookups", "[document]")
+{
+    mx::FileSearchPath searchPath(mx::FilePath::getCurrentPath());
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, doc);
+
+    // Record the expected results from a serial pass.
+    std::vector<std::pair<std::string, size_t>> expectedNodeDefs;
+    std::vector<std::pair<std::string, size_t>> expectedImpls;
+    for (mx::NodeDefPtr nodeDef : doc->getNodeDefs())
+    {
+        expectedNodeDefs.emplace_back(nodeDef->getNodeString(), doc->getMatchingNodeDefs(nodeDef->getNodeString()).size());
+        expectedImpls.emplace_back(nodeDef->getName(), doc->getMatchingImplementations(nodeDef->getName()).size());
+    }
+    REQUIRE(!expectedNodeDefs.empty());
+
+    // Invalidate the cache, so that threads race to rebuild it, and then
+    // hammer the lookup methods from many threads at once.
+    doc->invalidateCache();
+    const size_t threadCount = std::max<size_t>(std::thread::hardware_concurrency(), 4);
+    const size_t passCount = 8;
+    std::atomic<size_t> mismatchCount(0);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < threadCount; i++)
+    {
+        threads.emplace_back([&]()
+        {
+            for (size_t pass = 0; pass < passCount; pass++)
+            {
+                for (size_t j = 0; j < expectedNodeDefs.size(); j++)
+                {
+                    if (doc->getMatchingNodeDefs(expectedNodeDefs[j].first).size() != expectedNodeDefs[j].second ||
+                        doc->getMatchingImplementations(expectedImpls[j].first).size() != expectedImpls[j].second)
+                    {
+                        mismatchCount++;
+                    }
+                    doc->getMatchingPorts(expectedNodeDefs[j].first);
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    REQUIRE(mismatchCount == 0);
+}
+
+TEST_CASE("Threaded document validation", "[document]")
+{
+    mx::FileSearchPath searchPath(mx::FilePath::getCurrentPath());
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, doc);
+
+    // Introduce errors at several points in the document.
+    doc->addNodeGraph("graph1")->setNodeDefString("ND_missing");
+    doc->addNodeDef("ND_invalid", "float")->setInheritString("ND_missing");
+    doc->addNode("image", "image1", "color3")->addInput("texcoord", "vector2")->setNodeName("missing");
+
+    // Validate serially and with threads, comparing the error descriptions.
+    std::string serialMessage;
+    REQUIRE(!doc->validate(&serialMessage));
+    REQUIRE(!serialMessage.empty());
+    for (unsigned int threadCount : { 1u, 4u, 0u })
+    {
+        mx::ValidationOptions options;
+        options.threadCount = threadCount;
+        std::string message;
+        mx::ValidationTimeMap categoryTimes;
+        REQUIRE(!doc->validate(&message, options, &categoryTimes));
+        REQUIRE(message == serialMessage);
+        REQUIRE(categoryTimes.count(mx::NodeDef::CATEGORY));
+        REQUIRE(categoryTimes.count(mx::NodeGraph::CATEGORY));
+    }
+}
+
 TEST_CASE("Version", "[document]")
 {
     mx::DocumentPtr doc = mx::createDocument();
@@ -7,6 +7,9 @@
 
 #include <MaterialXCore/Document.h>
 
+#include <chrono>
+#include <sstream>
+
 namespace mx = MaterialX;
 
 TEST_CASE("Element", "[element]")
@@ -40,6 +43,21 @@ TEST_CASE("Element", "[element]")
     REQUIRE(elem1->getTypedAttribute<bool>("customColor") == false);
     REQUIRE(elem1->getTypedAttribute<mx::Color3>("customFlag") == mx::Color3(0.0f));
 
+    // Modify and remove attributes, preserving their order.
+    elem2->setAttribute("attr1", "value1");
+    elem2->setAttribute("attr2", "value2");
+    elem2->setAttribute("attr3", "value3");
+    elem2->setAttribute("attr1", "value4");
+    REQUIRE(elem2->getAttributeNames() == mx::StringVec({ "attr1", "attr2", "attr3" }));
+    REQUIRE(elem2->getAttribute("attr1") == "value4");
+    elem2->removeAttribute("attr2");
+    REQUIRE(!elem2->hasAttribute("attr2"));
+    REQUIRE(elem2->getAttribute("attr2").empty());
+    REQUIRE(elem2->getAttributeNames() == mx::StringVec({ "attr1", "attr3" }));
+    elem2->removeAttribute("attr1");
+    elem2->removeAttribute("attr3");
+    REQUIRE(elem2->getAttributeNames().empty());
+
     // Modify element names.
     elem1->setName("elem1");
     elem2->setName("elem2");
@@ -57,6 +75,41 @@ TEST_CASE("Element", "[element]")
     REQUIRE_THROWS_AS(doc2->setChildIndex("elem1", 100), mx::Exception&);
     REQUIRE(*doc2 == *doc);
 
+    // Add, rename and remove children beyond the name index threshold.
+    mx::ElementPtr parent = doc->addChildOfCategory("generic", "parent");
+    for (int i = 0; i < 40; i++)
+    {
+        parent->addChildOfCategory("generic", "child" + std::to_string(i));
+    }
+    REQUIRE(parent->getChild("child30")->getName() == "child30");
+    parent->getChild("child30")->setName("renamed30");
+    REQUIRE(!parent->getChild("child30"));
+    REQUIRE(parent->getChild("renamed30"));
+    REQUIRE_THROWS_AS(parent->getChild("child31")->setName("renamed30"), mx::Exception&);
+    parent->removeChild("child5");
+    REQUIRE(!parent->getChild("child5"));
+    REQUIRE(parent->getChildIndex("child6") == 5);
+    REQUIRE(parent->getChildren().size() == 39);
+    doc->removeChild("parent");
+
+    // Cache typed values, clearing the cache when the value or type changes.
+    mx::TokenPtr token = doc->addChildOfCategory("token", "token1")->asA<mx::Token>();
+    REQUIRE(!token->getValue());
+    token->setValue(1.0f);
+    mx::ValuePtr value = token->getValue();
+    REQUIRE(value->asA<float>() == 1.0f);
+
+    // Returned values are copies, so editing them leaves the cache unchanged.
+    std::static_pointer_cast<mx::TypedValue<float>>(value)->setData(3.0f);
+    REQUIRE(token->getValue()->asA<float>() == 1.0f);
+    token->setValueString("2");
+    REQUIRE(token->getValue()->asA<float>() == 2.0f);
+    token->setType("integer");
+    REQUIRE(token->getValue()->asA<int>() == 2);
+    token->removeAttribute(mx::ValueElement::VALUE_ATTRIBUTE);
+    REQUIRE(!token->getValue());
+    doc->removeChild("token1");
+
     // Create and test an orphaned element.
     mx::ElementPtr orphan;
     {
@@ -66,3 +119,61 @@ TEST_CASE("Element", "[element]")
     }
     REQUIRE_THROWS_AS(orphan->getDocument(), mx::ExceptionOrphanedElement&);    
 }
+
+// Hidden benchmark, run on request with: MaterialXTest "[.benchmark]"
+TEST_CASE("Element child benchmarks", "[element][.benchmark]")
+{
+    using Clock = std::chrono::steady_clock;
+    const size_t iterationCount = 20;
+
+    for (size_t fanOut : { 1, 4, 16, 64, 1024 })
+    {
+        std::vector<std::string> names;
+        for (size_t i = 0; i < fanOut; i++)
+        {
+            names.push_back("child" + std::to_string(i));
+        }
+
+        double addTime = 0.0, getTime = 0.0, removeTime = 0.0;
+        for (size_t iteration = 0; iteration < iterationCount; iteration++)
+        {
+            mx::DocumentPtr doc = mx::createDocument();
+            mx::ElementPtr parent = doc->addChildOfCategory("generic", "parent");
+
+            Clock::time_point start = Clock::now();
+            for (const std::string& name : names)
+            {
+                parent->addChildOfCategory("generic", name);
+            }
+            Clock::time_point end = Clock::now();
+            addTime += std::chrono::duration<double>(end - start).count();
+
+            start = Clock::now();
+            size_t foundCount = 0;
+            for (const std::string& name : names)
+            {
+                foundCount += parent->getChild(name) ? 1 : 0;
+            }
+            end = Clock::now();
+            getTime += std::chrono::duration<double>(end - start).count();
+            REQUIRE(foundCount == fanOut);
+
+            start = Clock::now();
+            for (const std::string& name : names)
+            {
+                parent->removeChild(name);
+            }
+            end = Clock::now();
+            removeTime += std::chrono::duration<double>(end - start).count();
+            REQUIRE(parent->getChildren().empty());
+        }
+
+        const double scale = 1.0e9 / (double) (iterationCount * fanOut);
+        std::stringstream report;
+        report << "Fan-out " << fanOut << ": "
+               << "add " << addTime * scale << " ns, "
+               << "get " << getTime * scale << " ns, "
+               << "remove " << removeTime * scale << " ns per child";
+        WARN(report.str());
+    }
+}
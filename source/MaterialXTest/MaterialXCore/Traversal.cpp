@@ -99,6 +99,38 @@ TEST_CASE("IntraGraph Traversal", "[traversal]")
     }
     REQUIRE(nodeCount == 0);
 
+    // Traverse the document tree (read-only iterator), verifying that the
+    // same elements are visited at the same depths.
+    std::vector<std::pair<const mx::Element*, size_t>> treeElems, constTreeElems;
+    for (mx::TreeIterator it = doc->traverseTree().begin(); it != mx::TreeIterator::end(); ++it)
+    {
+        treeElems.emplace_back(it.getElement().get(), it.getElementDepth());
+    }
+    for (mx::ConstTreeIterator it = doc->traverseTreeConst().begin(); it != mx::ConstTreeIterator::end(); ++it)
+    {
+        constTreeElems.emplace_back(it.getElement(), it.getElementDepth());
+    }
+    REQUIRE(constTreeElems == treeElems);
+
+    // Traverse the document tree (read-only iterator, prune subtree).
+    nodeCount = 0;
+    size_t elemCount = 0;
+    for (mx::ConstTreeIterator it = doc->traverseTreeConst().begin(); it != mx::ConstTreeIterator::end(); ++it)
+    {
+        const mx::Element& elem = *it;
+        if (elem.isA<mx::Node>())
+        {
+            nodeCount++;
+        }
+        if (elem.isA<mx::NodeGraph>())
+        {
+            it.setPruneSubtree(true);
+        }
+        elemCount++;
+    }
+    REQUIRE(nodeCount == 0);
+    REQUIRE(elemCount == doc->getChildren().size() + 1);
+
     // Traverse upstream from the graph output (implicit iterator).
     nodeCount = 0;
     for (mx::Edge edge : output->traverseGraph())
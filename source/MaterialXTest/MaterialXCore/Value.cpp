@@ -8,8 +8,21 @@
 #include <MaterialXCore/Util.h>
 #include <MaterialXCore/Value.h>
 
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <locale>
+#include <random>
+#include <sstream>
+
 namespace mx = MaterialX;
 
+class CommaNumpunct : public std::numpunct<char>
+{
+  protected:
+    char do_decimal_point() const override { return ','; }
+};
+
 template<class T> void testTypedValue(const T& v1, const T& v2)
 {
     T v0{};
@@ -21,6 +34,7 @@ template<class T> void testTypedValue(const T& v1, const T& v2)
     REQUIRE(value0->isA<T>());
     REQUIRE(value1->isA<T>());
     REQUIRE(value2->isA<T>());
+    REQUIRE(value0->getTypeTag() == mx::TypedValue<T>::TAG);
     REQUIRE(value0->asA<T>() == v0);
     REQUIRE(value1->asA<T>() == v1);
     REQUIRE(value2->asA<T>() == v2);
@@ -65,6 +79,42 @@ TEST_CASE("Value strings", "[value]")
         REQUIRE(mx::toValueString(0.1234f) == "0.12");
     }
 
+    // Verify that float formatting is independent of the global locale.
+    {
+        std::locale previous = std::locale::global(std::locale(std::locale::classic(), new CommaNumpunct));
+        std::string str = mx::toValueString(1.5f);
+        std::locale::global(previous);
+        REQUIRE(str == "1.5");
+    }
+
+    // Verify that the default float format matches stream formatting.
+    {
+        std::mt19937 rng(0);
+        std::uniform_real_distribution<float> mantissaDist(-10.0f, 10.0f);
+        std::uniform_int_distribution<int> exponentDist(-45, 38);
+        std::vector<float> values = { 0.0f, -0.0f, 0.5f, 0.125f, 0.25f, 1e-5f, 1e-4f, 9.9999999e-5f, 999999.5f, 1e6f, 123456789.0f,
+                                      std::numeric_limits<float>::max(), std::numeric_limits<float>::min(),
+                                      std::numeric_limits<float>::denorm_min(), std::numeric_limits<float>::infinity() };
+        for (int i = 0; i < 2000; i++)
+        {
+            values.push_back(mantissaDist(rng) * std::pow(10.0f, (float) exponentDist(rng)));
+        }
+        for (int precision : { 0, 1, 2, 6, 9, 17, 40 })
+        {
+            mx::ScopedFloatFormatting fmt(mx::Value::FloatFormatDefault, precision);
+            for (float value : values)
+            {
+                std::ostringstream ss;
+                ss.imbue(std::locale::classic());
+                ss.precision(precision);
+                ss << value;
+                REQUIRE(mx::toValueString(value) == ss.str());
+            }
+        }
+        REQUIRE(mx::toValueString(std::numeric_limits<double>::denorm_min()) == "4.94066e-324");
+        REQUIRE(mx::toValueString(std::numeric_limits<double>::max()) == "1.79769e+308");
+    }
+
     // Convert from value strings to data values.
     REQUIRE(mx::fromValueString<int>("1") == 1);
     REQUIRE(mx::fromValueString<float>("1") == 1.0f);
@@ -78,6 +128,123 @@ TEST_CASE("Value strings", "[value]")
     REQUIRE_THROWS_AS(mx::fromValueString<float>("text"), mx::ExceptionTypeError&);
     REQUIRE_THROWS_AS(mx::fromValueString<bool>("1"), mx::ExceptionTypeError&);
     REQUIRE_THROWS_AS(mx::fromValueString<mx::Color3>("1"), mx::ExceptionTypeError&);
+
+    // Verify that numeric conversions match stream conversions.
+    for (const std::string str : { "0", "-0", "+7", "2147483647", "-2147483648", "2147483648", "1.5", "1e3", " 1", "0x10" })
+    {
+        std::stringstream ss(str);
+        int data = 0;
+        if (ss >> data)
+        {
+            REQUIRE(mx::fromValueString<int>(str) == data);
+        }
+        else
+        {
+            REQUIRE_THROWS_AS(mx::fromValueString<int>(str), mx::ExceptionTypeError&);
+        }
+    }
+    std::mt19937 rng(0);
+    std::uniform_int_distribution<int> digitDist(0, 9);
+    std::uniform_int_distribution<int> lengthDist(1, 12);
+    std::uniform_int_distribution<int> exponentDist(-40, 40);
+    for (int i = 0; i < 10000; i++)
+    {
+        std::string str = (i % 2) ? "-" : "";
+        int length = lengthDist(rng);
+        int point = lengthDist(rng);
+        for (int j = 0; j < length; j++)
+        {
+            str += (j == point) ? '.' : char('0' + digitDist(rng));
+        }
+        if (i % 3 == 0)
+        {
+            str += "e" + std::to_string(exponentDist(rng));
+        }
+        std::stringstream floatStream(str);
+        std::stringstream doubleStream(str);
+        float floatData = 0.0f;
+        double doubleData = 0.0;
+        if (floatStream >> floatData)
+        {
+            REQUIRE(mx::fromValueString<float>(str) == floatData);
+        }
+        else
+        {
+            REQUIRE_THROWS_AS(mx::fromValueString<float>(str), mx::ExceptionTypeError&);
+        }
+        if (doubleStream >> doubleData)
+        {
+            REQUIRE(mx::fromValueString<double>(str) == doubleData);
+        }
+        else
+        {
+            REQUIRE_THROWS_AS(mx::fromValueString<double>(str), mx::ExceptionTypeError&);
+        }
+    }
+
+    // Verify that float values round-trip at sufficient precision.
+    std::uniform_real_distribution<float> floatDist(-1000.0f, 1000.0f);
+    {
+        mx::ScopedFloatFormatting fmt(mx::Value::FloatFormatDefault, 9);
+        for (int i = 0; i < 1000; i++)
+        {
+            mx::Matrix44 matrix;
+            for (size_t j = 0; j < 4; j++)
+            {
+                for (size_t k = 0; k < 4; k++)
+                {
+                    matrix[j][k] = floatDist(rng);
+                }
+            }
+            REQUIRE(mx::fromValueString<mx::Matrix44>(mx::toValueString(matrix)) == matrix);
+            mx::Color3 color(matrix[0][0], matrix[1][1], matrix[2][2] * 1.0e-20f);
+            REQUIRE(mx::fromValueString<mx::Color3>(mx::toValueString(color)) == color);
+        }
+    }
+}
+
+// Hidden benchmark, run on request with: MaterialXTest "[.benchmark]"
+TEST_CASE("Value string benchmarks", "[value][.benchmark]")
+{
+    using Clock = std::chrono::steady_clock;
+    const size_t iterationCount = 20000;
+
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<float> floatDist(0.0f, 1.0f);
+    std::vector<mx::ValuePtr> values;
+    for (size_t i = 0; i < iterationCount; i++)
+    {
+        values.push_back(mx::Value::createValue(floatDist(rng)));
+        values.push_back(mx::Value::createValue(mx::Color3(floatDist(rng), floatDist(rng), floatDist(rng))));
+        values.push_back(mx::Value::createValue(mx::Matrix44(floatDist(rng), 0.0f, 0.0f, 0.0f,
+                                                             0.0f, floatDist(rng), 0.0f, 0.0f,
+                                                             0.0f, 0.0f, floatDist(rng), 0.0f,
+                                                             floatDist(rng), floatDist(rng), floatDist(rng), 1.0f)));
+    }
+
+    std::vector<std::string> valueStrings(values.size());
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        valueStrings[i] = values[i]->getValueString();
+    }
+    double formatTime = std::chrono::duration<double>(Clock::now() - start).count();
+
+    start = Clock::now();
+    size_t parsedCount = 0;
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        parsedCount += mx::Value::createValueFromStrings(valueStrings[i], values[i]->getTypeString()) ? 1 : 0;
+    }
+    double parseTime = std::chrono::duration<double>(Clock::now() - start).count();
+    REQUIRE(parsedCount == values.size());
+
+    const double scale = 1.0e9 / (double) values.size();
+    std::stringstream report;
+    report << "Value strings: "
+           << "format " << formatTime * scale << " ns, "
+           << "parse " << parseTime * scale << " ns per value";
+    WARN(report.str());
 }
 
 TEST_CASE("Typed values", "[value]")
@@ -72,6 +72,27 @@ TEST_CASE("File search path operations", "[file]")
     }
 }
 
+TEST_CASE("Mapped files", "[file]")
+{
+    mx::FilePath path("libraries/stdlib/stdlib_defs.mtlx");
+    std::string contents = mx::readFile(path);
+
+    // Map the file and verify its contents.
+    mx::MappedFile mappedFile;
+    REQUIRE(mappedFile.open(path));
+    REQUIRE(mappedFile.isOpen());
+    REQUIRE(std::string(mappedFile.getData(), mappedFile.getSize()) == contents);
+
+    // Modify the mapped contents, verifying that the file is unchanged.
+    mappedFile.getData()[0] = '#';
+    REQUIRE(mx::readFile(path) == contents);
+    mappedFile.close();
+    REQUIRE(!mappedFile.isOpen());
+
+    // Map a non-existent file.
+    REQUIRE(!mappedFile.open("NonExistent.mtlx"));
+}
+
 TEST_CASE("Flatten filenames", "[file]")
 {
     const mx::FilePath TEST_FILE_PREFIX_STRING("resources\\Images\\");
@@ -5,10 +5,15 @@
 
 #include <MaterialXTest/Catch/catch.hpp>
 
+#include <MaterialXFormat/BinaryIo.h>
 #include <MaterialXFormat/Environ.h>
 #include <MaterialXFormat/File.h>
+#include <MaterialXFormat/Util.h>
 #include <MaterialXFormat/XmlIo.h>
 
+#include <cstdio>
+#include <cstring>
+
 namespace mx = MaterialX;
 
 TEST_CASE("Load content", "[xmlio]")
@@ -224,3 +229,179 @@ TEST_CASE("Load content", "[xmlio]")
     mx::DocumentPtr nonExistentDoc = mx::createDocument();
     REQUIRE_THROWS_AS(mx::readFromXmlFile(nonExistentDoc, "NonExistent.mtlx", mx::FileSearchPath(), &readOptions), mx::ExceptionFileMissing&);
 }
+
+TEST_CASE("Load libraries in parallel", "[xmlio]")
+{
+    mx::FileSearchPath searchPath(mx::FilePath::getCurrentPath());
+
+    // Load the libraries serially.
+    mx::DocumentPtr serialDoc = mx::createDocument();
+    mx::StringSet serialFiles = mx::loadLibraries({ "libraries" }, searchPath, serialDoc);
+
+    // Load the libraries in parallel, verifying identical content and order.
+    for (unsigned int threadCount : { 0u, 4u })
+    {
+        mx::XmlReadOptions readOptions;
+        readOptions.readThreadCount = threadCount;
+        mx::DocumentPtr parallelDoc = mx::createDocument();
+        mx::StringSet parallelFiles = mx::loadLibraries({ "libraries" }, searchPath, parallelDoc, mx::StringSet(), &readOptions);
+        REQUIRE(parallelFiles == serialFiles);
+        REQUIRE(*parallelDoc == *serialDoc);
+    }
+}
+
+TEST_CASE("Binary documents", "[xmlio]")
+{
+    mx::FileSearchPath searchPath(mx::FilePath::getCurrentPath());
+    mx::FilePath examplesPath("resources/Materials/Examples/StandardSurface");
+
+    // Round-trip the data libraries, retaining the source URIs of imported elements.
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libraries);
+    std::string binaryString = mx::writeToBinaryString(libraries);
+    mx::DocumentPtr binaryLibraries = mx::createDocument();
+    mx::readFromBinaryString(binaryLibraries, binaryString);
+    REQUIRE(*binaryLibraries == *libraries);
+    mx::NodeDefPtr nodeDef = binaryLibraries->getNodeDef("ND_standard_surface_surfaceshader");
+    REQUIRE(nodeDef);
+    REQUIRE(nodeDef->getSourceUri() == libraries->getNodeDef(nodeDef->getName())->getSourceUri());
+    REQUIRE(binaryLibraries->validate());
+
+    // Round-trip each example document through binary files.
+    for (const mx::FilePath& filename : examplesPath.getFilesInDirectory(mx::MTLX_EXTENSION))
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::readFromXmlFile(doc, examplesPath / filename, searchPath);
+
+        mx::FilePath binaryFilename = filename;
+        binaryFilename.removeExtension();
+        binaryFilename.addExtension(mx::MTLXB_EXTENSION);
+        mx::writeToBinaryFile(doc, binaryFilename);
+
+        mx::DocumentPtr binaryDoc = mx::createDocument();
+        mx::readFromBinaryFile(binaryDoc, binaryFilename);
+        REQUIRE(*binaryDoc == *doc);
+        REQUIRE(binaryDoc->getSourceUri() == binaryFilename.asString());
+        REQUIRE(mx::writeToXmlString(binaryDoc) == mx::writeToXmlString(doc));
+        std::remove(binaryFilename.asString().c_str());
+    }
+
+    // Read invalid binary data.
+    mx::DocumentPtr invalidDoc = mx::createDocument();
+    REQUIRE_THROWS_AS(mx::readFromBinaryString(invalidDoc, "<materialx/>"), mx::ExceptionParseError&);
+    REQUIRE_THROWS_AS(mx::readFromBinaryString(invalidDoc, binaryString.substr(0, binaryString.size() / 2)), mx::ExceptionParseError&);
+    REQUIRE_THROWS_AS(mx::readFromBinaryFile(invalidDoc, "NonExistent.mtlxb"), mx::ExceptionFileMissing&);
+
+    // Reject element trees beyond the maximum depth.
+    mx::DocumentPtr deepDoc = mx::createDocument();
+    mx::ElementPtr elem = deepDoc;
+    for (int i = 0; i < 2000; i++)
+    {
+        elem = elem->addChildOfCategory("generic", "elem");
+    }
+    REQUIRE_THROWS_AS(mx::readFromBinaryString(invalidDoc, mx::writeToBinaryString(deepDoc)), mx::ExceptionParseError&);
+
+    // Write to an invalid location.
+    REQUIRE_THROWS_AS(mx::writeToBinaryFile(libraries, "NonExistent/Libraries.mtlxb"), mx::ExceptionFileMissing&);
+}
+
+TEST_CASE("Streaming read", "[xmlio]")
+{
+    mx::FilePath libraryPath("libraries/stdlib");
+    mx::FilePath examplesPath("resources/Materials/Examples/Syntax");
+    mx::FileSearchPath searchPath = libraryPath.asString() +
+        mx::PATH_LIST_SEPARATOR +
+        examplesPath.asString();
+
+    // Verify that streaming reads match standard reads, with and without
+    // comments, with each reader using its own default XInclude handling.
+    for (bool readComments : { false, true })
+    {
+        mx::XmlReadOptions readOptions;
+        readOptions.readComments = readComments;
+        for (const mx::FilePath& filename : examplesPath.getFilesInDirectory(mx::MTLX_EXTENSION))
+        {
+            mx::DocumentPtr doc = mx::createDocument();
+            mx::readFromXmlFile(doc, filename, searchPath, &readOptions);
+            mx::DocumentPtr streamedDoc = mx::createDocument();
+            mx::readFromXmlFileStreaming(streamedDoc, filename, searchPath, &readOptions);
+            REQUIRE(*streamedDoc == *doc);
+            REQUIRE(streamedDoc->getSourceUri() == doc->getSourceUri());
+            REQUIRE(mx::writeToXmlString(streamedDoc) == mx::writeToXmlString(doc));
+        }
+    }
+
+    // Read only the looks and material assignments for a given geometry.
+    mx::XmlReadOptions readOptions;
+    readOptions.readXIncludeFunction = nullptr;
+    readOptions.elementPredicate = [](mx::ConstElementPtr elem)
+    {
+        mx::ConstElementPtr parent = elem->getParent();
+        if (parent->isA<mx::Document>())
+        {
+            return elem->isA<mx::Look>();
+        }
+        if (elem->isA<mx::MaterialAssign>())
+        {
+            return mx::geomStringsMatch(elem->asA<mx::MaterialAssign>()->getActiveGeom(), "/a/b/headlight");
+        }
+        return true;
+    };
+    mx::DocumentPtr filteredDoc = mx::createDocument();
+    mx::readFromXmlFileStreaming(filteredDoc, "Looks.mtlx", searchPath, &readOptions);
+    REQUIRE(!filteredDoc->getLooks().empty());
+    REQUIRE(filteredDoc->getChildren().size() == filteredDoc->getLooks().size());
+    size_t assignCount = 0;
+    for (mx::LookPtr look : filteredDoc->getLooks())
+    {
+        for (mx::MaterialAssignPtr assign : look->getMaterialAssigns())
+        {
+            REQUIRE(mx::geomStringsMatch(assign->getActiveGeom(), "/a/b/headlight"));
+            assignCount++;
+        }
+    }
+    REQUIRE(assignCount > 0);
+    mx::DocumentPtr filteredDomDoc = mx::createDocument();
+    mx::readFromXmlFile(filteredDomDoc, "Looks.mtlx", searchPath, &readOptions);
+    REQUIRE(*filteredDoc == *filteredDomDoc);
+
+    // Read character references and whitespace in attribute values.
+    std::string xmlString = "<?xml version=\"1.0\"?>\n"
+        "<!DOCTYPE materialx>\n"
+        "<materialx version=\"1.38\">\n"
+        "  <!-- comment -->\n"
+        "  <generic name=\"elem\" doc=\"a &lt;b&gt; &amp; &quot;c&quot; &#65;&#x42;\td\" />\n"
+        "</materialx>\n";
+    mx::DocumentPtr stringDoc = mx::createDocument();
+    mx::readFromXmlString(stringDoc, xmlString);
+    mx::DocumentPtr streamedStringDoc = mx::createDocument();
+    mx::readFromXmlBufferStreaming(streamedStringDoc, xmlString.data(), xmlString.size());
+    REQUIRE(*streamedStringDoc == *stringDoc);
+    REQUIRE(streamedStringDoc->getChild("elem")->getDocString() == "a <b> & \"c\" AB d");
+
+    // Included elements take precedence over duplicates in the document.
+    std::string includeString = "<materialx version=\"1.38\">\n"
+        "  <nodedef name=\"ND_image_color3\" node=\"local\" />\n"
+        "  <xi:include href=\"libraries/stdlib/stdlib_defs.mtlx\" />\n"
+        "</materialx>\n";
+    mx::DocumentPtr includeDoc = mx::createDocument();
+    mx::readFromXmlString(includeDoc, includeString);
+    mx::DocumentPtr streamedIncludeDoc = mx::createDocument();
+    mx::readFromXmlBufferStreaming(streamedIncludeDoc, includeString.data(), includeString.size());
+    REQUIRE(streamedIncludeDoc->getNodeDef("ND_image_color3")->getNodeString() == "image");
+    REQUIRE(*streamedIncludeDoc == *includeDoc);
+
+    // Read invalid documents.
+    mx::DocumentPtr invalidDoc = mx::createDocument();
+    for (const char* invalidString : { "<materialx><nodegraph name=\"ng\"></materialx>",
+                                       "<materialx><nodegraph name=\"ng></nodegraph></materialx>",
+                                       "<materialx>",
+                                       "<materialx><generic name=\"a\" doc=\"&#0;\" /></materialx>",
+                                       "<materialx><generic name=\"a\" doc=\"&#xD800;\" /></materialx>",
+                                       "<materialx><generic name=\"a\" doc=\"&#x110000;\" /></materialx>",
+                                       "" })
+    {
+        REQUIRE_THROWS_AS(mx::readFromXmlBufferStreaming(invalidDoc, invalidString, std::strlen(invalidString)), mx::ExceptionParseError&);
+    }
+    REQUIRE_THROWS_AS(mx::readFromXmlFileStreaming(invalidDoc, "NonExistent.mtlx"), mx::ExceptionFileMissing&);
+}
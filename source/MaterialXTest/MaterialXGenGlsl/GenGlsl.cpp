@@ -10,13 +10,22 @@
 #include <MaterialXCore/Document.h>
 
 #include <MaterialXFormat/File.h>
+#include <MaterialXFormat/Util.h>
+#include <MaterialXFormat/XmlIo.h>
 
+#include <MaterialXGenShader/Shader.h>
+#include <MaterialXGenShader/ShaderSourceCache.h>
 #include <MaterialXGenShader/TypeDesc.h>
+#include <MaterialXGenShader/Util.h>
 
 #include <MaterialXGenGlsl/GlslShaderGenerator.h>
 #include <MaterialXGenGlsl/GlslSyntax.h>
 #include <MaterialXGenGlsl/GlslResourceBindingContext.h>
 
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
 namespace mx = MaterialX;
 
 TEST_CASE("GenShader: GLSL Syntax Check", "[genglsl]")
@@ -122,6 +131,370 @@ TEST_CASE("GenShader: Bind Light Shaders", "[genglsl]")
     REQUIRE_NOTHROW(mx::HwShaderGenerator::bindLightShader(*spotLightShader, 66, context));
 }
 
+TEST_CASE("GenShader: GLSL Data Library", "[genglsl]")
+{
+    mx::FileSearchPath searchPath;
+    searchPath.append(mx::FilePath::getCurrentPath() / mx::FilePath("libraries"));
+    mx::DocumentPtr library = mx::createDocument();
+    loadLibraries({ "targets", "stdlib", "pbrlib", "bxdf" }, searchPath, library);
+
+    mx::FilePath materialPath = mx::FilePath::getCurrentPath() /
+        mx::FilePath("resources/Materials/Examples/StandardSurface/standard_surface_brass_tiled.mtlx");
+
+    // Generate with the library imported into the material document.
+    mx::DocumentPtr importedDoc = mx::createDocument();
+    mx::readFromXmlFile(importedDoc, materialPath);
+    importedDoc->importLibrary(library);
+
+    // Generate with the library referenced by the material document.
+    mx::DocumentPtr referencedDoc = mx::createDocument();
+    mx::readFromXmlFile(referencedDoc, materialPath);
+    referencedDoc->addDataLibrary(library);
+    REQUIRE(referencedDoc->getNodeDefs().empty());
+    REQUIRE(referencedDoc->getNodeDef("ND_standard_surface_surfaceshader"));
+    REQUIRE(referencedDoc->validate());
+
+    std::vector<mx::NodePtr> importedElements, referencedElements;
+    for (mx::NodePtr material : importedDoc->getMaterialNodes())
+    {
+        std::vector<mx::NodePtr> shaderNodes = mx::getShaderNodes(material);
+        importedElements.insert(importedElements.end(), shaderNodes.begin(), shaderNodes.end());
+    }
+    for (mx::NodePtr material : referencedDoc->getMaterialNodes())
+    {
+        std::vector<mx::NodePtr> shaderNodes = mx::getShaderNodes(material);
+        referencedElements.insert(referencedElements.end(), shaderNodes.begin(), shaderNodes.end());
+    }
+    REQUIRE(!importedElements.empty());
+    REQUIRE(importedElements.size() == referencedElements.size());
+
+    mx::GenContext context(mx::GlslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(searchPath);
+    for (size_t i = 0; i < importedElements.size(); i++)
+    {
+        const std::string name = importedElements[i]->getName();
+        mx::ShaderPtr importedShader = context.getShaderGenerator().generate(name, importedElements[i], context);
+        mx::ShaderPtr referencedShader = context.getShaderGenerator().generate(name, referencedElements[i], context);
+        REQUIRE(importedShader);
+        REQUIRE(referencedShader);
+        REQUIRE(importedShader->getSourceCode(mx::Stage::PIXEL) == referencedShader->getSourceCode(mx::Stage::PIXEL));
+        REQUIRE(importedShader->getSourceCode(mx::Stage::VERTEX) == referencedShader->getSourceCode(mx::Stage::VERTEX));
+    }
+}
+
+TEST_CASE("GenShader: GLSL Batch Generation", "[genglsl]")
+{
+    mx::FileSearchPath searchPath;
+    searchPath.append(mx::FilePath::getCurrentPath() / mx::FilePath("libraries"));
+    mx::DocumentPtr library = mx::createDocument();
+    loadLibraries({ "targets", "stdlib", "pbrlib", "bxdf", "lights" }, searchPath, library);
+    mx::NodeDefPtr pointLightShader = library->getNodeDef("ND_point_light");
+    REQUIRE(pointLightShader);
+
+    // Collect shader nodes from a set of example documents.
+    mx::FilePath examplesPath = mx::FilePath::getCurrentPath() /
+        mx::FilePath("resources/Materials/Examples/StandardSurface");
+    std::vector<mx::DocumentPtr> docs;
+    std::vector<mx::TypedElementPtr> elements;
+    for (const mx::FilePath& filename : examplesPath.getFilesInDirectory("mtlx"))
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::readFromXmlFile(doc, examplesPath / filename);
+        doc->importLibrary(library);
+        for (mx::NodePtr material : doc->getMaterialNodes())
+        {
+            for (mx::NodePtr shaderNode : mx::getShaderNodes(material))
+            {
+                elements.push_back(shaderNode);
+            }
+        }
+        docs.push_back(doc);
+    }
+    REQUIRE(elements.size() > 4);
+
+    for (bool verticalFlip : { false, true })
+    {
+        mx::GenContext context(mx::GlslShaderGenerator::create());
+        context.registerSourceCodeSearchPath(searchPath);
+        context.getOptions().fileTextureVerticalFlip = verticalFlip;
+
+        // Bound light shaders apply to every element of the batch.
+        mx::HwShaderGenerator::bindLightShader(*pointLightShader, 1, context);
+
+        // Generate shaders serially, each with a context of its own.
+        std::vector<mx::ShaderPtr> serialShaders;
+        for (mx::TypedElementPtr element : elements)
+        {
+            mx::GenContext serialContext(context);
+            serialShaders.push_back(context.getShaderGenerator().generate(element->getName(), element, serialContext));
+        }
+
+        // Generate the same shaders in a batch, sharing implementations.
+        std::vector<mx::ShaderPtr> batchShaders = mx::generateShaders(elements, context, 4);
+        REQUIRE(batchShaders.size() == serialShaders.size());
+        for (size_t i = 0; i < elements.size(); i++)
+        {
+            REQUIRE(batchShaders[i]);
+            REQUIRE(batchShaders[i]->getSourceCode(mx::Stage::PIXEL).find("point_light") != std::string::npos);
+            REQUIRE(batchShaders[i]->getSourceCode(mx::Stage::PIXEL) == serialShaders[i]->getSourceCode(mx::Stage::PIXEL));
+            REQUIRE(batchShaders[i]->getSourceCode(mx::Stage::VERTEX) == serialShaders[i]->getSourceCode(mx::Stage::VERTEX));
+        }
+    }
+}
+
+TEST_CASE("GenShader: GLSL Implementation Cache", "[genglsl]")
+{
+    mx::FileSearchPath searchPath;
+    searchPath.append(mx::FilePath::getCurrentPath() / mx::FilePath("libraries"));
+    mx::DocumentPtr doc = mx::createDocument();
+    loadLibraries({ "targets", "stdlib", "pbrlib", "bxdf" }, searchPath, doc);
+    mx::readFromXmlFile(doc, mx::FilePath::getCurrentPath() /
+        mx::FilePath("resources/Materials/Examples/StandardSurface/standard_surface_brass_tiled.mtlx"));
+
+    std::vector<mx::NodePtr> shaderNodes = mx::getShaderNodes(doc->getMaterialNodes()[0]);
+    REQUIRE(shaderNodes.size() == 1);
+    mx::NodePtr shaderNode = shaderNodes[0];
+
+    // Generate a reference shader without a shared cache.
+    mx::ShaderGeneratorPtr shadergen = mx::GlslShaderGenerator::create();
+    mx::GenContext refContext(shadergen);
+    refContext.registerSourceCodeSearchPath(searchPath);
+    mx::ShaderPtr refShader = shadergen->generate(shaderNode->getName(), shaderNode, refContext);
+    REQUIRE(refShader);
+
+    // Share a cache between two contexts.
+    mx::ShaderNodeImplCachePtr cache = mx::ShaderNodeImplCache::create();
+    mx::GenContext context1(shadergen);
+    context1.registerSourceCodeSearchPath(searchPath);
+    context1.setNodeImplementationCache(cache);
+    mx::ShaderPtr shader1 = shadergen->generate(shaderNode->getName(), shaderNode, context1);
+    REQUIRE(shader1->getSourceCode(mx::Stage::PIXEL) == refShader->getSourceCode(mx::Stage::PIXEL));
+    REQUIRE(cache->getMissCount() > 0);
+
+    mx::GenContext context2(shadergen);
+    context2.registerSourceCodeSearchPath(searchPath);
+    context2.setNodeImplementationCache(cache);
+    mx::ShaderPtr shader2 = shadergen->generate(shaderNode->getName(), shaderNode, context2);
+    REQUIRE(shader2->getSourceCode(mx::Stage::PIXEL) == refShader->getSourceCode(mx::Stage::PIXEL));
+    REQUIRE(shader2->getSourceCode(mx::Stage::VERTEX) == refShader->getSourceCode(mx::Stage::VERTEX));
+    REQUIRE(cache->getHitCount() > 0);
+
+    // Compound implementations are shared through the cache along with all
+    // other implementations, so the second context holds none of its own.
+    mx::StringSet cacheNames;
+    mx::StringSet contextNames;
+    cache->getNames(cacheNames);
+    context2.getNodeImplementationNames(contextNames);
+    REQUIRE(contextNames == cacheNames);
+    bool foundCompound = false;
+    for (const std::string& name : cacheNames)
+    {
+        mx::ShaderNodeImplPtr impl = context2.findNodeImplementation(name);
+        REQUIRE(impl);
+        foundCompound = foundCompound || impl->getGraph() != nullptr;
+    }
+    REQUIRE(foundCompound);
+
+    // Filename uniforms keep their original values when compounds are reused.
+    const mx::VariableBlock& refUniforms = refShader->getStage(mx::Stage::PIXEL).getUniformBlock(mx::HW::PUBLIC_UNIFORMS);
+    const mx::VariableBlock& uniforms = shader2->getStage(mx::Stage::PIXEL).getUniformBlock(mx::HW::PUBLIC_UNIFORMS);
+    REQUIRE(uniforms.size() == refUniforms.size());
+    for (size_t i = 0; i < uniforms.size(); i++)
+    {
+        REQUIRE(uniforms[i]->getName() == refUniforms[i]->getName());
+        mx::ValuePtr value = uniforms[i]->getValue();
+        mx::ValuePtr refValue = refUniforms[i]->getValue();
+        REQUIRE((value ? value->getValueString() : "") == (refValue ? refValue->getValueString() : ""));
+    }
+
+    // Share the cache across threads in a batch.
+    std::vector<mx::TypedElementPtr> elements(8, shaderNode);
+    std::vector<mx::ShaderPtr> batchShaders = mx::generateShaders(elements, context1, 4);
+    for (mx::ShaderPtr shader : batchShaders)
+    {
+        REQUIRE(shader->getSourceCode(mx::Stage::PIXEL) == refShader->getSourceCode(mx::Stage::PIXEL));
+    }
+
+    cache->resetCounters();
+    REQUIRE(cache->getHitCount() == 0);
+    REQUIRE(cache->getMissCount() == 0);
+}
+
+TEST_CASE("GenShader: GLSL Shader Source Cache", "[genglsl]")
+{
+    mx::FileSearchPath searchPath;
+    searchPath.append(mx::FilePath::getCurrentPath() / mx::FilePath("libraries"));
+    mx::DocumentPtr doc = mx::createDocument();
+    loadLibraries({ "targets", "stdlib", "pbrlib", "bxdf" }, searchPath, doc);
+    mx::readFromXmlFile(doc, mx::FilePath::getCurrentPath() /
+        mx::FilePath("resources/Materials/Examples/StandardSurface/standard_surface_brass_tiled.mtlx"));
+
+    std::vector<mx::NodePtr> shaderNodes = mx::getShaderNodes(doc->getMaterialNodes()[0]);
+    REQUIRE(shaderNodes.size() == 1);
+    mx::NodePtr shaderNode = shaderNodes[0];
+
+    mx::ShaderGeneratorPtr shadergen = mx::GlslShaderGenerator::create();
+    mx::GenContext context(shadergen);
+    context.registerSourceCodeSearchPath(searchPath);
+    mx::ShaderPtr refShader = shadergen->generate(shaderNode->getName(), shaderNode, context);
+    REQUIRE(refShader);
+
+    const mx::FilePath cachePath = mx::FilePath::getCurrentPath() / mx::FilePath("genglsl_shader_cache");
+    mx::ShaderSourceCache(cachePath).clear();
+
+    // Generate once to populate the cache, then read back identical source.
+    std::string key;
+    {
+        mx::ShaderSourceCachePtr cache = mx::ShaderSourceCache::create(cachePath);
+        REQUIRE(cache->getEntryCount() == 0);
+        mx::StringMap sources = cache->generate(shaderNode->getName(), shaderNode, context);
+        REQUIRE(cache->getMissCount() == 1);
+        REQUIRE(sources[mx::Stage::PIXEL] == refShader->getSourceCode(mx::Stage::PIXEL));
+        REQUIRE(sources[mx::Stage::VERTEX] == refShader->getSourceCode(mx::Stage::VERTEX));
+
+        mx::StringMap cachedSources = cache->generate(shaderNode->getName(), shaderNode, context);
+        REQUIRE(cache->getHitCount() == 1);
+        REQUIRE(cachedSources == sources);
+        REQUIRE(cache->getEntryCount() == 1);
+
+        // Keys depend on the options and on upstream content.
+        key = cache->computeKey(shaderNode->getName(), shaderNode, context);
+        REQUIRE(key.size() == 32);
+        mx::GenContext flipContext(context);
+        flipContext.getOptions().fileTextureVerticalFlip = true;
+        REQUIRE(cache->computeKey(shaderNode->getName(), shaderNode, flipContext) != key);
+
+        mx::DocumentPtr docCopy = doc->copy();
+        mx::NodePtr nodeCopy = docCopy->getDescendant(shaderNode->getNamePath())->asA<mx::Node>();
+        REQUIRE(cache->computeKey(shaderNode->getName(), nodeCopy, context) == key);
+        mx::NodeGraphPtr graphCopy = docCopy->getNodeGraph("NG_brass1");
+        graphCopy->getNodes()[0]->getInput("uvtiling")->setValueString("2.0, 2.0");
+        REQUIRE(cache->computeKey(shaderNode->getName(), nodeCopy, context) != key);
+
+        // Keys depend on source files at the top level of the search path.
+        const mx::FilePath topLevelFile = searchPath[0] / mx::FilePath("shader_cache_test.glsl");
+        std::ofstream(topLevelFile.asString()) << "// Shader source cache test" << std::endl;
+        std::string topLevelKey = mx::ShaderSourceCache(cachePath).computeKey(shaderNode->getName(), shaderNode, context);
+        std::remove(topLevelFile.asString().c_str());
+        REQUIRE(topLevelKey != key);
+    }
+
+    // Entries persist across cache objects.
+    {
+        mx::ShaderSourceCachePtr cache = mx::ShaderSourceCache::create(cachePath);
+        REQUIRE(cache->getEntryCount() == 1);
+        mx::StringMap sources;
+        REQUIRE(cache->find(key, sources));
+        REQUIRE(sources[mx::Stage::PIXEL] == refShader->getSourceCode(mx::Stage::PIXEL));
+
+        // Least recently used entries are evicted beyond the maximum size.
+        cache->store("entry1", { { mx::Stage::PIXEL, std::string(100, 'a') } });
+        cache->store("entry2", { { mx::Stage::PIXEL, std::string(100, 'b') } });
+        REQUIRE(cache->find("entry1", sources));
+        cache->setMaxSize(cache->getTotalSize() - 1);
+        REQUIRE(cache->getEntryCount() == 2);
+        REQUIRE(!cache->find(key, sources));
+        cache->setMaxSize(200);
+        REQUIRE(cache->getEntryCount() == 1);
+        REQUIRE(cache->find("entry1", sources));
+        REQUIRE(!cache->find("entry2", sources));
+        REQUIRE(cache->getTotalSize() <= cache->getMaxSize());
+        cache->clear();
+        REQUIRE(cache->getEntryCount() == 0);
+    }
+
+    // Concurrent writers of the same entry replace it in turn, through
+    // temporary files of their own.
+    {
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 4; i++)
+        {
+            threads.emplace_back([&cachePath, i]()
+            {
+                mx::ShaderSourceCache cache(cachePath);
+                for (int j = 0; j < 20; j++)
+                {
+                    cache.store("shared", { { mx::Stage::PIXEL, std::string(1000, (char) ('a' + i)) } });
+                }
+            });
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        mx::ShaderSourceCachePtr cache = mx::ShaderSourceCache::create(cachePath);
+        mx::StringMap sources;
+        REQUIRE(cache->find("shared", sources));
+        const std::string& source = sources[mx::Stage::PIXEL];
+        REQUIRE(source.size() == 1000);
+        REQUIRE(source == std::string(1000, source[0]));
+        cache->clear();
+    }
+}
+
+TEST_CASE("GenShader: GLSL Constant Folding", "[genglsl]")
+{
+    mx::FileSearchPath searchPath;
+    searchPath.append(mx::FilePath::getCurrentPath() / mx::FilePath("libraries"));
+    mx::DocumentPtr doc = mx::createDocument();
+    loadLibraries({ "targets", "stdlib" }, searchPath, doc);
+
+    // Build a graph with a chain of nodes on constant inputs,
+    // feeding a node with a geometric input.
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("NG_fold");
+    mx::NodePtr constant = nodeGraph->addNode("constant", "constant1", "float");
+    constant->setInputValue("value", 2.0f);
+    mx::NodePtr multiply = nodeGraph->addNode("multiply", "multiply1", "float");
+    multiply->setConnectedNode("in1", constant);
+    multiply->setInputValue("in2", 3.0f);
+    mx::NodePtr convert = nodeGraph->addNode("convert", "convert1", "color3");
+    convert->setConnectedNode("in", multiply);
+    mx::NodePtr swizzle = nodeGraph->addNode("swizzle", "swizzle1", "vector2");
+    swizzle->setConnectedNode("in", convert);
+    swizzle->setInputValue("channels", std::string("r1"));
+    mx::NodePtr texcoord = nodeGraph->addNode("texcoord", "texcoord1", "vector2");
+    mx::NodePtr add = nodeGraph->addNode("add", "add1", "vector2");
+    add->setConnectedNode("in1", texcoord);
+    add->setConnectedNode("in2", swizzle);
+    mx::OutputPtr output = nodeGraph->addOutput("out", "vector2");
+    output->setConnectedNode(add);
+
+    mx::ShaderGeneratorPtr shadergen = mx::GlslShaderGenerator::create();
+    mx::GenContext context(shadergen);
+    context.registerSourceCodeSearchPath(searchPath);
+
+    // Nodes are folded with a reduced interface.
+    context.getOptions().shaderInterfaceType = mx::SHADER_INTERFACE_REDUCED;
+    mx::ShaderPtr shader = shadergen->generate("fold", output, context);
+    REQUIRE(shader);
+    const mx::ShaderGraph& graph = shader->getGraph();
+    REQUIRE(graph.getFoldedNodes() == mx::StringVec({ "multiply1", "convert1", "swizzle1" }));
+    REQUIRE(graph.getNodes().size() == 2);
+    const mx::ShaderNode* addNode = graph.getNode("add1");
+    REQUIRE(addNode);
+    REQUIRE(!addNode->getInput("in2")->getConnection());
+    REQUIRE(addNode->getInput("in2")->getValue()->asA<mx::Vector2>() == mx::Vector2(6.0f, 1.0f));
+    const std::string& pixelSource = shader->getSourceCode(mx::Stage::PIXEL);
+    REQUIRE(pixelSource.find("multiply1") == std::string::npos);
+    REQUIRE(pixelSource.find("vec2(6.000000, 1.000000)") != std::string::npos);
+
+    // Nodes with non-constant or invalid inputs are not folded.
+    multiply->setInputValue("in2", 0.0f);
+    mx::NodePtr divide = nodeGraph->addNode("divide", "divide1", "float");
+    divide->setInputValue("in1", 1.0f);
+    divide->setConnectedNode("in2", multiply);
+    convert->setConnectedNode("in", divide);
+    shader = shadergen->generate("fold", output, context);
+    REQUIRE(shader->getGraph().getFoldedNodes() == mx::StringVec({ "multiply1" }));
+    REQUIRE(shader->getGraph().getNode("divide1"));
+
+    // Nodes are not folded with a complete interface.
+    context.getOptions().shaderInterfaceType = mx::SHADER_INTERFACE_COMPLETE;
+    shader = shadergen->generate("fold", output, context);
+    REQUIRE(shader->getGraph().getFoldedNodes().empty());
+    REQUIRE(shader->getGraph().getNode("multiply1"));
+}
+
 static void generateGlslCode(bool generateLayout = false)
 {
     const mx::FilePath testRootPath = mx::FilePath::getCurrentPath() / mx::FilePath("resources/Materials/TestSuite");
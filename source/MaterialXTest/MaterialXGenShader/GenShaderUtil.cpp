@@ -336,7 +336,7 @@ void ShaderGeneratorTester::checkImplementationUsage(const mx::StringSet& usedIm
 {
     // Get list of implementations for a given target.
     std::set<mx::ImplementationPtr> targetImpls;
-    const std::vector<mx::ElementPtr>& children = _dependLib->getChildren();
+    const mx::ElementVec& children = _dependLib->getChildren();
     for (const auto& child : children)
     {
         mx::ImplementationPtr impl = child->asA<mx::Implementation>();
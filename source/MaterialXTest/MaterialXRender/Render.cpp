@@ -6,6 +6,12 @@
 #include <MaterialXTest/Catch/catch.hpp>
 #include <MaterialXTest/MaterialXRender/RenderUtil.h>
 
+#include <MaterialXFormat/Util.h>
+
+#include <MaterialXRender/CpuBakeScheduler.h>
+#include <MaterialXRender/CpuEvaluator.h>
+#include <MaterialXRender/CpuKernels.h>
+#include <MaterialXRender/CpuTextureBaker.h>
 #include <MaterialXRender/ShaderRenderer.h>
 #include <MaterialXRender/StbImageLoader.h>
 #include <MaterialXRender/TinyObjLoader.h>
@@ -14,13 +20,21 @@
 #ifdef MATERIALX_BUILD_OIIO
 #include <MaterialXRender/OiioImageLoader.h>
 #endif
+#ifdef MATERIALX_BUILD_GEN_GLSL
+#include <MaterialXGenGlsl/GlslShaderGenerator.h>
+#endif
 #ifdef MATERIALX_BUILD_CONTRIB
 #include <MaterialXContrib/Handlers/TinyEXRImageLoader.h>
 #endif
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <limits>
+#include <random>
 #include <unordered_set>
 
 namespace mx = MaterialX;
@@ -55,6 +69,143 @@ TEST_CASE("Render: Half Float", "[rendercore]")
     }
 }
 
+TEST_CASE("Render: CPU Kernel Instruction Sets", "[rendercore]")
+{
+    const std::vector<std::string> categories =
+    {
+        "add", "subtract", "multiply", "divide", "modulo", "invert", "min", "max",
+        "absval", "floor", "ceil", "sqrt", "sign", "clamp", "mix", "smoothstep", "remap",
+        "dotproduct", "magnitude", "normalize", "crossproduct",
+        "ifgreater", "ifgreatereq", "ifequal",
+        "plus", "minus", "difference", "screen", "overlay", "burn", "dodge", "inside", "outside",
+        "over", "in", "out", "mask", "matte", "disjointover", "premult", "unpremult",
+        "luminance", "rgbtohsv", "hsvtorgb", "image",
+        "noise2d", "noise3d", "fractal3d", "cellnoise2d", "cellnoise3d"
+    };
+    const std::vector<mx::CpuInstructionSet> instructionSets =
+    {
+        mx::CpuInstructionSet::SSE4,
+        mx::CpuInstructionSet::AVX2,
+        mx::CpuInstructionSet::AVX512
+    };
+
+    // Process a count of samples that is not a multiple of any vector width.
+    const size_t STRIDE = 4 * mx::CpuKernelArgs::BATCH_ALIGNMENT;
+    const size_t COUNT = STRIDE - 11;
+
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<float> distribution(-4.0f, 4.0f);
+
+    mx::ImagePtr image = mx::Image::create(16, 8, 4, mx::Image::BaseType::FLOAT);
+    image->createResourceBuffer();
+    for (unsigned int y = 0; y < image->getHeight(); y++)
+    {
+        for (unsigned int x = 0; x < image->getWidth(); x++)
+        {
+            image->setTexelColor(x, y, mx::Color4(distribution(generator), distribution(generator),
+                                                  distribution(generator), distribution(generator)));
+        }
+    }
+
+    // Image nodes are compared with each address mode and filter type.
+    std::vector<mx::CpuKernelParams> imageParams(4);
+    const mx::ImageSamplingProperties::AddressMode addressModes[] =
+    {
+        mx::ImageSamplingProperties::AddressMode::PERIODIC,
+        mx::ImageSamplingProperties::AddressMode::CLAMP,
+        mx::ImageSamplingProperties::AddressMode::MIRROR,
+        mx::ImageSamplingProperties::AddressMode::CONSTANT
+    };
+    for (size_t k = 0; k < imageParams.size(); k++)
+    {
+        imageParams[k].image = image;
+        imageParams[k].samplingProperties.uaddressMode = addressModes[k];
+        imageParams[k].samplingProperties.vaddressMode = addressModes[(k + 1) % 4];
+        imageParams[k].samplingProperties.filterType = k == 1 ? mx::ImageSamplingProperties::FilterType::CLOSEST :
+                                                                mx::ImageSamplingProperties::FilterType::LINEAR;
+        imageParams[k].verticalFlip = k % 2 == 0;
+    }
+
+    auto runKernel = [&](mx::CpuKernel kernel, const std::vector<std::vector<float>>& inputs, size_t size, const mx::CpuKernelParams& params)
+    {
+        std::vector<float> output(4 * STRIDE, 0.0f);
+        mx::CpuKernelArgs args;
+        args.count = COUNT;
+        args.stride = STRIDE;
+        args.params = &params;
+        for (const std::vector<float>& input : inputs)
+        {
+            args.inputs.push_back(input.data());
+            args.inputSizes.push_back(size);
+        }
+        args.outputs.push_back(output.data());
+        args.outputSizes.push_back(size);
+        kernel(args);
+        return output;
+    };
+
+    for (mx::CpuInstructionSet instructionSet : instructionSets)
+    {
+        if (!mx::isCpuInstructionSetSupported(instructionSet))
+        {
+            continue;
+        }
+        for (const std::string& category : categories)
+        {
+            const mx::CpuKernelDef* scalarDef = mx::getCpuKernelDef(category, mx::CpuInstructionSet::SCALAR);
+            const mx::CpuKernelDef* vectorDef = mx::getCpuKernelDef(category, instructionSet);
+            REQUIRE(scalarDef);
+            REQUIRE(vectorDef);
+            REQUIRE(vectorDef->kernel != scalarDef->kernel);
+
+            const std::vector<mx::CpuKernelParams> paramsList = category == "image" ? imageParams : std::vector<mx::CpuKernelParams>(1);
+            for (const mx::CpuKernelParams& params : paramsList)
+            {
+                for (size_t size : { 1, 3, 4 })
+                {
+                    std::vector<std::vector<float>> inputs;
+                    for (const std::string& name : scalarDef->inputs)
+                    {
+                        std::vector<float> input(4 * STRIDE);
+                        for (float& value : input)
+                        {
+                            value = name == "octaves" ? (float) (generator() % 5) : distribution(generator);
+                        }
+                        inputs.push_back(input);
+                    }
+
+                    const std::vector<float> expected = runKernel(scalarDef->kernel, inputs, size, params);
+                    const std::vector<float> result = runKernel(vectorDef->kernel, inputs, size, params);
+                    size_t mismatches = 0;
+                    for (size_t c = 0; c < size; c++)
+                    {
+                        for (size_t i = 0; i < COUNT; i++)
+                        {
+                            const float a = expected[c * STRIDE + i];
+                            const float b = result[c * STRIDE + i];
+                            const bool match = (std::isnan(a) && std::isnan(b)) || a == b ||
+                                               std::abs(a - b) <= 1e-5f * std::max(1.0f, std::abs(a));
+                            if (!match)
+                            {
+                                mismatches++;
+                            }
+                        }
+                    }
+                    INFO(category + " " + mx::getCpuInstructionSetName(instructionSet) + " size " + std::to_string(size));
+                    CHECK(mismatches == 0);
+                }
+            }
+        }
+    }
+
+    // Kernels without a vectorized version fall back to the scalar kernel.
+    REQUIRE(mx::getCpuKernelDef("sin", mx::CpuInstructionSet::AVX512)->kernel ==
+            mx::getCpuKernelDef("sin", mx::CpuInstructionSet::SCALAR)->kernel);
+    REQUIRE(mx::getCpuKernelDef("sin") != nullptr);
+    REQUIRE(mx::getCpuKernelDef("unknown", mx::CpuInstructionSet::AVX2) == nullptr);
+    REQUIRE(mx::isCpuInstructionSetSupported(mx::getCpuInstructionSet()));
+}
+
 struct GeomHandlerTestOptions
 {
     mx::GeometryHandlerPtr geomHandler;
@@ -94,6 +245,528 @@ void testGeomHandler(GeomHandlerTestOptions& options)
     CHECK(loadFailed == 0);
 }
 
+#ifdef MATERIALX_BUILD_GEN_GLSL
+TEST_CASE("Render: CPU Evaluator", "[rendercore]")
+{
+    mx::FileSearchPath searchPath;
+    searchPath.append(mx::FilePath::getCurrentPath() / mx::FilePath("libraries"));
+    mx::DocumentPtr doc = mx::createDocument();
+    loadLibraries({ "targets", "stdlib", "pbrlib" }, searchPath, doc);
+
+    mx::GenContext context(mx::GlslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(searchPath);
+
+    mx::CpuSamples samples;
+    for (int y = 0; y < 20; y++)
+    {
+        for (int x = 0; x < 30; x++)
+        {
+            samples.texcoords.push_back(mx::Vector2((x + 0.5f) / 30.0f, (y + 0.5f) / 20.0f));
+            samples.positions.push_back(mx::Vector3((float) x, (float) y, 0.5f));
+        }
+    }
+    mx::CpuEvaluatorPtr evaluator = mx::CpuEvaluator::create();
+    std::vector<float> result;
+
+    // Math nodes on geometric inputs, with and without folding of the
+    // constant branch.
+    mx::NodeGraphPtr mathGraph = doc->addNodeGraph("NG_math");
+    mx::NodePtr texcoord = mathGraph->addNode("texcoord", "texcoord1", "vector2");
+    mx::NodePtr constant = mathGraph->addNode("constant", "constant1", "float");
+    constant->setInputValue("value", 0.25f);
+    mx::NodePtr multiply = mathGraph->addNode("multiply", "multiply1", "vector2");
+    multiply->setConnectedNode("in1", texcoord);
+    multiply->setInputValue("in2", mx::Vector2(2.0f, 3.0f));
+    mx::NodePtr add = mathGraph->addNode("add", "add1", "vector2");
+    add->setConnectedNode("in1", multiply);
+    add->setConnectedNode("in2", constant);
+    mx::NodePtr swizzle = mathGraph->addNode("swizzle", "swizzle1", "color3");
+    swizzle->setConnectedNode("in", add);
+    swizzle->setInputValue("channels", std::string("yx1"));
+    mx::OutputPtr mathOutput = mathGraph->addOutput("out", "color3");
+    mathOutput->setConnectedNode(swizzle);
+    for (mx::ShaderInterfaceType interfaceType : { mx::SHADER_INTERFACE_COMPLETE, mx::SHADER_INTERFACE_REDUCED })
+    {
+        context.getOptions().shaderInterfaceType = interfaceType;
+        evaluator->compile(mathOutput, context);
+        REQUIRE(evaluator->getOutputType() == mx::Type::COLOR3);
+        evaluator->evaluate(samples, result);
+        REQUIRE(result.size() == samples.size() * 3);
+        for (size_t i = 0; i < samples.size(); i++)
+        {
+            const mx::Vector2& uv = samples.texcoords[i];
+            REQUIRE(result[i * 3] == Approx(uv[1] * 3.0f + 0.25f));
+            REQUIRE(result[i * 3 + 1] == Approx(uv[0] * 2.0f + 0.25f));
+            REQUIRE(result[i * 3 + 2] == 1.0f);
+        }
+    }
+
+    // Image lookups through a node implemented as a graph, sampled at
+    // texel centers.
+    mx::ImageHandlerPtr imageHandler = mx::ImageHandler::create(mx::StbImageLoader::create());
+    imageHandler->setSearchPath(mx::FileSearchPath(mx::FilePath::getCurrentPath() / mx::FilePath("resources/Images")));
+    evaluator->setImageHandler(imageHandler);
+    mx::ImagePtr image = imageHandler->acquireImage("grid.png");
+    REQUIRE(image->getWidth() > 1);
+    mx::CpuSamples texelSamples;
+    for (unsigned int y = 0; y < image->getHeight(); y += 37)
+    {
+        for (unsigned int x = 0; x < image->getWidth(); x += 41)
+        {
+            texelSamples.texcoords.push_back(mx::Vector2((x + 0.5f) / image->getWidth(), (y + 0.5f) / image->getHeight()));
+        }
+    }
+    mx::NodeGraphPtr imageGraph = doc->addNodeGraph("NG_image");
+    mx::NodePtr tiledImage = imageGraph->addNode("tiledimage", "tiledimage1", "color3");
+    tiledImage->setInputValue("file", std::string("grid.png"), mx::FILENAME_TYPE_STRING);
+    mx::OutputPtr imageOutput = imageGraph->addOutput("out", "color3");
+    imageOutput->setConnectedNode(tiledImage);
+    evaluator->compile(imageOutput, context);
+    evaluator->evaluate(texelSamples, result);
+    for (size_t i = 0; i < texelSamples.size(); i++)
+    {
+        const mx::Vector2& uv = texelSamples.texcoords[i];
+        const mx::Color4 texel = image->getTexelColor((unsigned int) (uv[0] * image->getWidth()), (unsigned int) (uv[1] * image->getHeight()));
+        for (size_t c = 0; c < 3; c++)
+        {
+            REQUIRE(std::abs(result[i * 3 + c] - texel[c]) < 1e-5f);
+        }
+    }
+
+    // Gradient noise vanishes at lattice points, and cell noise is
+    // constant within a cell.
+    mx::NodeGraphPtr noiseGraph = doc->addNodeGraph("NG_noise");
+    mx::NodePtr position = noiseGraph->addNode("position", "position1", "vector3");
+    mx::NodePtr noise = noiseGraph->addNode("noise3d", "noise3d1", "float");
+    noise->setInputValue("pivot", 0.5f);
+    noise->setConnectedNode("position", position);
+    mx::NodePtr cellNoise = noiseGraph->addNode("cellnoise3d", "cellnoise3d1", "float");
+    cellNoise->setConnectedNode("position", position);
+    mx::NodePtr combine = noiseGraph->addNode("combine2", "combine1", "vector2");
+    combine->setConnectedNode("in1", noise);
+    combine->setConnectedNode("in2", cellNoise);
+    mx::OutputPtr noiseOutput = noiseGraph->addOutput("out", "vector2");
+    noiseOutput->setConnectedNode(combine);
+    evaluator->compile(noiseOutput, context);
+    mx::CpuSamples latticeSamples;
+    for (int i = -3; i < 3; i++)
+    {
+        latticeSamples.positions.push_back(mx::Vector3((float) i, (float) (2 * i), 5.0f));
+        latticeSamples.positions.push_back(mx::Vector3(i + 0.25f, 2 * i + 0.25f, 5.25f));
+        latticeSamples.positions.push_back(mx::Vector3(i + 0.75f, 2 * i + 0.5f, 5.75f));
+    }
+    evaluator->evaluate(latticeSamples, result);
+    for (size_t i = 0; i < latticeSamples.size(); i += 3)
+    {
+        REQUIRE(result[i * 2] == Approx(0.5f));
+        REQUIRE(result[(i + 1) * 2 + 1] >= 0.0f);
+        REQUIRE(result[(i + 1) * 2 + 1] <= 1.0f);
+        REQUIRE(result[(i + 1) * 2 + 1] == result[(i + 2) * 2 + 1]);
+    }
+
+    // Batches of varying size give identical results.
+    std::vector<float> sampleResult;
+    samples.resize(mx::CpuEvaluator::BATCH_SIZE * 2 + 17);
+    evaluator->evaluate(samples, result);
+    REQUIRE(result.size() == samples.size() * 2);
+    for (size_t i = 0; i < samples.size(); i += 101)
+    {
+        mx::CpuSamples single;
+        single.positions.push_back(samples.positions[i]);
+        evaluator->evaluate(single, sampleResult);
+        REQUIRE(sampleResult[0] == result[i * 2]);
+        REQUIRE(sampleResult[1] == result[i * 2 + 1]);
+    }
+
+    // Transforms between equivalent spaces leave their input unchanged,
+    // while transforms to the world space cannot be evaluated.
+    mx::NodeGraphPtr transformGraph = doc->addNodeGraph("NG_transform");
+    mx::NodePtr transformPosition = transformGraph->addNode("position", "position1", "vector3");
+    mx::NodePtr transform = transformGraph->addNode("transformpoint", "transformpoint1", "vector3");
+    transform->setConnectedNode("in", transformPosition);
+    transform->setInputValue("fromspace", std::string("model"));
+    transform->setInputValue("tospace", std::string("object"));
+    mx::OutputPtr transformOutput = transformGraph->addOutput("out", "vector3");
+    transformOutput->setConnectedNode(transform);
+    evaluator->compile(transformOutput, context);
+    evaluator->evaluate(latticeSamples, result);
+    for (size_t i = 0; i < latticeSamples.size(); i++)
+    {
+        for (size_t c = 0; c < 3; c++)
+        {
+            REQUIRE(result[i * 3 + c] == latticeSamples.positions[i][c]);
+        }
+    }
+    transform->setInputValue("tospace", std::string("world"));
+    REQUIRE_THROWS_AS(evaluator->compile(transformOutput, context), mx::ExceptionRenderError&);
+
+    // Nodes without a CPU kernel and shading nodes cannot be evaluated.
+    mx::NodePtr blur = doc->addNode("blur", "blur1", "float");
+    REQUIRE_THROWS_AS(evaluator->compile(blur, context), mx::ExceptionRenderError&);
+    REQUIRE(!evaluator->getOutputType());
+    mx::NodePtr bsdf = doc->addNode("oren_nayar_diffuse_bsdf", "bsdf1", "BSDF");
+    REQUIRE_THROWS_AS(evaluator->compile(bsdf, context), mx::ExceptionRenderError&);
+    REQUIRE(!evaluator->getOutputType());
+
+    // Color transforms inserted by color management, which have no node
+    // definition, are evaluated by the kernels of their source spaces.
+    mx::DefaultColorManagementSystemPtr cms = mx::DefaultColorManagementSystem::create(context.getShaderGenerator().getTarget());
+    cms->loadLibrary(doc);
+    context.getShaderGenerator().setColorManagementSystem(cms);
+    context.getOptions().targetColorSpaceOverride = "lin_rec709";
+    mx::NodeGraphPtr colorGraph = doc->addNodeGraph("NG_color");
+    mx::NodePtr colorImage = colorGraph->addNode("image", "image1", "color3");
+    colorImage->setInputValue("file", std::string("grid.png"), mx::FILENAME_TYPE_STRING);
+    colorImage->getInput("file")->setColorSpace("srgb_texture");
+    mx::OutputPtr colorOutput = colorGraph->addOutput("out", "color3");
+    colorOutput->setConnectedNode(colorImage);
+    for (mx::ShaderInterfaceType interfaceType : { mx::SHADER_INTERFACE_COMPLETE, mx::SHADER_INTERFACE_REDUCED })
+    {
+        context.getOptions().shaderInterfaceType = interfaceType;
+        evaluator->compile(colorOutput, context);
+        evaluator->evaluate(texelSamples, result);
+        bool transformed = false;
+        for (size_t i = 0; i < texelSamples.size(); i++)
+        {
+            const mx::Vector2& uv = texelSamples.texcoords[i];
+            const mx::Color4 texel = image->getTexelColor((unsigned int) (uv[0] * image->getWidth()), (unsigned int) (uv[1] * image->getHeight()));
+            for (size_t c = 0; c < 3; c++)
+            {
+                const float linear = texel[c] <= 0.04045f ? texel[c] / 12.92f : std::pow((texel[c] + 0.055f) / 1.055f, 2.4f);
+                REQUIRE(std::abs(result[i * 3 + c] - linear) < 1e-4f);
+                transformed = transformed || std::abs(linear - texel[c]) > 0.01f;
+            }
+        }
+        REQUIRE(transformed);
+    }
+
+    // Each source space of the default color management system maps to a
+    // kernel.  The primaries of these spaces leave gray values gray, so a
+    // gray constant is transformed by the transfer function alone.
+    const std::vector<std::pair<std::string, float>> TRANSFER_GAMMAS =
+    {
+        { "gamma18", 1.8f },
+        { "gamma22", 2.2f },
+        { "gamma24", 2.4f },
+        { "acescg", 1.0f },
+        { "g22_ap1", 2.2f }
+    };
+    context.getOptions().shaderInterfaceType = mx::SHADER_INTERFACE_COMPLETE;
+    mx::CpuSamples graySamples;
+    graySamples.resize(1);
+    for (const auto& pair : TRANSFER_GAMMAS)
+    {
+        for (const std::string type : { "color3", "color4" })
+        {
+            mx::NodeGraphPtr grayGraph = doc->addNodeGraph();
+            mx::NodePtr gray = grayGraph->addNode("constant", "constant1", type);
+            mx::InputPtr grayValue = gray->addInput("value", type);
+            grayValue->setValueString(type == "color3" ? "0.5, 0.5, 0.5" : "0.5, 0.5, 0.5, 0.25");
+            grayValue->setColorSpace(pair.first);
+            mx::OutputPtr grayOutput = grayGraph->addOutput("out", type);
+            grayOutput->setConnectedNode(gray);
+            evaluator->compile(grayOutput, context);
+            evaluator->evaluate(graySamples, result);
+            const float expected = std::pow(0.5f, pair.second);
+            for (size_t c = 0; c < 3; c++)
+            {
+                REQUIRE(result[c] == Approx(expected).epsilon(1e-4));
+            }
+            if (type == "color4")
+            {
+                REQUIRE(result[3] == Approx(0.25f));
+            }
+            doc->removeNodeGraph(grayGraph->getName());
+        }
+    }
+}
+
+TEST_CASE("Render: CPU Texture Baker", "[rendercore]")
+{
+    mx::FileSearchPath searchPath(mx::FilePath::getCurrentPath());
+    mx::DocumentPtr doc = mx::createDocument();
+    loadLibraries({ "targets", "stdlib", "pbrlib", "bxdf" }, mx::FileSearchPath(mx::FilePath::getCurrentPath() / mx::FilePath("libraries")), doc);
+
+    // A material with a varying color, a uniform roughness, and a uniform
+    // metalness at its default value.
+    mx::NodeGraphPtr graph = doc->addNodeGraph("NG_procedural");
+    mx::NodePtr ramp = graph->addNode("ramplr", "ramplr1", "color3");
+    ramp->setInputValue("valuel", mx::Color3(0.0f, 0.2f, 0.4f));
+    ramp->setInputValue("valuer", mx::Color3(1.0f, 0.6f, 0.2f));
+    mx::OutputPtr colorOutput = graph->addOutput("color_out", "color3");
+    colorOutput->setConnectedNode(ramp);
+    mx::NodePtr roughness = graph->addNode("constant", "roughness1", "float");
+    roughness->setInputValue("value", 0.6f);
+    mx::OutputPtr roughnessOutput = graph->addOutput("roughness_out", "float");
+    roughnessOutput->setConnectedNode(roughness);
+    mx::NodePtr metalness = graph->addNode("constant", "metalness1", "float");
+    metalness->setInputValue("value", 0.0f);
+    mx::OutputPtr metalnessOutput = graph->addOutput("metalness_out", "float");
+    metalnessOutput->setConnectedNode(metalness);
+    mx::NodePtr shader = doc->addNode("standard_surface", "SR_procedural", "surfaceshader");
+    shader->addInput("base_color", "color3")->setConnectedOutput(colorOutput);
+    shader->addInput("specular_roughness", "float")->setConnectedOutput(roughnessOutput);
+    shader->addInput("metalness", "float")->setConnectedOutput(metalnessOutput);
+    mx::NodePtr material = doc->addMaterialNode("M_procedural", shader);
+
+    const unsigned int WIDTH = 67;
+    const unsigned int HEIGHT = 37;
+    RenderUtil::ScopedOutputDirectory outputDirectory(mx::FilePath::getCurrentPath() / mx::FilePath("cpuBake"));
+    const mx::FilePath& outputPath = outputDirectory.getPath();
+
+    // Baking with one or many threads, and with a minimal memory budget,
+    // gives identical results.
+    std::vector<mx::ImagePtr> bakedImages;
+    for (size_t threadCount : { 1, 0 })
+    {
+        mx::CpuTextureBakerPtr baker = mx::CpuTextureBaker::create(WIDTH, HEIGHT, mx::Image::BaseType::UINT8);
+        REQUIRE_THROWS_AS(baker->createBakeDocuments(doc, searchPath), mx::ExceptionRenderError&);
+        baker->setShaderGenerator(mx::GlslShaderGenerator::create());
+        baker->setThreadCount(threadCount);
+        baker->setTileSize(threadCount == 1 ? 64 : 16);
+        baker->setMemoryBudget(threadCount == 1 ? 0 : 1);
+        baker->setOutputStream(nullptr);
+        baker->setOutputImagePath(outputPath);
+        mx::BakedDocumentVec bakedDocuments = baker->createBakeDocuments(doc, searchPath);
+        REQUIRE(bakedDocuments.size() == 1);
+        mx::DocumentPtr bakedDoc = bakedDocuments[0].second;
+        REQUIRE(bakedDoc->validate());
+
+        mx::NodePtr bakedShader = bakedDoc->getNode("SR_procedural_baked");
+        REQUIRE(bakedShader);
+        REQUIRE(bakedDoc->getNode("M_procedural_baked"));
+        REQUIRE(bakedShader->getInput("specular_roughness")->getValueString() == "0.6");
+        REQUIRE(!bakedShader->getInput("metalness"));
+        mx::OutputPtr bakedOutput = bakedShader->getInput("base_color")->getConnectedOutput();
+        REQUIRE(bakedOutput);
+        mx::NodePtr bakedImage = bakedOutput->getConnectedNode();
+        REQUIRE(bakedImage->getCategory() == "image");
+
+        mx::ImageHandlerPtr imageHandler = mx::ImageHandler::create(mx::StbImageLoader::create());
+        imageHandler->setSearchPath(mx::FileSearchPath(outputPath));
+        mx::ImagePtr image = imageHandler->acquireImage(bakedImage->getInputValue("file")->getValueString());
+        REQUIRE(image->getWidth() == WIDTH);
+        REQUIRE(image->getHeight() == HEIGHT);
+        bakedImages.push_back(image);
+    }
+    for (unsigned int y = 0; y < HEIGHT; y++)
+    {
+        for (unsigned int x = 0; x < WIDTH; x++)
+        {
+            REQUIRE(bakedImages[0]->getTexelColor(x, y) == bakedImages[1]->getTexelColor(x, y));
+        }
+    }
+
+    // Baked colors are encoded in sRGB, and vary along the ramp.
+    const float u = 0.5f / WIDTH;
+    const float expected = 1.055f * std::pow(0.2f + 0.4f * u, 1.0f / 2.4f) - 0.055f;
+    REQUIRE(std::abs(bakedImages[0]->getTexelColor(0, 0)[1] - expected) < 1.0f / 255.0f);
+    REQUIRE(bakedImages[0]->getTexelColor(WIDTH - 1, 0)[0] > 0.99f);
+
+    // Each UDIM is baked to its own image.
+    doc->addGeomInfo("GI_udim")->setGeomPropValue("udimset", mx::StringVec{ "1001", "1002" }, "stringarray");
+    mx::CpuTextureBakerPtr baker = mx::CpuTextureBaker::create(WIDTH, HEIGHT, mx::Image::BaseType::UINT8);
+    baker->setShaderGenerator(mx::GlslShaderGenerator::create());
+    baker->setOutputStream(nullptr);
+    baker->setOutputImagePath(outputPath);
+    mx::BakedDocumentVec bakedDocuments = baker->createBakeDocuments(doc, searchPath);
+    REQUIRE(bakedDocuments.size() == 1);
+    mx::DocumentPtr bakedDoc = bakedDocuments[0].second;
+    REQUIRE(bakedDoc->getGeomInfo("GI_baked"));
+    mx::NodePtr bakedImage = bakedDoc->getNode("SR_procedural_baked")->getInput("base_color")->getConnectedOutput()->getConnectedNode();
+    const std::string udimFilename = bakedImage->getInputValue("file")->getValueString();
+    REQUIRE(udimFilename.find(mx::UDIM_TOKEN) != std::string::npos);
+    for (const std::string udim : { "1001", "1002" })
+    {
+        mx::FilePath filename = outputPath / mx::FilePath(mx::replaceSubstrings(udimFilename, { { mx::UDIM_TOKEN, udim } }));
+        REQUIRE(filename.exists());
+    }
+
+    // Images in sRGB are transformed to linear values for evaluation, and
+    // back to sRGB for storage.
+    doc->removeGeomInfo("GI_udim");
+    mx::NodePtr image = graph->addNode("image", "image1", "color3");
+    image->setInputValue("file", std::string("resources/Images/grid.png"), mx::FILENAME_TYPE_STRING);
+    image->getInput("file")->setColorSpace("srgb_texture");
+    colorOutput->setConnectedNode(image);
+    mx::ImageHandlerPtr imageHandler = mx::ImageHandler::create(mx::StbImageLoader::create());
+    imageHandler->setSearchPath(searchPath);
+    mx::ImagePtr sourceImage = imageHandler->acquireImage("resources/Images/grid.png");
+    baker = mx::CpuTextureBaker::create(sourceImage->getWidth(), sourceImage->getHeight(), mx::Image::BaseType::UINT8);
+    baker->setShaderGenerator(mx::GlslShaderGenerator::create());
+    baker->setOutputStream(nullptr);
+    baker->setOutputImagePath(outputPath);
+    bakedDoc = baker->createBakeDocuments(doc, searchPath)[0].second;
+    bakedImage = bakedDoc->getNode("SR_procedural_baked")->getInput("base_color")->getConnectedOutput()->getConnectedNode();
+    imageHandler->setSearchPath(mx::FileSearchPath(outputPath));
+    mx::ImagePtr roundTripImage = imageHandler->acquireImage(bakedImage->getInputValue("file")->getValueString());
+    for (unsigned int y = 0; y < sourceImage->getHeight(); y += 13)
+    {
+        for (unsigned int x = 0; x < sourceImage->getWidth(); x += 11)
+        {
+            const mx::Color4 sourceColor = sourceImage->getTexelColor(x, y);
+            const mx::Color4 roundTripColor = roundTripImage->getTexelColor(x, y);
+            for (size_t c = 0; c < 3; c++)
+            {
+                REQUIRE(std::abs(sourceColor[c] - roundTripColor[c]) < 1.5f / 255.0f);
+            }
+        }
+    }
+}
+
+TEST_CASE("Render: CPU Bake Scheduler", "[rendercore]")
+{
+    mx::FileSearchPath searchPath;
+    searchPath.append(mx::FilePath::getCurrentPath() / mx::FilePath("libraries"));
+    mx::DocumentPtr doc = mx::createDocument();
+    loadLibraries({ "targets", "stdlib" }, searchPath, doc);
+
+    mx::GenContext context(mx::GlslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(searchPath);
+
+    // A varying output of high entropy, and a uniform output.
+    mx::NodeGraphPtr graph = doc->addNodeGraph("NG_schedule");
+    mx::NodePtr position = graph->addNode("position", "position1", "vector3");
+    mx::NodePtr scale = graph->addNode("multiply", "multiply1", "vector3");
+    scale->setConnectedNode("in1", position);
+    scale->setInputValue("in2", mx::Vector3(5.0f, 5.0f, 5.0f));
+    mx::NodePtr noise = graph->addNode("noise3d", "noise3d1", "color3");
+    noise->setInputValue("pivot", 0.5f);
+    noise->setConnectedNode("position", scale);
+    mx::OutputPtr varyingOutput = graph->addOutput("varying_out", "color3");
+    varyingOutput->setConnectedNode(noise);
+    mx::NodePtr constant = graph->addNode("constant", "constant1", "color3");
+    constant->setInputValue("value", mx::Color3(0.25f, 0.5f, 0.75f));
+    mx::OutputPtr uniformOutput = graph->addOutput("uniform_out", "color3");
+    uniformOutput->setConnectedNode(constant);
+
+    mx::CpuEvaluatorPtr varying = mx::CpuEvaluator::create();
+    varying->compile(varyingOutput, context);
+    mx::CpuEvaluatorPtr uniform = mx::CpuEvaluator::create();
+    uniform->compile(uniformOutput, context);
+
+    const unsigned int WIDTH = 150;
+    const unsigned int HEIGHT = 97;
+    RenderUtil::ScopedOutputDirectory outputDirectory(mx::FilePath::getCurrentPath() / mx::FilePath("cpuBakeScheduler"));
+    const mx::FilePath& outputPath = outputDirectory.getPath();
+    mx::ImageHandlerPtr imageHandler = mx::ImageHandler::create(mx::StbImageLoader::create());
+    imageHandler->setSearchPath(mx::FileSearchPath(outputPath));
+
+    // With an unlimited budget, images are saved through the image handler,
+    // and uniform images are not written.
+    mx::CpuBakeSchedulerPtr scheduler = mx::CpuBakeScheduler::create(WIDTH, HEIGHT, mx::Image::BaseType::UINT8);
+    scheduler->setImageHandler(imageHandler);
+    scheduler->addImage(varying, true, outputPath / mx::FilePath("reference.png"));
+    scheduler->addImage(varying, true, outputPath / mx::FilePath("reference.tga"));
+    scheduler->addImage(varying, false, outputPath / mx::FilePath("linear.tga"));
+    scheduler->addImage(uniform, true, outputPath / mx::FilePath("uniform.png"));
+    scheduler->run();
+    REQUIRE(scheduler->getBakedImage(0).filename == outputPath / mx::FilePath("reference.png"));
+    REQUIRE(scheduler->getBakedImage(1).filename == outputPath / mx::FilePath("reference.tga"));
+    REQUIRE(!scheduler->getBakedImage(0).isUniform);
+    REQUIRE(scheduler->getBakedImage(3).isUniform);
+    REQUIRE(scheduler->getBakedImage(3).filename.isEmpty());
+    REQUIRE(!(outputPath / mx::FilePath("uniform.png")).exists());
+    REQUIRE(!(outputPath / mx::FilePath("reference.png.partial")).exists());
+    const mx::Color4 uniformColor = scheduler->getBakedImage(3).uniformColor;
+    REQUIRE(std::abs(uniformColor[1] - (1.055f * std::pow(0.5f, 1.0f / 2.4f) - 0.055f)) < 1.0f / 255.0f);
+    REQUIRE(scheduler->getBakedImage(3).averageColor == uniformColor);
+
+    mx::ImagePtr reference = imageHandler->acquireImage("reference.png");
+    REQUIRE(reference->getWidth() == WIDTH);
+    REQUIRE(reference->getHeight() == HEIGHT);
+    mx::ImagePtr savedReference = imageHandler->acquireImage("reference.tga");
+    for (unsigned int y = 0; y < HEIGHT; y++)
+    {
+        for (unsigned int x = 0; x < WIDTH; x++)
+        {
+            REQUIRE(reference->getTexelColor(x, y) == savedReference->getTexelColor(x, y));
+        }
+    }
+
+    // With small tiles and a minimal budget, a single band of tiles is in
+    // flight, and the results are unchanged.
+    const unsigned int TILE_SIZE = 16;
+    const size_t tilesX = (WIDTH + TILE_SIZE - 1) / TILE_SIZE;
+    const size_t tilesY = (HEIGHT + TILE_SIZE - 1) / TILE_SIZE;
+    std::vector<mx::CpuBakeTile> tiles;
+    size_t completedTiles = 0;
+    size_t tileCount = 0;
+    bool ordered = true;
+    mx::CpuBakeSchedulerPtr budgeted = mx::CpuBakeScheduler::create(WIDTH, HEIGHT, mx::Image::BaseType::UINT8);
+    budgeted->setThreadCount(4);
+    budgeted->setTileSize(TILE_SIZE);
+    budgeted->setMemoryBudget(1);
+    budgeted->setTileCallback([&](const mx::CpuBakeTile& tile) { tiles.push_back(tile); });
+    budgeted->setProgressCallback([&](size_t completed, size_t total)
+    {
+        ordered = ordered && completed == completedTiles + 1;
+        completedTiles = completed;
+        tileCount = total;
+    });
+    budgeted->addImage(varying, true, outputPath / mx::FilePath("budgeted.png"));
+    budgeted->addImage(uniform, true, outputPath / mx::FilePath("uniform.png"));
+    budgeted->run();
+    REQUIRE(ordered);
+    REQUIRE(tileCount == 2 * tilesX * tilesY);
+    REQUIRE(completedTiles == tileCount);
+    REQUIRE(tiles.size() == tileCount);
+    size_t texelCount = 0;
+    for (const mx::CpuBakeTile& tile : tiles)
+    {
+        REQUIRE(tile.width <= TILE_SIZE);
+        REQUIRE(tile.height <= TILE_SIZE);
+        REQUIRE(tile.seconds >= 0.0);
+        texelCount += (size_t) tile.width * tile.height;
+    }
+    REQUIRE(texelCount == 2 * (size_t) WIDTH * HEIGHT);
+
+    const size_t texelMemory = 4 + sizeof(mx::Vector2) + sizeof(mx::Vector3) + 3 * sizeof(float);
+    const size_t bandMemory = tilesX * (TILE_SIZE * TILE_SIZE * texelMemory +
+                                        std::max(varying->getRegisterMemorySize(), uniform->getRegisterMemorySize()));
+    REQUIRE(budgeted->getPeakMemory() > 0);
+    REQUIRE(budgeted->getPeakMemory() <= bandMemory);
+
+    mx::ImagePtr budgetedImage = imageHandler->acquireImage("budgeted.png");
+    for (unsigned int y = 0; y < HEIGHT; y++)
+    {
+        for (unsigned int x = 0; x < WIDTH; x++)
+        {
+            REQUIRE(budgetedImage->getTexelColor(x, y) == reference->getTexelColor(x, y));
+        }
+    }
+    REQUIRE(budgeted->getBakedImage(0).averageColor == scheduler->getBakedImage(0).averageColor);
+
+    // Float images are streamed to Radiance HDR files through the default
+    // image handler.  Their shared exponents hold about eight bits of
+    // precision, without clamping.
+    mx::CpuBakeSchedulerPtr floatScheduler = mx::CpuBakeScheduler::create(WIDTH, HEIGHT, mx::Image::BaseType::FLOAT);
+    floatScheduler->addImage(varying, false, outputPath / mx::FilePath("float.hdr"));
+    floatScheduler->run();
+    mx::ImagePtr floatImage = imageHandler->acquireImage("float.hdr");
+    mx::ImagePtr linearImage = imageHandler->acquireImage("linear.tga");
+    REQUIRE(floatImage->getWidth() == WIDTH);
+    REQUIRE(floatImage->getHeight() == HEIGHT);
+    for (unsigned int y = 0; y < HEIGHT; y++)
+    {
+        for (unsigned int x = 0; x < WIDTH; x++)
+        {
+            const mx::Color4 floatColor = floatImage->getTexelColor(x, y);
+            const mx::Color4 linearColor = linearImage->getTexelColor(x, y);
+            for (size_t c = 0; c < 3; c++)
+            {
+                REQUIRE(std::abs(std::min(floatColor[c], 1.0f) - linearColor[c]) < 0.01f);
+            }
+        }
+    }
+
+    // Graphs must be compiled before baking.
+    mx::CpuBakeSchedulerPtr invalid = mx::CpuBakeScheduler::create(WIDTH, HEIGHT);
+    invalid->addImage(mx::CpuEvaluator::create(), false);
+    REQUIRE_THROWS_AS(invalid->run(), mx::ExceptionRenderError&);
+}
+#endif
+
 TEST_CASE("Render: Geometry Handler Load", "[rendercore]")
 {
     std::ofstream geomHandlerLog;
@@ -223,3 +896,96 @@ TEST_CASE("Render: Image Handler Load", "[rendercore]")
     CHECK(imagesLoaded);
     imageHandlerLog.close();
 }
+
+TEST_CASE("Render: Image Writer", "[rendercore]")
+{
+    RenderUtil::ScopedOutputDirectory outputDirectory(mx::FilePath::getCurrentPath() / mx::FilePath("imageWriter"));
+    const mx::FilePath& outputPath = outputDirectory.getPath();
+    mx::ImageHandlerPtr imageHandler = mx::ImageHandler::create(mx::StbImageLoader::create());
+    auto readFile = [](const mx::FilePath& path)
+    {
+        std::ifstream stream(path.asString(), std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    };
+
+    // Images written by rows match those saved as a whole, whether they are
+    // streamed to disk or assembled by the image handler.  The larger PNG
+    // image spans more than one compression window of its deflate stream.
+    struct WriterCase
+    {
+        std::string filename;
+        unsigned int width;
+        unsigned int height;
+        unsigned int channelCount;
+        mx::Image::BaseType baseType;
+        bool streamed;
+    };
+    const unsigned int WIDTH = 37;
+    const unsigned int HEIGHT = 23;
+    const std::vector<WriterCase> writerCases =
+    {
+        { "small.png", WIDTH, HEIGHT, 4, mx::Image::BaseType::UINT8, true },
+        { "large.png", 311, 203, 3, mx::Image::BaseType::UINT8, true },
+        { "gray.png", 64, 40, 1, mx::Image::BaseType::UINT8, true },
+        { "image.hdr", WIDTH, HEIGHT, 4, mx::Image::BaseType::FLOAT, true },
+        { "image.tga", WIDTH, HEIGHT, 4, mx::Image::BaseType::UINT8, false }
+    };
+    mx::StbImageLoaderPtr stbLoader = mx::StbImageLoader::create();
+    for (const WriterCase& writerCase : writerCases)
+    {
+        const unsigned int width = writerCase.width;
+        const unsigned int height = writerCase.height;
+        mx::ImagePtr image = mx::Image::create(width, height, writerCase.channelCount, writerCase.baseType);
+        image->createResourceBuffer();
+        unsigned int seed = 1;
+        for (unsigned int y = 0; y < height; y++)
+        {
+            for (unsigned int x = 0; x < width; x++)
+            {
+                // Mix smooth gradients, repeated blocks and noise.
+                seed = seed * 1103515245 + 12345;
+                const float noise = (float) ((seed >> 16) & 0xff) / 255.0f;
+                const float block = (float) (((x / 8) + (y / 8)) % 4) / 4.0f;
+                image->setTexelColor(x, y, mx::Color4((float) x / width, (float) y / height, (y % 3) ? block : noise, 1.0f));
+            }
+        }
+
+        const mx::FilePath rowsPath = outputPath / mx::FilePath("rows_" + writerCase.filename);
+        const mx::FilePath savedPath = outputPath / mx::FilePath("saved_" + writerCase.filename);
+        REQUIRE((stbLoader->createImageWriter(rowsPath, width, height, writerCase.channelCount, writerCase.baseType) != nullptr) == writerCase.streamed);
+        mx::ImageWriterPtr writer = imageHandler->createImageWriter(rowsPath, width, height, writerCase.channelCount, writerCase.baseType);
+        REQUIRE(writer);
+
+        // Write bands of varying heights.
+        unsigned int y = 0;
+        for (unsigned int bandHeight = 1; y < height; bandHeight = bandHeight % 7 + 1)
+        {
+            bandHeight = std::min(bandHeight, height - y);
+            mx::ImagePtr rows = mx::Image::create(width, bandHeight, writerCase.channelCount, writerCase.baseType);
+            rows->createResourceBuffer();
+            std::memcpy(rows->getResourceBuffer(),
+                        (const char*) image->getResourceBuffer() + (size_t) y * image->getRowStride(),
+                        (size_t) bandHeight * image->getRowStride());
+            REQUIRE(writer->writeRows(rows));
+            y += bandHeight;
+        }
+        mx::ImagePtr row = mx::Image::create(width, 1, writerCase.channelCount, writerCase.baseType);
+        row->createResourceBuffer();
+        REQUIRE(!writer->writeRows(row));
+        REQUIRE(!rowsPath.exists());
+        REQUIRE(writer->finish());
+        REQUIRE(imageHandler->saveImage(savedPath, image));
+        REQUIRE(readFile(rowsPath) == readFile(savedPath));
+    }
+
+    // Writers released before the image is finished leave no file behind.
+    const mx::FilePath unfinishedPath = outputPath / mx::FilePath("unfinished.hdr");
+    mx::ImageWriterPtr writer = imageHandler->createImageWriter(unfinishedPath, WIDTH, HEIGHT, 4, mx::Image::BaseType::FLOAT);
+    REQUIRE(writer);
+    writer = nullptr;
+    REQUIRE(!unfinishedPath.exists());
+    REQUIRE(!mx::FilePath(unfinishedPath.asString() + ".partial").exists());
+
+    // Unsupported extensions have no writer.
+    REQUIRE(!imageHandler->createImageWriter(outputPath / mx::FilePath("image.exr"), WIDTH, HEIGHT, 4, mx::Image::BaseType::FLOAT));
+}
@@ -12,11 +12,70 @@
 
 #include <MaterialXRender/Image.h>
 
+#if defined(_WIN32)
+#include <windows.h>
+#include <direct.h>
+#else
+#include <dirent.h>
+#include <unistd.h>
+#endif
+
+#include <cstdio>
+
 namespace mx = MaterialX;
 
 namespace RenderUtil
 {
 
+ScopedOutputDirectory::ScopedOutputDirectory(const mx::FilePath& path) :
+    _path(path)
+{
+    _path.createDirectory();
+}
+
+ScopedOutputDirectory::~ScopedOutputDirectory()
+{
+    mx::FilePathVec files;
+#if defined(_WIN32)
+    WIN32_FIND_DATA fd;
+    HANDLE hFind = FindFirstFile((_path / mx::FilePath("*")).asString().c_str(), &fd);
+    if (hFind != INVALID_HANDLE_VALUE)
+    {
+        do
+        {
+            if (!(fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+            {
+                files.emplace_back(fd.cFileName);
+            }
+        } while (FindNextFile(hFind, &fd));
+        FindClose(hFind);
+    }
+#else
+    DIR* dir = opendir(_path.asString().c_str());
+    if (dir)
+    {
+        while (struct dirent* entry = readdir(dir))
+        {
+            if (entry->d_type != DT_DIR)
+            {
+                files.emplace_back(entry->d_name);
+            }
+        }
+        closedir(dir);
+    }
+#endif
+
+    for (const mx::FilePath& file : files)
+    {
+        std::remove((_path / file).asString().c_str());
+    }
+#if defined(_WIN32)
+    _rmdir(_path.asString().c_str());
+#else
+    rmdir(_path.asString().c_str());
+#endif
+}
+
 ShaderRenderTester::ShaderRenderTester(mx::ShaderGeneratorPtr shaderGenerator) :
     _shaderGenerator(shaderGenerator)
 {
@@ -92,6 +92,23 @@ class AdditiveScopedTimer
     std::chrono::time_point<std::chrono::system_clock> _startTime;
 };
 
+// Scoped directory for test output, which is created on construction and
+// removed along with its files on destruction.
+//
+class ScopedOutputDirectory
+{
+  public:
+    explicit ScopedOutputDirectory(const mx::FilePath& path);
+    ~ScopedOutputDirectory();
+
+    const mx::FilePath& getPath() const
+    {
+        return _path;
+    }
+
+  protected:
+    mx::FilePath _path;
+};
 
 // Per language profile times
 //
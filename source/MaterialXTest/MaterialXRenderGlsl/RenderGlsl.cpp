@@ -19,6 +19,10 @@
 
 #include <MaterialXGenGlsl/GlslShaderGenerator.h>
 
+#include <MaterialXGenShader/DefaultColorManagementSystem.h>
+#include <MaterialXGenShader/Util.h>
+
+#include <MaterialXRender/CpuEvaluator.h>
 #include <MaterialXRender/GeometryHandler.h>
 #include <MaterialXRender/StbImageLoader.h>
 #if defined(MATERIALX_BUILD_OIIO)
@@ -28,6 +32,7 @@
 #include <MaterialXRenderGlsl/GlslRenderer.h>
 #include <MaterialXRenderGlsl/TextureBaker.h>
 
+#include <algorithm>
 #include <cmath>
 
 namespace mx = MaterialX;
@@ -746,3 +751,156 @@ TEST_CASE("Render: GLSL TestSuite", "[renderglsl]")
 
     renderTester.validate(testRootPaths, optionsFilePath);
 }
+
+namespace
+{
+
+// Nodes whose values in a texture-space render depend on geometry, time or
+// mipmapped texture filtering, none of which the CPU evaluator reproduces.
+const mx::StringSet UNMATCHED_NODES =
+{
+    "position", "normal", "tangent", "bitangent", "geomcolor", "geompropvalue",
+    "frame", "time", "viewdirection", "image"
+};
+
+bool hasUnmatchedNode(const mx::ShaderGraph& graph)
+{
+    for (const mx::ShaderNode* node : graph.getNodes())
+    {
+        if (UNMATCHED_NODES.count(node->getCategory()))
+        {
+            return true;
+        }
+        const mx::ShaderGraph* nodeGraph = node->getImplementation().getGraph();
+        if (nodeGraph && hasUnmatchedNode(*nodeGraph))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // anonymous namespace
+
+TEST_CASE("Render: GLSL CPU Evaluator Comparison", "[renderglsl]")
+{
+    const unsigned int RENDER_SIZE = 64;
+    const float TOLERANCE = 1e-3f;
+
+    // Texels near discontinuities, such as cell boundaries and conditional
+    // thresholds, may legitimately land on either side.
+    const float MAX_MISMATCH_FRACTION = 0.01f;
+
+    const mx::FilePath currentPath = mx::FilePath::getCurrentPath();
+    mx::FileSearchPath librarySearchPath(currentPath / mx::FilePath("libraries"));
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "targets", "stdlib", "pbrlib", "bxdf" }, librarySearchPath, libraries);
+
+    mx::GenContext context(mx::GlslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(librarySearchPath);
+    context.getOptions().targetColorSpaceOverride = "lin_rec709";
+    mx::DefaultColorManagementSystemPtr cms = mx::DefaultColorManagementSystem::create(context.getShaderGenerator().getTarget());
+    cms->loadLibrary(libraries);
+    context.getShaderGenerator().setColorManagementSystem(cms);
+
+    mx::GlslRendererPtr renderer = mx::GlslRenderer::create(RENDER_SIZE, RENDER_SIZE, mx::Image::BaseType::FLOAT);
+    renderer->initialize();
+    mx::ImageHandlerPtr imageHandler = mx::GLTextureHandler::create(mx::StbImageLoader::create());
+    imageHandler->setSearchPath(mx::FileSearchPath(currentPath));
+    renderer->setImageHandler(imageHandler);
+    renderer->setLightHandler(nullptr);
+    renderer->getFrameBuffer()->setEncodeSrgb(false);
+    mx::ImagePtr capture = mx::Image::create(RENDER_SIZE, RENDER_SIZE, 4, mx::Image::BaseType::FLOAT);
+    capture->createResourceBuffer();
+
+    // Sample the texel centers of the texture-space quad, whose rows are
+    // captured from the bottom up.
+    mx::CpuEvaluatorPtr evaluator = mx::CpuEvaluator::create();
+    mx::CpuSamples samples;
+    for (unsigned int y = 0; y < RENDER_SIZE; y++)
+    {
+        for (unsigned int x = 0; x < RENDER_SIZE; x++)
+        {
+            const mx::Vector2 uv((x + 0.5f) / RENDER_SIZE, (y + 0.5f) / RENDER_SIZE);
+            samples.texcoords.push_back(uv);
+            samples.positions.push_back(mx::Vector3(uv[0] * 2.0f - 1.0f, uv[1] * 2.0f - 1.0f, 0.0f));
+        }
+    }
+    std::vector<float> result;
+
+    std::vector<mx::DocumentPtr> documents;
+    mx::StringVec documentPaths;
+    mx::loadDocuments(currentPath / mx::FilePath("resources/Materials/TestSuite/stdlib"), librarySearchPath,
+                      mx::StringSet(), mx::StringSet(), documents, documentPaths);
+    REQUIRE(!documents.empty());
+
+    size_t comparedCount = 0;
+    for (size_t i = 0; i < documents.size(); i++)
+    {
+        mx::DocumentPtr doc = documents[i];
+        doc->importLibrary(libraries);
+        std::vector<mx::TypedElementPtr> elements;
+        mx::findRenderableElements(doc, elements);
+        for (mx::TypedElementPtr element : elements)
+        {
+            const mx::TypeDesc* type = mx::TypeDesc::get(element->getType());
+            if (!element->isA<mx::Output>() || !type || type->getBaseType() != mx::TypeDesc::BASETYPE_FLOAT || type->getSize() > 4)
+            {
+                continue;
+            }
+
+            // Skip outputs that either side cannot evaluate.
+            mx::ShaderPtr shader;
+            try
+            {
+                shader = context.getShaderGenerator().generate("CompareShader", element, context);
+                if (hasUnmatchedNode(shader->getGraph()))
+                {
+                    continue;
+                }
+                evaluator->compile(element, context);
+            }
+            catch (mx::Exception&)
+            {
+                continue;
+            }
+
+            INFO(documentPaths[i] + ": " + element->getNamePath());
+            renderer->createProgram(shader);
+            renderer->renderTextureSpace();
+            renderer->captureImage(capture);
+            evaluator->evaluate(samples, result);
+
+            // Expand each value to RGBA as the GLSL generator does.
+            const size_t size = type->getSize();
+            size_t mismatchCount = 0;
+            for (unsigned int y = 0; y < RENDER_SIZE; y++)
+            {
+                for (unsigned int x = 0; x < RENDER_SIZE; x++)
+                {
+                    const float* value = &result[(y * RENDER_SIZE + x) * size];
+                    mx::Color4 expected;
+                    switch (size)
+                    {
+                        case 1: expected = mx::Color4(value[0], value[0], value[0], 1.0f); break;
+                        case 2: expected = mx::Color4(value[0], value[1], 0.0f, 1.0f); break;
+                        case 3: expected = mx::Color4(value[0], value[1], value[2], 1.0f); break;
+                        default: expected = mx::Color4(value[0], value[1], value[2], value[3]); break;
+                    }
+                    const mx::Color4 rendered = capture->getTexelColor(x, y);
+                    for (size_t c = 0; c < 4; c++)
+                    {
+                        if (std::abs(rendered[c] - expected[c]) > TOLERANCE * std::max(1.0f, std::abs(expected[c])))
+                        {
+                            mismatchCount++;
+                            break;
+                        }
+                    }
+                }
+            }
+            REQUIRE(mismatchCount <= (size_t) (MAX_MISMATCH_FRACTION * RENDER_SIZE * RENDER_SIZE));
+            comparedCount++;
+        }
+    }
+    REQUIRE(comparedCount > 0);
+}
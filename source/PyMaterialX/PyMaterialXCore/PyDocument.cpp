@@ -19,6 +19,10 @@ void bindPyDocument(py::module& mod)
         .def("copy", &mx::Document::copy)
         .def("importLibrary", &mx::Document::importLibrary)
         .def("getReferencedSourceUris", &mx::Document::getReferencedSourceUris)
+        .def("addDataLibrary", &mx::Document::addDataLibrary)
+        .def("hasDataLibraries", &mx::Document::hasDataLibraries)
+        .def("getDataLibraries", &mx::Document::getDataLibraries)
+        .def("clearDataLibraries", &mx::Document::clearDataLibraries)
         .def("addNodeGraph", &mx::Document::addNodeGraph,
             py::arg("name") = mx::EMPTY_STRING)
         .def("getNodeGraph", &mx::Document::getNodeGraph)
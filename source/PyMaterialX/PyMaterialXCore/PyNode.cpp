@@ -24,6 +24,7 @@ void bindPyNode(py::module& mod)
         .def("getImplementation", &mx::Node::getImplementation,
             py::arg("target") = mx::EMPTY_STRING)
         .def("getDownstreamPorts", &mx::Node::getDownstreamPorts)
+        .def("getStructuralHash", &mx::Node::getStructuralHash)
         .def_readonly_static("CATEGORY", &mx::Node::CATEGORY);
 
     py::class_<mx::GraphElement, mx::GraphElementPtr, mx::InterfaceElement>(mod, "GraphElement")
@@ -46,6 +47,8 @@ void bindPyNode(py::module& mod)
         .def("flattenSubgraphs", &mx::GraphElement::flattenSubgraphs,
             py::arg("target") = mx::EMPTY_STRING, py::arg("filter") = nullptr)
         .def("topologicalSort", &mx::GraphElement::topologicalSort)
+        .def("getStructuralHash", &mx::GraphElement::getStructuralHash)
+        .def("mergeDuplicateNodes", &mx::GraphElement::mergeDuplicateNodes)
         .def("asStringDot", &mx::GraphElement::asStringDot);
 
     py::class_<mx::NodeGraph, mx::NodeGraphPtr, mx::GraphElement>(mod, "NodeGraph")
@@ -13,13 +13,23 @@ namespace mx = MaterialX;
 
 void bindPyGenContext(py::module& mod)
 {
+    py::class_<mx::ShaderNodeImplCache, mx::ShaderNodeImplCachePtr>(mod, "ShaderNodeImplCache")
+        .def(py::init<>())
+        .def_static("create", &mx::ShaderNodeImplCache::create)
+        .def("clear", &mx::ShaderNodeImplCache::clear)
+        .def("getHitCount", &mx::ShaderNodeImplCache::getHitCount)
+        .def("getMissCount", &mx::ShaderNodeImplCache::getMissCount)
+        .def("resetCounters", &mx::ShaderNodeImplCache::resetCounters);
+
     py::class_<mx::GenContext, mx::GenContextPtr>(mod, "GenContext")
         .def(py::init<mx::ShaderGeneratorPtr>())
         .def("getShaderGenerator", &mx::GenContext::getShaderGenerator)
         .def("getOptions", static_cast<mx::GenOptions& (mx::GenContext::*)()>(&mx::GenContext::getOptions), py::return_value_policy::reference)
         .def("registerSourceCodeSearchPath", static_cast<void (mx::GenContext::*)(const mx::FilePath&)>(&mx::GenContext::registerSourceCodeSearchPath))
         .def("registerSourceCodeSearchPath", static_cast<void (mx::GenContext::*)(const mx::FileSearchPath&)>(&mx::GenContext::registerSourceCodeSearchPath))
-        .def("resolveSourceFile", &mx::GenContext::resolveSourceFile);
+        .def("resolveSourceFile", &mx::GenContext::resolveSourceFile)
+        .def("setNodeImplementationCache", &mx::GenContext::setNodeImplementationCache)
+        .def("getNodeImplementationCache", &mx::GenContext::getNodeImplementationCache);
 }
 
 void bindPyGenUserData(py::module& mod)
@@ -18,6 +18,7 @@ void bindPyGenUserData(py::module& mod);
 void bindPyGenOptions(py::module& mod);
 void bindPyShaderStage(py::module& mod);
 void bindPyShaderTranslator(py::module& mod);
+void bindPyShaderSourceCache(py::module& mod);
 void bindPyUtil(py::module& mod);
 void bindPyTypeDesc(py::module& mod);
 void bindPyUnitSystem(py::module& mod);
@@ -36,6 +37,7 @@ PYBIND11_MODULE(PyMaterialXGenShader, mod)
     bindPyGenUserData(mod);
     bindPyShaderStage(mod);
     bindPyShaderTranslator(mod);
+    bindPyShaderSourceCache(mod);
     bindPyUtil(mod);
     bindPyTypeDesc(mod);
     bindPyUnitSystem(mod);
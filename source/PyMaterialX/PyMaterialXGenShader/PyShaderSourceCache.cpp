@@ -0,0 +1,38 @@
+//
+// TM & (c) 2021 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <PyMaterialX/PyMaterialX.h>
+
+#include <MaterialXGenShader/GenContext.h>
+#include <MaterialXGenShader/ShaderSourceCache.h>
+
+namespace py = pybind11;
+namespace mx = MaterialX;
+
+void bindPyShaderSourceCache(py::module& mod)
+{
+    py::class_<mx::ShaderSourceCache, mx::ShaderSourceCachePtr>(mod, "ShaderSourceCache")
+        .def_static("create", &mx::ShaderSourceCache::create,
+            py::arg("directory"), py::arg("maxSize") = mx::ShaderSourceCache::DEFAULT_MAX_SIZE)
+        .def("generate", &mx::ShaderSourceCache::generate)
+        .def("computeKey", &mx::ShaderSourceCache::computeKey)
+        .def("find", [](mx::ShaderSourceCache& cache, const std::string& key)
+        {
+            mx::StringMap stageSources;
+            cache.find(key, stageSources);
+            return stageSources;
+        })
+        .def("store", &mx::ShaderSourceCache::store)
+        .def("clear", &mx::ShaderSourceCache::clear)
+        .def("flush", &mx::ShaderSourceCache::flush)
+        .def("getDirectory", &mx::ShaderSourceCache::getDirectory)
+        .def("setMaxSize", &mx::ShaderSourceCache::setMaxSize)
+        .def("getMaxSize", &mx::ShaderSourceCache::getMaxSize)
+        .def("getTotalSize", &mx::ShaderSourceCache::getTotalSize)
+        .def("getEntryCount", &mx::ShaderSourceCache::getEntryCount)
+        .def("getHitCount", &mx::ShaderSourceCache::getHitCount)
+        .def("getMissCount", &mx::ShaderSourceCache::getMissCount)
+        .def("resetCounters", &mx::ShaderSourceCache::resetCounters);
+}
@@ -6,6 +6,8 @@
 #include <PyMaterialX/PyMaterialX.h>
 
 #include <MaterialXGenShader/Util.h>
+#include <MaterialXGenShader/GenContext.h>
+#include <MaterialXGenShader/Shader.h>
 #include <MaterialXGenShader/ShaderGenerator.h>
 
 namespace py = pybind11;
@@ -26,4 +28,6 @@ void bindPyUtil(py::module& mod)
     mod.def("getUdimScaleAndOffset", &mx::getUdimScaleAndOffset);
     mod.def("connectsToWorldSpaceNode", &mx::connectsToWorldSpaceNode);
     mod.def("hasElementAttributes", &mx::hasElementAttributes);
+    mod.def("generateShaders", &mx::generateShaders,
+        py::arg("elements"), py::arg("context"), py::arg("threadCount") = 0);
 }
@@ -0,0 +1,54 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <PyMaterialX/PyMaterialX.h>
+
+#include <MaterialXRender/CpuBakeScheduler.h>
+
+#include <pybind11/functional.h>
+
+namespace py = pybind11;
+namespace mx = MaterialX;
+
+void bindPyCpuBakeScheduler(py::module& mod)
+{
+    py::class_<mx::CpuBakeTile>(mod, "CpuBakeTile")
+        .def(py::init<>())
+        .def_readwrite("image", &mx::CpuBakeTile::image)
+        .def_readwrite("x", &mx::CpuBakeTile::x)
+        .def_readwrite("y", &mx::CpuBakeTile::y)
+        .def_readwrite("width", &mx::CpuBakeTile::width)
+        .def_readwrite("height", &mx::CpuBakeTile::height)
+        .def_readwrite("seconds", &mx::CpuBakeTile::seconds);
+
+    py::class_<mx::CpuBakedImage>(mod, "CpuBakedImage")
+        .def(py::init<>())
+        .def_readwrite("filename", &mx::CpuBakedImage::filename)
+        .def_readwrite("isUniform", &mx::CpuBakedImage::isUniform)
+        .def_readwrite("uniformColor", &mx::CpuBakedImage::uniformColor)
+        .def_readwrite("averageColor", &mx::CpuBakedImage::averageColor);
+
+    py::class_<mx::CpuBakeScheduler, mx::CpuBakeSchedulerPtr>(mod, "CpuBakeScheduler")
+        .def_static("create", &mx::CpuBakeScheduler::create)
+        .def("setThreadCount", &mx::CpuBakeScheduler::setThreadCount)
+        .def("getThreadCount", &mx::CpuBakeScheduler::getThreadCount)
+        .def("setTileSize", &mx::CpuBakeScheduler::setTileSize)
+        .def("getTileSize", &mx::CpuBakeScheduler::getTileSize)
+        .def("setMemoryBudget", &mx::CpuBakeScheduler::setMemoryBudget)
+        .def("getMemoryBudget", &mx::CpuBakeScheduler::getMemoryBudget)
+        .def("setImageHandler", &mx::CpuBakeScheduler::setImageHandler)
+        .def("getImageHandler", &mx::CpuBakeScheduler::getImageHandler)
+        .def("setProgressCallback", &mx::CpuBakeScheduler::setProgressCallback)
+        .def("getProgressCallback", &mx::CpuBakeScheduler::getProgressCallback)
+        .def("setTileCallback", &mx::CpuBakeScheduler::setTileCallback)
+        .def("getTileCallback", &mx::CpuBakeScheduler::getTileCallback)
+        .def("addImage", &mx::CpuBakeScheduler::addImage,
+            py::arg("evaluator"), py::arg("encodeSrgb"), py::arg("filename") = mx::FilePath())
+        .def("getImageCount", &mx::CpuBakeScheduler::getImageCount)
+        .def("run", &mx::CpuBakeScheduler::run, py::call_guard<py::gil_scoped_release>())
+        .def("getBakedImage", &mx::CpuBakeScheduler::getBakedImage)
+        .def("getPeakMemory", &mx::CpuBakeScheduler::getPeakMemory)
+        .def("clear", &mx::CpuBakeScheduler::clear);
+}
@@ -0,0 +1,54 @@
+//
+// TM & (c) 2019 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <PyMaterialX/PyMaterialX.h>
+
+#include <MaterialXRender/CpuEvaluator.h>
+
+#include <MaterialXGenShader/GenContext.h>
+
+namespace py = pybind11;
+namespace mx = MaterialX;
+
+void bindPyCpuEvaluator(py::module& mod)
+{
+    py::enum_<mx::CpuInstructionSet>(mod, "CpuInstructionSet")
+        .value("SCALAR", mx::CpuInstructionSet::SCALAR)
+        .value("SSE4", mx::CpuInstructionSet::SSE4)
+        .value("AVX2", mx::CpuInstructionSet::AVX2)
+        .value("AVX512", mx::CpuInstructionSet::AVX512)
+        .export_values();
+
+    mod.def("getCpuInstructionSet", &mx::getCpuInstructionSet);
+    mod.def("isCpuInstructionSetSupported", &mx::isCpuInstructionSetSupported);
+    mod.def("getCpuInstructionSetName", &mx::getCpuInstructionSetName);
+
+    py::class_<mx::CpuSamples>(mod, "CpuSamples")
+        .def(py::init<>())
+        .def("size", &mx::CpuSamples::size)
+        .def("resize", &mx::CpuSamples::resize)
+        .def_readwrite("texcoords", &mx::CpuSamples::texcoords)
+        .def_readwrite("positions", &mx::CpuSamples::positions)
+        .def_readwrite("normals", &mx::CpuSamples::normals)
+        .def_readwrite("tangents", &mx::CpuSamples::tangents);
+
+    py::class_<mx::CpuEvaluator, mx::CpuEvaluatorPtr>(mod, "CpuEvaluator")
+        .def_static("create", &mx::CpuEvaluator::create)
+        .def("setImageHandler", &mx::CpuEvaluator::setImageHandler)
+        .def("getImageHandler", &mx::CpuEvaluator::getImageHandler)
+        .def("setInstructionSet", &mx::CpuEvaluator::setInstructionSet)
+        .def("getInstructionSet", &mx::CpuEvaluator::getInstructionSet)
+        .def("compile", static_cast<void (mx::CpuEvaluator::*)(mx::ElementPtr, mx::GenContext&)>(&mx::CpuEvaluator::compile))
+        .def("getOutputType", &mx::CpuEvaluator::getOutputType, py::return_value_policy::reference)
+        .def("getInstructionCount", &mx::CpuEvaluator::getInstructionCount)
+        .def("getRegisterMemorySize", &mx::CpuEvaluator::getRegisterMemorySize)
+        .def("evaluate", [](const mx::CpuEvaluator& evaluator, const mx::CpuSamples& samples)
+        {
+            std::vector<float> result;
+            evaluator.evaluate(samples, result);
+            return result;
+        })
+        .def_readonly_static("BATCH_SIZE", &mx::CpuEvaluator::BATCH_SIZE);
+}
@@ -0,0 +1,53 @@
+//
+// TM & (c) 2017 Lucasfilm Entertainment Company Ltd. and Lucasfilm Ltd.
+// All rights reserved.  See LICENSE.txt for license.
+//
+
+#include <PyMaterialX/PyMaterialX.h>
+
+#include <MaterialXRender/CpuTextureBaker.h>
+#include <MaterialXCore/Material.h>
+
+#include <pybind11/functional.h>
+
+namespace py = pybind11;
+namespace mx = MaterialX;
+
+void bindPyCpuTextureBaker(py::module& mod)
+{
+    py::class_<mx::CpuTextureBaker, mx::CpuTextureBakerPtr>(mod, "CpuTextureBaker")
+        .def_static("create", &mx::CpuTextureBaker::create)
+        .def("setShaderGenerator", &mx::CpuTextureBaker::setShaderGenerator)
+        .def("getShaderGenerator", &mx::CpuTextureBaker::getShaderGenerator)
+        .def("setImageHandler", &mx::CpuTextureBaker::setImageHandler)
+        .def("getImageHandler", &mx::CpuTextureBaker::getImageHandler)
+        .def("setThreadCount", &mx::CpuTextureBaker::setThreadCount)
+        .def("getThreadCount", &mx::CpuTextureBaker::getThreadCount)
+        .def("setTileSize", &mx::CpuTextureBaker::setTileSize)
+        .def("getTileSize", &mx::CpuTextureBaker::getTileSize)
+        .def("setMemoryBudget", &mx::CpuTextureBaker::setMemoryBudget)
+        .def("getMemoryBudget", &mx::CpuTextureBaker::getMemoryBudget)
+        .def("setProgressCallback", &mx::CpuTextureBaker::setProgressCallback)
+        .def("getProgressCallback", &mx::CpuTextureBaker::getProgressCallback)
+        .def("setTileCallback", &mx::CpuTextureBaker::setTileCallback)
+        .def("getTileCallback", &mx::CpuTextureBaker::getTileCallback)
+        .def("setExtension", &mx::CpuTextureBaker::setExtension)
+        .def("getExtension", &mx::CpuTextureBaker::getExtension)
+        .def("setColorSpace", &mx::CpuTextureBaker::setColorSpace)
+        .def("getColorSpace", &mx::CpuTextureBaker::getColorSpace)
+        .def("setAverageImages", &mx::CpuTextureBaker::setAverageImages)
+        .def("getAverageImages", &mx::CpuTextureBaker::getAverageImages)
+        .def("setOptimizeConstants", &mx::CpuTextureBaker::setOptimizeConstants)
+        .def("getOptimizeConstants", &mx::CpuTextureBaker::getOptimizeConstants)
+        .def("setOutputImagePath", &mx::CpuTextureBaker::setOutputImagePath)
+        .def("getOutputImagePath", &mx::CpuTextureBaker::getOutputImagePath)
+        .def("setBakedGraphName", &mx::CpuTextureBaker::setBakedGraphName)
+        .def("getBakedGraphName", &mx::CpuTextureBaker::getBakedGraphName)
+        .def("setBakedGeomInfoName", &mx::CpuTextureBaker::setBakedGeomInfoName)
+        .def("getBakedGeomInfoName", &mx::CpuTextureBaker::getBakedGeomInfoName)
+        .def("setHashImageNames", &mx::CpuTextureBaker::setHashImageNames)
+        .def("getHashImageNames", &mx::CpuTextureBaker::getHashImageNames)
+        .def("bakeMaterial", &mx::CpuTextureBaker::bakeMaterial)
+        .def("createBakeDocuments", &mx::CpuTextureBaker::createBakeDocuments, py::call_guard<py::gil_scoped_release>())
+        .def("bakeAllMaterials", &mx::CpuTextureBaker::bakeAllMaterials, py::call_guard<py::gil_scoped_release>());
+}
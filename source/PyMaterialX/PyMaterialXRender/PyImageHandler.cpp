@@ -18,6 +18,10 @@ void bindPyImageHandler(py::module& mod)
         .def_readwrite("filterType", &mx::ImageSamplingProperties::filterType)
         .def_readwrite("defaultColor", &mx::ImageSamplingProperties::defaultColor);
 
+    py::class_<mx::ImageWriter, mx::ImageWriterPtr>(mod, "ImageWriter")
+        .def("writeRows", &mx::ImageWriter::writeRows)
+        .def("finish", &mx::ImageWriter::finish);
+
     py::class_<mx::ImageLoader, mx::ImageLoaderPtr>(mod, "ImageLoader")
         .def_readonly_static("BMP_EXTENSION", &mx::ImageLoader::BMP_EXTENSION)
         .def_readonly_static("EXR_EXTENSION", &mx::ImageLoader::EXR_EXTENSION)
@@ -34,13 +38,15 @@ void bindPyImageHandler(py::module& mod)
         .def_readonly_static("TXT_EXTENSION", &mx::ImageLoader::TXT_EXTENSION)
         .def("supportedExtensions", &mx::ImageLoader::supportedExtensions)
         .def("saveImage", &mx::ImageLoader::saveImage)
-        .def("loadImage", &mx::ImageLoader::loadImage);
+        .def("loadImage", &mx::ImageLoader::loadImage)
+        .def("createImageWriter", &mx::ImageLoader::createImageWriter);
 
     py::class_<mx::ImageHandler, mx::ImageHandlerPtr>(mod, "ImageHandler")
         .def_static("create", &mx::ImageHandler::create)
         .def("addLoader", &mx::ImageHandler::addLoader)
         .def("saveImage", &mx::ImageHandler::saveImage,
             py::arg("filePath"), py::arg("image"), py::arg("verticalFlip") = false)
+        .def("createImageWriter", &mx::ImageHandler::createImageWriter)
         .def("acquireImage", &mx::ImageHandler::acquireImage)
         .def("bindImage", &mx::ImageHandler::bindImage)
         .def("unbindImage", &mx::ImageHandler::unbindImage)
@@ -19,6 +19,9 @@ void bindPyOiioImageLoader(py::module& mod);
 void bindPyTinyObjLoader(py::module& mod);
 void bindPyViewHandler(py::module& mod);
 void bindPyShaderRenderer(py::module& mod);
+void bindPyCpuEvaluator(py::module& mod);
+void bindPyCpuBakeScheduler(py::module& mod);
+void bindPyCpuTextureBaker(py::module& mod);
 
 PYBIND11_MODULE(PyMaterialXRender, mod)
 {
@@ -36,4 +39,7 @@ PYBIND11_MODULE(PyMaterialXRender, mod)
     bindPyTinyObjLoader(mod);
     bindPyViewHandler(mod);
     bindPyShaderRenderer(mod);
+    bindPyCpuEvaluator(mod);
+    bindPyCpuBakeScheduler(mod);
+    bindPyCpuTextureBaker(mod);
 }